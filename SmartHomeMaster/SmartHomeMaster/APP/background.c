@@ -0,0 +1,74 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: background.c
+ * Description: Source file for the master background tasks
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "background.h"
+#include "../MCAL/SPI/SPI.h"
+#include "../MCAL/Timer/systick.h"
+#include "../MCAL/Trace/trace.h"
+#include "console.h"
+#include "shadow.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint32 link_check_time = 0;
+static uint8 link_ok = TRUE;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Fetch telemetry and revalidate the device shadow from it
+ * @return Void
+ */
+static void vBackgroundSyncSlave(void) {
+  const Telemetry_t *pstTelemetry;
+  uint8 u8LinkOk = u8TelemetryRefresh();
+
+  if (u8LinkOk != link_ok) {
+    TRACE_EMIT(TRACE_TIMEOUT, TRACE_TIMEOUT_LINK, u8LinkOk);
+  }
+  link_ok = u8LinkOk;
+  if (link_ok == FALSE) {
+    vShadowInvalidate(); /* screens ask the slave until it answers again */
+    return;
+  }
+
+  pstTelemetry = pstTelemetryGet();
+  if (pstTelemetry->u8Flags & TELEMETRY_FLAG_BOOT) {
+    /* The slave restarted with its defaults: the snapshot below replaces
+     * whatever the master recorded before, then the reset is acknowledged */
+    SPI_ui8TransmitRecive(CLEAR_BOOT_FLAG);
+    TRACE_EMIT(TRACE_LINK_TX, CLEAR_BOOT_FLAG, TRACE_NONE);
+  }
+  vShadowApplySnapshot(pstTelemetry->u8Devices);
+}
+
+/**
+ * @brief  Run the background tasks that are due, call from every wait loop
+ * @return Void
+ */
+void vBackgroundRun(void) {
+#if UART_CONSOLE_ENABLE
+  vConsoleRun();
+#endif
+  if ((CONSOLE_LINK_BUSY() == FALSE) &&
+      SYSTICK_u8HasElapsed(link_check_time, LINK_CHECK_PERIOD)) {
+    link_check_time = SYSTICK_u32GetMillis();
+    vBackgroundSyncSlave();
+  }
+}
+
+/**
+ * @brief  Result of the last slave probe (telemetry frame received)
+ * @return TRUE if the slave answered, FALSE otherwise
+ */
+uint8 u8BackgroundLinkOk(void) { return link_ok; }
\ No newline at end of file
@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: background.h
+ * Description: Header file for the master background tasks
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef APP_BACKGROUND_H_
+#define APP_BACKGROUND_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../LIB/STD_Types.h"
+#include "main_config.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* A telemetry fetch doubles as the link probe */
+#define LINK_CHECK_PERIOD (uint32)1000 /* ms between slave probes */
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Run the background tasks that are due, call from every wait loop
+ * @return Void
+ */
+void vBackgroundRun(void);
+
+/**
+ * @brief  Result of the last slave probe (telemetry frame received)
+ * @return TRUE if the slave answered, FALSE otherwise
+ */
+uint8 u8BackgroundLinkOk(void);
+
+#endif /* APP_BACKGROUND_H_ */
\ No newline at end of file
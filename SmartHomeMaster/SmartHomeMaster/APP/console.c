@@ -0,0 +1,915 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: console.c
+ * Description: Line oriented command console on the UART
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "console.h"
+#include "../MCAL/SPI/SPI.h"
+#include "../MCAL/Stack/stack_monitor.h"
+#include "../MCAL/Timer/systick.h"
+#include "../MCAL/Trace/trace.h"
+#include "../MCAL/UART/UART.h"
+#include "background.h"
+#include "lockout.h"
+#include "settings.h"
+#include "shadow.h"
+#include "telemetry.h"
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include <util/delay.h>
+
+#if UART_BAUD_ERROR(CONSOLE_BAUD) > 20
+#error "CONSOLE_BAUD is more than 2 % off at this F_CPU"
+#endif
+
+extern uint8 smart_mode_active;
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* TX ring space a dump line needs before it is queued */
+#define CONSOLE_LINE_ROOM (uint8)62   /* isr record, the longest line */
+#define CONSOLE_RECORD_ROOM (uint8)17 /* "r TTTT EE AA BB\r\n" */
+
+/* Work of a dump per vConsoleRun: SPI bytes (about 1 ms each) or lines */
+#define CONSOLE_RUN_STEPS (uint8)16
+
+/* Largest slave frame kept by a dump, the GET_ISR_PROFILE records */
+#define CONSOLE_FRAME_SIZE (uint8)(CONSOLE_ISR_MAX * ISR_RECORD_SIZE)
+
+/*******************************************************************************
+ *                        Function Prototypes                           *
+ *******************************************************************************/
+static void vConsoleHelp(const char *pcArg);
+static void vConsoleStatus(const char *pcArg);
+static void vConsoleOn(const char *pcArg);
+static void vConsoleOff(const char *pcArg);
+static void vConsoleBlower(const char *pcArg);
+static void vConsoleTemp(const char *pcArg);
+static void vConsoleSmart(const char *pcArg);
+static void vConsoleTelemetry(const char *pcArg);
+static void vConsoleDiag(const char *pcArg);
+static void vConsoleIsr(const char *pcArg);
+static void vConsoleStack(const char *pcArg);
+static void vConsoleTrace(const char *pcArg);
+
+/*******************************************************************************
+ *                           Flash Tables                               *
+ *******************************************************************************/
+static const ConsoleCommand_t astConsoleCommands[] PROGMEM = {
+    {"help", vConsoleHelp, CONSOLE_FLAG_NONE},
+    {"status", vConsoleStatus, CONSOLE_FLAG_NONE},
+    {"on", vConsoleOn, CONSOLE_FLAG_DEVICE},
+    {"off", vConsoleOff, CONSOLE_FLAG_DEVICE},
+    {"blower", vConsoleBlower, CONSOLE_FLAG_DEVICE},
+    {"temp", vConsoleTemp, CONSOLE_FLAG_DEVICE},
+    {"smart", vConsoleSmart, CONSOLE_FLAG_NONE},
+    {"tele", vConsoleTelemetry, CONSOLE_FLAG_NONE},
+    {"diag", vConsoleDiag, CONSOLE_FLAG_NONE},
+    {"isr", vConsoleIsr, CONSOLE_FLAG_NONE},
+    {"stack", vConsoleStack, CONSOLE_FLAG_NONE},
+    {"trace", vConsoleTrace, CONSOLE_FLAG_NONE}};
+
+#define CONSOLE_COMMAND_COUNT                                                  \
+  (uint8)(sizeof(astConsoleCommands) / sizeof(astConsoleCommands[0]))
+
+/* Device names, indexed by status code - ROOM1_STATUS */
+static const char sRoom1[] PROGMEM = "room1";
+static const char sRoom2[] PROGMEM = "room2";
+static const char sRoom3[] PROGMEM = "room3";
+static const char sRoom4[] PROGMEM = "room4";
+static const char sTv[] PROGMEM = "tv";
+static const char sAc[] PROGMEM = "ac";
+static const char *const apcConsoleDevices[] PROGMEM = {sRoom1, sRoom2, sRoom3,
+                                                        sRoom4, sTv,    sAc};
+
+#define CONSOLE_DEVICE_COUNT                                                   \
+  (uint8)(sizeof(apcConsoleDevices) / sizeof(apcConsoleDevices[0]))
+
+/* Slave ISR names, in GET_ISR_PROFILE record order */
+static const char sIsrTimer0[] PROGMEM = "t0_ovf";
+static const char sIsrEeprom[] PROGMEM = "ee_rdy";
+static const char *const apcConsoleIsrs[] PROGMEM = {sIsrTimer0, sIsrEeprom};
+
+#define CONSOLE_ISR_NAME_COUNT                                                 \
+  (uint8)(sizeof(apcConsoleIsrs) / sizeof(apcConsoleIsrs[0]))
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static char console_line[CONSOLE_LINE_SIZE];
+static uint8 console_length = 0;
+static uint8 console_overflow = FALSE; /* drop the rest of a long line */
+
+/* Dump in progress: NULL when idle, else its step function */
+static ConsoleJob_t console_job = NULL;
+static uint8 console_step = 0;
+static uint8 console_index = 0; /* next frame byte or record */
+static uint8 console_count = 0; /* records of the frame */
+static uint8 console_sum = 0;
+static uint8 console_frame[CONSOLE_FRAME_SIZE];
+static TraceInfo_t console_trace_info;
+static uint16 console_trace_sync = 0; /* master trace clock at GET_TRACE */
+static const char *console_reply = NULL; /* last line, flash */
+
+/* Set from the command byte to the last byte of a slave frame */
+static uint8 console_link = FALSE;
+static uint32 console_link_stamp = 0; /* when the command was sent */
+static uint8 console_link_delay = 0;  /* ms the slave needs to answer it */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Send a flash string followed by a line break
+ * @param  pcText Flash string
+ * @return Void
+ */
+static void vConsoleReply_P(const char *pcText) {
+  UART_vSendString_P(pcText);
+  UART_vSendString_P(PSTR("\r\n"));
+}
+
+/**
+ * @brief  Send an unsigned number in decimal
+ * @param  u32Number Number to send
+ * @return Void
+ */
+static void vConsoleSendNumber(uint32 u32Number) {
+  char acDigits[10];
+  uint8 u8Count = 0;
+  do {
+    acDigits[u8Count] = (char)('0' + (u32Number % 10));
+    u32Number /= 10;
+    u8Count++;
+  } while (u32Number > 0);
+  while (u8Count > 0) {
+    u8Count--;
+    UART_vSendByte((uint8)acDigits[u8Count]);
+  }
+}
+
+/**
+ * @brief  Send a byte as two lower case hex digits
+ * @param  u8Byte Byte to send
+ * @return Void
+ */
+static void vConsoleSendHex(uint8 u8Byte) {
+  uint8 u8Nibble = u8Byte >> 4;
+  uint8 u8Digit;
+  for (u8Digit = 0; u8Digit < 2; u8Digit++) {
+    UART_vSendByte((uint8)((u8Nibble < 10) ? ('0' + u8Nibble)
+                                           : ('a' + u8Nibble - 10)));
+    u8Nibble = u8Byte & 0x0F;
+  }
+}
+
+/**
+ * @brief  Send "<name>=<number> "
+ * @param  pcName Flash string
+ * @param  u32Number Value
+ * @return Void
+ */
+static void vConsoleSendField(const char *pcName, uint32 u32Number) {
+  UART_vSendString_P(pcName);
+  UART_vSendByte('=');
+  vConsoleSendNumber(u32Number);
+  UART_vSendByte(' ');
+}
+
+/**
+ * @brief  Look up a device name
+ * @param  pcName Name typed by the user
+ * @return Index from ROOM1_STATUS, CONSOLE_DEVICE_COUNT if unknown
+ */
+static uint8 u8ConsoleFindDevice(const char *pcName) {
+  uint8 u8Index;
+  for (u8Index = 0; u8Index < CONSOLE_DEVICE_COUNT; u8Index++) {
+    if (strcmp_P(pcName, (const char *)pgm_read_ptr(
+                             &apcConsoleDevices[u8Index])) == 0) {
+      break;
+    }
+  }
+  return u8Index;
+}
+
+/**
+ * @brief  Parse "on" or "off"
+ * @param  pcArg Argument text
+ * @return TRUE, FALSE or NOT_SELECTED if neither
+ */
+static uint8 u8ConsoleParseSwitch(const char *pcArg) {
+  if (strcmp_P(pcArg, PSTR("on")) == 0) {
+    return TRUE;
+  }
+  if (strcmp_P(pcArg, PSTR("off")) == 0) {
+    return FALSE;
+  }
+  return NOT_SELECTED;
+}
+
+/**
+ * @brief  Switch a device, same commands as the device screens
+ * @param  pcArg Device name
+ * @param  u8On TRUE to switch on, FALSE to switch off
+ * @return Void
+ */
+static void vConsoleSwitch(const char *pcArg, uint8 u8On) {
+  uint8 u8Index = u8ConsoleFindDevice(pcArg);
+  if (u8Index == CONSOLE_DEVICE_COUNT) {
+    vConsoleReply_P(PSTR("ERR device"));
+    return;
+  }
+  vShadowSendCommand((u8On ? ROOM1_TURN_ON : ROOM1_TURN_OFF) + u8Index);
+  vConsoleReply_P(PSTR("OK"));
+}
+
+/**
+ * @brief  help: list the commands
+ * @param  pcArg Unused
+ * @return Void
+ */
+static void vConsoleHelp(const char *pcArg) {
+  uint8 u8Index;
+  (void)pcArg;
+  for (u8Index = 0; u8Index < CONSOLE_COMMAND_COUNT; u8Index++) {
+    UART_vSendString_P(astConsoleCommands[u8Index].acName);
+    UART_vSendByte(' ');
+  }
+  vConsoleReply_P(PSTR(""));
+  vConsoleReply_P(PSTR("devices: room1-4 tv ac"));
+}
+
+/**
+ * @brief  status: device states from the shadow table
+ * @param  pcArg Unused
+ * @return Void
+ */
+static void vConsoleStatus(const char *pcArg) {
+  uint8 u8Index;
+  (void)pcArg;
+  for (u8Index = 0; u8Index < CONSOLE_DEVICE_COUNT; u8Index++) {
+    UART_vSendString_P(
+        (const char *)pgm_read_ptr(&apcConsoleDevices[u8Index]));
+    UART_vSendByte('=');
+    UART_vSendByte(
+        (u8ShadowGetStatus(ROOM1_STATUS + u8Index) == ON_STATUS) ? '1' : '0');
+    UART_vSendByte(' ');
+  }
+  vConsoleReply_P(PSTR(""));
+}
+
+/**
+ * @brief  on <device>
+ * @param  pcArg Device name
+ * @return Void
+ */
+static void vConsoleOn(const char *pcArg) { vConsoleSwitch(pcArg, TRUE); }
+
+/**
+ * @brief  off <device>
+ * @param  pcArg Device name
+ * @return Void
+ */
+static void vConsoleOff(const char *pcArg) { vConsoleSwitch(pcArg, FALSE); }
+
+/**
+ * @brief  blower on|off
+ * @param  pcArg "on" or "off"
+ * @return Void
+ */
+static void vConsoleBlower(const char *pcArg) {
+  uint8 u8On = u8ConsoleParseSwitch(pcArg);
+  if (u8On == NOT_SELECTED) {
+    vConsoleReply_P(PSTR("ERR on|off"));
+    return;
+  }
+  vShadowSendCommand((u8On == TRUE) ? BLOWER_TURN_ON : BLOWER_TURN_OFF);
+  vConsoleReply_P(PSTR("OK"));
+}
+
+/**
+ * @brief  Check the room in the TX ring
+ * @param  u8Bytes Length of the line to queue
+ * @return TRUE if the line can be queued without waiting
+ */
+static uint8 u8ConsoleHasRoom(uint8 u8Bytes) {
+  return (UART_u8TxFree() >= u8Bytes) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Send a command byte, the frame starts once the slave answered
+ * @param  u8Command Command code
+ * @param  u8Delay Time in ms the slave needs before the next byte
+ * @return Void
+ */
+static void vConsoleCommand(uint8 u8Command, uint8 u8Delay) {
+  SPI_ui8TransmitRecive(u8Command);
+  console_link = TRUE;
+  console_link_stamp = SYSTICK_u32GetMillis();
+  /* The stamp is a whole ms, so one more keeps the full delay */
+  console_link_delay = (uint8)(u8Delay + 1);
+}
+
+/**
+ * @brief  Check that the slave had the time to answer the command
+ * @return TRUE if the frame may be clocked in
+ */
+static uint8 u8ConsoleLinkReady(void) {
+  return SYSTICK_u8HasElapsed(console_link_stamp, console_link_delay);
+}
+
+/**
+ * @brief  Clock in the next byte of a frame, adds it to the checksum
+ * @return Void
+ */
+static void vConsoleReceive(void) {
+  uint8 u8Byte = SPI_ui8TransmitRecive(DEFAULT_ACK);
+  _delay_ms(TELEMETRY_BYTE_DELAY);
+  console_frame[console_index] = u8Byte;
+  console_sum += u8Byte;
+  console_index++;
+}
+
+/**
+ * @brief  Start a dump, it runs from the next vConsoleRun
+ * @param  pfJob Step function
+ * @return Void
+ */
+static void vConsoleStart(ConsoleJob_t pfJob) {
+  console_job = pfJob;
+  console_step = 0;
+  console_index = 0;
+  console_sum = 0;
+}
+
+/**
+ * @brief  Last step of a dump: send console_reply
+ * @return TRUE once sent
+ */
+static uint8 u8ConsoleJobReply(void) {
+  if (u8ConsoleHasRoom(CONSOLE_LINE_ROOM) == FALSE) {
+    return FALSE;
+  }
+  vConsoleReply_P(console_reply);
+  console_job = NULL;
+  return TRUE;
+}
+
+/**
+ * @brief  End a dump with one more line
+ * @param  pcReply Flash string
+ * @return TRUE, the step moved
+ */
+static uint8 u8ConsoleEnd(const char *pcReply) {
+  console_link = FALSE;
+  console_reply = pcReply;
+  console_job = u8ConsoleJobReply;
+  return TRUE;
+}
+
+/**
+ * @brief  Steps of temp: the command, then the value (console_frame[0])
+ *         SET_TEMPERATURE_DELAY later
+ * @return TRUE if the step moved
+ */
+static uint8 u8ConsoleJobTemp(void) {
+  if (console_step == 0) {
+    vConsoleCommand(SET_TEMPERATURE, SET_TEMPERATURE_DELAY);
+    console_step = 1;
+    return TRUE;
+  }
+  if (u8ConsoleLinkReady() == FALSE) {
+    return FALSE;
+  }
+  SPI_ui8TransmitRecive(console_frame[0]);
+  TRACE_EMIT(TRACE_LINK_TX, SET_TEMPERATURE, console_frame[0]);
+  return u8ConsoleEnd(PSTR("OK"));
+}
+
+/**
+ * @brief  temp <1-99>: send a new AC set point
+ * @param  pcArg Set point in degrees C
+ * @return Void
+ */
+static void vConsoleTemp(const char *pcArg) {
+  uint8 temperature = 0;
+  uint8 u8Digits = 0;
+  while ((*pcArg >= '0') && (*pcArg <= '9') && (u8Digits < 2)) {
+    temperature = (uint8)(temperature * 10 + (*pcArg - ASCII_ZERO));
+    pcArg++;
+    u8Digits++;
+  }
+  if ((u8Digits == 0) || (*pcArg != '\0') || (temperature == 0)) {
+    vConsoleReply_P(PSTR("ERR 1-99"));
+    return;
+  }
+  vConsoleStart(u8ConsoleJobTemp);
+  console_frame[0] = temperature;
+}
+
+/**
+ * @brief  smart [on|off]: show or change smart mode
+ * @param  pcArg "on", "off" or "" to query
+ * @return Void
+ */
+static void vConsoleSmart(const char *pcArg) {
+  uint8 u8On = u8ConsoleParseSwitch(pcArg);
+  if (*pcArg == '\0') {
+    vConsoleReply_P(smart_mode_active ? PSTR("smart=1") : PSTR("smart=0"));
+    return;
+  }
+  if (u8On == NOT_SELECTED) {
+    vConsoleReply_P(PSTR("ERR on|off"));
+    return;
+  }
+  smart_mode_active = u8On;
+  vSettingsSave();
+  vConsoleReply_P(PSTR("OK"));
+}
+
+/**
+ * @brief  tele: fetch and print a telemetry frame
+ * @param  pcArg Unused
+ * @return Void
+ */
+static void vConsoleTelemetry(const char *pcArg) {
+  const Telemetry_t *pstTelemetry;
+  (void)pcArg;
+  if (u8TelemetryRefresh() == FALSE) {
+    vConsoleReply_P(PSTR("ERR link"));
+    return;
+  }
+  pstTelemetry = pstTelemetryGet();
+  vConsoleSendField(PSTR("temp"), pstTelemetry->u8Temperature);
+  vConsoleSendField(PSTR("set"), pstTelemetry->u8SetPoint);
+  vConsoleSendField(PSTR("fan"), pstTelemetry->u8FanDuty);
+  vConsoleSendField(PSTR("flags"), pstTelemetry->u8Flags);
+  vConsoleSendField(PSTR("dev"), pstTelemetry->u8Devices);
+  vConsoleReply_P(PSTR(""));
+}
+
+/**
+ * @brief  diag: uptime, link, lockout and console health
+ * @param  pcArg Unused
+ * @return Void
+ */
+static void vConsoleDiag(const char *pcArg) {
+  (void)pcArg;
+  vConsoleSendField(PSTR("up_ms"), SYSTICK_u32GetMillis());
+  vConsoleSendField(PSTR("link"), u8BackgroundLinkOk());
+  vConsoleSendField(PSTR("lockout_s"), u8LockoutIsActive() == TRUE
+                                           ? u16LockoutSecondsLeft()
+                                           : 0);
+  vConsoleSendField(PSTR("rx_drop"), UART_u8GetOverruns());
+  vConsoleReply_P(PSTR(""));
+}
+
+/**
+ * @brief  Read a 16-bit record field, low byte first
+ * @param  pu8Field First byte of the field
+ * @return Field value
+ */
+static uint16 u16ConsoleField(const uint8 *pu8Field) {
+  return (uint16)(pu8Field[0] | ((uint16)pu8Field[1] << 8));
+}
+
+/**
+ * @brief  Steps of isr: fetch the records, then print them
+ * @return TRUE if the step moved
+ */
+static uint8 u8ConsoleJobIsr(void) {
+  const uint8 *pu8Record;
+  uint8 u8Index;
+
+  switch (console_step) {
+  case 0: /* request */
+    vConsoleCommand(GET_ISR_PROFILE, TELEMETRY_CMD_DELAY);
+    console_step = 1;
+    break;
+  case 1: /* record count */
+    if (u8ConsoleLinkReady() == FALSE) {
+      return FALSE;
+    }
+    console_count = SPI_ui8TransmitRecive(DEFAULT_ACK);
+    _delay_ms(TELEMETRY_BYTE_DELAY);
+    if (console_count > CONSOLE_ISR_MAX) {
+      return u8ConsoleEnd(PSTR("ERR link")); /* a missing slave reads 0xFF */
+    }
+    console_sum = console_count;
+    console_step = 2;
+    break;
+  case 2: /* records */
+    if (console_index < console_count * ISR_RECORD_SIZE) {
+      vConsoleReceive();
+    } else {
+      console_step = 3;
+    }
+    break;
+  case 3: /* checksum */
+    if (SPI_ui8TransmitRecive(DEFAULT_ACK) != (uint8)~console_sum) {
+      return u8ConsoleEnd(PSTR("ERR link"));
+    }
+    if (console_count == 0) {
+      return u8ConsoleEnd(PSTR("isr off")); /* slave without ISR_PROFILE */
+    }
+    console_link = FALSE;
+    console_index = 0;
+    console_step = 4;
+    break;
+  default: /* one line per record */
+    if (u8ConsoleHasRoom(CONSOLE_LINE_ROOM) == FALSE) {
+      return FALSE;
+    }
+    u8Index = console_index;
+    pu8Record = &console_frame[u8Index * ISR_RECORD_SIZE];
+    if (u8Index < CONSOLE_ISR_NAME_COUNT) {
+      UART_vSendString_P((const char *)pgm_read_ptr(&apcConsoleIsrs[u8Index]));
+    } else {
+      vConsoleSendNumber(u8Index);
+    }
+    UART_vSendByte(' ');
+    vConsoleSendField(PSTR("n"),
+                      u16ConsoleField(&pu8Record[ISR_RECORD_COUNT]));
+    vConsoleSendField(PSTR("min"), u16ConsoleField(&pu8Record[ISR_RECORD_MIN]));
+    vConsoleSendField(PSTR("max"), u16ConsoleField(&pu8Record[ISR_RECORD_MAX]));
+    vConsoleSendField(PSTR("mean"),
+                      u16ConsoleField(&pu8Record[ISR_RECORD_MEAN]));
+    vConsoleSendField(PSTR("load_pm"),
+                      u16ConsoleField(&pu8Record[ISR_RECORD_LOAD]));
+    vConsoleReply_P(PSTR(""));
+    console_index++;
+    if (console_index == console_count) {
+      console_job = NULL;
+    }
+    break;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief  isr [reset]: cycle statistics of the slave ISRs
+ * @param  pcArg "" to print them, "reset" to clear them
+ * @return Void
+ */
+static void vConsoleIsr(const char *pcArg) {
+  if (strcmp_P(pcArg, PSTR("reset")) == 0) {
+    vConsoleWaitLink();
+    SPI_ui8TransmitRecive(RESET_ISR_PROFILE);
+    vConsoleReply_P(PSTR("OK"));
+    return;
+  }
+  if (*pcArg != '\0') {
+    vConsoleReply_P(PSTR("ERR reset"));
+    return;
+  }
+  vConsoleStart(u8ConsoleJobIsr);
+}
+
+/**
+ * @brief  Send one node's line of the stack command
+ * @param  pcNode Flash string, node name
+ * @param  pstInfo Stack measurement, u16Size 0 when not painted
+ * @return Void
+ */
+static void vConsoleStackLine(const char *pcNode, const StackInfo_t *pstInfo) {
+  UART_vSendString_P(pcNode);
+  UART_vSendByte(' ');
+  if (pstInfo->u16Size == 0) {
+    vConsoleReply_P(PSTR("off"));
+    return;
+  }
+  vConsoleSendField(PSTR("size"), pstInfo->u16Size);
+  vConsoleSendField(PSTR("used"), pstInfo->u16Used);
+  vConsoleSendField(PSTR("free"), pstInfo->u16Size - pstInfo->u16Used);
+  vConsoleSendField(PSTR("guard"), pstInfo->u8Guard);
+  vConsoleReply_P(PSTR(""));
+}
+
+/**
+ * @brief  Steps of stack: the master line, then the slave frame and line
+ * @return TRUE if the step moved
+ */
+static uint8 u8ConsoleJobStack(void) {
+  StackInfo_t stInfo;
+  uint8 u8Sum = 0;
+  uint8 u8Index;
+
+  switch (console_step) {
+  case 0: /* master */
+    if (u8ConsoleHasRoom(CONSOLE_LINE_ROOM) == FALSE) {
+      return FALSE;
+    }
+    STACK_vGet(&stInfo);
+    vConsoleStackLine(PSTR("master"), &stInfo);
+    vConsoleCommand(GET_STACK_INFO, TELEMETRY_CMD_DELAY);
+    console_step = 1;
+    break;
+  case 1: /* frame */
+    if (u8ConsoleLinkReady() == FALSE) {
+      return FALSE;
+    }
+    vConsoleReceive();
+    if (console_index == STACK_FRAME_LENGTH) {
+      console_link = FALSE;
+      console_step = 2;
+    }
+    break;
+  default: /* slave */
+    if (u8ConsoleHasRoom(CONSOLE_LINE_ROOM) == FALSE) {
+      return FALSE;
+    }
+    console_job = NULL;
+    for (u8Index = 0; u8Index < STACK_FRAME_CHECKSUM; u8Index++) {
+      u8Sum += console_frame[u8Index];
+    }
+    if (console_frame[STACK_FRAME_CHECKSUM] != (uint8)~u8Sum) {
+      vConsoleReply_P(PSTR("slave ERR link"));
+      break;
+    }
+    stInfo.u16Size = u16ConsoleField(&console_frame[STACK_FRAME_SIZE]);
+    stInfo.u16Used = u16ConsoleField(&console_frame[STACK_FRAME_USED]);
+    stInfo.u8Guard = console_frame[STACK_FRAME_GUARD];
+    vConsoleStackLine(PSTR("slave"), &stInfo);
+    break;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief  stack: stack high-water mark and free RAM of both nodes
+ * @param  pcArg Unused
+ * @return Void
+ */
+static void vConsoleStack(const char *pcArg) {
+  (void)pcArg;
+  vConsoleStart(u8ConsoleJobStack);
+}
+
+/**
+ * @brief  Send the header fields of one node's trace block, the caller ends
+ *         the line
+ * @param  pcNode Flash string, node name
+ * @param  pstInfo Ring state, u16TickUs 0 when tracing is compiled out
+ * @return FALSE if the node traces nothing, the line is then complete
+ */
+static uint8 u8ConsoleTraceHeader(const char *pcNode,
+                                  const TraceInfo_t *pstInfo) {
+  UART_vSendString_P(PSTR("trace "));
+  UART_vSendString_P(pcNode);
+  UART_vSendByte(' ');
+  if (pstInfo->u16TickUs == 0) {
+    vConsoleReply_P(PSTR("off"));
+    return FALSE;
+  }
+  vConsoleSendField(PSTR("tick_us"), pstInfo->u16TickUs);
+  vConsoleSendField(PSTR("now"), pstInfo->u16Now);
+  vConsoleSendField(PSTR("total"), pstInfo->u16Total);
+  vConsoleSendField(PSTR("n"), pstInfo->u8Count);
+  return TRUE;
+}
+
+/**
+ * @brief  Send one record line of the trace command, "r TTTT EE AA BB" in hex
+ * @param  pstRecord Record to send
+ * @return Void
+ */
+static void vConsoleTraceRecord(const TraceRecord_t *pstRecord) {
+  UART_vSendString_P(PSTR("r "));
+  vConsoleSendHex((uint8)(pstRecord->u16Time >> 8));
+  vConsoleSendHex((uint8)pstRecord->u16Time);
+  UART_vSendByte(' ');
+  vConsoleSendHex(pstRecord->u8Event);
+  UART_vSendByte(' ');
+  vConsoleSendHex(pstRecord->u8Arg0);
+  UART_vSendByte(' ');
+  vConsoleSendHex(pstRecord->u8Arg1);
+  vConsoleReply_P(PSTR(""));
+}
+
+/**
+ * @brief  Steps of trace: the master block from the frozen ring, then the
+ *         slave block, each record printed as it arrives. The slave header
+ *         ends with sync, the master trace clock when GET_TRACE left, so
+ *         the decoder can put the slave "now" on the master timeline
+ * @return TRUE if the step moved
+ */
+static uint8 u8ConsoleJobTrace(void) {
+  TraceInfo_t *pstInfo = &console_trace_info;
+  TraceRecord_t stRecord;
+
+  switch (console_step) {
+  case 0: /* master header */
+    if (u8ConsoleHasRoom(CONSOLE_LINE_ROOM) == FALSE) {
+      return FALSE;
+    }
+    TRACE_vFreeze(pstInfo);
+    if (u8ConsoleTraceHeader(PSTR("master"), pstInfo) == TRUE) {
+      vConsoleReply_P(PSTR(""));
+    }
+    console_step = 1;
+    break;
+  case 1: /* master records, then the end line and the slave request */
+    if (u8ConsoleHasRoom(CONSOLE_RECORD_ROOM) == FALSE) {
+      return FALSE;
+    }
+    if (console_index < pstInfo->u8Count) {
+      TRACE_vGet(console_index, &stRecord);
+      vConsoleTraceRecord(&stRecord);
+      console_index++;
+      break;
+    }
+    TRACE_vResume();
+    vConsoleReply_P(PSTR("end ok"));
+    vConsoleCommand(GET_TRACE, TELEMETRY_CMD_DELAY);
+    console_trace_sync = TRACE_u16Now();
+    console_index = 0;
+    console_step = 2;
+    break;
+  case 2: /* slave header */
+    if (u8ConsoleLinkReady() == FALSE) {
+      return FALSE;
+    }
+    vConsoleReceive();
+    if (console_index < TRACE_HEADER_SIZE) {
+      break;
+    }
+    pstInfo->u16TickUs = u16ConsoleField(&console_frame[TRACE_HEADER_TICK_US]);
+    pstInfo->u16Now = u16ConsoleField(&console_frame[TRACE_HEADER_NOW]);
+    pstInfo->u16Total = u16ConsoleField(&console_frame[TRACE_HEADER_TOTAL]);
+    pstInfo->u8Count = console_frame[TRACE_HEADER_COUNT];
+    if (pstInfo->u8Count > TRACE_DEPTH) {
+      return u8ConsoleEnd(PSTR("trace slave ERR link")); /* no slave: 0xFF */
+    }
+    console_count = pstInfo->u8Count;
+    console_step = 3;
+    break;
+  case 3: /* slave header line */
+    if (u8ConsoleHasRoom(CONSOLE_LINE_ROOM) == FALSE) {
+      return FALSE;
+    }
+    console_index = 0;
+    console_step =
+        (u8ConsoleTraceHeader(PSTR("slave"), pstInfo) == TRUE) ? 4 : 5;
+    break;
+  case 4: /* sync ends the line, too long for the TX ring in one go */
+    if (u8ConsoleHasRoom(CONSOLE_RECORD_ROOM) == FALSE) {
+      return FALSE;
+    }
+    vConsoleSendField(PSTR("sync"), console_trace_sync);
+    vConsoleReply_P(PSTR(""));
+    console_step = 5;
+    break;
+  case 5: /* next slave record, the end line tells if the records hold */
+    if (console_count == 0) {
+      return u8ConsoleEnd(
+          (SPI_ui8TransmitRecive(DEFAULT_ACK) == (uint8)~console_sum)
+              ? PSTR("end ok")
+              : PSTR("end ERR link"));
+    }
+    vConsoleReceive();
+    if (console_index == TRACE_RECORD_SIZE) {
+      console_step = 6;
+    }
+    break;
+  default: /* its line */
+    if (u8ConsoleHasRoom(CONSOLE_RECORD_ROOM) == FALSE) {
+      return FALSE;
+    }
+    stRecord.u16Time = u16ConsoleField(&console_frame[TRACE_RECORD_TIME]);
+    stRecord.u8Event = console_frame[TRACE_RECORD_EVENT];
+    stRecord.u8Arg0 = console_frame[TRACE_RECORD_ARG0];
+    stRecord.u8Arg1 = console_frame[TRACE_RECORD_ARG1];
+    vConsoleTraceRecord(&stRecord);
+    console_count--;
+    console_index = 0;
+    console_step = 5;
+    break;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief  trace [clear]: dump the event trace of both nodes, one block per
+ *         node ending with "end ok" or "end ERR link"; smarthome_trace
+ *         decodes the output
+ * @param  pcArg "" to dump the records, "clear" to drop them
+ * @return Void
+ */
+static void vConsoleTrace(const char *pcArg) {
+  if (strcmp_P(pcArg, PSTR("clear")) == 0) {
+    TRACE_vClear();
+    vConsoleWaitLink();
+    SPI_ui8TransmitRecive(CLEAR_TRACE);
+    vConsoleReply_P(PSTR("OK"));
+    return;
+  }
+  if (*pcArg != '\0') {
+    vConsoleReply_P(PSTR("ERR clear"));
+    return;
+  }
+  vConsoleStart(u8ConsoleJobTrace);
+}
+
+/**
+ * @brief  Split and run one complete line
+ * @return Void
+ */
+static void vConsoleExecute(void) {
+  const ConsoleCommand_t *pstCommand = astConsoleCommands;
+  uint8 u8Count = CONSOLE_COMMAND_COUNT;
+  char *pcArg = console_line;
+
+  if (console_line[0] == '\0') {
+    return; /* empty line, e.g. the \n of a \r\n pair */
+  }
+  while ((*pcArg != '\0') && (*pcArg != ' ')) {
+    pcArg++;
+  }
+  if (*pcArg == ' ') {
+    *pcArg = '\0';
+    pcArg++;
+  }
+
+  while ((u8Count > 0) && (strcmp_P(console_line, pstCommand->acName) != 0)) {
+    pstCommand++;
+    u8Count--;
+  }
+  if (u8Count == 0) {
+    vConsoleReply_P(PSTR("ERR unknown, try help"));
+    return;
+  }
+  if ((pgm_read_byte(&pstCommand->u8Flags) & CONSOLE_FLAG_DEVICE) &&
+      (u8LockoutIsActive() == TRUE)) {
+    vConsoleReply_P(PSTR("ERR locked"));
+    return;
+  }
+  ((ConsoleHandler_t)pgm_read_ptr(&pstCommand->pfHandler))(pcArg);
+}
+
+/**
+ * @brief  Start the UART and print the banner
+ * @return Void
+ */
+void vConsoleInit(void) {
+  UART_vInit(UART_UBRR(CONSOLE_BAUD));
+  vConsoleReply_P(PSTR("SmartHome console, type help"));
+}
+
+/**
+ * @brief  Run the commands received so far, or one step of the dump in
+ *         progress; never waits for input or for the TX ring
+ * @return Void
+ */
+void vConsoleRun(void) {
+  uint8 u8Byte;
+  uint8 u8Step;
+  if (console_job != NULL) {
+    /* The next line waits for the dump, so replies stay in order */
+    u8Step = 0;
+    while ((u8Step < CONSOLE_RUN_STEPS) && (console_job != NULL) &&
+           (console_job() == TRUE)) {
+      u8Step++;
+    }
+    return;
+  }
+  while ((console_job == NULL) && UART_u8Receive(&u8Byte)) {
+    if ((u8Byte == '\r') || (u8Byte == '\n')) {
+      console_line[console_length] = '\0';
+      if (console_overflow == TRUE) {
+        vConsoleReply_P(PSTR("ERR too long"));
+      } else {
+        vConsoleExecute();
+      }
+      console_length = 0;
+      console_overflow = FALSE;
+    } else if (console_length < (CONSOLE_LINE_SIZE - 1)) {
+      console_line[console_length] = (char)u8Byte;
+      console_length++;
+    } else {
+      console_overflow = TRUE;
+    }
+  }
+}
+
+/**
+ * @brief  Check whether a console dump is in the middle of a slave frame
+ * @return TRUE while the console owns the SPI link
+ */
+uint8 u8ConsoleLinkBusy(void) { return console_link; }
+
+/**
+ * @brief  Finish the slave frame of the console dump in progress, call
+ *         before any other SPI transaction
+ * @return Void
+ */
+void vConsoleWaitLink(void) {
+  while (console_link == TRUE) {
+    (void)console_job();
+  }
+}
\ No newline at end of file
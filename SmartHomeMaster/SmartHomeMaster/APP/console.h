@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: console.h
+ * Description: Header file for the UART command console
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef APP_CONSOLE_H_
+#define APP_CONSOLE_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../LIB/STD_Types.h"
+#include "../MCAL/DIO/DIO.h" /* UART_CONSOLE_ENABLE */
+#include "main_config.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* 0.2 % off at 8 MHz; override with -DCONSOLE_BAUD=115200UL on a 7.3728 or
+ * 14.7456 MHz board */
+#ifndef CONSOLE_BAUD
+#define CONSOLE_BAUD 38400UL
+#endif
+#define CONSOLE_LINE_SIZE (uint8)24 /* longer lines are rejected */
+#define CONSOLE_NAME_SIZE (uint8)7
+#define CONSOLE_ISR_MAX (uint8)4 /* ISR records accepted from the slave */
+
+/* Other SPI users let a slave frame of the console finish first */
+#if UART_CONSOLE_ENABLE
+#define CONSOLE_WAIT_LINK() vConsoleWaitLink()
+#define CONSOLE_LINK_BUSY() u8ConsoleLinkBusy()
+#else
+#define CONSOLE_WAIT_LINK()
+#define CONSOLE_LINK_BUSY() FALSE
+#endif
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/* Runs one command, pcArg points at the text after the first space ("" if
+ * none) */
+typedef void (*ConsoleHandler_t)(const char *pcArg);
+
+/* One step of a dump, moves at most one SPI byte or one output line and
+ * returns TRUE if it did (FALSE while the slave or the TX ring is busy) */
+typedef uint8 (*ConsoleJob_t)(void);
+
+/**
+ * @brief  One console command (flash resident)
+ */
+typedef struct {
+  char acName[CONSOLE_NAME_SIZE];
+  ConsoleHandler_t pfHandler;
+  uint8 u8Flags; /* CONSOLE_FLAG_x */
+} ConsoleCommand_t;
+
+#define CONSOLE_FLAG_NONE (uint8)0x00
+#define CONSOLE_FLAG_DEVICE (uint8)0x01 /* refused during a login lockout */
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Start the UART and print the banner
+ * @return Void
+ */
+void vConsoleInit(void);
+
+/**
+ * @brief  Run the commands received so far, or one step of the dump in
+ *         progress; never waits for input or for the TX ring
+ * @return Void
+ */
+void vConsoleRun(void);
+
+/**
+ * @brief  Check whether a console dump is in the middle of a slave frame
+ * @return TRUE while the console owns the SPI link
+ */
+uint8 u8ConsoleLinkBusy(void);
+
+/**
+ * @brief  Finish the slave frame of the console dump in progress, call
+ *         before any other SPI transaction
+ * @return Void
+ */
+void vConsoleWaitLink(void);
+
+#endif /* APP_CONSOLE_H_ */
\ No newline at end of file
@@ -0,0 +1,115 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: lockout.c
+ * Description: Source file for the timed login lockout
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "lockout.h"
+#include "../HAL/Buzzer/buzzer.h"
+#include "../HAL/LED/LED.h"
+#include "../MCAL/Timer/systick.h"
+#include "../MCAL/Trace/trace.h"
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Buzzer sounds while BLOCK_LED is off, like the original alarm */
+static const BuzzerStep_t lockout_pattern[] PROGMEM = {
+    {BUZZER_OFF, LOCKOUT_BLINK_TIME},
+    {BUZZER_ON, LOCKOUT_BLINK_TIME},
+    BUZZER_STEP_LOOP};
+
+static volatile uint8 lockout_active = FALSE;
+static volatile uint16 lockout_phase_ms = 0;
+static uint32 lockout_deadline = 0;
+static uint8 lockout_count = 0; /* consecutive lockouts since last login */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Tick callback, blinks BLOCK_LED in step with the buzzer pattern
+ * @return Void
+ */
+static void vLockoutTick(void) {
+  if (lockout_active == TRUE) {
+    lockout_phase_ms++;
+    if (lockout_phase_ms >= LOCKOUT_BLINK_TIME) {
+      lockout_phase_ms = 0;
+      LED_vToggle(BLOCK_LED_PORT, BLOCK_LED_PIN);
+    }
+  }
+}
+
+/**
+ * @brief  Hook the alarm LED blinker on the system tick
+ * @return TRUE if hooked, FALSE if the system tick has no free slot
+ */
+uint8 u8LockoutInit(void) { return SYSTICK_u8RegisterCallback(vLockoutTick); }
+
+/**
+ * @brief  Enter lockout, the alarm pattern runs from the system tick
+ * @return Void
+ */
+void vLockoutStart(void) {
+  uint32 u32Duration = BLOCK_MODE_TIME;
+  uint8 u8Round;
+  if (LOCKOUT_BACKOFF == TRUE) {
+    for (u8Round = 0;
+         (u8Round < lockout_count) && (u32Duration < LOCKOUT_MAX_TIME);
+         u8Round++) {
+      u32Duration <<= 1;
+    }
+    if (u32Duration > LOCKOUT_MAX_TIME) {
+      u32Duration = LOCKOUT_MAX_TIME;
+    }
+  }
+  if (lockout_count < 0xFF) {
+    lockout_count++;
+  }
+  TRACE_EMIT(TRACE_LOCKOUT, TRUE, lockout_count);
+
+  lockout_deadline = SYSTICK_u32Deadline(u32Duration);
+
+  /* First phase: LED on, buzzer off */
+  LED_vTurnOn(BLOCK_LED_PORT, BLOCK_LED_PIN);
+  lockout_phase_ms = 0;
+  lockout_active = TRUE;
+  buzzer_vPlay(lockout_pattern);
+}
+
+/**
+ * @brief  Check the lockout state, stops the alarm once it expired
+ * @return TRUE while locked out, FALSE otherwise
+ */
+uint8 u8LockoutIsActive(void) {
+  if ((lockout_active == TRUE) && SYSTICK_u8IsExpired(lockout_deadline)) {
+    lockout_active = FALSE;
+    TRACE_EMIT(TRACE_LOCKOUT, FALSE, lockout_count);
+    LED_vTurnOff(BLOCK_LED_PORT, BLOCK_LED_PIN);
+    buzzer_vStop();
+  }
+  return lockout_active;
+}
+
+/**
+ * @brief  Remaining lockout time, rounded up
+ * @return Seconds left
+ */
+uint16 u16LockoutSecondsLeft(void) {
+  uint32 u32Left = 0;
+  if (u8LockoutIsActive() == TRUE) {
+    u32Left = lockout_deadline - SYSTICK_u32GetMillis();
+  }
+  return (uint16)((u32Left + 999) / 1000);
+}
+
+/**
+ * @brief  Forget previous lockouts after a successful login
+ * @return Void
+ */
+void vLockoutReset(void) { lockout_count = 0; }
\ No newline at end of file
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: lockout.h
+ * Description: Header file for the timed login lockout
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef APP_LOCKOUT_H_
+#define APP_LOCKOUT_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../LIB/STD_Types.h"
+#include "main_config.h"
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Hook the alarm LED blinker on the system tick
+ * @return TRUE if hooked, FALSE if the system tick has no free slot
+ */
+uint8 u8LockoutInit(void);
+
+/**
+ * @brief  Enter lockout, the alarm pattern runs from the system tick
+ * @return Void
+ */
+void vLockoutStart(void);
+
+/**
+ * @brief  Check the lockout state, stops the alarm once it expired
+ * @return TRUE while locked out, FALSE otherwise
+ */
+uint8 u8LockoutIsActive(void);
+
+/**
+ * @brief  Remaining lockout time, rounded up
+ * @return Seconds left
+ */
+uint16 u16LockoutSecondsLeft(void);
+
+/**
+ * @brief  Forget previous lockouts after a successful login
+ * @return Void
+ */
+void vLockoutReset(void);
+
+#endif /* APP_LOCKOUT_H_ */
\ No newline at end of file
@@ -18,7 +18,6 @@
  *******************************************************************************/
 /*********************************** Passwords
  * ***********************************/
-#define SITPASS TRUE //     OR  FALSE
 #define ADMIN_PASS {0, 0, 0, 0}
 #define GEST_PASS {1, 1, 1, 1}
 /*********************************************************************************/
@@ -26,8 +25,12 @@
 #define NOT_STORED 0xFF
 #define NOT_SELECTED 0xFF
 
-#define BLOCK_MODE_TIME 20000
+#define BLOCK_MODE_TIME (uint32)20000
+#define LOCKOUT_BACKOFF TRUE /* double the lockout on each repeat */
+#define LOCKOUT_MAX_TIME (uint32)320000
+#define LOCKOUT_BLINK_TIME (uint16)500 /* alarm LED/buzzer phase (ms) */
 #define CHARACTER_PREVIEW_TIME (uint16)300
+#define SET_TEMPERATURE_DELAY 200 /* ms between SET_TEMPERATURE and value */
 #define DEGREES_SYMBOL (uint8)0xDF
 
 /*********************************** PIN Configuration
@@ -73,15 +76,35 @@
 #define SELECT_AIR_COND_CTRL (uint8)'2'
 #define SELECT_AIR_COND_RET (uint8)'0'
 
-/****************************   number of ticks to run timeout
+#define SELECT_BLOWER (uint8)'5'
+#define SELECT_DASHBOARD (uint8)'6'
+#define SELECT_SMART_MODE (uint8)'5'
+#define SELECT_TURN_ON (uint8)'1'
+#define SELECT_TURN_OFF (uint8)'2'
+#define SELECT_RETURN (uint8)'0'
+#define SELECT_LOGOUT (uint8)'0'
+
+/* One-key shortcuts on the main menus (keypad symbols not used elsewhere) */
+#define HOTKEY_ROOM1 (uint8)'/'
+#define HOTKEY_ROOM2 (uint8)'*'
+#define HOTKEY_ROOM3 (uint8)'-'
+#define HOTKEY_ROOM4 (uint8)'+'
+#define HOTKEY_TV (uint8)'='
+#define HOTKEY_ALL_OFF (uint8)'A'
+#define MENU_HOTKEY_COUNT (uint8)6
+
+/****************************   keypad inactivity (ms) before logout
  * ***************************/
-#define ADMIN_TIMEOUT (uint16)3000
-#define GUEST_TIMEOUT (uint16)2000
+#define ADMIN_TIMEOUT (uint32)30000
+#define GUEST_TIMEOUT (uint32)20000
+#define SESSION_TIMEOUT_NOTICE_TIME 1000
 /*****************************************************************************************/
 
 /****************************   Show menu codes
  * *****************************************/
-#define MAIN_MENU (uint8)1
+/* Screen codes index the flash-resident screen table in menu_screens.c */
+#define MAIN_MENU (uint8)0
+#define GUEST_MAIN_MENU (uint8)1
 #define LIGHT_CONTROL_MENU (uint8)2
 #define ROOM1_MENU (uint8)3
 #define ROOM2_MENU (uint8)4
@@ -90,10 +113,11 @@
 #define TV_MENU (uint8)7
 #define AIRCONDITIONING_MENU (uint8)8
 #define AIRCOND_CTRL_MENU (uint8)9
-#define TEMPERATURE_MENU (uint8)10
-#define PASSWORD_MENU (uint8)11
-#define CHNG_ADMIN_PASS_MENU (uint8)12
-#define CHNG_GUEST_PASS_MENU (uint8)13
+#define PASSWORD_MENU (uint8)10
+#define SMART_MENU (uint8)11
+#define BLOWER_MENU (uint8)12
+#define DASHBOARD_MENU (uint8)13
+#define MENU_COUNT (uint8)14
 /*****************************************************************************************/
 
 /*******************************************************************************
@@ -105,5 +129,6 @@ void setAdminPassword(void);
 void setGestPassword(void);
 void AdiminLogin(void);
 void GistLogin(void);
+void endSession(void);
 
 #endif /* APP_MAIN_CONFIG_H_ */
\ No newline at end of file
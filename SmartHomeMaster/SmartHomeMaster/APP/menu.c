@@ -9,10 +9,17 @@
  *                             Includes                                 *
  *******************************************************************************/
 #include "menu.h"
+#include "../HAL/Buzzer/buzzer.h"
+#include "../MCAL/Trace/trace.h"
+#include "background.h"
 
-extern volatile uint16 session_counter;
 extern uint8 timeout_flag;
 
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint32 session_last_activity = 0; /* ms timestamp of the last key */
+
 /*******************************************************************************
  *                        Functions Definitions                         *
  *******************************************************************************/
@@ -37,85 +44,162 @@ uint8 ui8ComparePass(const uint8 *pass1, const uint8 *pass2, const uint8 size) {
 }
 
 /**
- * @brief  Handle Menu Options for Rooms
- * @param  u8SelectedRoom Selected Room ID
+ * @brief  Run the hotkey bound to a key, if the role may use it
+ * @param  key_pressed Key to look up
  * @param  u8LoginMode Login Mode (Admin/Guest)
- * @return Void
+ * @return TRUE if a hotkey handled the key, FALSE otherwise
+ */
+static uint8 u8MenuRunHotkey(uint8 key_pressed, const uint8 u8LoginMode) {
+  const MenuHotkey_t *pstHotkey = astMenuHotkeys;
+  MenuAction_t pfAction;
+  uint8 u8Count = MENU_HOTKEY_COUNT;
+
+  while ((u8Count > 0) && (pgm_read_byte(&pstHotkey->u8Key) != key_pressed)) {
+    pstHotkey++;
+    u8Count--;
+  }
+  if ((u8Count == 0) || ((pgm_read_byte(&pstHotkey->u8RoleMask) &
+                          MENU_ROLE(u8LoginMode)) == 0)) {
+    return FALSE;
+  }
+
+  pfAction = (MenuAction_t)pgm_read_ptr(&pstHotkey->pfAction);
+  LCD_clearscreen();
+  pfAction(pgm_read_byte(&pstHotkey->u8Arg)); /* prints its own result */
+  _delay_ms(MENU_HOTKEY_NOTICE_TIME);
+  return TRUE;
+}
+
+/**
+ * @brief  Draw a screen, wait for a key and run its binding
+ * @param  u8Screen Screen code to show
+ * @param  u8LoginMode Login Mode (Admin/Guest)
+ * @return Screen code to show next
  */
-void vMenuOption(const uint8 u8SelectedRoom, const uint8 u8LoginMode) {
-  uint8 u8StatusCode = 0;
-  uint8 u8TurnOnCode = 0;
-  uint8 u8TurnOffCode = 0;
-  uint8 response = DEFAULT_ACK;
+uint8 u8MenuRun(uint8 u8Screen, const uint8 u8LoginMode) {
+  const MenuScreen_t *pstScreen = &astMenuScreens[u8Screen];
+  const MenuKey_t *pstKey;
+  MenuRefresh_t pfRefresh;
+  MenuAction_t pfAction;
+  const char *pcNotice;
+  uint8 u8Flags;
+  uint8 u8KeyCount;
   uint8 key_pressed = NOT_PRESSED;
 
-  do {
-    LCD_clearscreen();
-    switch (u8SelectedRoom) {
-    case ROOM1_MENU:
-      u8StatusCode = ROOM1_STATUS;
-      u8TurnOnCode = ROOM1_TURN_ON;
-      u8TurnOffCode = ROOM1_TURN_OFF;
-      LCD_vSend_string("Room1 S:");
-      break;
-    case ROOM2_MENU:
-      u8StatusCode = ROOM2_STATUS;
-      u8TurnOnCode = ROOM2_TURN_ON;
-      u8TurnOffCode = ROOM2_TURN_OFF;
-      LCD_vSend_string("Room2 S:");
-      break;
-    case ROOM3_MENU:
-      u8StatusCode = ROOM3_STATUS;
-      u8TurnOnCode = ROOM3_TURN_ON;
-      u8TurnOffCode = ROOM3_TURN_OFF;
-      LCD_vSend_string("Room3 S:");
-      break;
-    case ROOM4_MENU:
-      u8StatusCode = ROOM4_STATUS;
-      u8TurnOnCode = ROOM4_TURN_ON;
-      u8TurnOffCode = ROOM4_TURN_OFF;
-      LCD_vSend_string("Room4 S:");
-      break;
-    case TV_MENU:
-      u8StatusCode = TV_STATUS;
-      u8TurnOnCode = TV_TURN_ON;
-      u8TurnOffCode = TV_TURN_OFF;
-      LCD_vSend_string("TV S:");
-      break;
-    case AIRCOND_CTRL_MENU:
-      u8StatusCode = AIR_COND_STATUS;
-      u8TurnOnCode = AIR_COND_TURN_ON;
-      u8TurnOffCode = AIR_COND_TURN_OFF;
-      LCD_vSend_string("Air Cond. S:");
-      break;
-    }
+  /* Roles without access see the fallback screen instead */
+  if ((pgm_read_byte(&pstScreen->u8RoleMask) & MENU_ROLE(u8LoginMode)) == 0) {
+    u8Screen = pgm_read_byte(&pstScreen->u8Fallback);
+    pstScreen = &astMenuScreens[u8Screen];
+  }
 
-    SPI_ui8TransmitRecive(u8StatusCode);
-    _delay_ms(100);
-    response = SPI_ui8TransmitRecive(DEMAND_RESPONSE);
-    if (response == ON_STATUS) {
-      LCD_vSend_string("ON");
-    } else {
-      LCD_vSend_string("OFF");
-    }
+  u8Flags = pgm_read_byte(&pstScreen->u8Flags);
+  pfRefresh = (MenuRefresh_t)pgm_read_ptr(&pstScreen->pfRefresh);
+  if ((u8Flags & MENU_FLAG_POLLED) == 0) {
+    u8Flags |= MENU_FLAG_LIVE; /* blocking screens draw once, up front */
+  }
 
-    LCD_movecursor(2, 1);
-    LCD_vSend_string("1-On 2-Off 0-RET");
+  LCD_clearscreen();
+  LCD_vSend_string_P(pstScreen->acLine1);
+  if ((u8Flags & MENU_FLAG_LIVE) && (pfRefresh != NULL)) {
+    key_pressed = pfRefresh(pgm_read_byte(&pstScreen->u8RefreshArg));
+  }
+  LCD_vWriteAt_P(2, 1, pstScreen->acLine2);
 
+  if (u8Flags & MENU_FLAG_POLLED) {
+    key_pressed = u8MenuPollKey();
+    if (u8MenuSessionExpired(u8LoginMode) == TRUE) {
+      return u8Screen;
+    }
+    if ((key_pressed == NOT_PRESSED) && ((u8Flags & MENU_FLAG_LIVE) == 0) &&
+        (pfRefresh != NULL)) {
+      key_pressed = pfRefresh(pgm_read_byte(&pstScreen->u8RefreshArg));
+    }
+  } else if (key_pressed == NOT_PRESSED) {
     key_pressed = u8GetKeyPressed(u8LoginMode);
-    _delay_ms(100);
-
-    if (key_pressed == '1') {
-      SPI_ui8TransmitRecive(u8TurnOnCode);
-    } else if (key_pressed == '2') {
-      SPI_ui8TransmitRecive(u8TurnOffCode);
-    } else if ((key_pressed != NOT_PRESSED) && (key_pressed != '0')) {
-      LCD_clearscreen();
-      LCD_vSend_string("Wrong input");
-      _delay_ms(500);
+  }
+
+  if (key_pressed == NOT_PRESSED) {
+    return u8Screen; /* idle window or session timeout: redraw */
+  }
+  buzzer_click();
+  keypad_vWaitRelease();
+
+  if ((u8Flags & MENU_FLAG_HOTKEYS) &&
+      (u8MenuRunHotkey(key_pressed, u8LoginMode) == TRUE)) {
+    return u8Screen;
+  }
+
+  /* One table lookup resolves the key */
+  pstKey = (const MenuKey_t *)pgm_read_ptr(&pstScreen->pstKeys);
+  u8KeyCount = pgm_read_byte(&pstScreen->u8KeyCount);
+  while ((u8KeyCount > 0) && (pgm_read_byte(&pstKey->u8Key) != key_pressed)) {
+    pstKey++;
+    u8KeyCount--;
+  }
+
+  if (u8KeyCount == 0) {
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Wrong input"));
+    _delay_ms(MENU_NOTICE_TIME);
+    return u8Screen;
+  }
+
+  pcNotice = (const char *)pgm_read_ptr(&pstKey->pcNotice);
+  pfAction = (MenuAction_t)pgm_read_ptr(&pstKey->pfAction);
+  if (pcNotice != NULL) {
+    LCD_clearscreen();
+    LCD_vSend_string_P(pcNotice);
+  }
+  if (pfAction != NULL) {
+    pfAction(pgm_read_byte(&pstKey->u8Arg));
+  }
+  if (pcNotice != NULL) {
+    _delay_ms(MENU_NOTICE_TIME);
+  }
+  return pgm_read_byte(&pstKey->u8Target);
+}
+
+/**
+ * @brief  Scan the keypad during a short window
+ * @return Key Pressed or NOT_PRESSED
+ */
+uint8 u8MenuPollKey(void) {
+  uint8 key_pressed = NOT_PRESSED;
+  uint8 k;
+  for (k = 0; k < MENU_POLL_TICKS; k++) {
+    key_pressed = keypad_u8check_press();
+    if (key_pressed != NOT_PRESSED) {
+      session_last_activity = SYSTICK_u32GetMillis();
+      break;
     }
-  } while (((key_pressed < '0') || (key_pressed > '2')) &&
-           (timeout_flag == FALSE));
+    vBackgroundRun();
+    _delay_ms(MENU_POLL_STEP_TIME);
+  }
+  return key_pressed;
+}
+
+/**
+ * @brief  Restart the inactivity timer of the session
+ * @return Void
+ */
+void vMenuSessionStart(void) {
+  session_last_activity = SYSTICK_u32GetMillis();
+  timeout_flag = FALSE;
+}
+
+/**
+ * @brief  Check the inactivity timer of the logged in role
+ * @param  u8LoginMode Login Mode (Admin/Guest)
+ * @return TRUE (and timeout_flag set) when the session expired
+ */
+uint8 u8MenuSessionExpired(const uint8 u8LoginMode) {
+  uint32 u32Timeout = (u8LoginMode == ADMIN) ? ADMIN_TIMEOUT : GUEST_TIMEOUT;
+  if ((timeout_flag == FALSE) &&
+      SYSTICK_u8HasElapsed(session_last_activity, u32Timeout)) {
+    TRACE_EMIT(TRACE_TIMEOUT, TRACE_TIMEOUT_SESSION, u8LoginMode);
+    timeout_flag = TRUE;
+  }
+  return timeout_flag;
 }
 
 /**
@@ -126,15 +210,16 @@ void vMenuOption(const uint8 u8SelectedRoom, const uint8 u8LoginMode) {
 uint8 u8GetKeyPressed(const uint8 u8LoginMode) {
   uint8 key_pressed = NOT_PRESSED;
   while (key_pressed == NOT_PRESSED) {
-    if ((session_counter >= ADMIN_TIMEOUT && u8LoginMode == ADMIN) ||
-        (session_counter >= GUEST_TIMEOUT &&
-         u8LoginMode == GUEST)) // check for timeout
+    if (u8MenuSessionExpired(u8LoginMode) == TRUE) // check for timeout
     {
-      timeout_flag = TRUE;
       break;
     }
 
+    vBackgroundRun();
     key_pressed = keypad_u8check_press();
   }
+  if (key_pressed != NOT_PRESSED) {
+    session_last_activity = SYSTICK_u32GetMillis();
+  }
   return key_pressed;
 }
\ No newline at end of file
@@ -16,7 +16,93 @@
 #include "../LIB/STD_MESSAGES.h"
 #include "../LIB/STD_Types.h"
 #include "../MCAL/SPI/SPI.h"
+#include "../MCAL/Timer/systick.h"
 #include "main_config.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define MENU_LINE_SIZE (uint8)17 /* 16 LCD columns + terminator */
+
+/* Role masks, one bit per login mode */
+#define MENU_ROLE(mode) (uint8)(1 << (mode))
+#define MENU_ROLE_ADMIN MENU_ROLE(ADMIN)
+#define MENU_ROLE_GUEST MENU_ROLE(GUEST)
+#define MENU_ROLE_ANY (uint8)(MENU_ROLE_ADMIN | MENU_ROLE_GUEST)
+
+/* Screen flags */
+#define MENU_FLAG_NONE (uint8)0x00
+#define MENU_FLAG_POLLED (uint8)0x01 /* timed key window, redraw on idle */
+#define MENU_FLAG_LIVE (uint8)0x02   /* refresh on every draw, not on idle */
+#define MENU_FLAG_HOTKEYS (uint8)0x04 /* global hotkeys checked first */
+
+#define MENU_POLL_TICKS (uint8)50
+#define MENU_POLL_STEP_TIME 10
+#define MENU_NOTICE_TIME 500
+#define MENU_HOTKEY_NOTICE_TIME 300
+
+/* Expands to the table pointer and entry count of a key table */
+#define MENU_KEYS(table) (table), (uint8)(sizeof(table) / sizeof((table)[0]))
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  Refresh callback of a screen
+ * @note   Blocking and live screens call it right after line 1 is drawn so
+ *         it can complete the display. Other polled screens call it when the
+ *         key window expired without a key. A returned key is handled like a
+ *         pressed one.
+ */
+typedef uint8 (*MenuRefresh_t)(uint8 u8Arg);
+
+/**
+ * @brief  Action bound to a key, runs before moving to the target screen
+ */
+typedef void (*MenuAction_t)(uint8 u8Arg);
+
+/**
+ * @brief  One key binding of a screen (flash resident)
+ */
+typedef struct {
+  uint8 u8Key;           /* Keypad symbol */
+  uint8 u8Target;        /* Screen shown after the key is handled */
+  MenuAction_t pfAction; /* Optional action, NULL for plain navigation */
+  uint8 u8Arg;           /* Argument passed to the action */
+  const char *pcNotice;  /* Optional flash string shown while acting */
+} MenuKey_t;
+
+/**
+ * @brief  One-key shortcut, runs an action without leaving the screen
+ */
+typedef struct {
+  uint8 u8Key;           /* Keypad symbol */
+  uint8 u8RoleMask;      /* Roles allowed to use it */
+  MenuAction_t pfAction; /* Device toggle or scene */
+  uint8 u8Arg;           /* Argument passed to the action */
+} MenuHotkey_t;
+
+/**
+ * @brief  One screen of the master UI (flash resident)
+ */
+typedef struct {
+  char acLine1[MENU_LINE_SIZE];
+  char acLine2[MENU_LINE_SIZE];
+  const MenuKey_t *pstKeys;
+  uint8 u8KeyCount;
+  uint8 u8RoleMask; /* Roles allowed to open the screen */
+  uint8 u8Fallback; /* Screen shown instead for other roles */
+  uint8 u8Flags;
+  MenuRefresh_t pfRefresh;
+  uint8 u8RefreshArg;
+} MenuScreen_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+extern const MenuScreen_t astMenuScreens[MENU_COUNT] PROGMEM;
+extern const MenuHotkey_t astMenuHotkeys[MENU_HOTKEY_COUNT] PROGMEM;
 
 /*******************************************************************************
  *                    Software Interfaces Declarations                  *
@@ -31,12 +117,31 @@
 uint8 ui8ComparePass(const uint8 *pass1, const uint8 *pass2, const uint8 size);
 
 /**
- * @brief  Handle Menu Options for Rooms
- * @param  u8SelectedRoom Selected Room ID
+ * @brief  Draw a screen, wait for a key and run its binding
+ * @param  u8Screen Screen code to show
  * @param  u8LoginMode Login Mode (Admin/Guest)
+ * @return Screen code to show next
+ */
+uint8 u8MenuRun(uint8 u8Screen, const uint8 u8LoginMode);
+
+/**
+ * @brief  Scan the keypad during a short window
+ * @return Key Pressed or NOT_PRESSED
+ */
+uint8 u8MenuPollKey(void);
+
+/**
+ * @brief  Restart the inactivity timer of the session
  * @return Void
  */
-void vMenuOption(const uint8 u8SelectedRoom, const uint8 u8LoginMode);
+void vMenuSessionStart(void);
+
+/**
+ * @brief  Check the inactivity timer of the logged in role
+ * @param  u8LoginMode Login Mode (Admin/Guest)
+ * @return TRUE (and timeout_flag set) when the session expired
+ */
+uint8 u8MenuSessionExpired(const uint8 u8LoginMode);
 
 /**
  * @brief  Get Key Pressed with Timeout
@@ -0,0 +1,510 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: menu_screens.c
+ * Description: Flash resident screen table and actions of the master UI
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../HAL/Buzzer/buzzer.h"
+#include "../HAL/LED/LED.h"
+#include "../MCAL/Trace/trace.h"
+#include "console.h"
+#include "menu.h"
+#include "shadow.h"
+#include "settings.h"
+#include "telemetry.h"
+
+extern uint8 login_mode;
+extern uint8 timeout_flag;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* --- GLOBAL SMART VARIABLES --- */
+uint8 smart_mode_active = FALSE;
+uint8 night_handled = FALSE;
+
+/*******************************************************************************
+ *                        Function Prototypes                           *
+ *******************************************************************************/
+static void vMenuSendCommand(uint8 u8Command);
+static void vMenuLogout(uint8 u8Arg);
+static void vMenuSetSmart(uint8 u8State);
+static void vMenuChangePass(uint8 u8Mode);
+static void vMenuSetTemperature(uint8 u8Arg);
+static uint8 u8MenuShowStatus(uint8 u8StatusCode);
+static uint8 u8MenuShowSmart(uint8 u8Arg);
+static uint8 u8MenuSmartIdle(uint8 u8Arg);
+static uint8 u8MenuShowClimate(uint8 u8Arg);
+static void vMenuToggleDevice(uint8 u8StatusCode);
+static void vMenuLightsScene(uint8 u8BaseCommand);
+
+/*******************************************************************************
+ *                           Flash Tables                               *
+ *******************************************************************************/
+static const char sShutdown[] PROGMEM = "Shutting Down...";
+static const char sBlowerOn[] PROGMEM = "Blower ON";
+static const char sBlowerOff[] PROGMEM = "Blower OFF";
+static const char sSmartOn[] PROGMEM = "Smart Enabled";
+static const char sSmartOff[] PROGMEM = "Smart Disabled";
+static const char sAcOn[] PROGMEM = "AC Enabled";
+static const char sAcOff[] PROGMEM = "AC Disabled";
+
+/* Device names, indexed by status code - ROOM1_STATUS */
+static const char sRoom1[] PROGMEM = "Room1";
+static const char sRoom2[] PROGMEM = "Room2";
+static const char sRoom3[] PROGMEM = "Room3";
+static const char sRoom4[] PROGMEM = "Room4";
+static const char sTv[] PROGMEM = "TV";
+static const char sAc[] PROGMEM = "AC";
+static const char *const apcDeviceNames[] PROGMEM = {sRoom1, sRoom2, sRoom3,
+                                                     sRoom4, sTv,    sAc};
+
+const MenuHotkey_t astMenuHotkeys[MENU_HOTKEY_COUNT] PROGMEM = {
+    {HOTKEY_ROOM1, MENU_ROLE_ANY, vMenuToggleDevice, ROOM1_STATUS},
+    {HOTKEY_ROOM2, MENU_ROLE_ANY, vMenuToggleDevice, ROOM2_STATUS},
+    {HOTKEY_ROOM3, MENU_ROLE_ANY, vMenuToggleDevice, ROOM3_STATUS},
+    {HOTKEY_ROOM4, MENU_ROLE_ANY, vMenuToggleDevice, ROOM4_STATUS},
+    {HOTKEY_TV, MENU_ROLE_ADMIN, vMenuToggleDevice, TV_STATUS},
+    {HOTKEY_ALL_OFF, MENU_ROLE_ANY, vMenuLightsScene, ROOM1_TURN_OFF}};
+
+/* Commands sent on logout, in order */
+static const uint8 au8ShutdownCmds[] PROGMEM = {
+    ROOM1_TURN_OFF, ROOM2_TURN_OFF,    ROOM3_TURN_OFF, ROOM4_TURN_OFF,
+    TV_TURN_OFF,    AIR_COND_TURN_OFF, BLOWER_TURN_OFF};
+
+static const MenuKey_t astMainKeys[] PROGMEM = {
+    {SELECT_LIGHT_CONTROL, LIGHT_CONTROL_MENU, NULL, 0, NULL},
+    {SELECT_PASSWORD, PASSWORD_MENU, NULL, 0, NULL},
+    {SELECT_AIR_CONDITIONING, AIRCONDITIONING_MENU, NULL, 0, NULL},
+    {SELECT_TV, TV_MENU, NULL, 0, NULL},
+    {SELECT_BLOWER, BLOWER_MENU, NULL, 0, NULL},
+    {SELECT_DASHBOARD, DASHBOARD_MENU, NULL, 0, NULL},
+    {SELECT_LOGOUT, MAIN_MENU, vMenuLogout, 0, sShutdown}};
+
+static const MenuKey_t astGuestMainKeys[] PROGMEM = {
+    {SELECT_LIGHT_CONTROL, LIGHT_CONTROL_MENU, NULL, 0, NULL},
+    {SELECT_DASHBOARD, DASHBOARD_MENU, NULL, 0, NULL},
+    {SELECT_LOGOUT, MAIN_MENU, vMenuLogout, 0, sShutdown}};
+
+static const MenuKey_t astLightKeys[] PROGMEM = {
+    {SELECT_ROOM1, ROOM1_MENU, NULL, 0, NULL},
+    {SELECT_ROOM2, ROOM2_MENU, NULL, 0, NULL},
+    {SELECT_ROOM3, ROOM3_MENU, NULL, 0, NULL},
+    {SELECT_ROOM4, ROOM4_MENU, NULL, 0, NULL},
+    {SELECT_SMART_MODE, SMART_MENU, NULL, 0, NULL},
+    {SELECT_RETURN, MAIN_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astSmartKeys[] PROGMEM = {
+    {SELECT_TURN_ON, MAIN_MENU, vMenuSetSmart, TRUE, sSmartOn},
+    {SELECT_TURN_OFF, SMART_MENU, vMenuSetSmart, FALSE, sSmartOff},
+    {SELECT_RETURN, LIGHT_CONTROL_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astRoom1Keys[] PROGMEM = {
+    {SELECT_TURN_ON, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM1_TURN_ON, NULL},
+    {SELECT_TURN_OFF, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM1_TURN_OFF,
+     NULL},
+    {SELECT_RETURN, LIGHT_CONTROL_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astRoom2Keys[] PROGMEM = {
+    {SELECT_TURN_ON, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM2_TURN_ON, NULL},
+    {SELECT_TURN_OFF, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM2_TURN_OFF,
+     NULL},
+    {SELECT_RETURN, LIGHT_CONTROL_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astRoom3Keys[] PROGMEM = {
+    {SELECT_TURN_ON, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM3_TURN_ON, NULL},
+    {SELECT_TURN_OFF, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM3_TURN_OFF,
+     NULL},
+    {SELECT_RETURN, LIGHT_CONTROL_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astRoom4Keys[] PROGMEM = {
+    {SELECT_TURN_ON, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM4_TURN_ON, NULL},
+    {SELECT_TURN_OFF, LIGHT_CONTROL_MENU, vMenuSendCommand, ROOM4_TURN_OFF,
+     NULL},
+    {SELECT_RETURN, LIGHT_CONTROL_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astTvKeys[] PROGMEM = {
+    {SELECT_TURN_ON, MAIN_MENU, vMenuSendCommand, TV_TURN_ON, NULL},
+    {SELECT_TURN_OFF, MAIN_MENU, vMenuSendCommand, TV_TURN_OFF, NULL},
+    {SELECT_RETURN, MAIN_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astPasswordKeys[] PROGMEM = {
+    {SELECT_CHNG_ADMIN_PASS, MAIN_MENU, vMenuChangePass, ADMIN, NULL},
+    {SELECT_CHNG_GUEST_PASS, MAIN_MENU, vMenuChangePass, GUEST, NULL},
+    {SELECT_PASS_RET, MAIN_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astAirCondKeys[] PROGMEM = {
+    {SELECT_SET_TEMPERATURE, AIRCONDITIONING_MENU, vMenuSetTemperature, 0,
+     NULL},
+    {SELECT_AIR_COND_CTRL, AIRCOND_CTRL_MENU, NULL, 0, NULL},
+    {SELECT_AIR_COND_RET, MAIN_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astAirCondCtrlKeys[] PROGMEM = {
+    {SELECT_TURN_ON, AIRCONDITIONING_MENU, vMenuSendCommand, AIR_COND_TURN_ON,
+     sAcOn},
+    {SELECT_TURN_OFF, AIRCONDITIONING_MENU, vMenuSendCommand,
+     AIR_COND_TURN_OFF, sAcOff},
+    {SELECT_RETURN, AIRCONDITIONING_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astBlowerKeys[] PROGMEM = {
+    {SELECT_TURN_ON, MAIN_MENU, vMenuSendCommand, BLOWER_TURN_ON, sBlowerOn},
+    {SELECT_TURN_OFF, MAIN_MENU, vMenuSendCommand, BLOWER_TURN_OFF,
+     sBlowerOff},
+    {SELECT_RETURN, MAIN_MENU, NULL, 0, NULL}};
+
+static const MenuKey_t astDashboardKeys[] PROGMEM = {
+    {SELECT_RETURN, MAIN_MENU, NULL, 0, NULL}};
+
+const MenuScreen_t astMenuScreens[MENU_COUNT] PROGMEM = {
+    [MAIN_MENU] = {"1Lg 2Pas 3AC 4TV", "5Blow 6Dash 0Out",
+                   MENU_KEYS(astMainKeys), MENU_ROLE_ADMIN, GUEST_MAIN_MENU,
+                   MENU_FLAG_POLLED | MENU_FLAG_HOTKEYS, u8MenuSmartIdle, 0},
+    [GUEST_MAIN_MENU] = {"1:Lght 0:Out", "6:Dash",
+                         MENU_KEYS(astGuestMainKeys), MENU_ROLE_GUEST,
+                         MAIN_MENU, MENU_FLAG_POLLED | MENU_FLAG_HOTKEYS,
+                         u8MenuSmartIdle, 0},
+    [LIGHT_CONTROL_MENU] = {"1:R1 2:R2 3:R3", "4:R4 5:Smt 0:Ret",
+                            MENU_KEYS(astLightKeys), MENU_ROLE_ANY, MAIN_MENU,
+                            MENU_FLAG_NONE, NULL, 0},
+    [ROOM1_MENU] = {"Room1 S:", "1-On 2-Off 0-RET", MENU_KEYS(astRoom1Keys),
+                    MENU_ROLE_ANY, MAIN_MENU, MENU_FLAG_NONE, u8MenuShowStatus,
+                    ROOM1_STATUS},
+    [ROOM2_MENU] = {"Room2 S:", "1-On 2-Off 0-RET", MENU_KEYS(astRoom2Keys),
+                    MENU_ROLE_ANY, MAIN_MENU, MENU_FLAG_NONE, u8MenuShowStatus,
+                    ROOM2_STATUS},
+    [ROOM3_MENU] = {"Room3 S:", "1-On 2-Off 0-RET", MENU_KEYS(astRoom3Keys),
+                    MENU_ROLE_ANY, MAIN_MENU, MENU_FLAG_NONE, u8MenuShowStatus,
+                    ROOM3_STATUS},
+    [ROOM4_MENU] = {"Room4 S:", "1-On 2-Off 0-RET", MENU_KEYS(astRoom4Keys),
+                    MENU_ROLE_ANY, MAIN_MENU, MENU_FLAG_NONE, u8MenuShowStatus,
+                    ROOM4_STATUS},
+    [TV_MENU] = {"TV S:", "1-On 2-Off 0-RET", MENU_KEYS(astTvKeys),
+                 MENU_ROLE_ADMIN, MAIN_MENU, MENU_FLAG_NONE, u8MenuShowStatus,
+                 TV_STATUS},
+    [AIRCONDITIONING_MENU] = {"1:Set Temp", "2:Ctrl 0:Ret",
+                              MENU_KEYS(astAirCondKeys), MENU_ROLE_ADMIN,
+                              MAIN_MENU, MENU_FLAG_NONE, NULL, 0},
+    [AIRCOND_CTRL_MENU] = {"AC Control", "1:ON 2:OFF 0:Ret",
+                           MENU_KEYS(astAirCondCtrlKeys), MENU_ROLE_ADMIN,
+                           MAIN_MENU, MENU_FLAG_NONE, NULL, 0},
+    [PASSWORD_MENU] = {"1:Admin 2:Guest", "0:Ret", MENU_KEYS(astPasswordKeys),
+                       MENU_ROLE_ADMIN, MAIN_MENU, MENU_FLAG_NONE, NULL, 0},
+    [SMART_MENU] = {"Smart Mode: ", "1:On 2:Off 0:Ret", MENU_KEYS(astSmartKeys),
+                    MENU_ROLE_ANY, MAIN_MENU, MENU_FLAG_NONE, u8MenuShowSmart,
+                    0},
+    [BLOWER_MENU] = {"Blower Control", "1:ON 2:OFF 0:Ret",
+                     MENU_KEYS(astBlowerKeys), MENU_ROLE_ADMIN, MAIN_MENU,
+                     MENU_FLAG_NONE, NULL, 0},
+    [DASHBOARD_MENU] = {"", "", MENU_KEYS(astDashboardKeys), MENU_ROLE_ANY,
+                        MAIN_MENU, MENU_FLAG_POLLED | MENU_FLAG_LIVE,
+                        u8MenuShowClimate, 0}};
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Send a single command byte to the slave
+ * @param  u8Command Command code
+ * @return Void
+ */
+static void vMenuSendCommand(uint8 u8Command) { vShadowSendCommand(u8Command); }
+
+/**
+ * @brief  Hotkey action, flips a device using its shadow state
+ * @param  u8StatusCode Status command of the device
+ * @return Void
+ */
+static void vMenuToggleDevice(uint8 u8StatusCode) {
+  uint8 u8Index = u8StatusCode - ROOM1_STATUS;
+  uint8 u8On = (u8ShadowGetStatus(u8StatusCode) == ON_STATUS) ? FALSE : TRUE;
+
+  vShadowSendCommand((u8On ? ROOM1_TURN_ON : ROOM1_TURN_OFF) + u8Index);
+  LCD_vSend_string_P((const char *)pgm_read_ptr(&apcDeviceNames[u8Index]));
+  LCD_vSend_string_P(u8On ? PSTR(" ON") : PSTR(" OFF"));
+}
+
+/**
+ * @brief  Hotkey action, sends the same command to the four rooms
+ * @param  u8BaseCommand ROOM1_TURN_ON or ROOM1_TURN_OFF
+ * @return Void
+ */
+static void vMenuLightsScene(uint8 u8BaseCommand) {
+  uint8 u8Room;
+  for (u8Room = 0; u8Room < 4; u8Room++) {
+    vShadowSendCommand(u8BaseCommand + u8Room);
+    _delay_ms(10);
+  }
+  LCD_vSend_string_P(u8BaseCommand == ROOM1_TURN_ON ? PSTR("All lights ON")
+                                                    : PSTR("All lights OFF"));
+}
+
+/**
+ * @brief  Switch every device off and end the session
+ * @param  u8Arg Unused
+ * @return Void
+ */
+static void vMenuLogout(uint8 u8Arg) {
+  uint8 u8Index;
+  (void)u8Arg;
+  for (u8Index = 0; u8Index < sizeof(au8ShutdownCmds); u8Index++) {
+    vShadowSendCommand(pgm_read_byte(&au8ShutdownCmds[u8Index]));
+    _delay_ms(10);
+  }
+  LED_vTurnOff(GUEST_LED_PORT, GUEST_LED_PIN);
+  LED_vTurnOff(ADMIN_LED_PORT, ADMIN_LED_PIN);
+
+  smart_mode_active = FALSE;
+  vSettingsSave();
+  login_mode = NO_MODE;
+}
+
+/**
+ * @brief  Enable or disable smart mode
+ * @param  u8State TRUE or FALSE
+ * @return Void
+ */
+static void vMenuSetSmart(uint8 u8State) {
+  smart_mode_active = u8State;
+  vSettingsSave();
+}
+
+/**
+ * @brief  Run the password change dialog of a role
+ * @param  u8Mode ADMIN or GUEST
+ * @return Void
+ */
+static void vMenuChangePass(uint8 u8Mode) {
+  LCD_clearscreen();
+  if (u8Mode == ADMIN) {
+    setAdminPassword();
+  } else {
+    setGestPassword();
+  }
+  vSettingsSave();
+}
+
+/**
+ * @brief  Read one digit for the temperature dialog
+ * @return Digit key or NOT_PRESSED on wrong input
+ */
+static uint8 u8MenuReadDigit(void) {
+  uint8 key_pressed = u8GetKeyPressed(login_mode);
+  if (key_pressed != NOT_PRESSED) {
+    buzzer_click();
+    keypad_vWaitRelease();
+  } else {
+    _delay_ms(250);
+  }
+  if (key_pressed < '0' || key_pressed > '9') {
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Wrong input"));
+    _delay_ms(MENU_NOTICE_TIME);
+    return NOT_PRESSED;
+  }
+  LCD_vSend_char(key_pressed);
+  return key_pressed;
+}
+
+/**
+ * @brief  Two digit set point dialog, sends SET_TEMPERATURE
+ * @param  u8Arg Unused
+ * @return Void
+ */
+static void vMenuSetTemperature(uint8 u8Arg) {
+  uint8 temperature = 0;
+  uint8 temp_tens;
+  uint8 temp_ones;
+  (void)u8Arg;
+
+  while ((temperature == 0) && (timeout_flag == FALSE)) {
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Set temp.:__ "));
+    LCD_vSend_char(DEGREES_SYMBOL);
+    LCD_vSend_char('C');
+    LCD_movecursor(1, 11);
+    _delay_ms(200);
+
+    temp_tens = u8MenuReadDigit();
+    if (temp_tens == NOT_PRESSED) {
+      continue;
+    }
+    temp_ones = u8MenuReadDigit();
+    if (temp_ones == NOT_PRESSED) {
+      continue;
+    }
+
+    temperature = (temp_tens - ASCII_ZERO) * 10 + (temp_ones - ASCII_ZERO);
+    CONSOLE_WAIT_LINK();
+    SPI_ui8TransmitRecive(SET_TEMPERATURE);
+    _delay_ms(SET_TEMPERATURE_DELAY);
+    SPI_ui8TransmitRecive(temperature);
+    TRACE_EMIT(TRACE_LINK_TX, SET_TEMPERATURE, temperature);
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Temperature Sent"));
+    _delay_ms(MENU_NOTICE_TIME);
+  }
+}
+
+/**
+ * @brief  Print a device status from the shadow table
+ * @param  u8StatusCode Status command of the device
+ * @return NOT_PRESSED
+ */
+static uint8 u8MenuShowStatus(uint8 u8StatusCode) {
+  if (u8ShadowGetStatus(u8StatusCode) == ON_STATUS) {
+    LCD_vSend_string_P(PSTR("ON"));
+  } else {
+    LCD_vSend_string_P(PSTR("OFF"));
+  }
+  return NOT_PRESSED;
+}
+
+/**
+ * @brief  Print the smart mode state
+ * @param  u8Arg Unused
+ * @return NOT_PRESSED
+ */
+static uint8 u8MenuShowSmart(uint8 u8Arg) {
+  (void)u8Arg;
+  LCD_vSend_string_P(smart_mode_active ? PSTR("ON") : PSTR("OFF"));
+  return NOT_PRESSED;
+}
+
+/**
+ * @brief  Main menu idle hook, runs the smart mode day/night logic
+ * @param  u8Arg Unused
+ * @return Key to handle on the main menu or NOT_PRESSED
+ */
+static uint8 u8MenuSmartIdle(uint8 u8Arg) {
+  const Telemetry_t *pstTelemetry = pstTelemetryGet();
+  uint8 key_pressed = NOT_PRESSED;
+  uint8 ldr_status;
+  uint8 u8Room;
+  (void)u8Arg;
+
+  if (smart_mode_active == FALSE) {
+    return NOT_PRESSED;
+  }
+
+  if ((pstTelemetry != NULL) && (u8TelemetryIsStale() == FALSE)) {
+    ldr_status = (pstTelemetry->u8Flags & TELEMETRY_FLAG_DAY) ? 1 : 0;
+  } else {
+    CONSOLE_WAIT_LINK();
+    SPI_ui8TransmitRecive(GET_LDR_STATUS);
+    _delay_ms(20);
+    ldr_status = SPI_ui8TransmitRecive(DEFAULT_ACK);
+    TRACE_EMIT(TRACE_LINK_TX, GET_LDR_STATUS, ldr_status);
+  }
+
+  if (ldr_status == 1) {
+    /* --- MORNING --- */
+    night_handled = FALSE; /* Reset flag */
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Status: Morning"));
+    LCD_vWriteAt_P(2, 1, PSTR("Lights OFF..."));
+
+    /* Auto OFF */
+    for (u8Room = 0; u8Room < 4; u8Room++) {
+      vShadowSendCommand(ROOM1_TURN_OFF + u8Room);
+      _delay_ms(5);
+    }
+    key_pressed = u8MenuPollKey();
+  } else if (night_handled == TRUE) {
+    /* ALREADY ANSWERED -> JUST SHOW STATUS */
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Status: Night"));
+    LCD_vWriteAt_P(2, 1, PSTR("Lights ON..."));
+    key_pressed = u8MenuPollKey();
+  } else {
+    /* --- NIGHT --- Ask Yes/No */
+    LCD_clearscreen();
+    LCD_vSend_string_P(PSTR("Night, Light ON?"));
+    LCD_vWriteAt_P(2, 1, PSTR("1:Yes 2:No"));
+
+    key_pressed = u8GetKeyPressed(login_mode);
+    if (key_pressed == '1') { // YES
+      buzzer_click();
+      keypad_vWaitRelease();
+      LCD_clearscreen();
+      LCD_vSend_string_P(PSTR("1:All 2:Select"));
+
+      key_pressed = NOT_PRESSED;
+      while ((key_pressed != '1') && (key_pressed != '2') &&
+             (timeout_flag == FALSE)) {
+        key_pressed = u8GetKeyPressed(login_mode);
+      }
+      night_handled = TRUE;
+
+      if (key_pressed == '1') {
+        buzzer_click();
+        keypad_vWaitRelease();
+        for (u8Room = 0; u8Room < 4; u8Room++) {
+          vShadowSendCommand(ROOM1_TURN_ON + u8Room);
+          _delay_ms(10);
+        }
+        LCD_clearscreen();
+        LCD_vSend_string_P(PSTR("All ROOMS' LIGHT"));
+        LCD_vWriteAt_P(2, 1, PSTR("     ARE ON     "));
+        _delay_ms(MENU_NOTICE_TIME);
+      } else if (key_pressed == '2') {
+        return SELECT_LIGHT_CONTROL; /* Go to manual select */
+      }
+    } else if (key_pressed == '2') { // NO
+      buzzer_click();
+      keypad_vWaitRelease();
+      night_handled = TRUE;
+    }
+    key_pressed = NOT_PRESSED; /* prompt answers are not navigation keys */
+  }
+  return key_pressed;
+}
+
+/**
+ * @brief  Draw the climate dashboard from the telemetry cache
+ * @note   Never waits on the link, the cache is refreshed in the background.
+ * @param  u8Arg Unused
+ * @return NOT_PRESSED
+ */
+static uint8 u8MenuShowClimate(uint8 u8Arg) {
+  const Telemetry_t *pstTelemetry = pstTelemetryGet();
+  uint8 u8Flags;
+  (void)u8Arg;
+
+  if (pstTelemetry == NULL) {
+    LCD_vSend_string_P(PSTR("No climate data"));
+    LCD_vWriteAt_P(2, 1, PSTR("0:Ret"));
+    return NOT_PRESSED;
+  }
+  u8Flags = pstTelemetry->u8Flags;
+
+  /* T:27'C Set:24'C (! when the cache is stale) */
+  LCD_vSend_string_P(PSTR("T:"));
+  LCD_vSend_number(pstTelemetry->u8Temperature);
+  LCD_vSend_char(DEGREES_SYMBOL);
+  LCD_vSend_string_P(PSTR("C Set:"));
+  LCD_vSend_number(pstTelemetry->u8SetPoint);
+  LCD_vSend_char(DEGREES_SYMBOL);
+  LCD_vSend_char('C');
+  if (u8TelemetryIsStale() == TRUE) {
+    LCD_vSend_char('!');
+  }
+
+  /* Fan:100% AC Day */
+  LCD_vWriteAt_P(2, 1, PSTR("Fan:"));
+  LCD_vSend_number(pstTelemetry->u8FanDuty);
+  LCD_vSend_string_P(PSTR("% "));
+  if (u8Flags & TELEMETRY_FLAG_AC) {
+    LCD_vSend_string_P(PSTR("AC "));
+  } else if (u8Flags & TELEMETRY_FLAG_HEATER) {
+    LCD_vSend_string_P(PSTR("HT "));
+  } else {
+    LCD_vSend_string_P(PSTR("-- "));
+  }
+  LCD_vSend_string_P((u8Flags & TELEMETRY_FLAG_DAY) ? PSTR("Day")
+                                                     : PSTR("Ngt"));
+  return NOT_PRESSED;
+}
\ No newline at end of file
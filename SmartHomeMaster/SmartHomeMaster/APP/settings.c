@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: settings.c
+ * Description: Source file for the persistent master settings
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "settings.h"
+#include "../HAL/NVM/nvm.h"
+
+extern uint8 Adminpass[PASS_SIZE];
+extern uint8 Gestpass[PASS_SIZE];
+extern uint8 smart_mode_active;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Restore passwords and smart mode from EEPROM
+ * @return TRUE if restored, FALSE on first boot (defaults are kept)
+ */
+uint8 u8SettingsLoad(void) {
+  Settings_t stSettings;
+  uint8 u8Index;
+
+  if (NVM_u8Load(SETTINGS_VERSION, &stSettings, sizeof(stSettings)) == 0) {
+    return FALSE;
+  }
+  for (u8Index = 0; u8Index < PASS_SIZE; u8Index++) {
+    Adminpass[u8Index] = stSettings.au8AdminPass[u8Index];
+    Gestpass[u8Index] = stSettings.au8GuestPass[u8Index];
+  }
+  smart_mode_active = (stSettings.u8SmartMode == TRUE) ? TRUE : FALSE;
+  return TRUE;
+}
+
+/**
+ * @brief  Save passwords and smart mode, written in the background
+ * @return Void
+ */
+void vSettingsSave(void) {
+  Settings_t stSettings;
+  uint8 u8Index;
+
+  for (u8Index = 0; u8Index < PASS_SIZE; u8Index++) {
+    stSettings.au8AdminPass[u8Index] = Adminpass[u8Index];
+    stSettings.au8GuestPass[u8Index] = Gestpass[u8Index];
+  }
+  stSettings.u8SmartMode = smart_mode_active;
+  (void)NVM_u8Save(SETTINGS_VERSION, &stSettings, sizeof(stSettings));
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: settings.h
+ * Description: Header file for the persistent master settings
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef APP_SETTINGS_H_
+#define APP_SETTINGS_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../LIB/STD_Types.h"
+#include "main_config.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SETTINGS_VERSION (uint8)1 /* bump when Settings_t changes */
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  Settings record kept in EEPROM
+ */
+typedef struct {
+  uint8 au8AdminPass[PASS_SIZE];
+  uint8 au8GuestPass[PASS_SIZE];
+  uint8 u8SmartMode;
+} Settings_t;
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Restore passwords and smart mode from EEPROM
+ * @return TRUE if restored, FALSE on first boot (defaults are kept)
+ */
+uint8 u8SettingsLoad(void);
+
+/**
+ * @brief  Save passwords and smart mode, written in the background
+ * @return Void
+ */
+void vSettingsSave(void);
+
+#endif /* APP_SETTINGS_H_ */
\ No newline at end of file
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: shadow.c
+ * Description: Source file for the master side shadow of slave device states
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "shadow.h"
+#include "../MCAL/SPI/SPI.h"
+#include "../MCAL/Trace/trace.h"
+#include "console.h"
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint8 shadow_state[SHADOW_DEVICES] = {
+    SHADOW_UNKNOWN, SHADOW_UNKNOWN, SHADOW_UNKNOWN,
+    SHADOW_UNKNOWN, SHADOW_UNKNOWN, SHADOW_UNKNOWN};
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Send a device command and record the state it sets
+ * @param  u8Command Command code (x_TURN_ON / x_TURN_OFF / others)
+ * @return Void
+ */
+void vShadowSendCommand(uint8 u8Command) {
+  CONSOLE_WAIT_LINK();
+  SPI_ui8TransmitRecive(u8Command);
+  TRACE_EMIT(TRACE_LINK_TX, u8Command, TRACE_NONE);
+
+  if (u8Command == AIR_COND_TURN_ON) {
+    /* Only enables the climate logic, the slave decides the AC output */
+    shadow_state[AIR_COND_STATUS - ROOM1_STATUS] = SHADOW_UNKNOWN;
+  } else if ((u8Command >= ROOM1_TURN_ON) && (u8Command <= TV_TURN_ON)) {
+    shadow_state[u8Command - ROOM1_TURN_ON] = ON_STATUS;
+  } else if ((u8Command >= ROOM1_TURN_OFF) &&
+             (u8Command <= AIR_COND_TURN_OFF)) {
+    shadow_state[u8Command - ROOM1_TURN_OFF] = OFF_STATUS;
+  }
+}
+
+/**
+ * @brief  State of a device, asks the slave only when the entry is stale
+ * @param  u8StatusCode Status command of the device
+ * @return ON_STATUS or OFF_STATUS
+ */
+uint8 u8ShadowGetStatus(uint8 u8StatusCode) {
+  uint8 *pu8State = &shadow_state[u8StatusCode - ROOM1_STATUS];
+  uint8 response;
+
+  if (*pu8State == SHADOW_UNKNOWN) {
+    CONSOLE_WAIT_LINK();
+    SPI_ui8TransmitRecive(u8StatusCode);
+    _delay_ms(SHADOW_QUERY_DELAY);
+    response = SPI_ui8TransmitRecive(DEMAND_RESPONSE);
+    TRACE_EMIT(TRACE_LINK_TX, u8StatusCode, response);
+    if ((response == ON_STATUS) || (response == OFF_STATUS)) {
+      *pu8State = response;
+    } else {
+      return OFF_STATUS; /* no valid answer, keep the entry stale */
+    }
+  }
+  return *pu8State;
+}
+
+/**
+ * @brief  Overwrite every entry with a slave snapshot
+ * @param  u8Devices TELEMETRY_DEVICE_BIT per device that is on
+ * @return Void
+ */
+void vShadowApplySnapshot(uint8 u8Devices) {
+  uint8 u8Index;
+  for (u8Index = 0; u8Index < SHADOW_DEVICES; u8Index++) {
+    shadow_state[u8Index] =
+        (u8Devices & (1 << u8Index)) ? ON_STATUS : OFF_STATUS;
+  }
+}
+
+/**
+ * @brief  Mark every entry stale (link lost or slave reset)
+ * @return Void
+ */
+void vShadowInvalidate(void) {
+  uint8 u8Index;
+  for (u8Index = 0; u8Index < SHADOW_DEVICES; u8Index++) {
+    shadow_state[u8Index] = SHADOW_UNKNOWN;
+  }
+}
\ No newline at end of file
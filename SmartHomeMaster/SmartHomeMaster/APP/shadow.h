@@ -0,0 +1,56 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: shadow.h
+ * Description: Header file for the master side shadow of slave device states
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef APP_SHADOW_H_
+#define APP_SHADOW_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../LIB/STD_MESSAGES.h"
+#include "../LIB/STD_Types.h"
+#include "main_config.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* One entry per status code, ROOM1_STATUS .. AIR_COND_STATUS */
+#define SHADOW_DEVICES (uint8)(AIR_COND_STATUS - ROOM1_STATUS + 1)
+#define SHADOW_UNKNOWN (uint8)0xFE /* stale, ask the slave */
+#define SHADOW_QUERY_DELAY 100     /* ms for the slave to load a status */
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Send a device command and record the state it sets
+ * @param  u8Command Command code (x_TURN_ON / x_TURN_OFF / others)
+ * @return Void
+ */
+void vShadowSendCommand(uint8 u8Command);
+
+/**
+ * @brief  State of a device, asks the slave only when the entry is stale
+ * @param  u8StatusCode Status command of the device
+ * @return ON_STATUS or OFF_STATUS
+ */
+uint8 u8ShadowGetStatus(uint8 u8StatusCode);
+
+/**
+ * @brief  Overwrite every entry with a slave snapshot
+ * @param  u8Devices TELEMETRY_DEVICE_BIT per device that is on
+ * @return Void
+ */
+void vShadowApplySnapshot(uint8 u8Devices);
+
+/**
+ * @brief  Mark every entry stale (link lost or slave reset)
+ * @return Void
+ */
+void vShadowInvalidate(void);
+
+#endif /* APP_SHADOW_H_ */
\ No newline at end of file
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: telemetry.c
+ * Description: Source file for the master side cache of slave telemetry
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "telemetry.h"
+#include "../MCAL/SPI/SPI.h"
+#include "../MCAL/Timer/systick.h"
+#include "console.h"
+#include <stddef.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static Telemetry_t telemetry_cache;
+static uint8 telemetry_valid = FALSE;
+static uint32 telemetry_stamp = 0; /* ms timestamp of the last valid frame */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Fetch a telemetry frame from the slave (about 10 ms)
+ * @return TRUE if a valid frame updated the cache, FALSE otherwise
+ */
+uint8 u8TelemetryRefresh(void) {
+  uint8 au8Frame[TELEMETRY_SIZE];
+  uint8 u8Index;
+  uint8 u8Sum = 0;
+
+  CONSOLE_WAIT_LINK();
+  SPI_ui8TransmitRecive(GET_TELEMETRY);
+  _delay_ms(TELEMETRY_CMD_DELAY);
+  for (u8Index = 0; u8Index < TELEMETRY_SIZE; u8Index++) {
+    au8Frame[u8Index] = SPI_ui8TransmitRecive(DEFAULT_ACK);
+    _delay_ms(TELEMETRY_BYTE_DELAY);
+  }
+
+  /* A missing slave reads as 0xFF and fails the check like a corrupt frame */
+  for (u8Index = 0; u8Index < TELEMETRY_CHECKSUM; u8Index++) {
+    u8Sum += au8Frame[u8Index];
+  }
+  if (au8Frame[TELEMETRY_CHECKSUM] != (uint8)~u8Sum) {
+    return FALSE;
+  }
+
+  telemetry_cache.u8Temperature = au8Frame[TELEMETRY_TEMPERATURE];
+  telemetry_cache.u8SetPoint = au8Frame[TELEMETRY_SET_POINT];
+  telemetry_cache.u8FanDuty = au8Frame[TELEMETRY_FAN_DUTY];
+  telemetry_cache.u8Flags = au8Frame[TELEMETRY_FLAGS];
+  telemetry_cache.u8Devices = au8Frame[TELEMETRY_DEVICES];
+  telemetry_stamp = SYSTICK_u32GetMillis();
+  telemetry_valid = TRUE;
+  return TRUE;
+}
+
+/**
+ * @brief  Cached telemetry, never touches the link
+ * @return Pointer to the cache or NULL if no frame was received yet
+ */
+const Telemetry_t *pstTelemetryGet(void) {
+  return (telemetry_valid == TRUE) ? &telemetry_cache : NULL;
+}
+
+/**
+ * @brief  Check the age of the cache
+ * @return TRUE if the last valid frame is older than TELEMETRY_STALE_TIME
+ */
+uint8 u8TelemetryIsStale(void) {
+  return SYSTICK_u8HasElapsed(telemetry_stamp, TELEMETRY_STALE_TIME);
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Module: APP
+ * File Name: telemetry.h
+ * Description: Header file for the master side cache of slave telemetry
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef APP_TELEMETRY_H_
+#define APP_TELEMETRY_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../LIB/STD_MESSAGES.h"
+#include "../LIB/STD_Types.h"
+#include "main_config.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define TELEMETRY_CMD_DELAY 5  /* ms for the slave to build the frame */
+#define TELEMETRY_BYTE_DELAY 1 /* ms for the slave to load the next byte */
+#define TELEMETRY_STALE_TIME (uint32)3000 /* age (ms) shown as stale */
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  Last climate state reported by the slave
+ */
+typedef struct {
+  uint8 u8Temperature; /* degrees C */
+  uint8 u8SetPoint;    /* degrees C */
+  uint8 u8FanDuty;     /* 0..100 % */
+  uint8 u8Flags;       /* TELEMETRY_FLAG_x */
+  uint8 u8Devices;     /* TELEMETRY_DEVICE_BIT per device */
+} Telemetry_t;
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Fetch a telemetry frame from the slave (about 10 ms)
+ * @return TRUE if a valid frame updated the cache, FALSE otherwise
+ */
+uint8 u8TelemetryRefresh(void);
+
+/**
+ * @brief  Cached telemetry, never touches the link
+ * @return Pointer to the cache or NULL if no frame was received yet
+ */
+const Telemetry_t *pstTelemetryGet(void);
+
+/**
+ * @brief  Check the age of the cache
+ * @return TRUE if the last valid frame is older than TELEMETRY_STALE_TIME
+ */
+uint8 u8TelemetryIsStale(void);
+
+#endif /* APP_TELEMETRY_H_ */
\ No newline at end of file
@@ -9,47 +9,145 @@
  *                             Includes                                 *
  *******************************************************************************/
 #include "buzzer.h"
+#include "../../MCAL/Timer/systick.h"
+#include <stddef.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+const BuzzerStep_t buzzer_pattern_click[] PROGMEM = {{BUZZER_ON, 40},
+                                                     BUZZER_STEP_END};
+
+const BuzzerStep_t buzzer_pattern_double[] PROGMEM = {
+    {BUZZER_ON, 40}, {BUZZER_OFF, 80}, {BUZZER_ON, 40}, BUZZER_STEP_END};
+
+const BuzzerStep_t buzzer_pattern_alarm[] PROGMEM = {
+    {BUZZER_ON, 150}, {BUZZER_OFF, 150}, {BUZZER_ON, 150}, {BUZZER_OFF, 150},
+    {BUZZER_ON, 150}, {BUZZER_OFF, 150}, {BUZZER_ON, 150}, {BUZZER_OFF, 150},
+    {BUZZER_ON, 150}, {BUZZER_OFF, 150}, {BUZZER_ON, 150}, BUZZER_STEP_END};
+
+static const BuzzerStep_t *buzzer_pattern = NULL; /* first step, for repeat */
+static const BuzzerStep_t *volatile buzzer_step = NULL; /* NULL when idle */
+static volatile uint16 buzzer_remaining = 0;
 
 /*******************************************************************************
  *                        Functions Definitions                         *
  *******************************************************************************/
 /**
- * @brief  Initialize Buzzer pin
+ * @brief  Drive the buzzer output
+ * @param  u8Level BUZZER_ON or BUZZER_OFF
  * @return Void
  */
-void buzzer_init(void) {
-  BUZZER_DDR |= (1 << BUZZER_PIN); // set PC3 as output
+static void buzzer_vOutput(uint8 u8Level) {
+  if (BUZZER_TONE_ENABLE) {
+    /* Timer0 keeps running, only its connection to OC0 is gated */
+    if (u8Level == BUZZER_ON) {
+      TIMER_vSetOutput(BUZZER_TONE_TIMER, TIMER_CHANNEL_A, TIMER_OUTPUT_TOGGLE);
+    } else {
+      TIMER_vSetOutput(BUZZER_TONE_TIMER, TIMER_CHANNEL_A, TIMER_OUTPUT_OFF);
+      CLR_BIT(PORTB, PB3); // leave the speaker unpowered
+    }
+  } else if (u8Level == BUZZER_ON) {
+    SET_BIT(BUZZER_PORT, BUZZER_PIN);
+  } else {
+    CLR_BIT(BUZZER_PORT, BUZZER_PIN);
+  }
 }
 
 /**
- * @brief  Generate a short beep
+ * @brief  Apply the current step, handles the end and repeat markers
  * @return Void
  */
-void buzzer_click(void) {
-  BUZZER_PORT |= (1 << BUZZER_PIN);
-  _delay_ms(40);
-  BUZZER_PORT &= ~(1 << BUZZER_PIN);
+static void buzzer_vLoadStep(void) {
+  uint8 u8Level = pgm_read_byte(&buzzer_step->u8Level);
+  if (u8Level == BUZZER_REPEAT) {
+    buzzer_step = buzzer_pattern;
+    u8Level = pgm_read_byte(&buzzer_step->u8Level);
+  }
+  buzzer_remaining = pgm_read_word(&buzzer_step->u16Time);
+  if (buzzer_remaining == 0) {
+    buzzer_step = NULL;
+    u8Level = BUZZER_OFF;
+  }
+  buzzer_vOutput(u8Level);
 }
 
 /**
- * @brief  Generate a double beep
+ * @brief  Tick callback, advances the pattern once per millisecond
  * @return Void
  */
-void buzzer_double(void) {
-  buzzer_click();
-  _delay_ms(80);
-  buzzer_click();
+static void buzzer_vTick(void) {
+  if (buzzer_step != NULL) {
+    buzzer_remaining--;
+    if (buzzer_remaining == 0) {
+      buzzer_step++;
+      buzzer_vLoadStep();
+    }
+  }
 }
 
 /**
- * @brief  Generate an alarm sequence
+ * @brief  Initialize Buzzer pin and hook the sequencer on the system tick
+ * @return TRUE if hooked, FALSE if the system tick has no free slot
+ */
+uint8 buzzer_init(void) {
+  static const Timer_Config_t stToneConfig = {
+      TIMER_MODE_CTC,   BUZZER_TONE_CLOCK, BUZZER_TONE_OCR,
+      TIMER_OUTPUT_OFF, TIMER_OUTPUT_OFF,  TIMER_CAPTURE_FALLING};
+  if (BUZZER_TONE_ENABLE) {
+    SET_BIT(DDRB, PB3); // OC0 as output
+    (void)TIMER_u8Init(BUZZER_TONE_TIMER, &stToneConfig);
+  } else {
+    BUZZER_DDR |= (1 << BUZZER_PIN); // set PC3 as output
+  }
+  return SYSTICK_u8RegisterCallback(buzzer_vTick);
+}
+
+/**
+ * @brief  Start a pattern, replaces the one playing (returns immediately)
+ * @param  pstPattern Step table in flash
  * @return Void
  */
-void buzzer_alarm(void) {
-  for (unsigned char i = 0; i < 6; i++) {
-    BUZZER_PORT |= (1 << BUZZER_PIN);
-    _delay_ms(150);
-    BUZZER_PORT &= ~(1 << BUZZER_PIN);
-    _delay_ms(150);
+void buzzer_vPlay(const BuzzerStep_t *pstPattern) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    buzzer_pattern = pstPattern;
+    buzzer_step = pstPattern;
+    buzzer_vLoadStep();
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief  Stop the current pattern and silence the buzzer
+ * @return Void
+ */
+void buzzer_vStop(void) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    buzzer_step = NULL;
+    buzzer_vOutput(BUZZER_OFF);
+  }
+}
+
+/**
+ * @brief  Check whether a pattern is still playing
+ * @return TRUE if busy, FALSE otherwise
+ */
+uint8 buzzer_u8IsBusy(void) { return (buzzer_step != NULL) ? 1 : 0; }
+
+/**
+ * @brief  Generate a short beep
+ * @return Void
+ */
+void buzzer_click(void) { buzzer_vPlay(buzzer_pattern_click); }
+
+/**
+ * @brief  Generate a double beep
+ * @return Void
+ */
+void buzzer_double(void) { buzzer_vPlay(buzzer_pattern_double); }
+
+/**
+ * @brief  Generate an alarm sequence
+ * @return Void
+ */
+void buzzer_alarm(void) { buzzer_vPlay(buzzer_pattern_alarm); }
@@ -11,9 +11,10 @@
 /*******************************************************************************
  *                             Includes                                 *
  *******************************************************************************/
+#include "../../LIB/STD_Types.h"
 #include "../../LIB/std_macros.h"
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
  *                             Definitions                              *
@@ -22,14 +23,73 @@
 #define BUZZER_DDR DDRC
 #define BUZZER_PIN PC3
 
+/*
+ * Hardware tone: set to 1 for a passive buzzer wired to OC0 (PB3). Timer0
+ * then toggles the pin at BUZZER_TONE_HZ and the pattern steps only gate it.
+ * With 0 the active buzzer on BUZZER_PIN is switched directly.
+ */
+#define BUZZER_TONE_ENABLE 0
+#define BUZZER_TONE_HZ 2000UL
+#define BUZZER_TONE_TIMER TIMER_0
+#define BUZZER_TONE_CLOCK TIMER_CLK_64
+#define BUZZER_TONE_PRESCALER 64UL
+#define BUZZER_TONE_OCR                                                        \
+  (uint8)((F_CPU / (2 * BUZZER_TONE_PRESCALER * BUZZER_TONE_HZ)) - 1)
+
+/* Step levels */
+#define BUZZER_OFF (uint8)0
+#define BUZZER_ON (uint8)1
+#define BUZZER_REPEAT (uint8)0xFF /* jump back to the first step */
+
+/* Pattern terminators, place one as the last step of every table */
+#define BUZZER_STEP_END {BUZZER_OFF, 0}
+#define BUZZER_STEP_LOOP {BUZZER_REPEAT, 0}
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  One step of a buzzer pattern (flash resident)
+ */
+typedef struct {
+  uint8 u8Level;  /* BUZZER_ON / BUZZER_OFF / BUZZER_REPEAT */
+  uint16 u16Time;  /* Step length in ms, 0 ends the pattern */
+} BuzzerStep_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+extern const BuzzerStep_t buzzer_pattern_click[] PROGMEM;
+extern const BuzzerStep_t buzzer_pattern_double[] PROGMEM;
+extern const BuzzerStep_t buzzer_pattern_alarm[] PROGMEM;
+
 /*******************************************************************************
  *                    Software Interfaces Declarations                  *
  *******************************************************************************/
 /**
- * @brief  Initialize Buzzer pin
+ * @brief  Initialize Buzzer pin and hook the sequencer on the system tick
+ * @return TRUE if hooked, FALSE if the system tick has no free slot
+ */
+uint8 buzzer_init(void);
+
+/**
+ * @brief  Start a pattern, replaces the one playing (returns immediately)
+ * @param  pstPattern Step table in flash
  * @return Void
  */
-void buzzer_init(void);
+void buzzer_vPlay(const BuzzerStep_t *pstPattern);
+
+/**
+ * @brief  Stop the current pattern and silence the buzzer
+ * @return Void
+ */
+void buzzer_vStop(void);
+
+/**
+ * @brief  Check whether a pattern is still playing
+ * @return 1 if busy, 0 otherwise
+ */
+uint8 buzzer_u8IsBusy(void);
 
 /**
  * @brief  Generate a short beep
@@ -49,4 +109,4 @@ void buzzer_double(void);
  */
 void buzzer_alarm(void);
 
-#endif /* HAL_BUZZER_BUZZER_H_ */
\ No newline at end of file
+#endif /* HAL_BUZZER_BUZZER_H_ */
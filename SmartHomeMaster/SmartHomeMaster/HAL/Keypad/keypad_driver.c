@@ -9,6 +9,24 @@
  *                             Includes                                 *
  *******************************************************************************/
 #include "keypad_driver.h"
+#include "../../MCAL/Trace/trace.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Flash Tables                               *
+ *******************************************************************************/
+/* keypad buttons, read with pgm_read_byte */
+static const uint8 keypad_map[4][4] PROGMEM = {{'7', '8', '9', '/'},
+                                               {'4', '5', '6', '*'},
+                                               {'1', '2', '3', '-'},
+                                               {'A', '0', '=', '+'}};
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+#if TRACE_ENABLE
+static uint8 keypad_traced = NOT_PRESSED; /* key of the last trace record */
+#endif
 
 /*******************************************************************************
  *                        Functions Definitions                         *
@@ -19,22 +37,16 @@
  */
 void keypad_vInit(void) {
   /* Initialize first four bits in keypad as output pins */
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_FIRST_PIN, 1);
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_SECOND_PIN, 1);
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_THIRD_PIN, 1);
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_FOURTH_PIN, 1);
+  DIO_vSetGroupDir(KEYPAD_ROW_PORT, KEYPAD_ROW_MASK, 1);
 
   /* initalize second four bits in keypad as input pins */
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_FIFTH_PIN, 0);
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_SIXTH_PIN, 0);
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_SEVENTH_PIN, 0);
-  DIO_vsetPINDir(KEYPAD_PORT, KEYPAD_EIGHTH_PIN, 0);
+  DIO_vSetGroupDir(KEYPAD_PORT, KEYPAD_COLUMN_MASK, 0);
 
   /*connect pull up resistance to the input pins*/
-  DIO_vconnectpullup(KEYPAD_PORT, KEYPAD_FIFTH_PIN, 1);
-  DIO_vconnectpullup(KEYPAD_PORT, KEYPAD_SIXTH_PIN, 1);
-  DIO_vconnectpullup(KEYPAD_PORT, KEYPAD_SEVENTH_PIN, 1);
-  DIO_vconnectpullup(KEYPAD_PORT, KEYPAD_EIGHTH_PIN, 1);
+  DIO_vSetPullup(KEYPAD_PORT, KEYPAD_FIFTH_PIN, 1);
+  DIO_vSetPullup(KEYPAD_PORT, KEYPAD_SIXTH_PIN, 1);
+  DIO_vSetPullup(KEYPAD_PORT, KEYPAD_SEVENTH_PIN, 1);
+  DIO_vSetPullup(KEYPAD_PORT, KEYPAD_EIGHTH_PIN, 1);
 }
 
 /**
@@ -42,40 +54,49 @@ void keypad_vInit(void) {
  * @return Pressed key or NOT_PRESSED
  */
 uint8 keypad_u8check_press(void) {
-  uint8 arr[4][4] = {{'7', '8', '9', '/'},
-                     {'4', '5', '6', '*'},
-                     {'1', '2', '3', '-'},
-                     {'A', '0', '=', '+'}}; // keypad buttons
-  uint8 row;                   // which indicate the given output  pin
-  uint8 coloumn;               // which indicate the given input pin
-  uint8 key_pressed_indicator; // the variable  which contain the key pressed
+  uint8 row;     // which indicate the given output  pin
+  uint8 coloumn; // which indicate the given input pin
+  uint8 columns; // levels of the four input pins, 0 where a key is pressed
 
   uint8 returnval = NOT_PRESSED; // the variable contain the value which will be
                                  // returned which will be key pressed or not
                                  // pressed in case of no key pressed
   for (row = 0; row < 4; row++) {
-    /*stop the work of keypad firstly*/
-    DIO_write(KEYPAD_PORT, KEYPAD_FIRST_PIN, 1);
-    DIO_write(KEYPAD_PORT, KEYPAD_SECOND_PIN, 1);
-    DIO_write(KEYPAD_PORT, KEYPAD_THIRD_PIN, 1);
-    DIO_write(KEYPAD_PORT, KEYPAD_FOURTH_PIN, 1);
-
+    /* one port write: strobe this row low, keep the other rows high */
+    DIO_vWriteGroup(KEYPAD_ROW_PORT, KEYPAD_ROW_MASK,
+                    (uint8)~(1 << (KEYPAD_FIRST_PIN + row)));
     _delay_ms(20);
-    DIO_write(KEYPAD_PORT, row,
-              0); // write 0 to the first pin in keypad (output pin from MC)
 
+    // read the input pins of MC which connected to keypad
+    columns = DIO_u8ReadGroup(KEYPAD_PORT, KEYPAD_COLUMN_MASK);
     for (coloumn = 0; coloumn < 4; coloumn++) {
-      key_pressed_indicator = DIO_u8read(
-          KEYPAD_PORT,
-          (coloumn + 4)); // read the input pins of MC which connected to keypad
-      if (key_pressed_indicator == 0) // will be 0 only if any key pressed
-      {
-        returnval =
-            arr[row][coloumn]; // put the selected pressed key to the retrurnval
-        break;                 // break from the loop
+      if ((columns & (1 << (KEYPAD_FIFTH_PIN + coloumn))) == 0) {
+        // put the selected pressed key to the retrurnval
+        returnval = pgm_read_byte(&keypad_map[row][coloumn]);
+        break; // break from the loop
       }
     }
   }
+#if TRACE_ENABLE
+  /* Only the edges are traced, the callers poll this in loops */
+  if (returnval != keypad_traced) {
+    if (returnval != NOT_PRESSED) {
+      TRACE_EMIT(TRACE_KEY, returnval, 1);
+    } else {
+      TRACE_EMIT(TRACE_KEY, keypad_traced, 0);
+    }
+    keypad_traced = returnval;
+  }
+#endif
   return returnval; // return the pressed key in case of key pressed or return
                     // 0xff in case of no key pressed
+}
+
+/**
+ * @brief  Wait until all keys are released
+ * @return Void
+ */
+void keypad_vWaitRelease(void) {
+  while (keypad_u8check_press() != NOT_PRESSED) {
+  }
 }
\ No newline at end of file
@@ -33,4 +33,10 @@ void keypad_vInit(void);
  */
 uint8 keypad_u8check_press(void);
 
+/**
+ * @brief  Wait until all keys are released
+ * @return Void
+ */
+void keypad_vWaitRelease(void);
+
 #endif /* HAL_KEYPAD_KEYPAD_DRIVER_H_ */
\ No newline at end of file
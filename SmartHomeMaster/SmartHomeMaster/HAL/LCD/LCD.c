@@ -21,36 +21,36 @@ static void send_falling_edge(void);
  */
 void LCD_vInit(void) {
 #if defined eight_bits_mode
-  DIO_vsetPINDir(LCD_PORT, LCD_FIRST_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_SECOND_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_THIRD_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_FOURTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_FIFTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_SIXTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_SEVENTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_EIGHTH_PIN, 1);
-
-  DIO_vsetPINDir(LCD_CONTROL_PORT, LCD_EN_PIN, 1);
-  DIO_vsetPINDir(LCD_CONTROL_PORT, LCD_RW_PIN, 1);
-  DIO_vsetPINDir(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
-
-  DIO_write(LCD_CONTROL_PORT, LCD_RW_PIN, 0);
+  DIO_vSetPinDir(LCD_PORT, LCD_FIRST_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_SECOND_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_THIRD_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_FOURTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_FIFTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_SIXTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_SEVENTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_EIGHTH_PIN, 1);
+
+  DIO_vSetPinDir(LCD_CONTROL_PORT, LCD_EN_PIN, 1);
+  DIO_vSetPinDir(LCD_CONTROL_PORT, LCD_RW_PIN, 1);
+  DIO_vSetPinDir(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
+
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RW_PIN, 0);
   LCD_vSend_cmd(EIGHT_BIT_MODE);
   LCD_vSend_cmd(CLR_SCREEN);
   LCD_vSend_cmd(DISPLAY_ON_CURSOR_ON);
   _delay_ms(10);
 
 #elif defined four_bits_mode
-  DIO_vsetPINDir(LCD_PORT, LCD_FIFTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_SIXTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_SEVENTH_PIN, 1);
-  DIO_vsetPINDir(LCD_PORT, LCD_EIGHTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_FIFTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_SIXTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_SEVENTH_PIN, 1);
+  DIO_vSetPinDir(LCD_PORT, LCD_EIGHTH_PIN, 1);
 
-  DIO_vsetPINDir(LCD_CONTROL_PORT, LCD_EN_PIN, 1);
-  DIO_vsetPINDir(LCD_CONTROL_PORT, LCD_RW_PIN, 1);
-  DIO_vsetPINDir(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
+  DIO_vSetPinDir(LCD_CONTROL_PORT, LCD_EN_PIN, 1);
+  DIO_vSetPinDir(LCD_CONTROL_PORT, LCD_RW_PIN, 1);
+  DIO_vSetPinDir(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
 
-  DIO_write(LCD_CONTROL_PORT, LCD_RW_PIN, 0);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RW_PIN, 0);
   LCD_vSend_cmd(FOUR_BIT_MODE_I);
   LCD_vSend_cmd(FOUR_BIT_MODE_II);
   LCD_vSend_cmd(CLR_SCREEN);
@@ -64,9 +64,9 @@ void LCD_vInit(void) {
  * @return Void
  */
 static void send_falling_edge(void) {
-  DIO_write(LCD_CONTROL_PORT, LCD_EN_PIN, 1);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_EN_PIN, 1);
   _delay_ms(2);
-  DIO_write(LCD_CONTROL_PORT, LCD_EN_PIN, 0);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_EN_PIN, 0);
   _delay_ms(2);
 }
 
@@ -77,18 +77,16 @@ static void send_falling_edge(void) {
  */
 void LCD_vSend_cmd(uint8 cmd) {
 #if defined eight_bits_mode
-  DIO_write_port(LCD_PORT, cmd);
-  DIO_write(LCD_CONTROL_PORT, LCD_RS_PIN, 0);
+  DIO_vWritePort(LCD_PORT, cmd);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RS_PIN, 0);
   send_falling_edge();
 
 #elif defined four_bits_mode
-  clear_high_nibble(LCD_PORT, cmd);
-  dio_write_highnibble(LCD_PORT, cmd & 0xf0);
-  DIO_write(LCD_CONTROL_PORT, LCD_RS_PIN, 0);
+  DIO_vWriteGroup(LCD_PORT, LCD_HIGH_NIBBLE_MASK, cmd);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RS_PIN, 0);
   send_falling_edge();
-  clear_high_nibble(LCD_PORT, cmd);
-  dio_write_highnibble(LCD_PORT, cmd << 4);
-  DIO_write(LCD_CONTROL_PORT, LCD_RS_PIN, 0);
+  DIO_vWriteGroup(LCD_PORT, LCD_HIGH_NIBBLE_MASK, cmd << 4);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RS_PIN, 0);
   send_falling_edge();
 #endif
 }
@@ -100,18 +98,16 @@ void LCD_vSend_cmd(uint8 cmd) {
  */
 void LCD_vSend_char(uint8 data) {
 #if defined eight_bits_mode
-  DIO_write_port(LCD_PORT, data);
-  DIO_write(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
+  DIO_vWritePort(LCD_PORT, data);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
   send_falling_edge();
 
 #elif defined four_bits_mode
-  clear_high_nibble(LCD_PORT, data);
-  dio_write_highnibble(LCD_PORT, data & 0xf0);
-  DIO_write(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
+  DIO_vWriteGroup(LCD_PORT, LCD_HIGH_NIBBLE_MASK, data);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
   send_falling_edge();
-  clear_high_nibble(LCD_PORT, data);
-  dio_write_highnibble(LCD_PORT, data << 4);
-  DIO_write(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
+  DIO_vWriteGroup(LCD_PORT, LCD_HIGH_NIBBLE_MASK, data << 4);
+  DIO_vWritePin(LCD_CONTROL_PORT, LCD_RS_PIN, 1);
   send_falling_edge();
 #endif
 }
@@ -121,13 +117,58 @@ void LCD_vSend_char(uint8 data) {
  * @param  data String pointer
  * @return Void
  */
-void LCD_vSend_string(char *data) {
+void LCD_vSend_string(const char *data) {
   while ((*data) != 0) {
     LCD_vSend_char(*data);
     data++;
   }
 }
 
+/**
+ * @brief  Send flash resident string to LCD
+ * @param  data Flash string pointer (PSTR or PROGMEM array)
+ * @return Void
+ */
+void LCD_vSend_string_P(const char *data) {
+  uint8 character = pgm_read_byte(data);
+  while (character != 0) {
+    LCD_vSend_char(character);
+    data++;
+    character = pgm_read_byte(data);
+  }
+}
+
+/**
+ * @brief  Move cursor then send flash resident string
+ * @param  row Row number (1 or 2)
+ * @param  column Column number (1-16)
+ * @param  data Flash string pointer (PSTR or PROGMEM array)
+ * @return Void
+ */
+void LCD_vWriteAt_P(uint8 row, uint8 column, const char *data) {
+  LCD_movecursor(row, column);
+  LCD_vSend_string_P(data);
+}
+
+/**
+ * @brief  Send unsigned decimal number to LCD
+ * @param  number Value to display (no padding)
+ * @return Void
+ */
+void LCD_vSend_number(uint16 number) {
+  uint8 digits[5];
+  uint8 count = 0;
+  do {
+    digits[count] = (number % 10) + '0';
+    number /= 10;
+    count++;
+  } while (number != 0);
+  while (count > 0) {
+    count--;
+    LCD_vSend_char(digits[count]);
+  }
+}
+
 /**
  * @brief  Clear LCD screen
  * @return Void
@@ -13,6 +13,7 @@
  *******************************************************************************/
 #include "../../MCAL/DIO/DIO.h"
 #include "LCD_config.h"
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
  *                             Definitions                              *
@@ -51,7 +52,30 @@ void LCD_vSend_char(uint8 data);
  * @param  data String pointer
  * @return Void
  */
-void LCD_vSend_string(char *data);
+void LCD_vSend_string(const char *data);
+
+/**
+ * @brief  Send flash resident string to LCD
+ * @param  data Flash string pointer (PSTR or PROGMEM array)
+ * @return Void
+ */
+void LCD_vSend_string_P(const char *data);
+
+/**
+ * @brief  Move cursor then send flash resident string
+ * @param  row Row number (1 or 2)
+ * @param  column Column number (1-16)
+ * @param  data Flash string pointer (PSTR or PROGMEM array)
+ * @return Void
+ */
+void LCD_vWriteAt_P(uint8 row, uint8 column, const char *data);
+
+/**
+ * @brief  Send unsigned decimal number to LCD
+ * @param  number Value to display (no padding)
+ * @return Void
+ */
+void LCD_vSend_number(uint16 number);
 
 /**
  * @brief  Clear LCD screen
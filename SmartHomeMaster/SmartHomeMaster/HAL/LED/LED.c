@@ -20,7 +20,7 @@
  * @return Void
  */
 void LED_vInit(uint8 portname, uint8 pinnumber) {
-  DIO_vsetPINDir(portname, pinnumber, 1);
+  DIO_vSetPinDir(portname, pinnumber, 1);
 }
 
 /**
@@ -30,7 +30,7 @@ void LED_vInit(uint8 portname, uint8 pinnumber) {
  * @return Void
  */
 void LED_vTurnOn(uint8 portname, uint8 pinnumber) {
-  DIO_write(portname, pinnumber, 1);
+  DIO_vWritePin(portname, pinnumber, 1);
 }
 
 /**
@@ -40,7 +40,7 @@ void LED_vTurnOn(uint8 portname, uint8 pinnumber) {
  * @return Void
  */
 void LED_vTurnOff(uint8 portname, uint8 pinnumber) {
-  DIO_write(portname, pinnumber, 0);
+  DIO_vWritePin(portname, pinnumber, 0);
 }
 
 /**
@@ -50,7 +50,7 @@ void LED_vTurnOff(uint8 portname, uint8 pinnumber) {
  * @return Void
  */
 void LED_vToggle(uint8 portname, uint8 pinnumber) {
-  DIO_toggle(portname, pinnumber);
+  DIO_vTogglePin(portname, pinnumber);
 }
 
 /**
@@ -60,5 +60,5 @@ void LED_vToggle(uint8 portname, uint8 pinnumber) {
  * @return Status (0 or 1)
  */
 uint8 LED_u8ReadStatus(uint8 portname, uint8 pinnumber) {
-  return DIO_u8read(portname, pinnumber);
+  return DIO_u8ReadPin(portname, pinnumber);
 }
\ No newline at end of file
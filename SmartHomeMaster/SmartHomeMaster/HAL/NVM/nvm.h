@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Module: NVM
+ * File Name: nvm.h
+ * Description: Header file for the wear-levelled settings record store
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HAL_NVM_NVM_H_
+#define HAL_NVM_NVM_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../../LIB/STD_Types.h"
+#include "../../MCAL/EEPROM/EEPROM.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/*
+ * The record is written to the next slot of a ring on every save, so each
+ * cell sees one write per NVM_SLOT_COUNT saves. The newest slot is the valid
+ * one whose successor does not continue its sequence number.
+ *
+ * Slot: [version][sequence][payload, zero padded][CRC-8 of the bytes before]
+ */
+#define NVM_BASE_ADDRESS (uint16)0
+#define NVM_SLOT_SIZE (uint8)16
+#define NVM_SLOT_COUNT (uint8)32 /* 512 bytes */
+#define NVM_PAYLOAD_SIZE (uint8)(NVM_SLOT_SIZE - 3)
+
+#define NVM_SLOT_VERSION (uint8)0
+#define NVM_SLOT_SEQUENCE (uint8)1
+#define NVM_SLOT_PAYLOAD (uint8)2
+#define NVM_SLOT_CRC (uint8)(NVM_SLOT_SIZE - 1)
+
+#define NVM_VERSION_ERASED (uint8)0xFF /* never a valid record version */
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Find the newest valid record and copy it out
+ * @param  u8Version Record layout version, older layouts are ignored
+ * @param  pvRecord Destination record
+ * @param  u8Size Record size (up to NVM_PAYLOAD_SIZE)
+ * @return 1 if a record was restored, 0 if the caller must use defaults
+ */
+uint8 NVM_u8Load(uint8 u8Version, void *pvRecord, uint8 u8Size);
+
+/**
+ * @brief  Save a record in the background (returns immediately)
+ * @note   A save requested while the previous one is still being written
+ *         replaces any save that has not started yet. An unchanged record is
+ *         not written again.
+ * @param  u8Version Record layout version
+ * @param  pvRecord Source record
+ * @param  u8Size Record size (up to NVM_PAYLOAD_SIZE)
+ * @return 1 if accepted, 0 if the record does not fit a slot
+ */
+uint8 NVM_u8Save(uint8 u8Version, const void *pvRecord, uint8 u8Size);
+
+/**
+ * @brief  Check for a save that is not fully written yet
+ * @return 1 if busy, 0 otherwise
+ */
+uint8 NVM_u8IsBusy(void);
+
+#endif /* HAL_NVM_NVM_H_ */
\ No newline at end of file
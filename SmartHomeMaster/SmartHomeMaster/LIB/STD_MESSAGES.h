@@ -34,6 +34,68 @@
 
 #define SET_TEMPERATURE 0x40
 
+#define BLOWER_TURN_ON 0x50
+#define BLOWER_TURN_OFF 0x51
+#define GET_LDR_STATUS 0x52
+#define GET_TELEMETRY 0x53
+#define CLEAR_BOOT_FLAG 0x54
+#define GET_ISR_PROFILE 0x55
+#define RESET_ISR_PROFILE 0x56
+#define GET_STACK_INFO 0x57
+#define GET_TRACE 0x58
+#define CLEAR_TRACE 0x59
+
+/* GET_TELEMETRY reply frame, one byte per transfer */
+#define TELEMETRY_TEMPERATURE 0 /* degrees C */
+#define TELEMETRY_SET_POINT 1   /* degrees C */
+#define TELEMETRY_FAN_DUTY 2    /* 0..100 % */
+#define TELEMETRY_FLAGS 3
+#define TELEMETRY_DEVICES 4  /* one TELEMETRY_DEVICE_BIT per device */
+#define TELEMETRY_CHECKSUM 5 /* ~(sum of the bytes above) */
+#define TELEMETRY_SIZE 6
+
+#define TELEMETRY_FLAG_AC 0x01
+#define TELEMETRY_FLAG_HEATER 0x02
+#define TELEMETRY_FLAG_DAY 0x04
+#define TELEMETRY_FLAG_AUTO 0x08
+#define TELEMETRY_FLAG_BLOWER 0x10
+#define TELEMETRY_FLAG_BOOT 0x20 /* slave reset, until CLEAR_BOOT_FLAG */
+
+/* Device bits follow the status codes: ROOM1_STATUS is bit 0 */
+#define TELEMETRY_DEVICE_BIT(status) (1 << ((status) - ROOM1_STATUS))
+
+/* GET_ISR_PROFILE reply frame: the record count (0 when the slave is built
+   without ISR_PROFILE_ENABLE), one record per profiled ISR, then
+   ~(sum of the bytes before). Record fields are 16-bit, low byte first. */
+#define ISR_RECORD_COUNT 0 /* runs in the current window */
+#define ISR_RECORD_MIN 2   /* cycles */
+#define ISR_RECORD_MAX 4   /* cycles */
+#define ISR_RECORD_MEAN 6  /* cycles */
+#define ISR_RECORD_LOAD 8  /* per mille of the CPU */
+#define ISR_RECORD_SIZE 10
+
+/* GET_STACK_INFO reply frame, 16-bit fields low byte first, then
+   ~(sum of the bytes before). A size of 0 means no painted stack. */
+#define STACK_FRAME_SIZE 0 /* painted bytes */
+#define STACK_FRAME_USED 2 /* high-water mark */
+#define STACK_FRAME_GUARD 4
+#define STACK_FRAME_CHECKSUM 5
+#define STACK_FRAME_LENGTH 6
+
+/* GET_TRACE reply frame: the header, TRACE_HEADER_COUNT records oldest
+   first, then ~(sum of the bytes before). 16-bit fields low byte first.
+   A tick length of 0 means the slave is built without TRACE_ENABLE. */
+#define TRACE_HEADER_TICK_US 0 /* microseconds per tick */
+#define TRACE_HEADER_NOW 2     /* ticks when the dump started */
+#define TRACE_HEADER_TOTAL 4   /* records written since the last clear */
+#define TRACE_HEADER_COUNT 6
+#define TRACE_HEADER_SIZE 7
+#define TRACE_RECORD_TIME 0 /* ticks */
+#define TRACE_RECORD_EVENT 2
+#define TRACE_RECORD_ARG0 3
+#define TRACE_RECORD_ARG1 4
+#define TRACE_RECORD_SIZE 5
+
 #define DEFAULT_ACK 0xFF
 #define DEMAND_RESPONSE 0xFF
 
@@ -17,5 +17,6 @@ typedef unsigned short uint16;
 typedef signed short sint16;
 typedef double float64;
 typedef unsigned long uint32;
+typedef signed long sint32;
 
 #endif /* STD_TYPES_H_ */
\ No newline at end of file
@@ -14,11 +14,214 @@
 #include "../../LIB/STD_Types.h"
 #include "../../LIB/std_macros.h"
 #include "DIO_config_master.h"
+#include <avr/io.h>
+#include <util/atomic.h>
 #include <util/delay.h>
 
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Forced inline so constant arguments fold at every call site */
+#define DIO_INLINE static inline __attribute__((always_inline))
+
+/* Mask of count consecutive pins starting at first */
+#define DIO_GROUP_MASK(first, count) (uint8)(((1 << (count)) - 1) << (first))
+
+/* Port letter the registers exist for */
+#define DIO_IS_PORT(portname) (((portname) >= 'A') && ((portname) <= 'D'))
+
+/* Both arguments known at compile time: the access is a single sbi/cbi */
+#define DIO_IS_CONSTANT_PIN(portname, pinnumber)                               \
+  (__builtin_constant_p(portname) && __builtin_constant_p(pinnumber))
+
+/*******************************************************************************
+ *                       Inline Interfaces (fast path)                  *
+ *******************************************************************************/
+/*
+ * Port letters map to registers with a ternary chain instead of a switch.
+ * With a constant port the chain folds to a fixed I/O address, and with a
+ * constant pin as well a write compiles to a single sbi/cbi and a read to
+ * sbic/sbis. The chain does not check the letter: anything other than
+ * 'A'..'C' selects port D, so the inline functions take valid constants
+ * only. The out-of-line API below does nothing for a letter outside
+ * 'A'..'D' and reads it as 0, as the switch it replaced did.
+ *
+ * Every other read-modify-write goes through DIO_vWriteGroup, which masks
+ * interrupts for its duration, so an ISR writing the same port can never
+ * be overwritten by a stale copy from the main loop.
+ */
+
+/**
+ * @brief  Output register of a port
+ * @param  portname Port Name (A, B, C, D)
+ * @return Pointer to PORTx
+ */
+DIO_INLINE volatile uint8 *DIO_pu8PortReg(uint8 portname) {
+  return (portname == 'A')   ? &PORTA
+         : (portname == 'B') ? &PORTB
+         : (portname == 'C') ? &PORTC
+                             : &PORTD;
+}
+
+/**
+ * @brief  Direction register of a port
+ * @param  portname Port Name (A, B, C, D)
+ * @return Pointer to DDRx
+ */
+DIO_INLINE volatile uint8 *DIO_pu8DdrReg(uint8 portname) {
+  return (portname == 'A')   ? &DDRA
+         : (portname == 'B') ? &DDRB
+         : (portname == 'C') ? &DDRC
+                             : &DDRD;
+}
+
+/**
+ * @brief  Input register of a port
+ * @param  portname Port Name (A, B, C, D)
+ * @return Pointer to PINx
+ */
+DIO_INLINE volatile uint8 *DIO_pu8PinReg(uint8 portname) {
+  return (portname == 'A')   ? &PINA
+         : (portname == 'B') ? &PINB
+         : (portname == 'C') ? &PINC
+                             : &PIND;
+}
+
+/**
+ * @brief  Write several pins of a port in one interrupt-safe operation
+ * @param  portname Port Name (A, B, C, D)
+ * @param  mask Pins to change, e.g. DIO_GROUP_MASK(4, 4) for pins 4-7
+ * @param  value New levels, bits outside the mask are ignored
+ * @return Void
+ */
+DIO_INLINE void DIO_vWriteGroup(uint8 portname, uint8 mask, uint8 value) {
+  volatile uint8 *pu8Port = DIO_pu8PortReg(portname);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *pu8Port = (*pu8Port & (uint8)~mask) | (value & mask);
+  }
+}
+
+/**
+ * @brief  Set the direction of several pins of a port at once
+ * @param  portname Port Name (A, B, C, D)
+ * @param  mask Pins to change
+ * @param  direction Direction (1 for Output, 0 for Input)
+ * @return Void
+ */
+DIO_INLINE void DIO_vSetGroupDir(uint8 portname, uint8 mask,
+                                 uint8 direction) {
+  volatile uint8 *pu8Ddr = DIO_pu8DdrReg(portname);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (direction == 1) {
+      *pu8Ddr |= mask;
+    } else {
+      *pu8Ddr &= (uint8)~mask;
+    }
+  }
+}
+
+/**
+ * @brief  Read several pins of a port in one access
+ * @param  portname Port Name (A, B, C, D)
+ * @param  mask Pins to read
+ * @return Pin levels, bits outside the mask are 0
+ */
+DIO_INLINE uint8 DIO_u8ReadGroup(uint8 portname, uint8 mask) {
+  return *DIO_pu8PinReg(portname) & mask;
+}
+
+/**
+ * @brief  Set the direction of a specific pin
+ * @param  portname Port Name (A, B, C, D)
+ * @param  pinnumber Pin Number (0-7)
+ * @param  direction Direction (1 for Output, 0 for Input)
+ * @return Void
+ */
+DIO_INLINE void DIO_vSetPinDir(uint8 portname, uint8 pinnumber,
+                               uint8 direction) {
+  if (!DIO_IS_CONSTANT_PIN(portname, pinnumber)) {
+    DIO_vSetGroupDir(portname, (uint8)(1 << pinnumber), direction);
+  } else if (direction == 1) {
+    SET_BIT(*DIO_pu8DdrReg(portname), pinnumber);
+  } else {
+    CLR_BIT(*DIO_pu8DdrReg(portname), pinnumber);
+  }
+}
+
+/**
+ * @brief  Write a value to a specific pin
+ * @param  portname Port Name (A, B, C, D)
+ * @param  pinnumber Pin Number (0-7)
+ * @param  outputvalue Value (1 for High, 0 for Low)
+ * @return Void
+ */
+DIO_INLINE void DIO_vWritePin(uint8 portname, uint8 pinnumber,
+                              uint8 outputvalue) {
+  if (!DIO_IS_CONSTANT_PIN(portname, pinnumber)) {
+    DIO_vWriteGroup(portname, (uint8)(1 << pinnumber),
+                    (outputvalue == 1) ? 0xFF : 0x00);
+  } else if (outputvalue == 1) {
+    SET_BIT(*DIO_pu8PortReg(portname), pinnumber);
+  } else {
+    CLR_BIT(*DIO_pu8PortReg(portname), pinnumber);
+  }
+}
+
+/**
+ * @brief  Read the value of a specific pin
+ * @param  portname Port Name (A, B, C, D)
+ * @param  pinnumber Pin Number (0-7)
+ * @return Value of the pin (0 or 1)
+ */
+DIO_INLINE uint8 DIO_u8ReadPin(uint8 portname, uint8 pinnumber) {
+  return (*DIO_pu8PinReg(portname) & (1 << pinnumber)) ? 1 : 0;
+}
+
+/**
+ * @brief  Toggle the value of a specific pin
+ * @param  portname Port Name (A, B, C, D)
+ * @param  pinnumber Pin Number (0-7)
+ * @return Void
+ */
+DIO_INLINE void DIO_vTogglePin(uint8 portname, uint8 pinnumber) {
+  volatile uint8 *pu8Port = DIO_pu8PortReg(portname);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { TOG_BIT(*pu8Port, pinnumber); }
+}
+
+/**
+ * @brief  Write a value to the entire port
+ * @param  portname Port Name (A, B, C, D)
+ * @param  portvalue Value to write (8-bit)
+ * @return Void
+ */
+DIO_INLINE void DIO_vWritePort(uint8 portname, uint8 portvalue) {
+  *DIO_pu8PortReg(portname) = portvalue;
+}
+
+/**
+ * @brief  Enable or disable internal pull-up resistor
+ * @param  portname Port Name (A, B, C, D)
+ * @param  pinnumber Pin Number (0-7)
+ * @param  connect_pullup 1 to enable, 0 to disable
+ * @return Void
+ */
+DIO_INLINE void DIO_vSetPullup(uint8 portname, uint8 pinnumber,
+                               uint8 connect_pullup) {
+  if (connect_pullup == 1) {
+    CLR_BIT(SFIOR, PUD);
+    DIO_vSetPinDir(portname, pinnumber, 0);
+    DIO_vWritePin(portname, pinnumber, 1);
+  } else {
+    DIO_vWritePin(portname, pinnumber, 0);
+  }
+}
+
 /*******************************************************************************
  *                    Software Interfaces Declarations                  *
  *******************************************************************************/
+/* Out-of-line API kept for existing callers, each wraps the inline version
+ * after checking the port letter */
+
 /**
  * @brief  Set the direction of a specific pin
  * @param  portname Port Name (A, B, C, D)
@@ -19,15 +19,33 @@
 #define GUEST_LED_PIN (uint8)1
 #define BLOCK_LED_PIN (uint8)2
 
-#define KEYPAD_PORT (uint8)'D'
+/* UART console on PD0 (RXD) / PD1 (TXD), off by default. Build with
+ * UART_CONSOLE_ENABLE=1 (SMARTHOME_UART_CONSOLE in CMake) to enable it. */
+#ifndef UART_CONSOLE_ENABLE
+#define UART_CONSOLE_ENABLE 0
+#endif
+
+/* With the console the keypad rows move to PC4..PC7 (JTAG must be off) */
+#if UART_CONSOLE_ENABLE
+#define KEYPAD_ROW_PORT (uint8)'C'
+#define KEYPAD_FIRST_PIN (uint8)4
+#define KEYPAD_SECOND_PIN (uint8)5
+#define KEYPAD_THIRD_PIN (uint8)6
+#define KEYPAD_FOURTH_PIN (uint8)7
+#else
+#define KEYPAD_ROW_PORT (uint8)'D'
 #define KEYPAD_FIRST_PIN (uint8)0
 #define KEYPAD_SECOND_PIN (uint8)1
 #define KEYPAD_THIRD_PIN (uint8)2
 #define KEYPAD_FOURTH_PIN (uint8)3
+#endif
+#define KEYPAD_PORT (uint8)'D' /* columns */
 #define KEYPAD_FIFTH_PIN (uint8)4
 #define KEYPAD_SIXTH_PIN (uint8)5
 #define KEYPAD_SEVENTH_PIN (uint8)6
 #define KEYPAD_EIGHTH_PIN (uint8)7
+#define KEYPAD_ROW_MASK DIO_GROUP_MASK(KEYPAD_FIRST_PIN, 4)
+#define KEYPAD_COLUMN_MASK DIO_GROUP_MASK(KEYPAD_FIFTH_PIN, 4)
 
 #define LCD_PORT (uint8)'A'
 #define LCD_FIRST_PIN (uint8)0
@@ -38,6 +56,7 @@
 #define LCD_SIXTH_PIN (uint8)5
 #define LCD_SEVENTH_PIN (uint8)6
 #define LCD_EIGHTH_PIN (uint8)7
+#define LCD_HIGH_NIBBLE_MASK DIO_GROUP_MASK(LCD_FIFTH_PIN, 4)
 #define LCD_CONTROL_PORT (uint8)'B'
 #define LCD_EN_PIN (uint8)0
 #define LCD_RS_PIN (uint8)1
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Module: EEPROM
+ * File Name: EEPROM.c
+ * Description: Source file for the internal EEPROM driver
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "EEPROM.h"
+#include <stddef.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Block being written, owned by the ISR while eeprom_busy is set */
+static volatile uint8 eeprom_busy = 0;
+static uint16 eeprom_address;
+static const uint8 *eeprom_data;
+static uint8 eeprom_remaining;
+static EepromCallback_t eeprom_done;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Read one byte, the EEPROM must be idle (EEWE clear)
+ * @param  u16Address EEPROM address
+ * @return Byte value
+ */
+static uint8 EEPROM_u8ReadRaw(uint16 u16Address) {
+  EEAR = u16Address;
+  SET_BIT(EECR, EERE);
+  return EEDR;
+}
+
+/**
+ * @brief  Read one byte, waits for a write in progress
+ * @param  u16Address EEPROM address
+ * @return Byte value
+ */
+uint8 EEPROM_u8ReadByte(uint16 u16Address) {
+  uint8 u8Value = 0;
+  uint8 u8Done = 0;
+  while (u8Done == 0) {
+    /* A byte takes ~8.5 ms to program, wait with interrupts enabled */
+    while (IS_BIT_SET(EECR, EEWE)) {
+    }
+    /* EEAR is shared with the ISR, which may have started the next byte
+     * in between */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (IS_BIT_CLR(EECR, EEWE)) {
+        u8Value = EEPROM_u8ReadRaw(u16Address);
+        u8Done = 1;
+      }
+    }
+  }
+  return u8Value;
+}
+
+/**
+ * @brief  Read a block, waits for a write in progress
+ * @param  u16Address EEPROM address of the first byte
+ * @param  pu8Data Destination buffer
+ * @param  u8Length Number of bytes
+ * @return Void
+ */
+void EEPROM_vReadBlock(uint16 u16Address, uint8 *pu8Data, uint8 u8Length) {
+  while (u8Length > 0) {
+    *pu8Data = EEPROM_u8ReadByte(u16Address);
+    pu8Data++;
+    u16Address++;
+    u8Length--;
+  }
+}
+
+/**
+ * @brief  Start writing a block in the background (returns immediately)
+ * @note   Each byte takes ~8.5 ms and is written from the EE_RDY interrupt.
+ *         Bytes that already hold the value are skipped. The buffer must stay
+ *         valid until the callback runs. Global interrupts must be enabled.
+ * @param  u16Address EEPROM address of the first byte
+ * @param  pu8Data Source buffer
+ * @param  u8Length Number of bytes
+ * @param  pfDone Optional completion callback (ISR context), may be NULL
+ * @return 1 if started, 0 if a write is already in progress
+ */
+uint8 EEPROM_u8WriteBlock(uint16 u16Address, const uint8 *pu8Data,
+                          uint8 u8Length, EepromCallback_t pfDone) {
+  uint8 u8Started = 0;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if ((eeprom_busy == 0) && (u8Length > 0)) {
+      eeprom_address = u16Address;
+      eeprom_data = pu8Data;
+      eeprom_remaining = u8Length;
+      eeprom_done = pfDone;
+      eeprom_busy = 1;
+      SET_BIT(EECR, EERIE); /* fires as soon as the EEPROM is ready */
+      u8Started = 1;
+    }
+  }
+  return u8Started;
+}
+
+/**
+ * @brief  Check for a background write in progress
+ * @return 1 if busy, 0 otherwise
+ */
+uint8 EEPROM_u8IsBusy(void) { return eeprom_busy; }
+
+/*******************************************************************************
+ *                        Interrupt Service Routines                    *
+ *******************************************************************************/
+/**
+ * @brief  EEPROM ready ISR, programs the next byte that differs
+ * @return Void
+ */
+ISR(EE_RDY_vect) {
+  EepromCallback_t pfDone;
+
+  while (eeprom_remaining > 0) {
+    uint8 u8Value = *eeprom_data;
+    uint16 u16Address = eeprom_address;
+    eeprom_data++;
+    eeprom_address++;
+    eeprom_remaining--;
+    if (EEPROM_u8ReadRaw(u16Address) != u8Value) {
+      EEDR = u8Value;
+      /* EEWE must follow EEMWE within four cycles */
+      SET_BIT(EECR, EEMWE);
+      SET_BIT(EECR, EEWE);
+      return; /* next byte on the next EE_RDY */
+    }
+  }
+
+  CLR_BIT(EECR, EERIE);
+  pfDone = eeprom_done;
+  eeprom_busy = 0;
+  if (pfDone != NULL) {
+    pfDone();
+  }
+}
\ No newline at end of file
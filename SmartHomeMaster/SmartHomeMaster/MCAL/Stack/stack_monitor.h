@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Module: Stack
+ * File Name: stack_monitor.h
+ * Description: Header file for the stack painting and high-water mark
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef MCAL_STACK_STACK_MONITOR_H_
+#define MCAL_STACK_STACK_MONITOR_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../../LIB/STD_Types.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Fill byte of the free RAM between the static data and the stack */
+#define STACK_CANARY (uint8)0xC5
+
+/* Lowest bytes of the free RAM the stack should never reach. STACK_vCheck
+   only tests the top STACK_CHECK_SIZE bytes of this zone, so the tick stays
+   short; the stack grows down through them before it reaches the rest */
+#define STACK_GUARD_SIZE (uint16)64
+#define STACK_CHECK_SIZE (uint8)4
+
+/* 1 checks the guard zone from the tick handler */
+#ifndef STACK_CHECK_ENABLE
+#define STACK_CHECK_ENABLE 1
+#endif
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  Stack use since reset, in bytes
+ */
+typedef struct {
+  uint16 u16Size; /* painted RAM, 0 when the image has no painting */
+  uint16 u16Used; /* deepest excursion of the stack */
+  uint8 u8Guard;  /* 1 once the stack reached the guard zone */
+} StackInfo_t;
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Flag the image when the stack reached the guard zone, called from
+ *         the tick handler
+ * @return Void
+ */
+void STACK_vCheck(void);
+
+/**
+ * @brief  Measure the stack high-water mark
+ * @param  pstInfo Receives the measurement
+ * @return Void
+ */
+void STACK_vGet(StackInfo_t *pstInfo);
+
+#endif /* MCAL_STACK_STACK_MONITOR_H_ */
\ No newline at end of file
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Module: SysTick
+ * File Name: systick.c
+ * Description: Source file for the 1 ms system tick service
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "systick.h"
+#include <stddef.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static volatile uint32 systick_millis = 0;
+static SysTickCallback_t systick_callbacks[SYSTICK_MAX_CALLBACKS];
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Timer2 compare match callback, advances the millisecond counter
+ * @return Void
+ */
+static void SYSTICK_vTick(void) {
+  uint8 u8Index;
+  systick_millis++;
+  for (u8Index = 0; u8Index < SYSTICK_MAX_CALLBACKS; u8Index++) {
+    if (systick_callbacks[u8Index] != NULL) {
+      systick_callbacks[u8Index]();
+    }
+  }
+}
+
+/**
+ * @brief  Start the 1 ms tick on Timer2 compare match
+ * @return Void
+ */
+void SYSTICK_vInit(void) {
+  static const Timer_Config_t stTickConfig = {
+      TIMER_MODE_CTC, SYSTICK_CLOCK, SYSTICK_TOP, TIMER_OUTPUT_OFF,
+      TIMER_OUTPUT_OFF, TIMER_CAPTURE_FALLING};
+  (void)TIMER_u8Init(SYSTICK_TIMER, &stTickConfig);
+  (void)TIMER_u8SetCallback(SYSTICK_TIMER, TIMER_EVENT_COMPARE_A,
+                            SYSTICK_vTick);
+}
+
+/**
+ * @brief  Milliseconds since SYSTICK_vInit (wraps after ~49 days)
+ * @return Timestamp in ms
+ */
+uint32 SYSTICK_u32GetMillis(void) {
+  uint32 u32Millis;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { u32Millis = systick_millis; }
+  return u32Millis;
+}
+
+/**
+ * @brief  Build a deadline relative to now
+ * @param  u32Duration Time from now in ms
+ * @return Absolute deadline timestamp
+ */
+uint32 SYSTICK_u32Deadline(uint32 u32Duration) {
+  return SYSTICK_u32GetMillis() + u32Duration;
+}
+
+/**
+ * @brief  Check whether a deadline has passed (wrap safe)
+ * @param  u32Deadline Deadline from SYSTICK_u32Deadline
+ * @return TRUE if expired, FALSE otherwise
+ */
+uint8 SYSTICK_u8IsExpired(uint32 u32Deadline) {
+  return ((sint32)(SYSTICK_u32GetMillis() - u32Deadline) >= 0) ? 1 : 0;
+}
+
+/**
+ * @brief  Check whether a duration elapsed since a timestamp (wrap safe)
+ * @param  u32Start Timestamp from SYSTICK_u32GetMillis
+ * @param  u32Duration Duration in ms
+ * @return TRUE if elapsed, FALSE otherwise
+ */
+uint8 SYSTICK_u8HasElapsed(uint32 u32Start, uint32 u32Duration) {
+  return ((SYSTICK_u32GetMillis() - u32Start) >= u32Duration) ? 1 : 0;
+}
+
+/**
+ * @brief  Register a function to run on every tick
+ * @param  pfCallback Function called from the tick ISR
+ * @return TRUE if registered, FALSE if all slots are used
+ */
+uint8 SYSTICK_u8RegisterCallback(SysTickCallback_t pfCallback) {
+  uint8 u8Index;
+  uint8 u8Registered = 0;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (u8Index = 0; u8Index < SYSTICK_MAX_CALLBACKS; u8Index++) {
+      if ((systick_callbacks[u8Index] == NULL) ||
+          (systick_callbacks[u8Index] == pfCallback)) {
+        systick_callbacks[u8Index] = pfCallback;
+        u8Registered = 1;
+        break;
+      }
+    }
+  }
+  return u8Registered;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Module: SysTick
+ * File Name: systick.h
+ * Description: Header file for the 1 ms system tick service
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef MCAL_TIMER_SYSTICK_H_
+#define MCAL_TIMER_SYSTICK_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../../LIB/STD_Types.h"
+#include "timer_driver.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Buzzer, lockout, trace and stack check, plus room for two more */
+#define SYSTICK_MAX_CALLBACKS (uint8)6
+
+/* Timer2 in CTC mode, 125 counts of clk/64 per millisecond at 8 MHz */
+#define SYSTICK_TIMER TIMER_2
+#define SYSTICK_CLOCK TIMER_CLK_64
+#define SYSTICK_PRESCALER 64UL
+#define SYSTICK_HZ 1000UL
+#define SYSTICK_TOP (uint16)((F_CPU / SYSTICK_PRESCALER / SYSTICK_HZ) - 1)
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/* Called from the tick ISR every millisecond, keep it short */
+typedef void (*SysTickCallback_t)(void);
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Start the 1 ms tick on Timer2 compare match
+ * @return Void
+ */
+void SYSTICK_vInit(void);
+
+/**
+ * @brief  Milliseconds since SYSTICK_vInit (wraps after ~49 days)
+ * @return Timestamp in ms
+ */
+uint32 SYSTICK_u32GetMillis(void);
+
+/**
+ * @brief  Build a deadline relative to now
+ * @param  u32Duration Time from now in ms
+ * @return Absolute deadline timestamp
+ */
+uint32 SYSTICK_u32Deadline(uint32 u32Duration);
+
+/**
+ * @brief  Check whether a deadline has passed (wrap safe)
+ * @param  u32Deadline Deadline from SYSTICK_u32Deadline
+ * @return TRUE if expired, FALSE otherwise
+ */
+uint8 SYSTICK_u8IsExpired(uint32 u32Deadline);
+
+/**
+ * @brief  Check whether a duration elapsed since a timestamp (wrap safe)
+ * @param  u32Start Timestamp from SYSTICK_u32GetMillis
+ * @param  u32Duration Duration in ms
+ * @return TRUE if elapsed, FALSE otherwise
+ */
+uint8 SYSTICK_u8HasElapsed(uint32 u32Start, uint32 u32Duration);
+
+/**
+ * @brief  Register a function to run on every tick
+ * @param  pfCallback Function called from the tick ISR
+ * @return TRUE if registered, FALSE if all slots are used
+ */
+uint8 SYSTICK_u8RegisterCallback(SysTickCallback_t pfCallback);
+
+#endif /* MCAL_TIMER_SYSTICK_H_ */
\ No newline at end of file
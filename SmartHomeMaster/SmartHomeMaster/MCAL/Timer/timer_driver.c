@@ -9,62 +9,319 @@
  *                             Includes                                 *
  *******************************************************************************/
 #include "timer_driver.h"
+#include <stddef.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define TIMER_CS_MASK (uint8)0x07
+#define TIMER_NO_BIT (uint8)0xFF
+#define TIMER_8BIT_TOP (uint16)0xFF
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* CSx2:0 encoding of each TIMER_CLK_x, Timer0 and Timer1 share one table */
+static const uint8 timer_clock_bits[2][8] = {
+    {0, 1, 2, TIMER_NO_BIT, 3, TIMER_NO_BIT, 4, 5}, /* Timer0 / Timer1 */
+    {0, 1, 2, 3, 4, 5, 6, 7}};                      /* Timer2 */
+
+/* TIMSK bit of each event */
+static const uint8 timer_event_bits[TIMER_COUNT][TIMER_EVENT_COUNT] = {
+    {TOIE0, OCIE0, TIMER_NO_BIT, TIMER_NO_BIT},
+    {TOIE1, OCIE1A, OCIE1B, TICIE1},
+    {TOIE2, OCIE2, TIMER_NO_BIT, TIMER_NO_BIT}};
+
+static TimerCallback_t volatile timer_callbacks[TIMER_COUNT]
+                                               [TIMER_EVENT_COUNT];
+
+/* TIMER_MODE_x of each timer, Timer1 fast PWM moves the top to ICR1 */
+static uint8 timer_mode[TIMER_COUNT];
+
+/* CSx2:0 bits of each timer, TIMER_vStart sets them again after a stop */
+static uint8 timer_clock[TIMER_COUNT];
 
 /*******************************************************************************
  *                        Functions Definitions                         *
  *******************************************************************************/
 /**
- * @brief  Initialize Timer0 in CTC Mode
- * @return Void
+ * @brief  Current top of a timer, used to scale duty cycles
+ * @param  u8Timer Timer
+ * @return Top value
  */
-void timer0_initializeCTC(void) {
-  OCR0 = 78;
+static uint16 TIMER_u16GetTop(uint8 u8Timer) {
+  uint16 u16Top = TIMER_8BIT_TOP;
+  if (u8Timer == TIMER_1) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { u16Top = ICR1; }
+  }
+  return u16Top;
+}
 
-  SET_BIT(TCCR0, WGM01);
-  CLR_BIT(TCCR0, WGM00);
+/**
+ * @brief  Configure and start a timer, OCx pins must be set as outputs
+ * @param  u8Timer TIMER_0, TIMER_1 or TIMER_2
+ * @param  pstConfig Configuration
+ * @return 1 on success, 0 if the clock or mode is not valid for the timer
+ */
+uint8 TIMER_u8Init(uint8 u8Timer, const Timer_Config_t *pstConfig) {
+  uint8 u8Clock;
+  uint8 u8Control;
 
-  SET_BIT(TCCR0, CS00);
-  CLR_BIT(TCCR0, CS01);
-  SET_BIT(TCCR0, CS02);
+  if ((u8Timer >= TIMER_COUNT) || (pstConfig->u8Clock > TIMER_CLK_1024) ||
+      (pstConfig->u8Mode > TIMER_MODE_FAST_PWM)) {
+    return 0;
+  }
+  u8Clock = timer_clock_bits[(u8Timer == TIMER_2) ? 1 : 0][pstConfig->u8Clock];
+  if (u8Clock == TIMER_NO_BIT) {
+    return 0;
+  }
+  timer_mode[u8Timer] = pstConfig->u8Mode;
+  timer_clock[u8Timer] = u8Clock;
 
-  sei();
+  switch (u8Timer) {
+  case TIMER_0:
+  case TIMER_2:
+    /* Same TCCR layout: WGMx0 bit 6, COMx1:0 bits 5:4, WGMx1 bit 3 */
+    u8Control = (uint8)((pstConfig->u8OutputA & 0x03) << COM00) | u8Clock;
+    if (pstConfig->u8Mode == TIMER_MODE_CTC) {
+      u8Control |= (1 << WGM01);
+    } else if (pstConfig->u8Mode == TIMER_MODE_FAST_PWM) {
+      u8Control |= (1 << WGM01) | (1 << WGM00);
+    }
+    if (u8Timer == TIMER_0) {
+      OCR0 = (uint8)pstConfig->u16Top;
+      TCNT0 = 0;
+      TCCR0 = u8Control;
+    } else {
+      OCR2 = (uint8)pstConfig->u16Top;
+      TCNT2 = 0;
+      TCCR2 = u8Control;
+    }
+    break;
 
-  SET_BIT(TIMSK, OCIE0);
+  case TIMER_1:
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      TCCR1B = 0; /* stop while reconfiguring */
+      TCNT1 = 0;
+      if (pstConfig->u8Mode == TIMER_MODE_FAST_PWM) {
+        ICR1 = pstConfig->u16Top; /* mode 14 */
+        TCCR1A = (1 << WGM11);
+        u8Control = (1 << WGM13) | (1 << WGM12);
+      } else {
+        OCR1A = pstConfig->u16Top;
+        TCCR1A = 0;
+        u8Control = (pstConfig->u8Mode == TIMER_MODE_CTC) ? (1 << WGM12) : 0;
+      }
+      TCCR1A |= (uint8)(((pstConfig->u8OutputA & 0x03) << COM1A0) |
+                        ((pstConfig->u8OutputB & 0x03) << COM1B0));
+      if (pstConfig->u8CaptureEdge == TIMER_CAPTURE_RISING) {
+        u8Control |= (1 << ICES1);
+      }
+      TCCR1B = u8Control | (1 << ICNC1) | u8Clock;
+    }
+    break;
+  }
+  return 1;
 }
 
 /**
- * @brief  Stop Timer0
+ * @brief  Stop the clock of a timer, its configuration is kept
+ * @param  u8Timer Timer
  * @return Void
  */
-void timer0_stop(void) {
-  CLR_BIT(TCCR0, CS00);
-  CLR_BIT(TCCR0, CS01);
-  CLR_BIT(TCCR0, CS02);
+void TIMER_vStop(uint8 u8Timer) {
+  switch (u8Timer) {
+  case TIMER_0:
+    TCCR0 &= (uint8)~TIMER_CS_MASK;
+    break;
+  case TIMER_1:
+    TCCR1B &= (uint8)~TIMER_CS_MASK;
+    break;
+  case TIMER_2:
+    TCCR2 &= (uint8)~TIMER_CS_MASK;
+    break;
+  }
 }
 
 /**
- * @brief  Initialize Timer0 in Fast PWM Mode
+ * @brief  Restart a stopped timer with the clock of its last TIMER_u8Init,
+ *         the counter goes on from where it stopped
+ * @param  u8Timer Timer
  * @return Void
  */
-void timer_initializefastpwm(void) {
-  OCR0 = 128;
-
-  SET_BIT(TCCR0, WGM00);
-  SET_BIT(TCCR0, WGM01);
+void TIMER_vStart(uint8 u8Timer) {
+  switch (u8Timer) {
+  case TIMER_0:
+    TCCR0 = (TCCR0 & (uint8)~TIMER_CS_MASK) | timer_clock[TIMER_0];
+    break;
+  case TIMER_1:
+    TCCR1B = (TCCR1B & (uint8)~TIMER_CS_MASK) | timer_clock[TIMER_1];
+    break;
+  case TIMER_2:
+    TCCR2 = (TCCR2 & (uint8)~TIMER_CS_MASK) | timer_clock[TIMER_2];
+    break;
+  }
+}
 
-  sei();
+/**
+ * @brief  Set a raw compare value
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u16Value Compare value (8-bit timers use the low byte)
+ * @return Void
+ */
+void TIMER_vSetCompare(uint8 u8Timer, uint8 u8Channel, uint16 u16Value) {
+  switch (u8Timer) {
+  case TIMER_0:
+    OCR0 = (uint8)u16Value;
+    break;
+  case TIMER_1:
+    /* 16-bit writes share the TEMP register with the ISRs */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (u8Channel == TIMER_CHANNEL_B) {
+        OCR1B = u16Value;
+      } else {
+        OCR1A = u16Value;
+      }
+    }
+    break;
+  case TIMER_2:
+    OCR2 = (uint8)u16Value;
+    break;
+  }
+}
 
-  SET_BIT(TCCR0, COM01);
-  SET_BIT(TIMSK, TOIE0);
+/**
+ * @brief  Set the period: CTC top, or ICR1 for Timer1 fast PWM
+ * @param  u8Timer Timer
+ * @param  u16Top Top value in timer ticks
+ * @return Void
+ */
+void TIMER_vSetPeriod(uint8 u8Timer, uint16 u16Top) {
+  if ((u8Timer == TIMER_1) && (timer_mode[TIMER_1] == TIMER_MODE_FAST_PWM)) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ICR1 = u16Top; }
+  } else {
+    TIMER_vSetCompare(u8Timer, TIMER_CHANNEL_A, u16Top);
+  }
+}
 
-  SET_BIT(TCCR0, CS00);
-  CLR_BIT(TCCR0, CS01);
-  SET_BIT(TCCR0, CS02);
+/**
+ * @brief  Set a PWM duty cycle in whole percent of the current top
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u8Percent Duty cycle (0-100)
+ * @return Void
+ */
+void TIMER_vSetDuty(uint8 u8Timer, uint8 u8Channel, uint8 u8Percent) {
+  uint32 u32Compare;
+  if (u8Percent > 100) {
+    u8Percent = 100;
+  }
+  u32Compare = ((uint32)TIMER_u16GetTop(u8Timer) * u8Percent) / 100;
+  TIMER_vSetCompare(u8Timer, u8Channel, (uint16)u32Compare);
 }
 
 /**
- * @brief  Change Duty Cycle of PWM
- * @param  duty Duty cycle percentage (0-100)
+ * @brief  Change the compare output mode of a channel
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u8Output TIMER_OUTPUT_x
  * @return Void
  */
-void change_dutycycle(float64 duty) { OCR0 = (duty / 100) * 256; }
\ No newline at end of file
+void TIMER_vSetOutput(uint8 u8Timer, uint8 u8Channel, uint8 u8Output) {
+  u8Output &= 0x03;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    switch (u8Timer) {
+    case TIMER_0:
+      TCCR0 = (TCCR0 & (uint8)~(0x03 << COM00)) | (uint8)(u8Output << COM00);
+      break;
+    case TIMER_1:
+      if (u8Channel == TIMER_CHANNEL_B) {
+        TCCR1A = (TCCR1A & (uint8)~(0x03 << COM1B0)) |
+                 (uint8)(u8Output << COM1B0);
+      } else {
+        TCCR1A = (TCCR1A & (uint8)~(0x03 << COM1A0)) |
+                 (uint8)(u8Output << COM1A0);
+      }
+      break;
+    case TIMER_2:
+      TCCR2 = (TCCR2 & (uint8)~(0x03 << COM20)) | (uint8)(u8Output << COM20);
+      break;
+    }
+  }
+}
+
+/**
+ * @brief  Read the counter
+ * @param  u8Timer Timer
+ * @return Counter value
+ */
+uint16 TIMER_u16GetCount(uint8 u8Timer) {
+  uint16 u16Count = 0;
+  switch (u8Timer) {
+  case TIMER_0:
+    u16Count = TCNT0;
+    break;
+  case TIMER_1:
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { u16Count = TCNT1; }
+    break;
+  case TIMER_2:
+    u16Count = TCNT2;
+    break;
+  }
+  return u16Count;
+}
+
+/**
+ * @brief  Read the last input capture of Timer1
+ * @return ICR1
+ */
+uint16 TIMER_u16GetCapture(void) {
+  uint16 u16Capture;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { u16Capture = ICR1; }
+  return u16Capture;
+}
+
+/**
+ * @brief  Register an event callback and enable its interrupt, global
+ *         interrupts are left to the caller (sei)
+ * @param  u8Timer Timer
+ * @param  u8Event TIMER_EVENT_x
+ * @param  pfCallback Function called from the ISR, NULL disables the event
+ * @return 1 on success, 0 if the timer has no such event
+ */
+uint8 TIMER_u8SetCallback(uint8 u8Timer, uint8 u8Event,
+                          TimerCallback_t pfCallback) {
+  uint8 u8Bit;
+  if ((u8Timer >= TIMER_COUNT) || (u8Event >= TIMER_EVENT_COUNT)) {
+    return 0;
+  }
+  u8Bit = timer_event_bits[u8Timer][u8Event];
+  if (u8Bit == TIMER_NO_BIT) {
+    return 0;
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    timer_callbacks[u8Timer][u8Event] = pfCallback;
+    if (pfCallback != NULL) {
+      SET_BIT(TIMSK, u8Bit);
+    } else {
+      CLR_BIT(TIMSK, u8Bit);
+    }
+  }
+  return 1;
+}
+
+/*******************************************************************************
+ *                        Interrupt Service Routines                    *
+ *******************************************************************************/
+/* Interrupts are only enabled for events that have a callback */
+ISR(TIMER0_OVF_vect) { timer_callbacks[TIMER_0][TIMER_EVENT_OVERFLOW](); }
+ISR(TIMER0_COMP_vect) { timer_callbacks[TIMER_0][TIMER_EVENT_COMPARE_A](); }
+ISR(TIMER1_OVF_vect) { timer_callbacks[TIMER_1][TIMER_EVENT_OVERFLOW](); }
+ISR(TIMER1_COMPA_vect) { timer_callbacks[TIMER_1][TIMER_EVENT_COMPARE_A](); }
+ISR(TIMER1_COMPB_vect) { timer_callbacks[TIMER_1][TIMER_EVENT_COMPARE_B](); }
+ISR(TIMER1_CAPT_vect) { timer_callbacks[TIMER_1][TIMER_EVENT_CAPTURE](); }
+ISR(TIMER2_OVF_vect) { timer_callbacks[TIMER_2][TIMER_EVENT_OVERFLOW](); }
+ISR(TIMER2_COMP_vect) { timer_callbacks[TIMER_2][TIMER_EVENT_COMPARE_A](); }
\ No newline at end of file
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Module: Trace
+ * File Name: trace.h
+ * Description: Header file for the binary event trace ring
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef MCAL_TRACE_TRACE_H_
+#define MCAL_TRACE_TRACE_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../../LIB/STD_Types.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* 1 records the TRACE_EMIT events, 0 compiles them out */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+/* Records kept in RAM, a power of two. The oldest one is overwritten */
+#define TRACE_DEPTH (uint8)32
+
+/* Event ids, the same on both nodes and in smarthome_trace */
+#define TRACE_BOOT (uint8)0x01    /* a0: MCUCSR reset flags */
+#define TRACE_LINK_TX (uint8)0x02 /* master, a0: command, a1: reply or value */
+#define TRACE_LINK_RX (uint8)0x03 /* slave, a0: command, a1: reply or value */
+#define TRACE_KEY (uint8)0x04     /* a0: key, a1: 1 pressed, 0 released */
+#define TRACE_LOGIN (uint8)0x05   /* a0: login mode, a1: 1 when blocked */
+#define TRACE_TIMEOUT (uint8)0x06 /* a0: TRACE_TIMEOUT_x */
+#define TRACE_LOCKOUT (uint8)0x07 /* a0: 1 start, 0 end, a1: lockout count */
+#define TRACE_CLIMATE (uint8)0x08 /* a0: temperature, a1: TRACE_OUT_x bits */
+#define TRACE_FAN (uint8)0x09     /* a0: duty percent, a1: 1 in blower mode */
+
+#define TRACE_TIMEOUT_SESSION (uint8)0 /* keypad inactivity */
+#define TRACE_TIMEOUT_LINK (uint8)1    /* no telemetry, a1: 0 lost 1 back */
+
+#define TRACE_OUT_HEATER (uint8)0x01
+#define TRACE_OUT_AC (uint8)0x02
+#define TRACE_OUT_FAN (uint8)0x04
+
+/* No reply byte */
+#define TRACE_NONE (uint8)0xFF
+
+#if TRACE_ENABLE
+#define TRACE_EMIT(u8Event, u8Arg0, u8Arg1)                                    \
+  TRACE_vEmit((u8Event), (uint8)(u8Arg0), (uint8)(u8Arg1))
+#else
+#define TRACE_EMIT(u8Event, u8Arg0, u8Arg1)
+#endif
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  One event, 5 bytes
+ */
+typedef struct {
+  uint16 u16Time; /* node ticks, wraps */
+  uint8 u8Event;  /* TRACE_x */
+  uint8 u8Arg0;
+  uint8 u8Arg1;
+} TraceRecord_t;
+
+/**
+ * @brief  State of the ring, taken when a dump starts
+ */
+typedef struct {
+  uint16 u16TickUs; /* length of a tick, 0 when tracing is compiled out */
+  uint16 u16Now;    /* tick count at the snapshot */
+  uint16 u16Total;  /* records written since the last clear, wraps */
+  uint8 u8Count;    /* records held, oldest first */
+} TraceInfo_t;
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Clear the ring and record TRACE_BOOT with the reset flags
+ * @param  u16TickUs Period of TRACE_vTick in microseconds
+ * @return Void
+ */
+void TRACE_vInit(uint16 u16TickUs);
+
+/**
+ * @brief  Advance the trace clock, called from the node's tick interrupt
+ * @return Void
+ */
+void TRACE_vTick(void);
+
+/**
+ * @brief  Read the trace clock
+ * @return Ticks since boot, wraps
+ */
+uint16 TRACE_u16Now(void);
+
+/**
+ * @brief  Append one record, safe from any context including ISRs
+ * @param  u8Event TRACE_x
+ * @param  u8Arg0 First argument
+ * @param  u8Arg1 Second argument
+ * @return Void
+ */
+void TRACE_vEmit(uint8 u8Event, uint8 u8Arg0, uint8 u8Arg1);
+
+/**
+ * @brief  Stop recording and take the state of the ring for a dump.
+ *         Events emitted until TRACE_vResume are dropped
+ * @param  pstInfo Receives the state
+ * @return Void
+ */
+void TRACE_vFreeze(TraceInfo_t *pstInfo);
+
+/**
+ * @brief  Read a record of a frozen ring
+ * @param  u8Index 0 for the oldest, up to u8Count - 1
+ * @param  pstRecord Receives the record
+ * @return Void
+ */
+void TRACE_vGet(uint8 u8Index, TraceRecord_t *pstRecord);
+
+/**
+ * @brief  Record again after a dump
+ * @return Void
+ */
+void TRACE_vResume(void);
+
+/**
+ * @brief  Drop every record
+ * @return Void
+ */
+void TRACE_vClear(void);
+
+#endif /* MCAL_TRACE_TRACE_H_ */
\ No newline at end of file
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Module: UART
+ * File Name: UART.c
+ * Description: Source file for the interrupt driven USART driver
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "UART.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define UART_RX_MASK (uint8)(UART_RX_BUFFER_SIZE - 1)
+#define UART_TX_MASK (uint8)(UART_TX_BUFFER_SIZE - 1)
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Each index has a single writer: head in the producer, tail in the consumer */
+static uint8 uart_rx_buffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 uart_rx_head = 0;
+static volatile uint8 uart_rx_tail = 0;
+static volatile uint8 uart_rx_overruns = 0;
+
+static uint8 uart_tx_buffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 uart_tx_head = 0;
+static volatile uint8 uart_tx_tail = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Initialize the USART, 8N1, RX and TX interrupts
+ * @param  u16Ubrr Baud rate register value, see UART_UBRR
+ * @return Void
+ */
+void UART_vInit(uint16 u16Ubrr) {
+  UBRRH = (uint8)(u16Ubrr >> 8);
+  UBRRL = (uint8)u16Ubrr;
+  UCSRA = (1 << U2X);
+  UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0); /* 8 data, 1 stop */
+  UCSRB = (1 << RXEN) | (1 << TXEN) | (1 << RXCIE);
+}
+
+/**
+ * @brief  Take one received byte (never waits)
+ * @param  pu8Byte Destination of the byte
+ * @return 1 if a byte was read, 0 if the RX ring is empty
+ */
+uint8 UART_u8Receive(uint8 *pu8Byte) {
+  uint8 u8Tail = uart_rx_tail;
+  if (u8Tail == uart_rx_head) {
+    return 0;
+  }
+  *pu8Byte = uart_rx_buffer[u8Tail];
+  uart_rx_tail = (uint8)((u8Tail + 1) & UART_RX_MASK);
+  return 1;
+}
+
+/**
+ * @brief  Queue one byte, waits only while the TX ring is full
+ * @param  u8Byte Byte to send
+ * @return Void
+ */
+void UART_vSendByte(uint8 u8Byte) {
+  uint8 u8Next = (uint8)((uart_tx_head + 1) & UART_TX_MASK);
+  while (u8Next == uart_tx_tail) {
+    /* full: the UDRE interrupt frees one slot every ~87 us */
+  }
+  uart_tx_buffer[uart_tx_head] = u8Byte;
+  uart_tx_head = u8Next;
+  SET_BIT(UCSRB, UDRIE);
+}
+
+/**
+ * @brief  Queue a RAM string
+ * @param  pcString Null terminated string
+ * @return Void
+ */
+void UART_vSendString(const char *pcString) {
+  while (*pcString != '\0') {
+    UART_vSendByte((uint8)*pcString);
+    pcString++;
+  }
+}
+
+/**
+ * @brief  Queue a flash string
+ * @param  pcString Null terminated string in program memory
+ * @return Void
+ */
+void UART_vSendString_P(const char *pcString) {
+  char cChar = (char)pgm_read_byte(pcString);
+  while (cChar != '\0') {
+    UART_vSendByte((uint8)cChar);
+    pcString++;
+    cChar = (char)pgm_read_byte(pcString);
+  }
+}
+
+/**
+ * @brief  Free space of the TX ring
+ * @return Bytes that can be queued without waiting
+ */
+uint8 UART_u8TxFree(void) {
+  return (uint8)((uart_tx_tail - uart_tx_head - 1) & UART_TX_MASK);
+}
+
+/**
+ * @brief  Number of received bytes dropped because the RX ring was full
+ * @return Overrun count (saturates at 255)
+ */
+uint8 UART_u8GetOverruns(void) { return uart_rx_overruns; }
+
+/*******************************************************************************
+ *                        Interrupt Service Routines                    *
+ *******************************************************************************/
+/**
+ * @brief  Receive complete ISR, stores the byte or counts an overrun
+ * @return Void
+ */
+ISR(USART_RXC_vect) {
+  uint8 u8Byte = UDR; /* always read, clears RXC */
+  uint8 u8Next = (uint8)((uart_rx_head + 1) & UART_RX_MASK);
+  if (u8Next != uart_rx_tail) {
+    uart_rx_buffer[uart_rx_head] = u8Byte;
+    uart_rx_head = u8Next;
+  } else if (uart_rx_overruns < 0xFF) {
+    uart_rx_overruns++;
+  }
+}
+
+/**
+ * @brief  Data register empty ISR, sends the next queued byte
+ * @return Void
+ */
+ISR(USART_UDRE_vect) {
+  uint8 u8Tail = uart_tx_tail;
+  if (u8Tail == uart_tx_head) {
+    CLR_BIT(UCSRB, UDRIE); /* nothing left */
+    return;
+  }
+  UDR = uart_tx_buffer[u8Tail];
+  uart_tx_tail = (uint8)((u8Tail + 1) & UART_TX_MASK);
+}
\ No newline at end of file
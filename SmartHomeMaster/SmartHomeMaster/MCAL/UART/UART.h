@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Module: UART
+ * File Name: UART.h
+ * Description: Header file for the interrupt driven USART driver
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef MCAL_UART_UART_H_
+#define MCAL_UART_UART_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../../LIB/STD_Types.h"
+#include "../../LIB/std_macros.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Ring sizes must be powers of two (index wrap by mask) */
+#define UART_RX_BUFFER_SIZE (uint8)32
+#define UART_TX_BUFFER_SIZE (uint8)64
+
+/* Double speed mode, rounded to the nearest divisor */
+#define UART_UBRR_VALUE(baud) (((F_CPU + 4UL * (baud)) / (8UL * (baud))) - 1)
+#define UART_UBRR(baud) (uint16)UART_UBRR_VALUE(baud)
+
+/* Baud rate error of UART_UBRR in 0.1 % steps, usable in #if. The receiver
+ * tolerates about 1.5 %, e.g. 38400 at 8 MHz is 2 (0.2 %) but 115200 is 35
+ * and needs a 7.3728 or 14.7456 MHz crystal. */
+#define UART_BAUD_ACTUAL(baud) (F_CPU / (8UL * (UART_UBRR_VALUE(baud) + 1)))
+#define UART_BAUD_ERROR(baud)                                                  \
+  (((UART_BAUD_ACTUAL(baud) > (baud)) ? (UART_BAUD_ACTUAL(baud) - (baud))      \
+                                      : ((baud) - UART_BAUD_ACTUAL(baud))) *   \
+   1000UL / (baud))
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Initialize the USART, 8N1, RX and TX interrupts
+ * @param  u16Ubrr Baud rate register value, see UART_UBRR
+ * @return Void
+ */
+void UART_vInit(uint16 u16Ubrr);
+
+/**
+ * @brief  Take one received byte (never waits)
+ * @param  pu8Byte Destination of the byte
+ * @return 1 if a byte was read, 0 if the RX ring is empty
+ */
+uint8 UART_u8Receive(uint8 *pu8Byte);
+
+/**
+ * @brief  Queue one byte, waits only while the TX ring is full
+ * @param  u8Byte Byte to send
+ * @return Void
+ */
+void UART_vSendByte(uint8 u8Byte);
+
+/**
+ * @brief  Queue a RAM string
+ * @param  pcString Null terminated string
+ * @return Void
+ */
+void UART_vSendString(const char *pcString);
+
+/**
+ * @brief  Queue a flash string
+ * @param  pcString Null terminated string in program memory
+ * @return Void
+ */
+void UART_vSendString_P(const char *pcString);
+
+/**
+ * @brief  Free space of the TX ring
+ * @return Bytes that can be queued without waiting
+ */
+uint8 UART_u8TxFree(void);
+
+/**
+ * @brief  Number of received bytes dropped because the RX ring was full
+ * @return Overrun count (saturates at 255)
+ */
+uint8 UART_u8GetOverruns(void);
+
+#endif /* MCAL_UART_UART_H_ */
\ No newline at end of file
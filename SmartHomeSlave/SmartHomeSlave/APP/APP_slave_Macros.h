@@ -33,4 +33,8 @@
 #define ROOM3_PORT (uint8)'D'
 #define ROOM4_PORT (uint8)'D'
 
+/* The four room LEDs share PD4-PD7 and are driven as one group */
+#define ROOMS_PORT (uint8)'D'
+#define ROOMS_MASK DIO_GROUP_MASK(ROOM1_PIN, 4)
+
 #endif /* APP_APP_SLAVE_MACROS_H_ */
\ No newline at end of file
@@ -8,24 +8,38 @@
  *                             Includes                                 *
  *******************************************************************************/
 #include "../HAL/LED/LED.h"
+#include "../HAL/NVM/nvm.h"
 #include "../LIB/STD_MESSAGES.h"
 #include "../LIB/std_macros.h"
 #include "../MCAL/ADC/ADC_driver.h"
 #include "../MCAL/DIO/DIO.h"
 #include "../MCAL/SPI/SPI.h"
+#include "../MCAL/Stack/stack_monitor.h"
+#include "../MCAL/Timer/isr_profile.h"
 #include "../MCAL/Timer/timer_driver.h"
+#include "../MCAL/Trace/trace.h"
 #include "APP_slave_Macros.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <util/atomic.h>
 
 /*******************************************************************************
  *                        Function Prototypes                           *
  *******************************************************************************/
-uint16 ADC_u16ReadChannel_Custom(uint8 channel);
 void vFanSetPositive(void);
 void vFanSetNegative(void);
 void vFanStop(void);
 void vSystemInit(void);
+void vSendTelemetry(void);
+void vSendIsrProfile(void);
+void vSendStackInfo(void);
+void vSendTrace(void);
+void vSettingsLoad(void);
+void vSettingsSave(void);
+static void vControlTick(void);
+#if TRACE_ENABLE
+static void vTraceClimate(void);
+#endif
 
 /*******************************************************************************
  *                             Definitions                              *
@@ -37,29 +51,52 @@ void vSystemInit(void);
 #define FALSE 0
 #endif
 
-/* Command Macros */
-#define BLOWER_TURN_ON 0x50
-#define BLOWER_TURN_OFF 0x51
-#define GET_LDR_STATUS 0x52
-
 /* Hardware Definitions */
 #define FAN_PORT PORTB
-#define FAN_DDR DDRB
 #define FAN_EN_PIN 0
 #define FAN_IN1_PIN 1
 #define FAN_IN2_PIN 2
+#define FAN_DIO_PORT (uint8)'B'
+#define FAN_DIR_MASK (uint8)((1 << FAN_IN1_PIN) | (1 << FAN_IN2_PIN))
+#define FAN_MASK (uint8)((1 << FAN_EN_PIN) | FAN_DIR_MASK)
 
 #define HEATER_PORT PORTD
-#define HEATER_DDR DDRD
 #define HEATER_PIN 1
+#define HEATER_DIO_PORT (uint8)'D'
+
+/* AC LED and heater are switched off together, in one PORTD write */
+#define CLIMATE_MASK (uint8)((1 << AIR_COND_PIN) | (1 << HEATER_PIN))
 
 #define LDR_CHANNEL 1
 #define TEMP_CHANNEL 0
 
-/* Logic Constants */
+/* Timer0 overflow period, 256 counts of clk/64 at 8 MHz */
+#define CONTROL_TICK_US (uint16)2048
+
+/* Settings record kept in EEPROM, bump the version when it changes */
+#define SETTINGS_VERSION (uint8)1
+
+typedef struct {
+  uint8 u8SetPoint;
+} Settings_t;
+
+/* Logic Constants, the climate thresholds can be set from the build */
 #define LDR_THRESHOLD 512
-#define MAX_TEMP 40
-#define MIN_FAN_TEMP 30
+#ifndef HEATER_ON_TEMP
+#define HEATER_ON_TEMP 10 /* heater on below */
+#endif
+#ifndef AC_ON_TEMP
+#define AC_ON_TEMP 25 /* AC on above, off below the set point */
+#endif
+#ifndef MIN_FAN_TEMP
+#define MIN_FAN_TEMP 30 /* auto fan on above */
+#endif
+#ifndef MAX_TEMP
+#define MAX_TEMP 40 /* full fan speed */
+#endif
+#ifndef FAN_GAIN
+#define FAN_GAIN 10 /* duty percent per degree above MIN_FAN_TEMP */
+#endif
 
 volatile uint16 required_temperature = 24;
 volatile uint16 temp_sensor_reading = 0;
@@ -75,31 +112,18 @@ volatile uint8 blower_mode = FALSE;
 */
 volatile uint8 auto_climate_active = TRUE;
 
+/* Reported in telemetry until the master acknowledges it */
+volatile uint8 boot_flag = TRUE;
+
 /*******************************************************************************
  *                        Functions Definitions                         *
  *******************************************************************************/
-/**
- * @brief  Custom ADC Read with Channel Selection
- * @param  channel ADC Channel
- * @return ADC Value
- */
-uint16 ADC_u16ReadChannel_Custom(uint8 channel) {
-  ADMUX &= 0xE0;
-  ADMUX |= (channel & 0x1F);
-  ADCSRA |= (1 << ADSC);
-  while ((ADCSRA & (1 << ADIF)) == 0)
-    ;
-  ADCSRA |= (1 << ADIF);
-  return ADC;
-}
-
 /**
  * @brief  Set Fan Direction Positive
  * @return Void
  */
 void vFanSetPositive(void) {
-  FAN_PORT |= (1 << FAN_IN1_PIN);
-  FAN_PORT &= ~(1 << FAN_IN2_PIN);
+  DIO_vWriteGroup(FAN_DIO_PORT, FAN_DIR_MASK, (1 << FAN_IN1_PIN));
 }
 
 /**
@@ -107,8 +131,7 @@ void vFanSetPositive(void) {
  * @return Void
  */
 void vFanSetNegative(void) {
-  FAN_PORT &= ~(1 << FAN_IN1_PIN);
-  FAN_PORT |= (1 << FAN_IN2_PIN);
+  DIO_vWriteGroup(FAN_DIO_PORT, FAN_DIR_MASK, (1 << FAN_IN2_PIN));
 }
 
 /**
@@ -116,34 +139,219 @@ void vFanSetNegative(void) {
  * @return Void
  */
 void vFanStop(void) {
-  FAN_PORT &= ~(1 << FAN_IN1_PIN);
-  FAN_PORT &= ~(1 << FAN_IN2_PIN);
+  DIO_vWriteGroup(FAN_DIO_PORT, FAN_DIR_MASK, 0);
   fan_duty_cycle = 0;
 }
 
+/**
+ * @brief  Restore the AC set point, the default is kept on first boot
+ * @return Void
+ */
+void vSettingsLoad(void) {
+  Settings_t stSettings;
+  if (NVM_u8Load(SETTINGS_VERSION, &stSettings, sizeof(stSettings))) {
+    required_temperature = stSettings.u8SetPoint;
+  }
+}
+
+/**
+ * @brief  Save the AC set point, written in the background
+ * @return Void
+ */
+void vSettingsSave(void) {
+  Settings_t stSettings;
+  stSettings.u8SetPoint = (uint8)required_temperature;
+  (void)NVM_u8Save(SETTINGS_VERSION, &stSettings, sizeof(stSettings));
+}
+
 /**
  * @brief  Initialize Slave System
  * @return Void
  */
 void vSystemInit(void) {
+  TRACE_vInit(CONTROL_TICK_US);
+  vSettingsLoad();
   ADC_vinit();
   SPI_vInitSlave();
 
   LED_vInit(AIR_COND_PORT, AIR_COND_PIN);
   LED_vInit(TV_PORT, TV_PIN);
-  LED_vInit(ROOM1_PORT, ROOM1_PIN);
-  LED_vInit(ROOM2_PORT, ROOM2_PIN);
-  LED_vInit(ROOM3_PORT, ROOM3_PIN);
-  LED_vInit(ROOM4_PORT, ROOM4_PIN);
+  DIO_vSetGroupDir(ROOMS_PORT, ROOMS_MASK, 1);
+
+  DIO_vSetGroupDir(FAN_DIO_PORT, FAN_MASK, 1);
+  DIO_vSetPinDir(HEATER_DIO_PORT, HEATER_PIN, 1);
 
-  FAN_DDR |= (1 << FAN_EN_PIN) | (1 << FAN_IN1_PIN) | (1 << FAN_IN2_PIN);
-  HEATER_DDR |= (1 << HEATER_PIN);
+  PROFILE_vInit(); /* Timer1, only with ISR_PROFILE_ENABLE */
 
-  TCCR0 = (1 << CS01) | (1 << CS00);
-  TIMSK |= (1 << TOIE0);
+  /* Free running Timer0 at clk/64, the overflow paces PWM and sensors */
+  static const Timer_Config_t stTickConfig = {
+      TIMER_MODE_NORMAL, TIMER_CLK_64,     0,
+      TIMER_OUTPUT_OFF,  TIMER_OUTPUT_OFF, TIMER_CAPTURE_FALLING};
+  (void)TIMER_u8Init(TIMER_0, &stTickConfig);
+  (void)TIMER_u8SetCallback(TIMER_0, TIMER_EVENT_OVERFLOW, vControlTick);
   sei();
 }
 
+/**
+ * @brief  Answer GET_TELEMETRY with a consistent snapshot of the climate state
+ * @return Void
+ */
+void vSendTelemetry(void) {
+  uint8 au8Frame[TELEMETRY_SIZE];
+  uint8 u8Index;
+  uint8 u8Sum = 0;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    au8Frame[TELEMETRY_TEMPERATURE] = (uint8)temp_sensor_reading;
+    au8Frame[TELEMETRY_SET_POINT] = (uint8)required_temperature;
+    au8Frame[TELEMETRY_FAN_DUTY] = fan_duty_cycle;
+    au8Frame[TELEMETRY_FLAGS] =
+        (LED_u8ReadStatus(AIR_COND_PORT, AIR_COND_PIN) ? TELEMETRY_FLAG_AC
+                                                        : 0) |
+        ((HEATER_PORT & (1 << HEATER_PIN)) ? TELEMETRY_FLAG_HEATER : 0) |
+        ((ldr_reading > LDR_THRESHOLD) ? TELEMETRY_FLAG_DAY : 0) |
+        (auto_climate_active ? TELEMETRY_FLAG_AUTO : 0) |
+        (blower_mode ? TELEMETRY_FLAG_BLOWER : 0) |
+        (boot_flag ? TELEMETRY_FLAG_BOOT : 0);
+    au8Frame[TELEMETRY_DEVICES] =
+        (LED_u8ReadStatus(ROOM1_PORT, ROOM1_PIN)
+             ? TELEMETRY_DEVICE_BIT(ROOM1_STATUS)
+             : 0) |
+        (LED_u8ReadStatus(ROOM2_PORT, ROOM2_PIN)
+             ? TELEMETRY_DEVICE_BIT(ROOM2_STATUS)
+             : 0) |
+        (LED_u8ReadStatus(ROOM3_PORT, ROOM3_PIN)
+             ? TELEMETRY_DEVICE_BIT(ROOM3_STATUS)
+             : 0) |
+        (LED_u8ReadStatus(ROOM4_PORT, ROOM4_PIN)
+             ? TELEMETRY_DEVICE_BIT(ROOM4_STATUS)
+             : 0) |
+        (LED_u8ReadStatus(TV_PORT, TV_PIN) ? TELEMETRY_DEVICE_BIT(TV_STATUS)
+                                           : 0) |
+        (LED_u8ReadStatus(AIR_COND_PORT, AIR_COND_PIN)
+             ? TELEMETRY_DEVICE_BIT(AIR_COND_STATUS)
+             : 0);
+  }
+  for (u8Index = 0; u8Index < TELEMETRY_CHECKSUM; u8Index++) {
+    u8Sum += au8Frame[u8Index];
+  }
+  au8Frame[TELEMETRY_CHECKSUM] = (uint8)~u8Sum;
+
+  /* The master clocks the frame out with DEFAULT_ACK bytes */
+  for (u8Index = 0; u8Index < TELEMETRY_SIZE; u8Index++) {
+    SPI_ui8TransmitRecive(au8Frame[u8Index]);
+  }
+}
+
+/**
+ * @brief  Answer GET_ISR_PROFILE with the statistics of the profiled ISRs
+ * @return Void
+ */
+void vSendIsrProfile(void) {
+  IsrProfile_t stProfile;
+  uint8 au8Record[ISR_RECORD_SIZE];
+  uint8 u8Records = ISR_PROFILE_ENABLE ? PROFILE_COUNT : 0;
+  uint8 u8Isr;
+  uint8 u8Index;
+  uint8 u8Sum = u8Records;
+
+  SPI_ui8TransmitRecive(u8Records);
+  for (u8Isr = 0; u8Isr < u8Records; u8Isr++) {
+    PROFILE_vGet(u8Isr, &stProfile);
+    au8Record[ISR_RECORD_COUNT] = (uint8)stProfile.u16Count;
+    au8Record[ISR_RECORD_COUNT + 1] = (uint8)(stProfile.u16Count >> 8);
+    au8Record[ISR_RECORD_MIN] = (uint8)stProfile.u16Min;
+    au8Record[ISR_RECORD_MIN + 1] = (uint8)(stProfile.u16Min >> 8);
+    au8Record[ISR_RECORD_MAX] = (uint8)stProfile.u16Max;
+    au8Record[ISR_RECORD_MAX + 1] = (uint8)(stProfile.u16Max >> 8);
+    au8Record[ISR_RECORD_MEAN] = (uint8)stProfile.u16Mean;
+    au8Record[ISR_RECORD_MEAN + 1] = (uint8)(stProfile.u16Mean >> 8);
+    au8Record[ISR_RECORD_LOAD] = (uint8)stProfile.u16Load;
+    au8Record[ISR_RECORD_LOAD + 1] = (uint8)(stProfile.u16Load >> 8);
+    for (u8Index = 0; u8Index < ISR_RECORD_SIZE; u8Index++) {
+      SPI_ui8TransmitRecive(au8Record[u8Index]);
+      u8Sum += au8Record[u8Index];
+    }
+  }
+  SPI_ui8TransmitRecive((uint8)~u8Sum);
+}
+
+/**
+ * @brief  Answer GET_STACK_INFO with the stack high-water mark
+ * @return Void
+ */
+void vSendStackInfo(void) {
+  StackInfo_t stInfo;
+  uint8 au8Frame[STACK_FRAME_LENGTH];
+  uint8 u8Index;
+  uint8 u8Sum = 0;
+
+  STACK_vGet(&stInfo);
+  au8Frame[STACK_FRAME_SIZE] = (uint8)stInfo.u16Size;
+  au8Frame[STACK_FRAME_SIZE + 1] = (uint8)(stInfo.u16Size >> 8);
+  au8Frame[STACK_FRAME_USED] = (uint8)stInfo.u16Used;
+  au8Frame[STACK_FRAME_USED + 1] = (uint8)(stInfo.u16Used >> 8);
+  au8Frame[STACK_FRAME_GUARD] = stInfo.u8Guard;
+  for (u8Index = 0; u8Index < STACK_FRAME_CHECKSUM; u8Index++) {
+    u8Sum += au8Frame[u8Index];
+  }
+  au8Frame[STACK_FRAME_CHECKSUM] = (uint8)~u8Sum;
+
+  for (u8Index = 0; u8Index < STACK_FRAME_LENGTH; u8Index++) {
+    SPI_ui8TransmitRecive(au8Frame[u8Index]);
+  }
+}
+
+/**
+ * @brief  Send bytes of a reply frame and add them to its checksum
+ * @param  pu8Bytes Bytes to send
+ * @param  u8Length Number of bytes
+ * @param  u8Sum Sum of the bytes sent before
+ * @return Sum including these bytes
+ */
+static uint8 u8SendBytes(const uint8 *pu8Bytes, uint8 u8Length, uint8 u8Sum) {
+  uint8 u8Index;
+  for (u8Index = 0; u8Index < u8Length; u8Index++) {
+    SPI_ui8TransmitRecive(pu8Bytes[u8Index]);
+    u8Sum += pu8Bytes[u8Index];
+  }
+  return u8Sum;
+}
+
+/**
+ * @brief  Answer GET_TRACE with the trace ring, oldest record first
+ * @return Void
+ */
+void vSendTrace(void) {
+  TraceInfo_t stInfo;
+  TraceRecord_t stRecord;
+  uint8 au8Bytes[TRACE_HEADER_SIZE];
+  uint8 u8Index;
+  uint8 u8Sum;
+
+  TRACE_vFreeze(&stInfo); /* the ring stays put while it is clocked out */
+  au8Bytes[TRACE_HEADER_TICK_US] = (uint8)stInfo.u16TickUs;
+  au8Bytes[TRACE_HEADER_TICK_US + 1] = (uint8)(stInfo.u16TickUs >> 8);
+  au8Bytes[TRACE_HEADER_NOW] = (uint8)stInfo.u16Now;
+  au8Bytes[TRACE_HEADER_NOW + 1] = (uint8)(stInfo.u16Now >> 8);
+  au8Bytes[TRACE_HEADER_TOTAL] = (uint8)stInfo.u16Total;
+  au8Bytes[TRACE_HEADER_TOTAL + 1] = (uint8)(stInfo.u16Total >> 8);
+  au8Bytes[TRACE_HEADER_COUNT] = stInfo.u8Count;
+  u8Sum = u8SendBytes(au8Bytes, TRACE_HEADER_SIZE, 0);
+
+  for (u8Index = 0; u8Index < stInfo.u8Count; u8Index++) {
+    TRACE_vGet(u8Index, &stRecord);
+    au8Bytes[TRACE_RECORD_TIME] = (uint8)stRecord.u16Time;
+    au8Bytes[TRACE_RECORD_TIME + 1] = (uint8)(stRecord.u16Time >> 8);
+    au8Bytes[TRACE_RECORD_EVENT] = stRecord.u8Event;
+    au8Bytes[TRACE_RECORD_ARG0] = stRecord.u8Arg0;
+    au8Bytes[TRACE_RECORD_ARG1] = stRecord.u8Arg1;
+    u8Sum = u8SendBytes(au8Bytes, TRACE_RECORD_SIZE, u8Sum);
+  }
+  TRACE_vResume();
+  SPI_ui8TransmitRecive((uint8)~u8Sum);
+}
+
 /**
  * @brief  Main Function
  * @return Integer
@@ -155,6 +363,7 @@ int main(void) {
 
   while (1) {
     request = SPI_ui8TransmitRecive(DEFAULT_ACK);
+    response = TRACE_NONE; /* reply or value of the command, for the trace */
 
     switch (request) {
     case ROOM1_STATUS:
@@ -224,14 +433,15 @@ int main(void) {
       break;
 
     case AIR_COND_TURN_OFF:
-      auto_climate_active = FALSE;               /* Kill Auto Logic */
-      LED_vTurnOff(AIR_COND_PORT, AIR_COND_PIN); /* AC OFF */
-      HEATER_PORT &= ~(1 << HEATER_PIN);         /* Heater OFF */
+      auto_climate_active = FALSE; /* Kill Auto Logic */
+      DIO_vWriteGroup(HEATER_DIO_PORT, CLIMATE_MASK, 0); /* AC + Heater OFF */
       /* AutoFan stops in ISR next cycle */
       break;
 
     case SET_TEMPERATURE:
       required_temperature = SPI_ui8TransmitRecive(DEFAULT_ACK);
+      response = (uint8)required_temperature;
+      vSettingsSave();
       break;
 
     case BLOWER_TURN_ON:
@@ -246,21 +456,81 @@ int main(void) {
       break;
 
     case GET_LDR_STATUS:
-      ldr_reading = ADC_u16ReadChannel_Custom(LDR_CHANNEL);
       response = (ldr_reading > LDR_THRESHOLD) ? 1 : 0;
       SPI_ui8TransmitRecive(response);
       break;
+
+    case GET_TELEMETRY:
+      vSendTelemetry();
+      break;
+
+    case CLEAR_BOOT_FLAG:
+      boot_flag = FALSE;
+      break;
+
+    case GET_ISR_PROFILE:
+      vSendIsrProfile();
+      break;
+
+    case RESET_ISR_PROFILE:
+      PROFILE_vReset();
+      break;
+
+    case GET_STACK_INFO:
+      vSendStackInfo();
+      break;
+
+    case GET_TRACE:
+      vSendTrace();
+      break;
+
+    case CLEAR_TRACE:
+      TRACE_vClear();
+      break;
+    }
+
+    /* GET_TELEMETRY comes every LINK_CHECK_PERIOD and would flush the ring */
+    if ((request != DEFAULT_ACK) && (request != GET_TELEMETRY)) {
+      TRACE_EMIT(TRACE_LINK_RX, request, response);
     }
   }
 }
 
+#if TRACE_ENABLE
 /**
- * @brief  Timer0 Overflow ISR for PWM and Sensor Logic
+ * @brief  Trace the climate outputs and the fan duty when they changed,
+ *         called from the control tick after the sensor logic
  * @return Void
  */
-ISR(TIMER0_OVF_vect) {
+static void vTraceClimate(void) {
+  static uint8 trace_outputs = 0;
+  static uint8 trace_duty = 0;
+  uint8 u8Outputs =
+      ((HEATER_PORT & (1 << HEATER_PIN)) ? TRACE_OUT_HEATER : 0) |
+      (LED_u8ReadStatus(AIR_COND_PORT, AIR_COND_PIN) ? TRACE_OUT_AC : 0) |
+      ((fan_duty_cycle != 0) ? TRACE_OUT_FAN : 0);
+
+  if (u8Outputs != trace_outputs) {
+    trace_outputs = u8Outputs;
+    TRACE_EMIT(TRACE_CLIMATE, temp_sensor_reading, u8Outputs);
+  }
+  if (fan_duty_cycle != trace_duty) {
+    trace_duty = fan_duty_cycle;
+    TRACE_EMIT(TRACE_FAN, fan_duty_cycle, blower_mode);
+  }
+}
+#endif
+
+/**
+ * @brief  Timer0 overflow callback for PWM and Sensor Logic
+ * @return Void
+ */
+static void vControlTick(void) {
   static uint8 pwm_counter = 0;
   static uint8 temp_check_tick = 0;
+  uint16 u16Duty;
+
+  TRACE_vTick();
 
   /* 1. Soft PWM Generation */
   pwm_counter++;
@@ -271,24 +541,32 @@ ISR(TIMER0_OVF_vect) {
   else
     FAN_PORT &= ~(1 << FAN_EN_PIN);
 
+#if STACK_CHECK_ENABLE
+  /* Stack guard, the flag is read with GET_STACK_INFO */
+  STACK_vCheck();
+#endif
+
   /* 2. Sensor Logic (Every ~150 ticks) */
   temp_check_tick++;
   if (temp_check_tick >= 150) {
     temp_check_tick = 0;
 
+    /* The ADC is only used here, so main never races the ISR for ADMUX */
+    ldr_reading = ADC_u16ReadChannel_Custom(LDR_CHANNEL);
+
     /* ONLY Run Logic if System is Enabled */
     if (auto_climate_active == TRUE) {
       temp_sensor_reading = (0.25 * ADC_u16ReadChannel_Custom(TEMP_CHANNEL));
 
       /* --- HEATER LOGIC (< 10 C) --- */
-      if (temp_sensor_reading < 10) {
+      if (temp_sensor_reading < HEATER_ON_TEMP) {
         HEATER_PORT |= (1 << HEATER_PIN);
       } else {
         HEATER_PORT &= ~(1 << HEATER_PIN);
       }
 
       /* --- AC LOGIC (> 25 C) --- */
-      if (temp_sensor_reading > 25) {
+      if (temp_sensor_reading > AC_ON_TEMP) {
         LED_vTurnOn(AIR_COND_PORT, AIR_COND_PIN);
       } else if (temp_sensor_reading < required_temperature) {
         LED_vTurnOff(AIR_COND_PORT, AIR_COND_PIN);
@@ -297,12 +575,14 @@ ISR(TIMER0_OVF_vect) {
       /* --- AUTO FAN LOGIC (> 30 C) --- */
       /* Only runs if Manual Blower is NOT active */
       if (blower_mode == FALSE) {
-        if (temp_sensor_reading > 30) {
+        if (temp_sensor_reading > MIN_FAN_TEMP) {
           vFanSetPositive();
-          if (temp_sensor_reading >= MAX_TEMP)
+          /* 16-bit product, a high gain must not wrap the 8-bit duty */
+          u16Duty = (uint16)((temp_sensor_reading - MIN_FAN_TEMP) * FAN_GAIN);
+          if ((temp_sensor_reading >= MAX_TEMP) || (u16Duty > 100))
             fan_duty_cycle = 100;
           else
-            fan_duty_cycle = (temp_sensor_reading - MIN_FAN_TEMP) * 10;
+            fan_duty_cycle = (uint8)u16Duty;
         } else {
           vFanStop();
         }
@@ -310,8 +590,7 @@ ISR(TIMER0_OVF_vect) {
     } else {
       /* SYSTEM DISABLED: FORCE OFF */
       /* This ensures that if you logged out, they STAY off */
-      LED_vTurnOff(AIR_COND_PORT, AIR_COND_PIN);
-      HEATER_PORT &= ~(1 << HEATER_PIN);
+      DIO_vWriteGroup(HEATER_DIO_PORT, CLIMATE_MASK, 0);
 
       /* Fan is Off (Unless Manual Blower Mode is active) */
       /* Blower Mode is handled by BLOWER_TURN_OFF command from Master on Logout
@@ -320,5 +599,8 @@ ISR(TIMER0_OVF_vect) {
         vFanStop();
       }
     }
+#if TRACE_ENABLE
+    vTraceClimate();
+#endif
   }
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Module: NVM
+ * File Name: nvm.c
+ * Description: Source file for the wear-levelled settings record store
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "nvm.h"
+#include <util/atomic.h>
+#include <util/crc16.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint8 nvm_image[NVM_SLOT_SIZE];      /* slot being written */
+static uint8 nvm_payload[NVM_PAYLOAD_SIZE]; /* latest record requested */
+static uint8 nvm_version = NVM_VERSION_ERASED;
+static uint8 nvm_next_slot = 0;
+static uint8 nvm_sequence = 0; /* sequence of the newest slot */
+static volatile uint8 nvm_pending = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  CRC-8 (CCITT) over the slot bytes before the CRC
+ * @param  pu8Slot Slot image
+ * @return CRC value
+ */
+static uint8 NVM_u8Crc(const uint8 *pu8Slot) {
+  uint8 u8Crc = 0;
+  uint8 u8Index;
+  for (u8Index = 0; u8Index < NVM_SLOT_CRC; u8Index++) {
+    u8Crc = _crc8_ccitt_update(u8Crc, pu8Slot[u8Index]);
+  }
+  return u8Crc;
+}
+
+/**
+ * @brief  EEPROM address of a slot
+ * @param  u8Slot Slot index
+ * @return Address of the first byte
+ */
+static uint16 NVM_u16SlotAddress(uint8 u8Slot) {
+  return NVM_BASE_ADDRESS + ((uint16)u8Slot * NVM_SLOT_SIZE);
+}
+
+static void NVM_vWriteDone(void);
+
+/**
+ * @brief  Write the pending record to the next slot
+ * @note   Runs with interrupts disabled, from NVM_u8Save or the EEPROM ISR
+ * @return Void
+ */
+static void NVM_vStartWrite(void) {
+  uint8 u8Index;
+  nvm_image[NVM_SLOT_VERSION] = nvm_version;
+  nvm_image[NVM_SLOT_SEQUENCE] = (uint8)(nvm_sequence + 1);
+  for (u8Index = 0; u8Index < NVM_PAYLOAD_SIZE; u8Index++) {
+    nvm_image[NVM_SLOT_PAYLOAD + u8Index] = nvm_payload[u8Index];
+  }
+  nvm_image[NVM_SLOT_CRC] = NVM_u8Crc(nvm_image);
+
+  if (EEPROM_u8WriteBlock(NVM_u16SlotAddress(nvm_next_slot), nvm_image,
+                          NVM_SLOT_SIZE, NVM_vWriteDone)) {
+    nvm_sequence++;
+    nvm_next_slot = (uint8)((nvm_next_slot + 1) % NVM_SLOT_COUNT);
+    nvm_pending = 0;
+  }
+}
+
+/**
+ * @brief  EEPROM completion callback, chains a save requested meanwhile
+ * @return Void
+ */
+static void NVM_vWriteDone(void) {
+  if (nvm_pending) {
+    NVM_vStartWrite();
+  }
+}
+
+/**
+ * @brief  Find the newest valid record and copy it out
+ * @param  u8Version Record layout version, older layouts are ignored
+ * @param  pvRecord Destination record
+ * @param  u8Size Record size (up to NVM_PAYLOAD_SIZE)
+ * @return 1 if a record was restored, 0 if the caller must use defaults
+ */
+uint8 NVM_u8Load(uint8 u8Version, void *pvRecord, uint8 u8Size) {
+  uint8 au8Sequence[NVM_SLOT_COUNT];
+  uint32 u32Valid = 0;
+  uint8 u8Slot;
+  uint8 u8Next;
+  uint8 u8Newest = NVM_SLOT_COUNT;
+  uint8 u8Index;
+
+  nvm_version = NVM_VERSION_ERASED; /* the first save always writes */
+  nvm_next_slot = 0;
+  nvm_sequence = 0;
+  if (u8Size > NVM_PAYLOAD_SIZE) {
+    return 0;
+  }
+
+  for (u8Slot = 0; u8Slot < NVM_SLOT_COUNT; u8Slot++) {
+    EEPROM_vReadBlock(NVM_u16SlotAddress(u8Slot), nvm_image, NVM_SLOT_SIZE);
+    au8Sequence[u8Slot] = nvm_image[NVM_SLOT_SEQUENCE];
+    if ((nvm_image[NVM_SLOT_VERSION] == u8Version) &&
+        (nvm_image[NVM_SLOT_CRC] == NVM_u8Crc(nvm_image))) {
+      u32Valid |= (uint32)1 << u8Slot;
+    }
+  }
+
+  for (u8Slot = 0; u8Slot < NVM_SLOT_COUNT; u8Slot++) {
+    u8Next = (uint8)((u8Slot + 1) % NVM_SLOT_COUNT);
+    if ((u32Valid & ((uint32)1 << u8Slot)) &&
+        (((u32Valid & ((uint32)1 << u8Next)) == 0) ||
+         (au8Sequence[u8Next] != (uint8)(au8Sequence[u8Slot] + 1)))) {
+      u8Newest = u8Slot;
+      break;
+    }
+  }
+  if (u8Newest == NVM_SLOT_COUNT) {
+    return 0; /* blank, corrupted or older layout */
+  }
+
+  EEPROM_vReadBlock(NVM_u16SlotAddress(u8Newest), nvm_image, NVM_SLOT_SIZE);
+  for (u8Index = 0; u8Index < NVM_PAYLOAD_SIZE; u8Index++) {
+    nvm_payload[u8Index] = nvm_image[NVM_SLOT_PAYLOAD + u8Index];
+  }
+  for (u8Index = 0; u8Index < u8Size; u8Index++) {
+    ((uint8 *)pvRecord)[u8Index] = nvm_payload[u8Index];
+  }
+  nvm_version = u8Version;
+  nvm_sequence = au8Sequence[u8Newest];
+  nvm_next_slot = u8Next;
+  return 1;
+}
+
+/**
+ * @brief  Save a record in the background (returns immediately)
+ * @note   A save requested while the previous one is still being written
+ *         replaces any save that has not started yet. An unchanged record is
+ *         not written again.
+ * @param  u8Version Record layout version
+ * @param  pvRecord Source record
+ * @param  u8Size Record size (up to NVM_PAYLOAD_SIZE)
+ * @return 1 if accepted, 0 if the record does not fit a slot
+ */
+uint8 NVM_u8Save(uint8 u8Version, const void *pvRecord, uint8 u8Size) {
+  const uint8 *pu8Record = (const uint8 *)pvRecord;
+  uint8 u8Changed = (u8Version != nvm_version) ? 1 : 0;
+  uint8 u8Index;
+
+  if (u8Size > NVM_PAYLOAD_SIZE) {
+    return 0;
+  }
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (u8Index = 0; u8Index < NVM_PAYLOAD_SIZE; u8Index++) {
+      uint8 u8Value = (u8Index < u8Size) ? pu8Record[u8Index] : 0;
+      if (nvm_payload[u8Index] != u8Value) {
+        nvm_payload[u8Index] = u8Value;
+        u8Changed = 1;
+      }
+    }
+    if (u8Changed) {
+      nvm_version = u8Version;
+      nvm_pending = 1;
+      if (EEPROM_u8IsBusy() == 0) {
+        NVM_vStartWrite();
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief  Check for a save that is not fully written yet
+ * @return 1 if busy, 0 otherwise
+ */
+uint8 NVM_u8IsBusy(void) {
+  return (nvm_pending || EEPROM_u8IsBusy()) ? 1 : 0;
+}
\ No newline at end of file
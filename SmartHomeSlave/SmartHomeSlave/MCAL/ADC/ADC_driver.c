@@ -42,4 +42,19 @@ uint16 ADC_u16Read(void) {
   read_val = (ADCL);
   read_val |= (ADCH << 8);
   return read_val;
+}
+
+/**
+ * @brief  Custom ADC Read with Channel Selection
+ * @param  channel ADC Channel
+ * @return ADC Value
+ */
+uint16 ADC_u16ReadChannel_Custom(uint8 channel) {
+  ADMUX &= 0xE0;
+  ADMUX |= (channel & 0x1F);
+  ADCSRA |= (1 << ADSC);
+  while ((ADCSRA & (1 << ADIF)) == 0)
+    ;
+  ADCSRA |= (1 << ADIF);
+  return ADC;
 }
\ No newline at end of file
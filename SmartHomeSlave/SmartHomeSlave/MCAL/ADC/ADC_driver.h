@@ -28,4 +28,11 @@ void ADC_vinit(void);
  */
 uint16 ADC_u16Read(void);
 
+/**
+ * @brief  Custom ADC Read with Channel Selection
+ * @param  channel ADC Channel
+ * @return ADC Value
+ */
+uint16 ADC_u16ReadChannel_Custom(uint8 channel);
+
 #endif /* MCAL_ADC_ADC_DRIVER_H_ */
\ No newline at end of file
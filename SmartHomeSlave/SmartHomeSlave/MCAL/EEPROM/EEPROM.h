@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Module: EEPROM
+ * File Name: EEPROM.h
+ * Description: Header file for the internal EEPROM driver
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef MCAL_EEPROM_EEPROM_H_
+#define MCAL_EEPROM_EEPROM_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "../../LIB/STD_Types.h"
+#include "../../LIB/std_macros.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define EEPROM_SIZE (uint16)1024 /* ATmega32 */
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/* Called from the EE_RDY ISR once the last byte of a block is written */
+typedef void (*EepromCallback_t)(void);
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Read one byte, waits for a write in progress
+ * @param  u16Address EEPROM address
+ * @return Byte value
+ */
+uint8 EEPROM_u8ReadByte(uint16 u16Address);
+
+/**
+ * @brief  Read a block, waits for a write in progress
+ * @param  u16Address EEPROM address of the first byte
+ * @param  pu8Data Destination buffer
+ * @param  u8Length Number of bytes
+ * @return Void
+ */
+void EEPROM_vReadBlock(uint16 u16Address, uint8 *pu8Data, uint8 u8Length);
+
+/**
+ * @brief  Start writing a block in the background (returns immediately)
+ * @note   Each byte takes ~8.5 ms and is written from the EE_RDY interrupt.
+ *         Bytes that already hold the value are skipped. The buffer must stay
+ *         valid until the callback runs. Global interrupts must be enabled.
+ * @param  u16Address EEPROM address of the first byte
+ * @param  pu8Data Source buffer
+ * @param  u8Length Number of bytes
+ * @param  pfDone Optional completion callback (ISR context), may be NULL
+ * @return 1 if started, 0 if a write is already in progress
+ */
+uint8 EEPROM_u8WriteBlock(uint16 u16Address, const uint8 *pu8Data,
+                          uint8 u8Length, EepromCallback_t pfDone);
+
+/**
+ * @brief  Check for a background write in progress
+ * @return 1 if busy, 0 otherwise
+ */
+uint8 EEPROM_u8IsBusy(void);
+
+#endif /* MCAL_EEPROM_EEPROM_H_ */
\ No newline at end of file
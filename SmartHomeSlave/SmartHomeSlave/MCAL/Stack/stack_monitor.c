@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Module: Stack
+ * File Name: stack_monitor.c
+ * Description: Source file for the stack painting and high-water mark
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Before main, the RAM from __heap_start (the end of .bss/.noinit, no
+ * malloc is used) up to RAMEND is filled with STACK_CANARY. The stack grows
+ * down from RAMEND and overwrites the fill as it goes, so the canary bytes
+ * left above __heap_start are the RAM the stack never used. A local that
+ * happens to hold the canary value at the deepest point makes the mark at
+ * most that local too shallow.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "stack_monitor.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+extern uint8 __heap_start; /* first byte after the static data, linker */
+
+static volatile uint8 stack_guard = 0; /* sticky */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Paint the free RAM, runs in .init3 once the stack pointer is set
+ *         and before .data/.bss are initialised
+ * @return Void
+ */
+void STACK_vPaint(void) __attribute__((naked, used, section(".init3")));
+void STACK_vPaint(void) {
+  uint8 *pu8Byte = &__heap_start;
+  while (pu8Byte <= (uint8 *)RAMEND) {
+    *pu8Byte = STACK_CANARY;
+    pu8Byte++;
+  }
+}
+
+/**
+ * @brief  Flag the image when the stack reached the guard zone, called from
+ *         the tick handler
+ * @return Void
+ */
+void STACK_vCheck(void) {
+  const uint8 *pu8Byte = &__heap_start + STACK_GUARD_SIZE - STACK_CHECK_SIZE;
+  uint8 u8Index;
+  for (u8Index = 0; u8Index < STACK_CHECK_SIZE; u8Index++) {
+    if (pu8Byte[u8Index] != STACK_CANARY) {
+      stack_guard = 1;
+    }
+  }
+}
+
+/**
+ * @brief  Measure the stack high-water mark
+ * @param  pstInfo Receives the measurement
+ * @return Void
+ */
+void STACK_vGet(StackInfo_t *pstInfo) {
+  const uint8 *pu8Byte = &__heap_start;
+  uint16 u16Size = (uint16)((uint8 *)RAMEND + 1 - &__heap_start);
+  uint16 u16Free = 0;
+
+  /* Only the stack writes here, and it only moves the top of the fill */
+  while ((u16Free < u16Size) && (pu8Byte[u16Free] == STACK_CANARY)) {
+    u16Free++;
+  }
+  pstInfo->u16Size = u16Size;
+  pstInfo->u16Used = u16Size - u16Free;
+  pstInfo->u8Guard = (u16Free < STACK_GUARD_SIZE) ? 1 : stack_guard;
+}
\ No newline at end of file
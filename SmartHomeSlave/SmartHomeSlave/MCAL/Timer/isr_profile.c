@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Module: Timer
+ * File Name: isr_profile.c
+ * Description: Source file for the ISR cycle profiler
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Timer1 runs free at the CPU clock, so one count is one cycle. A profiled
+ * ISR stamps TCNT1 on entry and accounts the difference on exit: the time
+ * of its body plus one stamp, without the vector jump and the register
+ * save/restore of the compiler (about 40 cycles more). The Timer1 overflow
+ * counts the elapsed time that the load is measured against.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "isr_profile.h"
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define PROFILE_NO_MIN (uint16)0xFFFF
+#define PROFILE_MAX_COUNT (uint16)0xFFFF
+#define PROFILE_LOAD_SHIFT 6 /* keeps cycles * 1000 within 32 bits */
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint32 u32Cycles; /* sum over the window */
+  uint16 u16Count;
+  uint16 u16Min;
+  uint16 u16Max;
+} ProfileSlot_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Written by the ISRs, read by main inside an atomic block */
+static ProfileSlot_t profile_slots[PROFILE_COUNT];
+static uint16 profile_wraps = 0; /* Timer1 overflows in the window */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Timer1 overflow callback, ages the window
+ * @return Void
+ */
+static void PROFILE_vWrap(void) {
+  uint8 u8Isr;
+  profile_wraps++;
+  if (profile_wraps >= PROFILE_HALF_LIFE) {
+    profile_wraps /= 2;
+    for (u8Isr = 0; u8Isr < PROFILE_COUNT; u8Isr++) {
+      profile_slots[u8Isr].u32Cycles /= 2;
+      profile_slots[u8Isr].u16Count /= 2;
+    }
+  }
+}
+
+/**
+ * @brief  Clear the statistics of every ISR
+ * @return Void
+ */
+void PROFILE_vReset(void) {
+  uint8 u8Isr;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (u8Isr = 0; u8Isr < PROFILE_COUNT; u8Isr++) {
+      profile_slots[u8Isr].u32Cycles = 0;
+      profile_slots[u8Isr].u16Count = 0;
+      profile_slots[u8Isr].u16Min = PROFILE_NO_MIN;
+      profile_slots[u8Isr].u16Max = 0;
+    }
+    profile_wraps = 0;
+  }
+}
+
+/**
+ * @brief  Start Timer1 at clk/1 as the time base and clear the statistics
+ * @return Void
+ */
+void PROFILE_vInit(void) {
+  static const Timer_Config_t stProfileConfig = {
+      TIMER_MODE_NORMAL, TIMER_CLK_1,      0,
+      TIMER_OUTPUT_OFF,  TIMER_OUTPUT_OFF, TIMER_CAPTURE_FALLING};
+  if (ISR_PROFILE_ENABLE == 0) {
+    return;
+  }
+  PROFILE_vReset();
+  (void)TIMER_u8Init(TIMER_1, &stProfileConfig);
+  (void)TIMER_u8SetCallback(TIMER_1, TIMER_EVENT_OVERFLOW, PROFILE_vWrap);
+}
+
+/**
+ * @brief  Current cycle stamp, called first in a profiled ISR
+ * @return Timer1 count
+ */
+uint16 PROFILE_u16Stamp(void) { return TIMER_u16GetCount(TIMER_1); }
+
+/**
+ * @brief  Account one ISR run, called last in a profiled ISR
+ * @param  u8Isr PROFILE_x
+ * @param  u16Start Stamp taken on entry
+ * @return Void
+ */
+void PROFILE_vRecord(uint8 u8Isr, uint16 u16Start) {
+  ProfileSlot_t *pstSlot = &profile_slots[u8Isr];
+  uint16 u16Cycles = (uint16)(TIMER_u16GetCount(TIMER_1) - u16Start);
+
+  pstSlot->u32Cycles += u16Cycles;
+  if (pstSlot->u16Count < PROFILE_MAX_COUNT) {
+    pstSlot->u16Count++;
+  }
+  if (u16Cycles < pstSlot->u16Min) {
+    pstSlot->u16Min = u16Cycles;
+  }
+  if (u16Cycles > pstSlot->u16Max) {
+    pstSlot->u16Max = u16Cycles;
+  }
+}
+
+/**
+ * @brief  Snapshot of the statistics of one ISR
+ * @param  u8Isr PROFILE_x
+ * @param  pstProfile Receives the statistics
+ * @return Void
+ */
+void PROFILE_vGet(uint8 u8Isr, IsrProfile_t *pstProfile) {
+  ProfileSlot_t stSlot;
+  uint32 u32Elapsed;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    stSlot = profile_slots[u8Isr];
+    u32Elapsed = ((uint32)profile_wraps << 16) | TIMER_u16GetCount(TIMER_1);
+  }
+  u32Elapsed >>= PROFILE_LOAD_SHIFT;
+
+  pstProfile->u16Count = stSlot.u16Count;
+  pstProfile->u16Min = (stSlot.u16Min == PROFILE_NO_MIN) ? 0 : stSlot.u16Min;
+  pstProfile->u16Max = stSlot.u16Max;
+  pstProfile->u16Mean =
+      (stSlot.u16Count > 0) ? (uint16)(stSlot.u32Cycles / stSlot.u16Count) : 0;
+  pstProfile->u16Load =
+      (u32Elapsed > 0)
+          ? (uint16)(((stSlot.u32Cycles >> PROFILE_LOAD_SHIFT) * 1000) /
+                     u32Elapsed)
+          : 0;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Module: Timer
+ * File Name: isr_profile.h
+ * Description: Header file for the ISR cycle profiler
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef MCAL_TIMER_ISR_PROFILE_H_
+#define MCAL_TIMER_ISR_PROFILE_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "timer_driver.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* 1 stamps the profiled ISRs against Timer1, which is then reserved */
+#ifndef ISR_PROFILE_ENABLE
+#define ISR_PROFILE_ENABLE 0
+#endif
+
+/* Profiled ISRs */
+#define PROFILE_TIMER0_OVF (uint8)0 /* control tick, 488 Hz */
+#define PROFILE_EE_RDY (uint8)1     /* EEPROM byte programming */
+#define PROFILE_COUNT (uint8)2
+
+/* Sums are halved every PROFILE_HALF_LIFE Timer1 wraps (about 8.4 s), so
+   the mean and the load follow the last few seconds */
+#define PROFILE_HALF_LIFE (uint16)1024
+
+#if ISR_PROFILE_ENABLE
+/* First and last statements of a profiled ISR body */
+#define PROFILE_ENTER() uint16 u16ProfileStart = PROFILE_u16Stamp()
+#define PROFILE_LEAVE(u8Isr) PROFILE_vRecord((u8Isr), u16ProfileStart)
+#else
+#define PROFILE_ENTER()
+#define PROFILE_LEAVE(u8Isr)
+#endif
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/**
+ * @brief  Statistics of one ISR, in CPU cycles
+ */
+typedef struct {
+  uint16 u16Count; /* runs in the current window */
+  uint16 u16Min;   /* since the last reset, 0 before the first run */
+  uint16 u16Max;
+  uint16 u16Mean;
+  uint16 u16Load; /* share of the CPU in per mille */
+} IsrProfile_t;
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Start Timer1 at clk/1 as the time base and clear the statistics
+ * @return Void
+ */
+void PROFILE_vInit(void);
+
+/**
+ * @brief  Clear the statistics of every ISR
+ * @return Void
+ */
+void PROFILE_vReset(void);
+
+/**
+ * @brief  Current cycle stamp, called first in a profiled ISR
+ * @return Timer1 count
+ */
+uint16 PROFILE_u16Stamp(void);
+
+/**
+ * @brief  Account one ISR run, called last in a profiled ISR
+ * @param  u8Isr PROFILE_x
+ * @param  u16Start Stamp taken on entry
+ * @return Void
+ */
+void PROFILE_vRecord(uint8 u8Isr, uint16 u16Start);
+
+/**
+ * @brief  Snapshot of the statistics of one ISR
+ * @param  u8Isr PROFILE_x
+ * @param  pstProfile Receives the statistics
+ * @return Void
+ */
+void PROFILE_vGet(uint8 u8Isr, IsrProfile_t *pstProfile);
+
+#endif /* MCAL_TIMER_ISR_PROFILE_H_ */
\ No newline at end of file
@@ -16,32 +16,152 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Timers */
+#define TIMER_0 (uint8)0 /* 8-bit, OC0 = PB3 */
+#define TIMER_1 (uint8)1 /* 16-bit, OC1A = PD5, OC1B = PD4, ICP1 = PD6 */
+#define TIMER_2 (uint8)2 /* 8-bit, OC2 = PD7 */
+#define TIMER_COUNT (uint8)3
+
+/* Waveform modes */
+#define TIMER_MODE_NORMAL (uint8)0
+#define TIMER_MODE_CTC (uint8)1      /* top = u16Top (OCR0/OCR1A/OCR2) */
+#define TIMER_MODE_FAST_PWM (uint8)2 /* top = 0xFF, Timer1: top = ICR1 */
+
+/* Clock sources, not every prescaler exists on every timer */
+#define TIMER_CLK_STOP (uint8)0
+#define TIMER_CLK_1 (uint8)1
+#define TIMER_CLK_8 (uint8)2
+#define TIMER_CLK_32 (uint8)3 /* Timer2 only */
+#define TIMER_CLK_64 (uint8)4
+#define TIMER_CLK_128 (uint8)5 /* Timer2 only */
+#define TIMER_CLK_256 (uint8)6
+#define TIMER_CLK_1024 (uint8)7
+
+/* Compare output modes (COMx1:COMx0), CLEAR is non-inverting in PWM mode */
+#define TIMER_OUTPUT_OFF (uint8)0
+#define TIMER_OUTPUT_TOGGLE (uint8)1
+#define TIMER_OUTPUT_CLEAR (uint8)2
+#define TIMER_OUTPUT_SET (uint8)3
+
+/* Compare channels, B exists on Timer1 only */
+#define TIMER_CHANNEL_A (uint8)0
+#define TIMER_CHANNEL_B (uint8)1
+
+/* Input capture edge (Timer1 only) */
+#define TIMER_CAPTURE_FALLING (uint8)0
+#define TIMER_CAPTURE_RISING (uint8)1
+
+/* Interrupt events */
+#define TIMER_EVENT_OVERFLOW (uint8)0
+#define TIMER_EVENT_COMPARE_A (uint8)1
+#define TIMER_EVENT_COMPARE_B (uint8)2 /* Timer1 only */
+#define TIMER_EVENT_CAPTURE (uint8)3   /* Timer1 only */
+#define TIMER_EVENT_COUNT (uint8)4
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/* Called from the timer ISR, keep it short */
+typedef void (*TimerCallback_t)(void);
+
+/**
+ * @brief  Configuration of one timer
+ */
+typedef struct {
+  uint8 u8Mode;        /* TIMER_MODE_x */
+  uint8 u8Clock;       /* TIMER_CLK_x */
+  uint16 u16Top;       /* CTC compare value, or ICR1 in Timer1 fast PWM */
+  uint8 u8OutputA;     /* TIMER_OUTPUT_x on OC0 / OC1A / OC2 */
+  uint8 u8OutputB;     /* TIMER_OUTPUT_x on OC1B (Timer1 only) */
+  uint8 u8CaptureEdge; /* TIMER_CAPTURE_x (Timer1 only) */
+} Timer_Config_t;
+
 /*******************************************************************************
  *                    Software Interfaces Declarations                  *
  *******************************************************************************/
 /**
- * @brief  Initialize Timer0 in CTC Mode
+ * @brief  Configure and start a timer, OCx pins must be set as outputs
+ * @param  u8Timer TIMER_0, TIMER_1 or TIMER_2
+ * @param  pstConfig Configuration
+ * @return 1 on success, 0 if the clock or mode is not valid for the timer
+ */
+uint8 TIMER_u8Init(uint8 u8Timer, const Timer_Config_t *pstConfig);
+
+/**
+ * @brief  Stop the clock of a timer, its configuration is kept
+ * @param  u8Timer Timer
  * @return Void
  */
-void timer0_initializeCTC(void);
+void TIMER_vStop(uint8 u8Timer);
 
 /**
- * @brief  Stop Timer0
+ * @brief  Restart a stopped timer with the clock of its last TIMER_u8Init,
+ *         the counter goes on from where it stopped
+ * @param  u8Timer Timer
  * @return Void
  */
-void timer0_stop(void);
+void TIMER_vStart(uint8 u8Timer);
 
 /**
- * @brief  Initialize Timer0 in Fast PWM Mode
+ * @brief  Set a raw compare value
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u16Value Compare value (8-bit timers use the low byte)
  * @return Void
  */
-void timer_initializefastpwm(void);
+void TIMER_vSetCompare(uint8 u8Timer, uint8 u8Channel, uint16 u16Value);
 
 /**
- * @brief  Change Duty Cycle of PWM
- * @param  duty Duty cycle percentage (0-100)
+ * @brief  Set the period: CTC top, or ICR1 for Timer1 fast PWM
+ * @param  u8Timer Timer
+ * @param  u16Top Top value in timer ticks
  * @return Void
  */
-void change_dutycycle(float64 duty);
+void TIMER_vSetPeriod(uint8 u8Timer, uint16 u16Top);
+
+/**
+ * @brief  Set a PWM duty cycle in whole percent of the current top
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u8Percent Duty cycle (0-100)
+ * @return Void
+ */
+void TIMER_vSetDuty(uint8 u8Timer, uint8 u8Channel, uint8 u8Percent);
+
+/**
+ * @brief  Change the compare output mode of a channel
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u8Output TIMER_OUTPUT_x
+ * @return Void
+ */
+void TIMER_vSetOutput(uint8 u8Timer, uint8 u8Channel, uint8 u8Output);
+
+/**
+ * @brief  Read the counter
+ * @param  u8Timer Timer
+ * @return Counter value
+ */
+uint16 TIMER_u16GetCount(uint8 u8Timer);
+
+/**
+ * @brief  Read the last input capture of Timer1
+ * @return ICR1
+ */
+uint16 TIMER_u16GetCapture(void);
+
+/**
+ * @brief  Register an event callback and enable its interrupt, global
+ *         interrupts are left to the caller (sei)
+ * @param  u8Timer Timer
+ * @param  u8Event TIMER_EVENT_x
+ * @param  pfCallback Function called from the ISR, NULL disables the event
+ * @return 1 on success, 0 if the timer has no such event
+ */
+uint8 TIMER_u8SetCallback(uint8 u8Timer, uint8 u8Event,
+                          TimerCallback_t pfCallback);
 
 #endif /* MCAL_TIMER_TIMER_DRIVER_H_ */
\ No newline at end of file
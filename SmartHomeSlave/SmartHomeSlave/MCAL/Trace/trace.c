@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Module: Trace
+ * File Name: trace.c
+ * Description: Source file for the binary event trace ring
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * The ring holds the last TRACE_DEPTH events. Each one is stamped with a
+ * 16-bit tick count that the node advances from its tick interrupt, so an
+ * emit is a handful of loads and stores with the interrupts off. A dump
+ * freezes the ring, reads it oldest first and resumes; the reader rebuilds
+ * absolute times backwards from the snapshot's tick count, which holds as
+ * long as consecutive events are less than 65536 ticks apart.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "trace.h"
+#include <avr/io.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define TRACE_INDEX_MASK (uint8)(TRACE_DEPTH - 1)
+
+/* PORF, EXTRF, BORF, WDRF and JTRF of MCUCSR */
+#define TRACE_RESET_FLAGS (uint8)0x1F
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static TraceRecord_t trace_ring[TRACE_ENABLE ? TRACE_DEPTH : 1];
+static volatile uint16 trace_clock = 0;
+static uint16 trace_tick_us = 0;
+static uint16 trace_total = 0;
+static uint8 trace_head = 0; /* next slot written */
+static uint8 trace_count = 0;
+static volatile uint8 trace_frozen = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Clear the ring and record TRACE_BOOT with the reset flags
+ * @param  u16TickUs Period of TRACE_vTick in microseconds
+ * @return Void
+ */
+void TRACE_vInit(uint16 u16TickUs) {
+  trace_tick_us = u16TickUs;
+  TRACE_vClear();
+#if TRACE_ENABLE
+  TRACE_vEmit(TRACE_BOOT, MCUCSR & TRACE_RESET_FLAGS, 0);
+  /* Writing 0 clears a flag, so the next reset reports only its own cause */
+  MCUCSR &= (uint8)~TRACE_RESET_FLAGS;
+#endif
+}
+
+/**
+ * @brief  Advance the trace clock, called from the node's tick interrupt
+ * @return Void
+ */
+void TRACE_vTick(void) { trace_clock++; }
+
+/**
+ * @brief  Read the trace clock
+ * @return Ticks since boot, wraps
+ */
+uint16 TRACE_u16Now(void) {
+  uint16 u16Now;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { u16Now = trace_clock; }
+  return u16Now;
+}
+
+/**
+ * @brief  Append one record, safe from any context including ISRs
+ * @param  u8Event TRACE_x
+ * @param  u8Arg0 First argument
+ * @param  u8Arg1 Second argument
+ * @return Void
+ */
+void TRACE_vEmit(uint8 u8Event, uint8 u8Arg0, uint8 u8Arg1) {
+  TraceRecord_t *pstRecord;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (trace_frozen == 0) {
+      pstRecord = &trace_ring[trace_head];
+      pstRecord->u16Time = trace_clock;
+      pstRecord->u8Event = u8Event;
+      pstRecord->u8Arg0 = u8Arg0;
+      pstRecord->u8Arg1 = u8Arg1;
+      trace_head = (trace_head + 1) & TRACE_INDEX_MASK;
+      if (trace_count < TRACE_DEPTH) {
+        trace_count++;
+      }
+      trace_total++;
+    }
+  }
+}
+
+/**
+ * @brief  Stop recording and take the state of the ring for a dump.
+ *         Events emitted until TRACE_vResume are dropped
+ * @param  pstInfo Receives the state
+ * @return Void
+ */
+void TRACE_vFreeze(TraceInfo_t *pstInfo) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    trace_frozen = 1;
+    pstInfo->u16Now = trace_clock;
+  }
+  pstInfo->u16TickUs = TRACE_ENABLE ? trace_tick_us : 0;
+  pstInfo->u16Total = trace_total;
+  pstInfo->u8Count = trace_count;
+}
+
+/**
+ * @brief  Read a record of a frozen ring
+ * @param  u8Index 0 for the oldest, up to u8Count - 1
+ * @param  pstRecord Receives the record
+ * @return Void
+ */
+void TRACE_vGet(uint8 u8Index, TraceRecord_t *pstRecord) {
+  uint8 u8Slot = (uint8)(trace_head - trace_count + u8Index);
+  *pstRecord = trace_ring[u8Slot & TRACE_INDEX_MASK];
+}
+
+/**
+ * @brief  Record again after a dump
+ * @return Void
+ */
+void TRACE_vResume(void) { trace_frozen = 0; }
+
+/**
+ * @brief  Drop every record
+ * @return Void
+ */
+void TRACE_vClear(void) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    trace_head = 0;
+    trace_count = 0;
+    trace_total = 0;
+  }
+}
\ No newline at end of file
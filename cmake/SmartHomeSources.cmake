@@ -0,0 +1,46 @@
+# Sources of both firmwares, as listed in the .cproj files.
+#
+# *_PORTABLE_SOURCES only reach the hardware through register macros and
+# build unchanged for the host. *_DRIVER_SOURCES are the MCAL drivers that
+# the host build replaces with simulated ones (host/mcal).
+set(MASTER_DIR ${CMAKE_SOURCE_DIR}/SmartHomeMaster/SmartHomeMaster)
+set(SLAVE_DIR ${CMAKE_SOURCE_DIR}/SmartHomeSlave/SmartHomeSlave)
+
+set(MASTER_PORTABLE_SOURCES
+  ${MASTER_DIR}/APP/background.c
+  ${MASTER_DIR}/APP/console.c
+  ${MASTER_DIR}/APP/lockout.c
+  ${MASTER_DIR}/APP/main.c
+  ${MASTER_DIR}/APP/menu.c
+  ${MASTER_DIR}/APP/menu_screens.c
+  ${MASTER_DIR}/APP/settings.c
+  ${MASTER_DIR}/APP/shadow.c
+  ${MASTER_DIR}/APP/telemetry.c
+  ${MASTER_DIR}/HAL/Buzzer/buzzer.c
+  ${MASTER_DIR}/HAL/Keypad/keypad_driver.c
+  ${MASTER_DIR}/HAL/LCD/LCD.c
+  ${MASTER_DIR}/HAL/LED/LED.c
+  ${MASTER_DIR}/HAL/NVM/nvm.c
+  ${MASTER_DIR}/MCAL/DIO/DIO.c
+  ${MASTER_DIR}/MCAL/Timer/systick.c
+  ${MASTER_DIR}/MCAL/Trace/trace.c)
+set(MASTER_DRIVER_SOURCES
+  ${MASTER_DIR}/MCAL/EEPROM/EEPROM.c
+  ${MASTER_DIR}/MCAL/SPI/SPI.c
+  ${MASTER_DIR}/MCAL/Stack/stack_monitor.c
+  ${MASTER_DIR}/MCAL/Timer/timer_driver.c
+  ${MASTER_DIR}/MCAL/UART/UART.c)
+
+set(SLAVE_PORTABLE_SOURCES
+  ${SLAVE_DIR}/APP/main.c
+  ${SLAVE_DIR}/HAL/LED/LED.c
+  ${SLAVE_DIR}/HAL/NVM/nvm.c
+  ${SLAVE_DIR}/MCAL/ADC/ADC_driver.c
+  ${SLAVE_DIR}/MCAL/DIO/DIO.c
+  ${SLAVE_DIR}/MCAL/Timer/isr_profile.c
+  ${SLAVE_DIR}/MCAL/Trace/trace.c)
+set(SLAVE_DRIVER_SOURCES
+  ${SLAVE_DIR}/MCAL/EEPROM/EEPROM.c
+  ${SLAVE_DIR}/MCAL/SPI/SPI.c
+  ${SLAVE_DIR}/MCAL/Stack/stack_monitor.c
+  ${SLAVE_DIR}/MCAL/Timer/timer_driver.c)
@@ -0,0 +1,31 @@
+# Toolchain file for the ATmega32 images:
+#
+#   cmake -S . -B build-avr -DCMAKE_TOOLCHAIN_FILE=cmake/avr-gcc.cmake
+#
+# The flags match the .cproj files plus the Microchip Studio defaults
+# (section garbage collection): Release is -Os, Debug is -O1 -g2.
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR avr)
+
+set(AVR_MCU atmega32 CACHE STRING "Target device")
+
+set(CMAKE_C_COMPILER avr-gcc)
+set(CMAKE_ASM_COMPILER avr-gcc)
+find_program(CMAKE_OBJCOPY avr-objcopy)
+find_program(AVR_SIZE avr-size)
+find_program(AVR_OBJDUMP avr-objdump)
+find_program(AVR_NM avr-nm)
+
+# No startup files or libc for the test programs of CMake's compiler checks
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+set(CMAKE_C_FLAGS_INIT
+  "-mmcu=${AVR_MCU} -funsigned-char -funsigned-bitfields -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -Wall")
+# Cached so they replace CMake's -O3 / -O0 defaults instead of extending them
+set(CMAKE_C_FLAGS_RELEASE "-Os -DNDEBUG" CACHE STRING "")
+set(CMAKE_C_FLAGS_DEBUG "-O1 -g2 -DDEBUG" CACHE STRING "")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "-mmcu=${AVR_MCU} -Wl,--gc-sections")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
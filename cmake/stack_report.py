@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+# Worst-case stack depth and static RAM of one AVR image.
+#
+#   stack_report.py --elf smarthome_master.elf --objects DIR --budget 2048
+#                   [--objdump avr-objdump] [--nm avr-nm] [--top 5]
+#
+# Frame sizes come from the -fstack-usage files (*.su) next to the objects
+# in DIR, the call graph from the disassembly of the linked image. Every
+# call adds the frame of the callee plus the return address. Functions
+# without a .su file (libgcc, avr-libc) are charged UNKNOWN_FRAME bytes.
+#
+# Indirect calls (icall: callbacks, menu and console tables) cannot be
+# resolved from the code. --gc-sections only keeps functions that are
+# referenced, so a kept function that is never called directly and is not
+# main or a vector has its address taken; an indirect call is charged the
+# deepest of those.
+#
+# The worst case is the deepest path from main plus the deepest vector on
+# top of it. AVR interrupts do not nest unless a vector executes sei, in
+# which case every such vector is stacked as well.
+#
+# The exit code is 1 when .data + .bss + .noinit + worst-case stack exceed
+# the budget, or when the depth is unbounded (recursion, alloca/VLA).
+
+import argparse
+import collections
+import os
+import re
+import subprocess
+import sys
+
+RETURN_ADDRESS = 2  # bytes pushed by call/rcall and by a vector
+UNKNOWN_FRAME = 16
+
+DIRECT = ("call", "rcall")
+TAIL = ("jmp", "rjmp")
+INDIRECT = ("icall", "eicall", "ijmp", "eijmp")
+
+FUNCTION_LINE = re.compile(r"^[0-9a-f]+ <([^>]+)>:$")
+TARGET = re.compile(r"<([^>+]+)(\+0x[0-9a-f]+)?>\s*$")
+VECTOR = re.compile(r"^__vector_\d+$")
+# Startup code and the vector table, not part of any call path
+RUNTIME = re.compile(r"^(__vectors|__ctors_|__dtors_|__init|__do_|__bad_|"
+                     r"__trampolines|_exit|__stop_program|exit|__jumpMain)")
+
+
+def run(tool, *args):
+    return subprocess.run([tool, *args], check=True, stdout=subprocess.PIPE,
+                          universal_newlines=True).stdout
+
+
+def read_frames(objects):
+    """Frame size and qualifier of every compiled function."""
+    frames = {}
+    dynamic = set()
+    for root, _, files in os.walk(objects):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(root, name)) as su:
+                for line in su:
+                    fields = line.rstrip("\n").split("\t")
+                    if len(fields) < 3:
+                        continue
+                    function = fields[0].rsplit(":", 1)[-1]
+                    frames[function] = max(frames.get(function, 0),
+                                           int(fields[1]))
+                    if fields[2] != "static":
+                        dynamic.add(function)
+    return frames, dynamic
+
+
+def read_calls(objdump, elf):
+    """Direct callees, indirect call flag and sei flag per function."""
+    calls = collections.defaultdict(set)
+    indirect = set()
+    enables = set()
+    current = None
+    for line in run(objdump, "-d", elf).splitlines():
+        match = FUNCTION_LINE.match(line)
+        if match:
+            current = match.group(1)
+            calls[current]
+            continue
+        fields = line.split("\t")
+        if current is None or len(fields) < 3:
+            continue
+        mnemonic = (fields[2].split() or [""])[0]
+        if mnemonic in INDIRECT:
+            indirect.add(current)
+        elif mnemonic == "sei":
+            enables.add(current)
+        elif mnemonic in DIRECT or mnemonic in TAIL:
+            target = TARGET.search(line)
+            if target is None or target.group(1) == current:
+                continue
+            # A jump into the middle of a function is a branch, not a call
+            if mnemonic in TAIL and target.group(2):
+                continue
+            calls[current].add(target.group(1))
+    return calls, indirect, enables
+
+
+class Graph:
+    def __init__(self, frames, dynamic, calls, indirect):
+        self.frames = frames
+        self.dynamic = dynamic
+        self.calls = calls
+        self.indirect = indirect
+        self.depth = {}
+        self.path = {}
+        self.active = []  # call stack of the walk
+        self.via = []  # reached through an icall, per entry of active
+        self.unbounded = set()
+        self.cut = set()
+        self.assumed = set()
+        self.targets = []
+
+    def frame(self, function):
+        if function not in self.frames:
+            self.assumed.add(function)
+            return UNKNOWN_FRAME
+        if function in self.dynamic:
+            self.unbounded.add(function)
+        return self.frames[function]
+
+    def walk(self, function, indirect=False):
+        """Deepest stack use of function, its return address excluded.
+
+        indirect tells whether function was reached through an icall. A
+        cycle of direct calls is recursion; a cycle that closes through an
+        icall is most likely a table entry that cannot call itself and is
+        cut, but reported.
+        """
+        if function in self.depth:
+            return self.depth[function]
+        if function in self.active:
+            start = self.active.index(function)
+            if indirect or any(self.via[start + 1:]):
+                self.cut.add(function)
+            else:
+                self.unbounded.add(function)
+            return 0
+        self.active.append(function)
+        self.via.append(indirect)
+        callees = [(c, False) for c in sorted(self.calls.get(function, ()))]
+        if function in self.indirect:
+            callees += [(t, True) for t in self.targets if t != function]
+        deepest, path = 0, []
+        for callee, through in callees:
+            depth = RETURN_ADDRESS + self.walk(callee, through)
+            if depth > deepest:
+                deepest, path = depth, self.path.get(callee, [callee])
+        self.active.pop()
+        self.via.pop()
+        self.depth[function] = self.frame(function) + deepest
+        self.path[function] = [function] + path
+        return self.depth[function]
+
+
+def read_symbols(nm, path):
+    """(name, type, size) of the sized symbols of an object or image."""
+    symbols = []
+    for line in run(nm, "-S", path).splitlines():
+        fields = line.split()
+        if len(fields) == 4:
+            symbols.append((fields[3], fields[2], int(fields[1], 16)))
+    return symbols
+
+
+def read_static(nm, elf):
+    """Bytes of .data, .bss and .noinit from the linker symbols."""
+    marks = {}
+    for line in run(nm, elf).splitlines():
+        fields = line.split()
+        if len(fields) == 3:
+            marks[fields[2]] = int(fields[0], 16)
+
+    def span(start, end):
+        if start in marks and end in marks:
+            return marks[end] - marks[start]
+        return 0
+
+    return (span("__data_start", "__data_end"),
+            span("__bss_start", "__bss_end"),
+            span("__noinit_start", "__noinit_end"))
+
+
+def module_of(objects, path):
+    """APP/menu.c for .../SmartHomeMaster/SmartHomeMaster/APP/menu.c.obj."""
+    module = os.path.relpath(path, objects)
+    module = re.sub(r"\.(obj|o)$", "", module)
+    parts = module.split(os.sep)
+    for index in range(len(parts) - 1):
+        if parts[index] in ("SmartHomeMaster", "SmartHomeSlave") and \
+                parts[index + 1] == parts[index]:
+            return "/".join(parts[index + 2:])
+    return "/".join(parts)
+
+
+def largest_symbols(nm, elf, objects, top):
+    """Largest .data/.bss symbols of every module that made it to the image."""
+    kept = {(name, size) for name, kind, size in read_symbols(nm, elf)
+            if kind in "dDbB"}
+    modules = collections.defaultdict(list)
+    for root, _, files in os.walk(objects):
+        for name in files:
+            if not re.search(r"\.(obj|o)$", name):
+                continue
+            path = os.path.join(root, name)
+            for symbol, kind, size in read_symbols(nm, path):
+                if kind in "dDbB" and (symbol, size) in kept:
+                    modules[module_of(objects, path)].append((size, symbol))
+    report = []
+    for module, symbols in modules.items():
+        symbols.sort(reverse=True)
+        report.append((sum(size for size, _ in symbols), module,
+                       symbols[:top]))
+    report.sort(reverse=True)
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Worst-case stack depth and static RAM of an AVR image")
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--objects", required=True)
+    parser.add_argument("--budget", type=int, default=2048)
+    parser.add_argument("--objdump", default="avr-objdump")
+    parser.add_argument("--nm", default="avr-nm")
+    parser.add_argument("--top", type=int, default=0,
+                        help="list the N largest symbols of every module")
+    args = parser.parse_args()
+
+    frames, dynamic = read_frames(args.objects)
+    calls, indirect, enables = read_calls(args.objdump, args.elf)
+    called = set().union(*calls.values()) if calls else set()
+    vectors = sorted(f for f in calls if VECTOR.match(f))
+    graph = Graph(frames, dynamic, calls, indirect)
+    graph.targets = sorted(f for f in calls
+                           if f not in called and f != "main" and
+                           not VECTOR.match(f) and not RUNTIME.match(f))
+
+    name = os.path.basename(args.elf)
+    main_depth = RETURN_ADDRESS + graph.walk("main")
+    isr_depths = sorted(((RETURN_ADDRESS + graph.walk(v), v) for v in vectors),
+                        reverse=True)
+    isr_depth = isr_depths[0][0] if isr_depths else 0
+    # Vectors that re-enable interrupts can all be stacked on each other
+    nesting = [v for v in vectors if set(graph.path[v]) & enables]
+    if nesting:
+        isr_depth = sum(depth for depth, _ in isr_depths)
+    stack = main_depth + isr_depth
+
+    data, bss, noinit = read_static(args.nm, args.elf)
+    used = data + bss + noinit + stack
+
+    print("%s: RAM budget %d B" % (name, args.budget))
+    print("  static  .data %d + .bss %d + .noinit %d = %d B"
+          % (data, bss, noinit, data + bss + noinit))
+    print("  main    %d B: %s" % (main_depth, " > ".join(graph.path["main"])))
+    if isr_depths:
+        depth, vector = isr_depths[0]
+        print("  isr     %d B: %s" % (depth, " > ".join(graph.path[vector])))
+    if nesting:
+        print("  nested  %s re-enable interrupts, all vectors stacked: %d B"
+              % (", ".join(nesting), isr_depth))
+    if graph.targets:
+        print("  icall   charged the deepest of %d address-taken functions"
+              % len(graph.targets))
+    if graph.cut:
+        print("  cut     icall cycles through %s" % ", ".join(sorted(graph.cut)))
+    if graph.assumed:
+        print("  assumed %d B frames for %s" % (
+            UNKNOWN_FRAME, ", ".join(sorted(graph.assumed))))
+    print("  total   %d B, %d B free" % (used, args.budget - used))
+
+    if args.top > 0:
+        print("  largest .data/.bss per module:")
+        for total, module, symbols in largest_symbols(args.nm, args.elf,
+                                                      args.objects, args.top):
+            print("    %5d  %s" % (total, module))
+            for size, symbol in symbols:
+                print("    %5d    %s" % (size, symbol))
+
+    if graph.unbounded:
+        print("%s: stack depth is unbounded through %s (recursion or "
+              "dynamic frame)" % (name, ", ".join(sorted(graph.unbounded))),
+              file=sys.stderr)
+        return 1
+    if used > args.budget:
+        print("%s: %d B of RAM over the %d B budget"
+              % (name, used - args.budget, args.budget), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,22 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: interrupt.h
+ * Description: Interrupt control for the host build
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <stdint.h>
+
+void SIM_vSei(void);
+void SIM_vCli(void);
+
+#define sei() SIM_vSei()
+#define cli() SIM_vCli()
+
+/* Vectors are plain functions, the fake MCAL calls its handlers directly */
+#define ISR(vector, ...) void vector(void)
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
\ No newline at end of file
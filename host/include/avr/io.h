@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: io.h
+ * Description: ATmega32 register file for the host build
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+/*
+ * Registers are bytes of SIM_au8Io at their ATmega32 I/O address. Plain
+ * registers are ordinary memory. Registers whose value depends on the
+ * outside world (PINx, the ADC) go through an accessor that refreshes the
+ * byte first, so firmware reads see the simulated keypad and sensors.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+#define SIM_IO_SIZE 0x40
+extern volatile uint8_t SIM_au8Io[SIM_IO_SIZE];
+
+volatile uint8_t *SIM_pu8ReadPin(uint8_t u8Address);
+volatile uint8_t *SIM_pu8AdcControl(void);
+uint16_t SIM_u16AdcResult(void);
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define _SFR_IO8(address) (SIM_au8Io[(address)])
+
+#define ADCL ((uint8_t)(SIM_u16AdcResult() & 0xFF))
+#define ADCH ((uint8_t)(SIM_u16AdcResult() >> 8))
+#define ADC SIM_u16AdcResult()
+#define ADCW SIM_u16AdcResult()
+#define ADCSRA (*SIM_pu8AdcControl())
+#define ADMUX _SFR_IO8(0x07)
+#define ACSR _SFR_IO8(0x08)
+#define UBRRL _SFR_IO8(0x09)
+#define UCSRB _SFR_IO8(0x0A)
+#define UCSRA _SFR_IO8(0x0B)
+#define UDR _SFR_IO8(0x0C)
+#define SPCR _SFR_IO8(0x0D)
+#define SPSR _SFR_IO8(0x0E)
+#define SPDR _SFR_IO8(0x0F)
+#define PIND (*SIM_pu8ReadPin(0x10))
+#define DDRD _SFR_IO8(0x11)
+#define PORTD _SFR_IO8(0x12)
+#define PINC (*SIM_pu8ReadPin(0x13))
+#define DDRC _SFR_IO8(0x14)
+#define PORTC _SFR_IO8(0x15)
+#define PINB (*SIM_pu8ReadPin(0x16))
+#define DDRB _SFR_IO8(0x17)
+#define PORTB _SFR_IO8(0x18)
+#define PINA (*SIM_pu8ReadPin(0x19))
+#define DDRA _SFR_IO8(0x1A)
+#define PORTA _SFR_IO8(0x1B)
+#define EECR _SFR_IO8(0x1C)
+#define EEDR _SFR_IO8(0x1D)
+#define UBRRH _SFR_IO8(0x20)
+#define UCSRC _SFR_IO8(0x20)
+#define OCR2 _SFR_IO8(0x23)
+#define TCNT2 _SFR_IO8(0x24)
+#define TCCR2 _SFR_IO8(0x25)
+#define TCCR1B _SFR_IO8(0x2E)
+#define TCCR1A _SFR_IO8(0x2F)
+#define SFIOR _SFR_IO8(0x30)
+#define TCNT0 _SFR_IO8(0x32)
+#define TCCR0 _SFR_IO8(0x33)
+#define MCUCSR _SFR_IO8(0x34)
+#define MCUCR _SFR_IO8(0x35)
+#define TIFR _SFR_IO8(0x38)
+#define TIMSK _SFR_IO8(0x39)
+#define GICR _SFR_IO8(0x3B)
+#define OCR0 _SFR_IO8(0x3C)
+#define SREG _SFR_IO8(0x3F)
+
+/* Port pins */
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PC7 7
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+/* ADMUX */
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+#define MUX4 4
+#define MUX3 3
+#define MUX2 2
+#define MUX1 1
+#define MUX0 0
+
+/* ADCSRA */
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+/* SFIOR */
+#define PUD 2
+
+#define _BV(bit) (1 << (bit))
+
+#endif /* HOST_AVR_IO_H_ */
\ No newline at end of file
@@ -0,0 +1,26 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: atomic.h
+ * Description: ATOMIC_BLOCK for the host build
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_UTIL_ATOMIC_H_
+#define HOST_UTIL_ATOMIC_H_
+
+#include <stdint.h>
+
+uint8_t SIM_u8AtomicEnter(void);
+void SIM_vAtomicLeave(const uint8_t *pu8State);
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+
+/* Same shape as avr-libc: the cleanup runs on every exit from the block */
+#define ATOMIC_BLOCK(type)                                                     \
+  for (uint8_t sim_atomic_state __attribute__((cleanup(SIM_vAtomicLeave))) =  \
+           SIM_u8AtomicEnter(),                                                \
+                        sim_atomic_todo = 1;                                   \
+       sim_atomic_todo; sim_atomic_todo = 0)
+
+#endif /* HOST_UTIL_ATOMIC_H_ */
\ No newline at end of file
@@ -0,0 +1,27 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: crc16.h
+ * Description: avr-libc CRC helpers for the host build
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_UTIL_CRC16_H_
+#define HOST_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+/* CRC-8 CCITT (polynomial 0x07), same result as the avr-libc version */
+static inline uint8_t _crc8_ccitt_update(uint8_t inCrc, uint8_t inData) {
+  uint8_t i;
+  uint8_t data = inCrc ^ inData;
+  for (i = 0; i < 8; i++) {
+    if (data & 0x80) {
+      data = (uint8_t)((data << 1) ^ 0x07);
+    } else {
+      data <<= 1;
+    }
+  }
+  return data;
+}
+
+#endif /* HOST_UTIL_CRC16_H_ */
\ No newline at end of file
@@ -0,0 +1,18 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: delay.h
+ * Description: Busy-wait delays for the host build (advance simulated time)
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+void SIM_vDelayUs(uint32_t u32Microseconds);
+
+#define _delay_ms(ms) SIM_vDelayUs((uint32_t)((ms) * 1000.0))
+#define _delay_us(us) SIM_vDelayUs((uint32_t)(us))
+
+#endif /* HOST_UTIL_DELAY_H_ */
\ No newline at end of file
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: EEPROM.c
+ * Description: EEPROM driver of the host build, optionally file backed
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * The array starts erased (0xFF) or with the contents of the file named by
+ * SIM_EEPROM, and is written back to that file when the run ends. Writes
+ * keep the timing of the real driver: one differing byte per 8.5 ms, then
+ * the callback in interrupt context. Bytes still queued at exit are lost,
+ * as on a power cut.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "MCAL/EEPROM/EEPROM.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define EEPROM_BYTE_TIME_NS (8500 * SIM_NS_PER_US)
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint8 eeprom_memory[EEPROM_SIZE];
+static const char *eeprom_file = NULL;
+
+/* Block being written, owned by the write handler while eeprom_busy is set */
+static volatile uint8 eeprom_busy = 0;
+static uint16 eeprom_address;
+static const uint8 *eeprom_data;
+static uint8 eeprom_remaining;
+static EepromCallback_t eeprom_done;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Write the array back to SIM_EEPROM
+ * @return Void
+ */
+static void EEPROM_vSave(void) {
+  FILE *pFile = fopen(eeprom_file, "wb");
+  if (pFile != NULL) {
+    (void)fwrite(eeprom_memory, 1, EEPROM_SIZE, pFile);
+    fclose(pFile);
+  }
+}
+
+/**
+ * @brief  Load SIM_EEPROM before main, a missing file is a blank part
+ * @return Void
+ */
+__attribute__((constructor)) static void EEPROM_vLoad(void) {
+  FILE *pFile;
+  memset(eeprom_memory, 0xFF, EEPROM_SIZE);
+  eeprom_file = getenv("SIM_EEPROM");
+  if ((eeprom_file == NULL) || (*eeprom_file == '\0')) {
+    return;
+  }
+  pFile = fopen(eeprom_file, "rb");
+  if (pFile != NULL) {
+    (void)fread(eeprom_memory, 1, EEPROM_SIZE, pFile);
+    fclose(pFile);
+  }
+  atexit(EEPROM_vSave);
+}
+
+/**
+ * @brief  Skip the bytes that already hold their value
+ * @return 1 if a byte is left to write, 0 when the block is done
+ */
+static uint8 EEPROM_u8SkipEqual(void) {
+  while ((eeprom_remaining > 0) &&
+         (eeprom_memory[eeprom_address % EEPROM_SIZE] == *eeprom_data)) {
+    eeprom_address++;
+    eeprom_data++;
+    eeprom_remaining--;
+  }
+  return (eeprom_remaining > 0);
+}
+
+/**
+ * @brief  EEPROM ready interrupt: the pending byte is in, start the next
+ * @return Void
+ */
+static void EEPROM_vReady(void) {
+  EepromCallback_t pfDone;
+  if (eeprom_remaining > 0) {
+    eeprom_memory[eeprom_address % EEPROM_SIZE] = *eeprom_data;
+    eeprom_address++;
+    eeprom_data++;
+    eeprom_remaining--;
+  }
+  if (EEPROM_u8SkipEqual()) {
+    SIM_vSchedule(SIM_EVENT_EEPROM, SIM_u64Now() + EEPROM_BYTE_TIME_NS,
+                  EEPROM_vReady);
+    return;
+  }
+  pfDone = eeprom_done;
+  eeprom_busy = 0;
+  if (pfDone != NULL) {
+    pfDone(); /* may start the next block */
+  }
+}
+
+/**
+ * @brief  Read one byte, waits for a write in progress
+ * @param  u16Address EEPROM address
+ * @return Byte value
+ */
+uint8 EEPROM_u8ReadByte(uint16 u16Address) {
+  return eeprom_memory[u16Address % EEPROM_SIZE];
+}
+
+/**
+ * @brief  Read a block, waits for a write in progress
+ * @param  u16Address EEPROM address of the first byte
+ * @param  pu8Data Destination buffer
+ * @param  u8Length Number of bytes
+ * @return Void
+ */
+void EEPROM_vReadBlock(uint16 u16Address, uint8 *pu8Data, uint8 u8Length) {
+  while (u8Length > 0) {
+    *pu8Data = EEPROM_u8ReadByte(u16Address);
+    pu8Data++;
+    u16Address++;
+    u8Length--;
+  }
+}
+
+/**
+ * @brief  Start writing a block in the background (returns immediately)
+ * @param  u16Address EEPROM address of the first byte
+ * @param  pu8Data Source buffer
+ * @param  u8Length Number of bytes
+ * @param  pfDone Optional completion callback (ISR context), may be NULL
+ * @return 1 if started, 0 if a write is already in progress
+ */
+uint8 EEPROM_u8WriteBlock(uint16 u16Address, const uint8 *pu8Data,
+                          uint8 u8Length, EepromCallback_t pfDone) {
+  if ((eeprom_busy != 0) || (u8Length == 0)) {
+    return 0;
+  }
+  eeprom_address = u16Address;
+  eeprom_data = pu8Data;
+  eeprom_remaining = u8Length;
+  eeprom_done = pfDone;
+  eeprom_busy = 1;
+  /* The real ISR also fires once for a block with nothing to change */
+  SIM_vSchedule(SIM_EVENT_EEPROM,
+                SIM_u64Now() + (EEPROM_u8SkipEqual() ? EEPROM_BYTE_TIME_NS : 0),
+                EEPROM_vReady);
+  return 1;
+}
+
+/**
+ * @brief  Check for a background write in progress
+ * @return 1 if busy, 0 otherwise
+ */
+uint8 EEPROM_u8IsBusy(void) { return eeprom_busy; }
\ No newline at end of file
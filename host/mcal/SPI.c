@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: SPI.c
+ * Description: SPI driver of the host build, the link is a socket pair
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * The launcher hands both nodes one end of a socket pair in SIM_SPI_FD.
+ * Each byte the master clocks out is a frame of the master time (8 bytes)
+ * and the data byte, the slave answers with the byte it had loaded. The
+ * slave blocks in SPI_ui8TransmitRecive until the next frame arrives and
+ * catches up to the master time first, so its timer interrupts run in step
+ * with the master. Without a peer the master reads 0xFF (MISO pulled up)
+ * and the slave idles until SIM_TIME_LIMIT_MS, as if no byte ever came.
+ * Both ends log every byte as an SPI event.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "MCAL/SPI/SPI.h"
+#include "sim.h"
+#include "sim_events.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SPI_FRAME_SIZE 9               /* time stamp + data */
+#define SPI_BYTE_TIME_NS (16 * 1000ULL) /* 8 bits at fosc/16 */
+#define SPI_IDLE_BYTE (uint8)0xFF
+#define SPI_IDLE_STEP_NS (10 * SIM_NS_PER_MS) /* slave without a master */
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static int spi_fd = -1;
+static uint8 spi_is_master = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Read or write a whole buffer on the link
+ * @param  u8Write 1 to write, 0 to read
+ * @param  pu8Data Buffer
+ * @param  u8Length Number of bytes
+ * @return 1 on success, 0 if the peer is gone
+ */
+static uint8 SPI_u8Transfer(uint8 u8Write, uint8 *pu8Data, uint8 u8Length) {
+  ssize_t sDone;
+  while (u8Length > 0) {
+    sDone = u8Write ? write(spi_fd, pu8Data, u8Length)
+                    : read(spi_fd, pu8Data, u8Length);
+    if (sDone <= 0) {
+      return 0;
+    }
+    pu8Data += sDone;
+    u8Length = (uint8)(u8Length - sDone);
+  }
+  return 1;
+}
+
+/**
+ * @brief  Initialize SPI as Master
+ * @return Void
+ */
+void SPI_vInitMaster(void) {
+  spi_fd = (int)SIM_s32Env("SIM_SPI_FD", -1);
+  spi_is_master = 1;
+}
+
+/**
+ * @brief  Initialize SPI as Slave
+ * @return Void
+ */
+void SPI_vInitSlave(void) {
+  spi_fd = (int)SIM_s32Env("SIM_SPI_FD", -1);
+  spi_is_master = 0;
+  if ((spi_fd < 0) && (SIM_u8LimitIsFixed() == 0)) {
+    fprintf(stderr, "slave: SIM_SPI_FD and SIM_TIME_LIMIT_MS are not set\n");
+  }
+}
+
+/**
+ * @brief  Transmit and receive a byte via SPI
+ * @param  data Data to transmit
+ * @return Received data
+ */
+uint8 SPI_ui8TransmitRecive(uint8 data) {
+  uint8 au8Frame[SPI_FRAME_SIZE];
+  uint64_t u64Time;
+
+  if (spi_is_master) {
+    SIM_vAdvanceTo(SIM_u64Now() + SPI_BYTE_TIME_NS);
+    if (spi_fd < 0) {
+      return SPI_IDLE_BYTE;
+    }
+    u64Time = SIM_u64Now();
+    memcpy(au8Frame, &u64Time, sizeof(u64Time));
+    au8Frame[SPI_FRAME_SIZE - 1] = data;
+    if ((SPI_u8Transfer(1, au8Frame, SPI_FRAME_SIZE) == 0) ||
+        (SPI_u8Transfer(0, au8Frame, 1) == 0)) {
+      close(spi_fd);
+      spi_fd = -1;
+      return SPI_IDLE_BYTE;
+    }
+    SIM_vEvent(u64Time, NULL, "SPI rx=0x%02x tx=0x%02x", au8Frame[0], data);
+    return au8Frame[0];
+  }
+
+  /* Slave alone: the run ends at the time limit */
+  while ((spi_fd < 0) && (SIM_u8LimitIsFixed() != 0)) {
+    SIM_vAdvanceTo(SIM_u64Now() + SPI_IDLE_STEP_NS);
+  }
+
+  /* Slave: wait for the master to clock the next byte */
+  if ((spi_fd < 0) || (SPI_u8Transfer(0, au8Frame, SPI_FRAME_SIZE) == 0)) {
+    SIM_vFinish(); /* master gone, the run is over */
+  }
+  memcpy(&u64Time, au8Frame, sizeof(u64Time));
+  SIM_vAdvanceTo(u64Time);
+  if (SPI_u8Transfer(1, &data, 1) == 0) {
+    SIM_vFinish();
+  }
+  SIM_vEvent(u64Time, NULL, "SPI rx=0x%02x tx=0x%02x",
+             au8Frame[SPI_FRAME_SIZE - 1], data);
+  return au8Frame[SPI_FRAME_SIZE - 1];
+}
\ No newline at end of file
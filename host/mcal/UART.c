@@ -0,0 +1,130 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: UART.c
+ * Description: UART driver of the host build, backed by files
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Received bytes come from SIM_UART_IN ("-" for stdin) at the line rate of
+ * the configured baud rate, sent bytes go to SIM_UART_OUT (stderr when not
+ * set). Nothing is buffered, so the rings never overrun.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "MCAL/UART/UART.h"
+#include "sim.h"
+#include <avr/pgmspace.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define UART_FRAME_BITS 10ULL /* start + 8 data + stop */
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static int uart_in_fd = -1;
+static FILE *uart_out = NULL;
+static uint64_t uart_byte_time = 0; /* ns per frame */
+static uint64_t uart_rx_next = 0;   /* earliest time of the next byte */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Initialize the USART, 8N1, RX and TX interrupts
+ * @param  u16Ubrr Baud rate register value, see UART_UBRR
+ * @return Void
+ */
+void UART_vInit(uint16 u16Ubrr) {
+  const char *pcIn = getenv("SIM_UART_IN");
+  const char *pcOut = getenv("SIM_UART_OUT");
+
+  /* Double speed mode: baud = F_CPU / (8 * (UBRR + 1)) */
+  uart_byte_time = UART_FRAME_BITS * 8ULL * ((uint64_t)u16Ubrr + 1) *
+                   SIM_NS_PER_CYCLE;
+  uart_rx_next = SIM_u64Now();
+
+  if ((pcIn != NULL) && (strcmp(pcIn, "-") == 0)) {
+    uart_in_fd = STDIN_FILENO;
+    (void)fcntl(uart_in_fd, F_SETFL,
+                fcntl(uart_in_fd, F_GETFL) | O_NONBLOCK);
+  } else if ((pcIn != NULL) && (*pcIn != '\0')) {
+    uart_in_fd = open(pcIn, O_RDONLY | O_NONBLOCK);
+  }
+  uart_out = ((pcOut != NULL) && (*pcOut != '\0')) ? fopen(pcOut, "w") : NULL;
+  if (uart_out == NULL) {
+    uart_out = stderr;
+  }
+}
+
+/**
+ * @brief  Take one received byte (never waits)
+ * @param  pu8Byte Destination of the byte
+ * @return 1 if a byte was read, 0 if the RX ring is empty
+ */
+uint8 UART_u8Receive(uint8 *pu8Byte) {
+  if ((uart_in_fd < 0) || (SIM_u64Now() < uart_rx_next) ||
+      (read(uart_in_fd, pu8Byte, 1) != 1)) {
+    return 0;
+  }
+  uart_rx_next = SIM_u64Now() + uart_byte_time;
+  return 1;
+}
+
+/**
+ * @brief  Queue one byte, waits only while the TX ring is full
+ * @param  u8Byte Byte to send
+ * @return Void
+ */
+void UART_vSendByte(uint8 u8Byte) {
+  if (uart_out != NULL) {
+    (void)fputc(u8Byte, uart_out);
+    if (u8Byte == '\n') {
+      (void)fflush(uart_out);
+    }
+  }
+}
+
+/**
+ * @brief  Queue a RAM string
+ * @param  pcString Null terminated string
+ * @return Void
+ */
+void UART_vSendString(const char *pcString) {
+  while (*pcString != '\0') {
+    UART_vSendByte((uint8)*pcString);
+    pcString++;
+  }
+}
+
+/**
+ * @brief  Queue a flash string
+ * @param  pcString Null terminated string in program memory
+ * @return Void
+ */
+void UART_vSendString_P(const char *pcString) {
+  UART_vSendString(pcString); /* flash is ordinary memory on the host */
+}
+
+/**
+ * @brief  Free space of the TX ring
+ * @return Bytes that can be queued without waiting
+ */
+uint8 UART_u8TxFree(void) {
+  return (uint8)(UART_TX_BUFFER_SIZE - 1); /* bytes leave at once */
+}
+
+/**
+ * @brief  Number of received bytes dropped because the RX ring was full
+ * @return Overrun count (saturates at 255)
+ */
+uint8 UART_u8GetOverruns(void) { return 0; }
\ No newline at end of file
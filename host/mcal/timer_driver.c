@@ -0,0 +1,279 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: timer_driver.c
+ * Description: Timer driver of the host build, events on simulated time
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Only the interrupt timing is modelled: every enabled event of a running
+ * timer fires once per period, the period being the prescaler times the
+ * counter range of the configured mode. Output compare pins are not driven.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "MCAL/Timer/timer_driver.h"
+#include "sim.h"
+#include <avr/interrupt.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define TIMER_8BIT_RANGE 256UL
+#define TIMER_16BIT_RANGE 65536UL
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Prescaler of each TIMER_CLK_x code, 0 where the timer lacks it */
+static const uint16 timer_prescaler[2][TIMER_CLK_1024 + 1] = {
+    {0, 1, 8, 0, 64, 0, 256, 1024},     /* Timer0 / Timer1 */
+    {0, 1, 8, 32, 64, 128, 256, 1024}}; /* Timer2 */
+
+static Timer_Config_t timer_config[TIMER_COUNT];
+static uint16 timer_compare[TIMER_COUNT][2];
+static uint64_t timer_start[TIMER_COUNT];
+static uint8 timer_running[TIMER_COUNT];
+static TimerCallback_t timer_callbacks[TIMER_COUNT][TIMER_EVENT_COUNT];
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Length of one counter tick
+ * @param  u8Timer Timer
+ * @return Tick time in ns
+ */
+static uint64_t TIMER_u64TickNs(uint8 u8Timer) {
+  return SIM_NS_PER_CYCLE *
+         timer_prescaler[(u8Timer == TIMER_2) ? 1 : 0]
+                        [timer_config[u8Timer].u8Clock];
+}
+
+/**
+ * @brief  Counter range of the configured mode
+ * @param  u8Timer Timer
+ * @return Ticks per period
+ */
+static uint32 TIMER_u32Range(uint8 u8Timer) {
+  const Timer_Config_t *pstConfig = &timer_config[u8Timer];
+  if ((pstConfig->u8Mode == TIMER_MODE_CTC) ||
+      ((u8Timer == TIMER_1) && (pstConfig->u8Mode == TIMER_MODE_FAST_PWM))) {
+    return (uint32)pstConfig->u16Top + 1;
+  }
+  return (u8Timer == TIMER_1) ? TIMER_16BIT_RANGE : TIMER_8BIT_RANGE;
+}
+
+static void TIMER_vPeriod(uint8 u8Timer);
+
+/* Interrupt handlers of the three timers */
+static void TIMER_vPeriod0(void) { TIMER_vPeriod(TIMER_0); }
+static void TIMER_vPeriod1(void) { TIMER_vPeriod(TIMER_1); }
+static void TIMER_vPeriod2(void) { TIMER_vPeriod(TIMER_2); }
+
+static const SimHandler_t timer_handlers[TIMER_COUNT] = {
+    TIMER_vPeriod0, TIMER_vPeriod1, TIMER_vPeriod2};
+
+/**
+ * @brief  Arm the next period end, one pending interrupt at most
+ * @param  u8Timer Timer
+ * @return Void
+ */
+static void TIMER_vArm(uint8 u8Timer) {
+  uint64_t u64Period = TIMER_u64TickNs(u8Timer) * TIMER_u32Range(u8Timer);
+  uint64_t u64Elapsed = SIM_u64Now() - timer_start[u8Timer];
+  uint8 u8Event;
+  uint8 u8Enabled = 0;
+
+  for (u8Event = 0; u8Event < TIMER_EVENT_COUNT; u8Event++) {
+    if (timer_callbacks[u8Timer][u8Event] != NULL) {
+      u8Enabled = 1;
+    }
+  }
+  if ((timer_running[u8Timer] == 0) || (u8Enabled == 0) || (u64Period == 0)) {
+    SIM_vCancel(u8Timer);
+    return;
+  }
+  SIM_vSchedule(u8Timer,
+                timer_start[u8Timer] + (u64Elapsed / u64Period + 1) * u64Period,
+                timer_handlers[u8Timer]);
+}
+
+/**
+ * @brief  Period interrupt of a timer, runs the enabled callbacks
+ * @param  u8Timer Timer
+ * @return Void
+ */
+static void TIMER_vPeriod(uint8 u8Timer) {
+  uint8 u8Event;
+  TimerCallback_t pfCallback;
+  for (u8Event = 0; u8Event < TIMER_EVENT_COUNT; u8Event++) {
+    pfCallback = timer_callbacks[u8Timer][u8Event];
+    if ((pfCallback == NULL) || (u8Event == TIMER_EVENT_CAPTURE) ||
+        ((u8Event == TIMER_EVENT_OVERFLOW) &&
+         (timer_config[u8Timer].u8Mode == TIMER_MODE_CTC))) {
+      continue;
+    }
+    pfCallback();
+  }
+  TIMER_vArm(u8Timer);
+}
+
+/**
+ * @brief  Configure and start a timer, OCx pins must be set as outputs
+ * @param  u8Timer TIMER_0, TIMER_1 or TIMER_2
+ * @param  pstConfig Configuration
+ * @return 1 on success, 0 if the clock or mode is not valid for the timer
+ */
+uint8 TIMER_u8Init(uint8 u8Timer, const Timer_Config_t *pstConfig) {
+  if ((u8Timer >= TIMER_COUNT) || (pstConfig->u8Clock > TIMER_CLK_1024) ||
+      (pstConfig->u8Mode > TIMER_MODE_FAST_PWM) ||
+      ((pstConfig->u8Clock != TIMER_CLK_STOP) &&
+       (timer_prescaler[(u8Timer == TIMER_2) ? 1 : 0][pstConfig->u8Clock] ==
+        0))) {
+    return 0;
+  }
+  timer_config[u8Timer] = *pstConfig;
+  timer_compare[u8Timer][TIMER_CHANNEL_A] = pstConfig->u16Top;
+  timer_start[u8Timer] = SIM_u64Now();
+  timer_running[u8Timer] = (pstConfig->u8Clock != TIMER_CLK_STOP);
+  TIMER_vArm(u8Timer);
+  return 1;
+}
+
+/**
+ * @brief  Stop the clock of a timer, its configuration is kept
+ * @param  u8Timer Timer
+ * @return Void
+ */
+void TIMER_vStop(uint8 u8Timer) {
+  if (u8Timer < TIMER_COUNT) {
+    timer_running[u8Timer] = 0;
+    TIMER_vArm(u8Timer);
+  }
+}
+
+/**
+ * @brief  Restart a stopped timer with the clock of its last TIMER_u8Init,
+ *         the period starts over instead of going on from the stop
+ * @param  u8Timer Timer
+ * @return Void
+ */
+void TIMER_vStart(uint8 u8Timer) {
+  if ((u8Timer < TIMER_COUNT) && (timer_running[u8Timer] == 0)) {
+    timer_start[u8Timer] = SIM_u64Now();
+    timer_running[u8Timer] = (timer_config[u8Timer].u8Clock != TIMER_CLK_STOP);
+    TIMER_vArm(u8Timer);
+  }
+}
+
+/**
+ * @brief  Set a raw compare value
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u16Value Compare value (8-bit timers use the low byte)
+ * @return Void
+ */
+void TIMER_vSetCompare(uint8 u8Timer, uint8 u8Channel, uint16 u16Value) {
+  if ((u8Timer >= TIMER_COUNT) || (u8Channel > TIMER_CHANNEL_B)) {
+    return;
+  }
+  timer_compare[u8Timer][u8Channel] =
+      (u8Timer == TIMER_1) ? u16Value : (uint8)u16Value;
+  if ((u8Channel == TIMER_CHANNEL_A) &&
+      (timer_config[u8Timer].u8Mode == TIMER_MODE_CTC)) {
+    timer_config[u8Timer].u16Top = timer_compare[u8Timer][u8Channel];
+    TIMER_vArm(u8Timer);
+  }
+}
+
+/**
+ * @brief  Set the period: CTC top, or ICR1 for Timer1 fast PWM
+ * @param  u8Timer Timer
+ * @param  u16Top Top value in timer ticks
+ * @return Void
+ */
+void TIMER_vSetPeriod(uint8 u8Timer, uint16 u16Top) {
+  if ((u8Timer == TIMER_1) &&
+      (timer_config[TIMER_1].u8Mode == TIMER_MODE_FAST_PWM)) {
+    timer_config[TIMER_1].u16Top = u16Top;
+    TIMER_vArm(TIMER_1);
+  } else {
+    TIMER_vSetCompare(u8Timer, TIMER_CHANNEL_A, u16Top);
+  }
+}
+
+/**
+ * @brief  Set a PWM duty cycle in whole percent of the current top
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u8Percent Duty cycle (0-100)
+ * @return Void
+ */
+void TIMER_vSetDuty(uint8 u8Timer, uint8 u8Channel, uint8 u8Percent) {
+  uint32 u32Top = (u8Timer < TIMER_COUNT) ? TIMER_u32Range(u8Timer) - 1 : 0;
+  if (u8Percent > 100) {
+    u8Percent = 100;
+  }
+  TIMER_vSetCompare(u8Timer, u8Channel, (uint16)((u32Top * u8Percent) / 100));
+}
+
+/**
+ * @brief  Change the compare output mode of a channel (not modelled)
+ * @param  u8Timer Timer
+ * @param  u8Channel TIMER_CHANNEL_A or TIMER_CHANNEL_B
+ * @param  u8Output TIMER_OUTPUT_x
+ * @return Void
+ */
+void TIMER_vSetOutput(uint8 u8Timer, uint8 u8Channel, uint8 u8Output) {
+  if (u8Timer >= TIMER_COUNT) {
+    return;
+  }
+  if (u8Channel == TIMER_CHANNEL_B) {
+    timer_config[u8Timer].u8OutputB = u8Output;
+  } else {
+    timer_config[u8Timer].u8OutputA = u8Output;
+  }
+}
+
+/**
+ * @brief  Read the counter
+ * @param  u8Timer Timer
+ * @return Counter value
+ */
+uint16 TIMER_u16GetCount(uint8 u8Timer) {
+  uint64_t u64Tick;
+  if ((u8Timer >= TIMER_COUNT) || (timer_running[u8Timer] == 0)) {
+    return 0;
+  }
+  u64Tick = TIMER_u64TickNs(u8Timer);
+  return (uint16)(((SIM_u64Now() - timer_start[u8Timer]) / u64Tick) %
+                  TIMER_u32Range(u8Timer));
+}
+
+/**
+ * @brief  Read the last input capture of Timer1 (no ICP1 input modelled)
+ * @return ICR1
+ */
+uint16 TIMER_u16GetCapture(void) { return 0; }
+
+/**
+ * @brief  Install or remove an interrupt callback
+ * @param  u8Timer Timer
+ * @param  u8Event TIMER_EVENT_x
+ * @param  pfCallback Function called from the ISR, NULL disables the event
+ * @return 1 on success, 0 if the event does not exist on the timer
+ */
+uint8 TIMER_u8SetCallback(uint8 u8Timer, uint8 u8Event,
+                          TimerCallback_t pfCallback) {
+  if ((u8Timer >= TIMER_COUNT) || (u8Event >= TIMER_EVENT_COUNT) ||
+      ((u8Timer != TIMER_1) && (u8Event > TIMER_EVENT_COMPARE_A))) {
+    return 0;
+  }
+  timer_callbacks[u8Timer][u8Event] = pfCallback;
+  TIMER_vArm(u8Timer);
+  return 1;
+}
\ No newline at end of file
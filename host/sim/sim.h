@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim.h
+ * Description: Header file for the simulation core shared by both nodes
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_SIM_SIM_H_
+#define HOST_SIM_SIM_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SIM_NS_PER_US 1000ULL
+#define SIM_NS_PER_MS 1000000ULL
+#define SIM_NS_PER_CYCLE 125ULL /* F_CPU = 8 MHz */
+
+/* Time charged each time a critical section ends with interrupts enabled,
+   so polling loops that only read the system tick still make progress */
+#define SIM_SPIN_QUANTUM_NS (5 * SIM_NS_PER_US)
+
+/* Interrupt sources, lower numbers win when two are due at the same time */
+#define SIM_EVENT_TIMER_0 (uint8_t)0
+#define SIM_EVENT_TIMER_1 (uint8_t)1
+#define SIM_EVENT_TIMER_2 (uint8_t)2
+#define SIM_EVENT_EEPROM (uint8_t)3
+#define SIM_EVENT_COUNT (uint8_t)4
+
+#define SIM_NO_LIMIT UINT64_MAX
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/* Runs in interrupt context: global interrupts are off while it executes */
+typedef void (*SimHandler_t)(void);
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Simulated time since reset
+ * @return Time in ns
+ */
+uint64_t SIM_u64Now(void);
+
+/**
+ * @brief  Move simulated time forward, running the interrupts that fall due
+ * @param  u64Target Absolute time in ns, earlier times are ignored
+ * @return Void
+ */
+void SIM_vAdvanceTo(uint64_t u64Target);
+
+/**
+ * @brief  Arm an interrupt source, replaces an earlier request of the source
+ * @param  u8Event SIM_EVENT_x
+ * @param  u64Due Absolute time in ns
+ * @param  pfHandler Interrupt handler
+ * @return Void
+ */
+void SIM_vSchedule(uint8_t u8Event, uint64_t u64Due, SimHandler_t pfHandler);
+
+/**
+ * @brief  Disarm an interrupt source
+ * @param  u8Event SIM_EVENT_x
+ * @return Void
+ */
+void SIM_vCancel(uint8_t u8Event);
+
+/**
+ * @brief  Stop the run once simulated time reaches a limit
+ * @param  u64Limit Absolute time in ns or SIM_NO_LIMIT
+ * @return Void
+ */
+void SIM_vSetTimeLimit(uint64_t u64Limit);
+
+/**
+ * @brief  Check whether the limit came from SIM_TIME_LIMIT_MS
+ * @return 1 if the user fixed the limit, 0 otherwise
+ */
+uint8_t SIM_u8LimitIsFixed(void);
+
+/**
+ * @brief  End the run: print the board state and exit with code 0
+ * @return Does not return
+ */
+void SIM_vFinish(void) __attribute__((noreturn));
+
+/**
+ * @brief  Read an integer setting from the environment
+ * @param  pcName Variable name
+ * @param  s32Default Value used when the variable is not set
+ * @return Setting value
+ */
+int32_t SIM_s32Env(const char *pcName, int32_t s32Default);
+
+/**
+ * @brief  Log a PIN event whenever an output pin changes
+ * @param  u8Port Port letter ('A'..'D')
+ * @param  u8Pin Pin number
+ * @param  pcName Name used in the event
+ * @return Void
+ */
+void SIM_vWatchPin(uint8_t u8Port, uint8_t u8Pin, const char *pcName);
+
+/**
+ * @brief  Compare the watched pins with their last level, log the changes
+ * @return Void
+ */
+void SIM_vPollPins(void);
+
+/*
+ * Board hooks, implemented once per node (sim_master.c / sim_slave.c)
+ */
+
+/**
+ * @brief  Read the board configuration, called before main
+ * @return Void
+ */
+void SIM_vBoardInit(void);
+
+/**
+ * @brief  Called by _delay_ms/_delay_us before time moves on
+ * @return Void
+ */
+void SIM_vBoardDelay(void);
+
+/**
+ * @brief  Called after every time step
+ * @return Void
+ */
+void SIM_vBoardTick(void);
+
+/**
+ * @brief  Levels driven onto a port by the outside world
+ * @param  u8Port Port letter ('A'..'D')
+ * @param  u8Levels Levels seen without external drive
+ * @return Levels seen by the firmware
+ */
+uint8_t SIM_u8BoardPins(uint8_t u8Port, uint8_t u8Levels);
+
+/**
+ * @brief  Analog input voltage of a channel
+ * @param  u8Channel ADC channel
+ * @return 10-bit conversion result
+ */
+uint16_t SIM_u16BoardAnalog(uint8_t u8Channel);
+
+/**
+ * @brief  Print the final board state
+ * @return Void
+ */
+void SIM_vBoardFinish(void);
+
+#endif /* HOST_SIM_SIM_H_ */
\ No newline at end of file
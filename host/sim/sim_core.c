@@ -0,0 +1,226 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_core.c
+ * Description: Simulated clock, interrupt controller and delays
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Time only moves when the firmware would burn cycles: in _delay_ms and
+ * _delay_us, at the end of critical sections, and when the slave waits for
+ * the next SPI byte. Interrupt sources are due times in a small table. They
+ * run in time order while time moves forward, with global interrupts
+ * enabled, and at most once each while interrupts are masked, like the
+ * pending flags of the AVR.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "sim.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <util/atomic.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint64_t sim_now = 0;
+static uint64_t sim_limit = SIM_NO_LIMIT;
+static uint8_t sim_limit_fixed = 0;
+
+static uint8_t sim_irq_enabled = 0; /* I bit of SREG, off after reset */
+static uint8_t sim_in_isr = 0;
+
+static uint64_t sim_event_due[SIM_EVENT_COUNT];
+static SimHandler_t sim_event_handler[SIM_EVENT_COUNT];
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Read an integer setting from the environment
+ * @param  pcName Variable name
+ * @param  s32Default Value used when the variable is not set
+ * @return Setting value
+ */
+int32_t SIM_s32Env(const char *pcName, int32_t s32Default) {
+  const char *pcValue = getenv(pcName);
+  if ((pcValue == NULL) || (*pcValue == '\0')) {
+    return s32Default;
+  }
+  return (int32_t)strtol(pcValue, NULL, 0);
+}
+
+/**
+ * @brief  Read the run settings before the firmware starts
+ * @return Void
+ */
+__attribute__((constructor)) static void SIM_vInit(void) {
+  int32_t s32Limit = SIM_s32Env("SIM_TIME_LIMIT_MS", -1);
+  if (s32Limit >= 0) {
+    sim_limit = (uint64_t)s32Limit * SIM_NS_PER_MS;
+    sim_limit_fixed = 1;
+  }
+  SIM_vBoardInit();
+}
+
+/**
+ * @brief  Simulated time since reset
+ * @return Time in ns
+ */
+uint64_t SIM_u64Now(void) { return sim_now; }
+
+/**
+ * @brief  Stop the run once simulated time reaches a limit
+ * @param  u64Limit Absolute time in ns or SIM_NO_LIMIT
+ * @return Void
+ */
+void SIM_vSetTimeLimit(uint64_t u64Limit) {
+  if (sim_limit_fixed == 0) {
+    sim_limit = u64Limit;
+  }
+}
+
+/**
+ * @brief  Check whether the limit came from SIM_TIME_LIMIT_MS
+ * @return 1 if the user fixed the limit, 0 otherwise
+ */
+uint8_t SIM_u8LimitIsFixed(void) { return sim_limit_fixed; }
+
+/**
+ * @brief  End the run: print the board state and exit with code 0
+ * @return Does not return
+ */
+void SIM_vFinish(void) {
+  SIM_vBoardFinish();
+  fflush(stdout);
+  exit(0); /* fake drivers save their state from atexit handlers */
+}
+
+/**
+ * @brief  Arm an interrupt source, replaces an earlier request of the source
+ * @param  u8Event SIM_EVENT_x
+ * @param  u64Due Absolute time in ns
+ * @param  pfHandler Interrupt handler
+ * @return Void
+ */
+void SIM_vSchedule(uint8_t u8Event, uint64_t u64Due, SimHandler_t pfHandler) {
+  sim_event_due[u8Event] = u64Due;
+  sim_event_handler[u8Event] = pfHandler;
+}
+
+/**
+ * @brief  Disarm an interrupt source
+ * @param  u8Event SIM_EVENT_x
+ * @return Void
+ */
+void SIM_vCancel(uint8_t u8Event) { sim_event_handler[u8Event] = NULL; }
+
+/**
+ * @brief  Earliest armed source due at or before a time
+ * @param  u64Target Time in ns
+ * @return Source number or SIM_EVENT_COUNT if none is due
+ */
+static uint8_t SIM_u8NextEvent(uint64_t u64Target) {
+  uint8_t u8Event;
+  uint8_t u8Next = SIM_EVENT_COUNT;
+  for (u8Event = 0; u8Event < SIM_EVENT_COUNT; u8Event++) {
+    if ((sim_event_handler[u8Event] != NULL) &&
+        (sim_event_due[u8Event] <= u64Target) &&
+        ((u8Next == SIM_EVENT_COUNT) ||
+         (sim_event_due[u8Event] < sim_event_due[u8Next]))) {
+      u8Next = u8Event;
+    }
+  }
+  return u8Next;
+}
+
+/**
+ * @brief  Move simulated time forward, running the interrupts that fall due
+ * @param  u64Target Absolute time in ns, earlier times are ignored
+ * @return Void
+ */
+void SIM_vAdvanceTo(uint64_t u64Target) {
+  SimHandler_t pfHandler;
+  uint8_t u8Event;
+
+  SIM_vPollPins(); /* stamp output changes before time moves on */
+  while ((sim_irq_enabled != 0) && (sim_in_isr == 0)) {
+    u8Event = SIM_u8NextEvent(u64Target);
+    if (u8Event == SIM_EVENT_COUNT) {
+      break;
+    }
+    if (sim_event_due[u8Event] > sim_now) {
+      sim_now = sim_event_due[u8Event];
+    }
+    /* One shot: the handler arms its source again if it repeats */
+    pfHandler = sim_event_handler[u8Event];
+    sim_event_handler[u8Event] = NULL;
+    sim_in_isr = 1;
+    sim_irq_enabled = 0;
+    pfHandler();
+    sim_irq_enabled = 1;
+    sim_in_isr = 0;
+    SIM_vPollPins();
+  }
+  if (u64Target > sim_now) {
+    sim_now = u64Target;
+  }
+
+  SIM_vBoardTick();
+  if (sim_now >= sim_limit) {
+    SIM_vFinish();
+  }
+}
+
+/**
+ * @brief  sei(): enable interrupts, pending ones run at once
+ * @return Void
+ */
+void SIM_vSei(void) {
+  sim_irq_enabled = 1;
+  if (sim_in_isr == 0) {
+    SIM_vAdvanceTo(sim_now);
+  }
+}
+
+/**
+ * @brief  cli(): disable interrupts
+ * @return Void
+ */
+void SIM_vCli(void) { sim_irq_enabled = 0; }
+
+/**
+ * @brief  Enter an ATOMIC_BLOCK
+ * @return Interrupt state to restore
+ */
+uint8_t SIM_u8AtomicEnter(void) {
+  uint8_t u8State = sim_irq_enabled;
+  sim_irq_enabled = 0;
+  return u8State;
+}
+
+/**
+ * @brief  Leave an ATOMIC_BLOCK, restores the interrupt state
+ * @param  pu8State State saved by SIM_u8AtomicEnter
+ * @return Void
+ */
+void SIM_vAtomicLeave(const uint8_t *pu8State) {
+  sim_irq_enabled = *pu8State;
+  if ((sim_irq_enabled != 0) && (sim_in_isr == 0)) {
+    SIM_vAdvanceTo(sim_now + SIM_SPIN_QUANTUM_NS);
+  }
+}
+
+/**
+ * @brief  Busy wait, backs _delay_ms and _delay_us
+ * @param  u32Microseconds Delay length
+ * @return Void
+ */
+void SIM_vDelayUs(uint32_t u32Microseconds) {
+  SIM_vBoardDelay();
+  SIM_vAdvanceTo(sim_now + (uint64_t)u32Microseconds * SIM_NS_PER_US);
+}
\ No newline at end of file
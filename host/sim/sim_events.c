@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_events.c
+ * Description: Timestamped event log shared by the simulators
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * One line per event: "<ns> <node> <kind> <details>", for example
+ *
+ *   1234000000 master KEY 5
+ *   1251016000 slave SPI rx=0x11 tx=0xff
+ *   1251016000 slave PIN room1 1
+ *   1302000000 master LCD |Room1 ON        |                |
+ *
+ * Both nodes of a host run append to the same file. Each line is a single
+ * write, so lines never interleave, but they are only sorted per node.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "sim_events.h"
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SIM_EVENT_LINE_SIZE 128
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static int sim_events_fd = -1;
+static const char *sim_events_node = "";
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Start logging events, appending to a file shared by both nodes
+ * @param  pcPath Log file, NULL keeps logging off
+ * @param  pcNode Node name used when SIM_vEvent gets NULL
+ * @return Void
+ */
+void SIM_vEventsOpen(const char *pcPath, const char *pcNode) {
+  sim_events_node = pcNode;
+  if ((pcPath == NULL) || (*pcPath == '\0')) {
+    return;
+  }
+  sim_events_fd = open(pcPath, O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (sim_events_fd < 0) {
+    perror(pcPath);
+  }
+}
+
+/**
+ * @brief  Check whether events are logged
+ * @return 1 if a log is open, 0 otherwise
+ */
+uint8_t SIM_u8EventsOn(void) { return (sim_events_fd >= 0) ? 1 : 0; }
+
+/**
+ * @brief  Log one event as "<ns> <node> <text>"
+ * @param  u64Now Simulated time in ns
+ * @param  pcNode Node name, NULL for the one given to SIM_vEventsOpen
+ * @param  pcFormat printf format of the text, starts with the event kind
+ * @return Void
+ */
+void SIM_vEvent(uint64_t u64Now, const char *pcNode, const char *pcFormat,
+                ...) {
+  char acLine[SIM_EVENT_LINE_SIZE];
+  va_list stArgs;
+  int iLength;
+
+  if (sim_events_fd < 0) {
+    return;
+  }
+  iLength = snprintf(acLine, sizeof(acLine), "%llu %s ",
+                     (unsigned long long)u64Now,
+                     (pcNode != NULL) ? pcNode : sim_events_node);
+  va_start(stArgs, pcFormat);
+  iLength += vsnprintf(acLine + iLength, sizeof(acLine) - (size_t)iLength,
+                       pcFormat, stArgs);
+  va_end(stArgs);
+  if (iLength > (int)sizeof(acLine) - 1) {
+    iLength = (int)sizeof(acLine) - 1;
+  }
+  acLine[iLength++] = '\n';
+  (void)write(sim_events_fd, acLine, (size_t)iLength);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_events.h
+ * Description: Header file for the timestamped event log of a run
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_SIM_SIM_EVENTS_H_
+#define HOST_SIM_SIM_EVENTS_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Start logging events, appending to a file shared by both nodes
+ * @param  pcPath Log file, NULL keeps logging off
+ * @param  pcNode Node name used when SIM_vEvent gets NULL
+ * @return Void
+ */
+void SIM_vEventsOpen(const char *pcPath, const char *pcNode);
+
+/**
+ * @brief  Check whether events are logged
+ * @return 1 if a log is open, 0 otherwise
+ */
+uint8_t SIM_u8EventsOn(void);
+
+/**
+ * @brief  Log one event as "<ns> <node> <text>"
+ * @param  u64Now Simulated time in ns
+ * @param  pcNode Node name, NULL for the one given to SIM_vEventsOpen
+ * @param  pcFormat printf format of the text, starts with the event kind
+ * @return Void
+ */
+void SIM_vEvent(uint64_t u64Now, const char *pcNode, const char *pcFormat, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#endif /* HOST_SIM_SIM_EVENTS_H_ */
\ No newline at end of file
@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_io.c
+ * Description: Simulated I/O registers: ports and the ADC
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "sim.h"
+#include "sim_events.h"
+#include <avr/io.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* PINx, DDRx and PORTx are consecutive addresses, port A is highest */
+#define SIM_PORT(pin_address) SIM_au8Io[(pin_address) + 2]
+
+#define SIM_ADC_CHANNEL_MASK (uint8_t)0x1F
+
+#define SIM_WATCH_MAX 16
+#define SIM_PORT_ADDRESS(port) (uint8_t)(0x1B - 3 * ((port) - 'A'))
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint8_t u8Address; /* PORTx */
+  uint8_t u8Mask;
+  uint8_t u8Level;
+  const char *pcName;
+} SimWatch_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+volatile uint8_t SIM_au8Io[SIM_IO_SIZE];
+
+static uint16_t sim_adc_result = 0;
+
+static SimWatch_t sim_watches[SIM_WATCH_MAX];
+static uint8_t sim_watch_count = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Refresh a PINx register from the port state and the board
+ * @note   Outputs read back their PORT level, inputs read their pull-up
+ *         level unless the board drives them.
+ * @param  u8Address I/O address of PINx
+ * @return Pointer to the refreshed register
+ */
+volatile uint8_t *SIM_pu8ReadPin(uint8_t u8Address) {
+  uint8_t u8Port = (uint8_t)('A' + (0x19 - u8Address) / 3);
+  uint8_t u8Levels = SIM_PORT(u8Address);
+  SIM_au8Io[u8Address] = SIM_u8BoardPins(u8Port, u8Levels);
+  return &SIM_au8Io[u8Address];
+}
+
+/**
+ * @brief  ADCSRA access, a started conversion completes immediately
+ * @return Pointer to ADCSRA
+ */
+volatile uint8_t *SIM_pu8AdcControl(void) {
+  volatile uint8_t *pu8Adcsra = &SIM_au8Io[0x06];
+  if ((*pu8Adcsra & (1 << ADEN)) && (*pu8Adcsra & (1 << ADSC))) {
+    sim_adc_result =
+        SIM_u16BoardAnalog((uint8_t)(ADMUX & SIM_ADC_CHANNEL_MASK)) & 0x3FF;
+    *pu8Adcsra = (uint8_t)((*pu8Adcsra & ~(1 << ADSC)) | (1 << ADIF));
+  }
+  return pu8Adcsra;
+}
+
+/**
+ * @brief  Result of the last conversion (ADCL/ADCH/ADC)
+ * @return Right adjusted 10-bit result
+ */
+uint16_t SIM_u16AdcResult(void) { return sim_adc_result; }
+
+/**
+ * @brief  Log a PIN event whenever an output pin changes
+ * @param  u8Port Port letter ('A'..'D')
+ * @param  u8Pin Pin number
+ * @param  pcName Name used in the event
+ * @return Void
+ */
+void SIM_vWatchPin(uint8_t u8Port, uint8_t u8Pin, const char *pcName) {
+  SimWatch_t *pstWatch = &sim_watches[sim_watch_count];
+  if ((SIM_u8EventsOn() == 0) || (sim_watch_count == SIM_WATCH_MAX)) {
+    return;
+  }
+  pstWatch->u8Address = SIM_PORT_ADDRESS(u8Port);
+  pstWatch->u8Mask = (uint8_t)(1 << u8Pin);
+  pstWatch->u8Level = 0; /* PORTx is cleared at reset */
+  pstWatch->pcName = pcName;
+  sim_watch_count++;
+}
+
+/**
+ * @brief  Compare the watched pins with their last level, log the changes
+ * @return Void
+ */
+void SIM_vPollPins(void) {
+  SimWatch_t *pstWatch;
+  uint8_t u8Level;
+  uint8_t u8Index;
+  for (u8Index = 0; u8Index < sim_watch_count; u8Index++) {
+    pstWatch = &sim_watches[u8Index];
+    u8Level = (SIM_au8Io[pstWatch->u8Address] & pstWatch->u8Mask) ? 1 : 0;
+    if (u8Level != pstWatch->u8Level) {
+      pstWatch->u8Level = u8Level;
+      SIM_vEvent(SIM_u64Now(), NULL, "PIN %s %u", pstWatch->pcName,
+                 (unsigned)u8Level);
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,435 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_keys.c
+ * Description: Scripted keypad user shared by the host build and simavr
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Key script: every keypad symbol is one tap, "[NNN]" waits NNN ms before
+ * the next tap and blanks are ignored. The simulated user is patient: a key
+ * stays down until the firmware has seen it on a row scan, plus
+ * SIM_KEY_HOLD_MS, and the next tap only starts SIM_KEY_GAP_MS after the
+ * firmware scanned all four rows of the idle keypad. A script never depends
+ * on how long the UI takes to redraw. Once the script is done the run ends
+ * SIM_KEYS_TAIL_MS later. The KEY event of a tap carries the time the key
+ * went down, the SCAN event the time the firmware first saw it.
+ *
+ * For load tests a symbol may be followed by "{NNN}" to hold it NNN ms
+ * after it was seen, "@NNN" keeps the next tap up until NNN ms after reset,
+ * and "~N" or "~N:SEED" expands to N random taps with random waits and the
+ * odd long hold. The storm only depends on SEED (1 by default), so a run is
+ * replayed exactly from its script.
+ *
+ * A firmware that never scans a pressed key, or never scans the keypad
+ * after a release, would hold the script forever: once one step waited
+ * SIM_KEYS_STUCK_MS (600000 by default, from the environment) the run ends
+ * with a STUCK event.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "sim_keys.h"
+#include "sim.h"
+#include "sim_events.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SIM_KEYS_CHUNK 256 /* taps added each time the script grows */
+#define SIM_KEY_HOLD_MS 100ULL
+#define SIM_KEY_GAP_MS 100ULL
+
+/* Life of one tap */
+#define SIM_KEY_RELEASED (uint8_t)0 /* up, the firmware has not scanned yet */
+#define SIM_KEY_WAITING (uint8_t)1  /* up, goes down at sim_key_time */
+#define SIM_KEY_PRESSED (uint8_t)2  /* down, not scanned yet */
+#define SIM_KEY_SEEN (uint8_t)3     /* down, goes up SIM_KEY_HOLD_MS later */
+#define SIM_ALL_ROWS (uint8_t)0x0F
+
+/* Storm taps: wait up to SIM_STORM_WAIT_MS, one in SIM_STORM_LONG_ODDS is
+   held SIM_STORM_LONG_MS plus up to as much again */
+#define SIM_STORM_WAIT_MS 500U
+#define SIM_STORM_LONG_ODDS 16U
+#define SIM_STORM_LONG_MS 1000U
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint8_t u8Row;
+  uint8_t u8Column;
+  uint32_t u32WaitMs; /* idle time before the tap */
+  uint32_t u32HoldMs; /* time held once the firmware saw it */
+  uint32_t u32AtMs;   /* earliest press time after reset, 0 for any */
+} SimKey_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Same layout as keypad_map in keypad_driver.c */
+static const char sim_keypad_map[4][4] = {{'7', '8', '9', '/'},
+                                          {'4', '5', '6', '*'},
+                                          {'1', '2', '3', '-'},
+                                          {'A', '0', '=', '+'}};
+
+static SimKey_t *sim_keys = NULL;
+static uint16_t sim_key_size = 0; /* taps allocated */
+static uint16_t sim_key_count = 0;
+static uint16_t sim_key_index = 0;
+static uint32_t sim_keys_tail_ms = 0; /* trailing [NNN] of the script */
+static uint8_t sim_key_state = SIM_KEY_WAITING;
+static uint8_t sim_idle_rows = 0; /* rows scanned since the last release */
+static uint64_t sim_key_time = 0; /* press time, or first scan when seen */
+static uint64_t sim_keys_end = 0; /* release of the last key */
+static uint64_t sim_keys_stuck = 0; /* SIM_KEYS_STUCK_MS in ns */
+static uint8_t sim_keys_stuck_logged = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Position of a symbol on the keypad
+ * @param  cKey Keypad symbol
+ * @param  pstKey Receives the row and column
+ * @return 1 if the symbol exists, 0 otherwise
+ */
+static uint8_t SIM_u8FindKey(char cKey, SimKey_t *pstKey) {
+  uint8_t u8Row;
+  uint8_t u8Column;
+  for (u8Row = 0; u8Row < 4; u8Row++) {
+    for (u8Column = 0; u8Column < 4; u8Column++) {
+      if (sim_keypad_map[u8Row][u8Column] == cKey) {
+        pstKey->u8Row = u8Row;
+        pstKey->u8Column = u8Column;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief  Append one tap to the script, growing it as needed
+ * @param  u32WaitMs Idle time before the tap
+ * @return The new tap, its position still to be filled in
+ */
+static SimKey_t *SIM_pstAddKey(uint32_t u32WaitMs) {
+  SimKey_t *pstKey;
+
+  if (sim_key_count == sim_key_size) {
+    if (sim_key_size > UINT16_MAX - SIM_KEYS_CHUNK) {
+      fprintf(stderr, "keys: more than %d keys\n", UINT16_MAX);
+      exit(2);
+    }
+    sim_key_size += SIM_KEYS_CHUNK;
+    sim_keys = realloc(sim_keys, sim_key_size * sizeof(SimKey_t));
+    if (sim_keys == NULL) {
+      fprintf(stderr, "keys: out of memory\n");
+      exit(2);
+    }
+  }
+  pstKey = &sim_keys[sim_key_count++];
+  pstKey->u32WaitMs = u32WaitMs;
+  pstKey->u32HoldMs = (uint32_t)SIM_KEY_HOLD_MS;
+  pstKey->u32AtMs = 0;
+  return pstKey;
+}
+
+/**
+ * @brief  Next number of a storm, xorshift32
+ * @param  pu32State Generator state, never 0
+ * @param  u32Range Number of possible results
+ * @return A number below u32Range
+ */
+static uint32_t SIM_u32Random(uint32_t *pu32State, uint32_t u32Range) {
+  uint32_t u32X = *pu32State;
+  u32X ^= u32X << 13;
+  u32X ^= u32X >> 17;
+  u32X ^= u32X << 5;
+  *pu32State = u32X;
+  return u32X % u32Range;
+}
+
+/**
+ * @brief  Append random taps to the script
+ * @param  u32Count Number of taps
+ * @param  u32Seed Generator seed, the same seed gives the same taps
+ * @param  u32WaitMs Idle time before the first tap
+ * @return Void
+ */
+static void SIM_vAddStorm(uint32_t u32Count, uint32_t u32Seed,
+                          uint32_t u32WaitMs) {
+  uint32_t u32State = (u32Seed != 0) ? u32Seed : 1;
+  uint32_t u32Key;
+  SimKey_t *pstKey;
+
+  while (u32Count-- > 0) {
+    pstKey = SIM_pstAddKey(u32WaitMs +
+                           SIM_u32Random(&u32State, SIM_STORM_WAIT_MS + 1));
+    u32Key = SIM_u32Random(&u32State, 16);
+    pstKey->u8Row = (uint8_t)(u32Key / 4);
+    pstKey->u8Column = (uint8_t)(u32Key % 4);
+    if (SIM_u32Random(&u32State, SIM_STORM_LONG_ODDS) == 0) {
+      pstKey->u32HoldMs =
+          SIM_STORM_LONG_MS + SIM_u32Random(&u32State, SIM_STORM_LONG_MS + 1);
+    }
+    u32WaitMs = 0;
+  }
+}
+
+/**
+ * @brief  Load a key script, exits with code 2 if it is malformed
+ * @param  pcScript Script text, NULL for no keys
+ * @return Void
+ */
+void SIM_vKeysInit(const char *pcScript) {
+  const char *pcStuck = getenv("SIM_KEYS_STUCK_MS");
+  uint32_t u32Wait = 0;
+  uint32_t u32At = 0;
+  uint32_t u32Count;
+  uint32_t u32Seed;
+  SimKey_t *pstKey;
+  SimKey_t stPosition;
+  char *pcEnd;
+
+  sim_keys_stuck = SIM_KEYS_STUCK_MS * SIM_NS_PER_MS;
+  if ((pcStuck != NULL) && (*pcStuck != '\0')) {
+    sim_keys_stuck = strtoull(pcStuck, NULL, 0) * SIM_NS_PER_MS;
+  }
+
+  while ((pcScript != NULL) && (*pcScript != '\0')) {
+    if (*pcScript == '[') {
+      u32Wait += (uint32_t)strtoul(pcScript + 1, &pcEnd, 10);
+      if (*pcEnd != ']') {
+        fprintf(stderr, "keys: missing ']'\n");
+        exit(2);
+      }
+      pcScript = pcEnd + 1;
+      continue;
+    }
+    if (*pcScript == '@') {
+      u32At = (uint32_t)strtoul(pcScript + 1, &pcEnd, 10);
+      if (pcEnd == pcScript + 1) {
+        fprintf(stderr, "keys: '@' needs a time in ms\n");
+        exit(2);
+      }
+      pcScript = pcEnd;
+      continue;
+    }
+    if (*pcScript == '~') {
+      u32Count = (uint32_t)strtoul(pcScript + 1, &pcEnd, 10);
+      if (pcEnd == pcScript + 1) {
+        fprintf(stderr, "keys: '~' needs a tap count\n");
+        exit(2);
+      }
+      u32Seed = 1;
+      if (*pcEnd == ':') {
+        u32Seed = (uint32_t)strtoul(pcEnd + 1, &pcEnd, 0);
+      }
+      if (u32Count > 0) {
+        SIM_vAddStorm(u32Count, u32Seed, u32Wait);
+        sim_keys[sim_key_count - u32Count].u32AtMs = u32At;
+        u32Wait = 0;
+        u32At = 0;
+      }
+      pcScript = pcEnd;
+      continue;
+    }
+    if ((*pcScript == ' ') || (*pcScript == ',')) {
+      pcScript++;
+      continue;
+    }
+    if (SIM_u8FindKey(*pcScript, &stPosition) == 0) {
+      fprintf(stderr, "keys: '%c' is not on the keypad\n", *pcScript);
+      exit(2);
+    }
+    pstKey = SIM_pstAddKey(u32Wait);
+    pstKey->u8Row = stPosition.u8Row;
+    pstKey->u8Column = stPosition.u8Column;
+    pstKey->u32AtMs = u32At;
+    pcScript++;
+    if (*pcScript == '{') {
+      pstKey->u32HoldMs = (uint32_t)strtoul(pcScript + 1, &pcEnd, 10);
+      if (*pcEnd != '}') {
+        fprintf(stderr, "keys: missing '}'\n");
+        exit(2);
+      }
+      pcScript = pcEnd + 1;
+    }
+    u32Wait = 0;
+    u32At = 0;
+  }
+  sim_keys_tail_ms = u32Wait;
+  if (sim_key_count > 0) {
+    sim_key_time = sim_keys[0].u32WaitMs * SIM_NS_PER_MS;
+    if (sim_key_time < sim_keys[0].u32AtMs * SIM_NS_PER_MS) {
+      sim_key_time = sim_keys[0].u32AtMs * SIM_NS_PER_MS;
+    }
+    sim_key_state = SIM_KEY_WAITING;
+  }
+}
+
+/**
+ * @brief  Step the script: press the next key, release a seen one
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vKeysUpdate(uint64_t u64Now) {
+  if (sim_key_index >= sim_key_count) {
+    return;
+  }
+  if ((sim_key_state == SIM_KEY_WAITING) && (u64Now >= sim_key_time)) {
+    sim_key_state = SIM_KEY_PRESSED;
+    SIM_vEvent(sim_key_time, "master", "KEY %c",
+               sim_keypad_map[sim_keys[sim_key_index].u8Row]
+                             [sim_keys[sim_key_index].u8Column]);
+  } else if ((sim_key_state == SIM_KEY_SEEN) &&
+             (u64Now >= sim_key_time + sim_keys[sim_key_index].u32HoldMs *
+                                           SIM_NS_PER_MS)) {
+    sim_key_state = SIM_KEY_RELEASED;
+    sim_idle_rows = 0;
+    sim_key_index++;
+    sim_keys_end = u64Now;
+  }
+}
+
+/**
+ * @brief  Columns pulled low while the firmware strobes keypad rows
+ * @param  u8RowsLow Bit n set when row n is an output driven low
+ * @param  u64Now Simulated time in ns
+ * @return Bit n set when column n is pulled low
+ */
+uint8_t SIM_u8KeysColumns(uint8_t u8RowsLow, uint64_t u64Now) {
+  const SimKey_t *pstKey;
+  uint64_t u64At;
+
+  SIM_vKeysUpdate(u64Now);
+  if (sim_key_index >= sim_key_count) {
+    return 0;
+  }
+  pstKey = &sim_keys[sim_key_index];
+  if (sim_key_state == SIM_KEY_RELEASED) {
+    /* Once every row was scanned idle the firmware saw the release */
+    sim_idle_rows |= (uint8_t)(u8RowsLow & SIM_ALL_ROWS);
+    if (sim_idle_rows == SIM_ALL_ROWS) {
+      sim_key_state = SIM_KEY_WAITING;
+      sim_key_time =
+          u64Now + (SIM_KEY_GAP_MS + pstKey->u32WaitMs) * SIM_NS_PER_MS;
+      u64At = pstKey->u32AtMs * SIM_NS_PER_MS;
+      if (sim_key_time < u64At) {
+        sim_key_time = u64At;
+      }
+    }
+  }
+  if (sim_key_state < SIM_KEY_PRESSED) {
+    return 0;
+  }
+
+  /* A pressed key connects its column to its row */
+  if ((u8RowsLow & (1 << pstKey->u8Row)) == 0) {
+    return 0;
+  }
+  if (sim_key_state == SIM_KEY_PRESSED) {
+    sim_key_state = SIM_KEY_SEEN;
+    SIM_vEvent(u64Now, "master", "SCAN %c",
+               sim_keypad_map[pstKey->u8Row][pstKey->u8Column]);
+    sim_key_time = u64Now;
+  }
+  return (uint8_t)(1 << pstKey->u8Column);
+}
+
+/**
+ * @brief  Start of the step that waits on the firmware
+ * @return Press time of a key not scanned yet, release time of a key whose
+ *         release was not scanned yet, or SIM_NO_LIMIT when no step waits
+ */
+static uint64_t SIM_u64KeysWaitStart(void) {
+  if (sim_key_index >= sim_key_count) {
+    return SIM_NO_LIMIT;
+  }
+  if (sim_key_state == SIM_KEY_PRESSED) {
+    return sim_key_time;
+  }
+  if (sim_key_state == SIM_KEY_RELEASED) {
+    return sim_keys_end;
+  }
+  return SIM_NO_LIMIT;
+}
+
+/**
+ * @brief  Time at which the run should end
+ * @return SIM_KEYS_STUCK_MS after the start of a step that waits on the
+ *         firmware, the script tail after the last release, or SIM_NO_LIMIT
+ *         while a step runs on its own, in ns
+ */
+uint64_t SIM_u64KeysDeadline(void) {
+  uint64_t u64Start;
+
+  if (sim_key_index < sim_key_count) {
+    u64Start = SIM_u64KeysWaitStart();
+    return (u64Start == SIM_NO_LIMIT) ? SIM_NO_LIMIT
+                                      : u64Start + sim_keys_stuck;
+  }
+  return sim_keys_end + (sim_keys_tail_ms + SIM_KEYS_TAIL_MS) * SIM_NS_PER_MS;
+}
+
+/**
+ * @brief  Check whether the script gave up on the firmware, logs a STUCK
+ *         event with the key and the time waited the first time it does
+ * @param  u64Now Simulated time in ns
+ * @return 1 if the current step waited SIM_KEYS_STUCK_MS, 0 otherwise
+ */
+uint8_t SIM_u8KeysStuck(uint64_t u64Now) {
+  uint64_t u64Waited = SIM_u64KeysWaiting(u64Now);
+
+  if ((u64Waited == 0) || (u64Waited < sim_keys_stuck)) {
+    return 0;
+  }
+  if (sim_keys_stuck_logged == 0) {
+    sim_keys_stuck_logged = 1;
+    SIM_vEvent(u64Now, "master", "STUCK %c %s %llu", SIM_cKeysCurrent(),
+               (sim_key_state == SIM_KEY_PRESSED) ? "press" : "release",
+               (unsigned long long)(u64Waited / SIM_NS_PER_MS));
+  }
+  return 1;
+}
+
+/**
+ * @brief  Symbol of the tap being played
+ * @return Keypad symbol, or ' ' once the script is done
+ */
+char SIM_cKeysCurrent(void) {
+  if (sim_key_index >= sim_key_count) {
+    return ' ';
+  }
+  return sim_keypad_map[sim_keys[sim_key_index].u8Row]
+                       [sim_keys[sim_key_index].u8Column];
+}
+
+/**
+ * @brief  Time the current step has been waiting on the firmware
+ * @param  u64Now Simulated time in ns
+ * @return Time in ns, 0 when no step waits
+ */
+uint64_t SIM_u64KeysWaiting(uint64_t u64Now) {
+  uint64_t u64Start = SIM_u64KeysWaitStart();
+  return ((u64Start == SIM_NO_LIMIT) || (u64Now < u64Start))
+             ? 0
+             : u64Now - u64Start;
+}
+
+/**
+ * @brief  Number of taps completed so far
+ * @return Completed taps
+ */
+uint16_t SIM_u16KeysDone(void) { return sim_key_index; }
+
+/**
+ * @brief  Number of taps in the script
+ * @return Script length
+ */
+uint16_t SIM_u16KeysTotal(void) { return sim_key_count; }
\ No newline at end of file
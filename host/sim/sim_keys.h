@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_keys.h
+ * Description: Header file for the scripted keypad user
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_SIM_SIM_KEYS_H_
+#define HOST_SIM_SIM_KEYS_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SIM_KEYS_TAIL_MS 2000ULL
+/* Default of SIM_KEYS_STUCK_MS: a step the firmware never completes */
+#define SIM_KEYS_STUCK_MS 600000ULL
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Load a key script, exits with code 2 if it is malformed
+ * @param  pcScript Script text, NULL for no keys
+ * @return Void
+ */
+void SIM_vKeysInit(const char *pcScript);
+
+/**
+ * @brief  Step the script: press the next key, release a seen one
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vKeysUpdate(uint64_t u64Now);
+
+/**
+ * @brief  Columns pulled low while the firmware strobes keypad rows
+ * @param  u8RowsLow Bit n set when row n is an output driven low
+ * @param  u64Now Simulated time in ns
+ * @return Bit n set when column n is pulled low
+ */
+uint8_t SIM_u8KeysColumns(uint8_t u8RowsLow, uint64_t u64Now);
+
+/**
+ * @brief  Time at which the run should end
+ * @return SIM_KEYS_STUCK_MS after the start of a step that waits on the
+ *         firmware, the script tail after the last release, or SIM_NO_LIMIT
+ *         while a step runs on its own, in ns
+ */
+uint64_t SIM_u64KeysDeadline(void);
+
+/**
+ * @brief  Check whether the script gave up on the firmware, logs a STUCK
+ *         event with the key and the time waited the first time it does
+ * @param  u64Now Simulated time in ns
+ * @return 1 if the current step waited SIM_KEYS_STUCK_MS, 0 otherwise
+ */
+uint8_t SIM_u8KeysStuck(uint64_t u64Now);
+
+/**
+ * @brief  Symbol of the tap being played
+ * @return Keypad symbol, or ' ' once the script is done
+ */
+char SIM_cKeysCurrent(void);
+
+/**
+ * @brief  Time the current step has been waiting on the firmware
+ * @param  u64Now Simulated time in ns
+ * @return Time in ns, 0 when no step waits
+ */
+uint64_t SIM_u64KeysWaiting(uint64_t u64Now);
+
+/**
+ * @brief  Number of taps completed so far
+ * @return Completed taps
+ */
+uint16_t SIM_u16KeysDone(void);
+
+/**
+ * @brief  Number of taps in the script
+ * @return Script length
+ */
+uint16_t SIM_u16KeysTotal(void);
+
+#endif /* HOST_SIM_SIM_KEYS_H_ */
\ No newline at end of file
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_lcd.c
+ * Description: HD44780 display model shared by the host build and simavr
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Only the DDRAM is modelled: text writes, address set, clear and home. A
+ * frame is printed when the display has been stable for SIM_LCD_SETTLE_MS,
+ * so the partial frames of a redraw never show. Its LCD event carries the
+ * time of the last write, when the text was complete, and ends with
+ * "draw_us=N", the time from the first write of the redraw to the last.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "sim_lcd.h"
+#include "sim.h"
+#include "sim_events.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SIM_LCD_COLUMNS 16
+#define SIM_LCD_LINE2 0x40
+#define SIM_LCD_DDRAM_SIZE 0x80
+#define SIM_LCD_SETTLE_MS 50ULL
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static char sim_lcd_ddram[SIM_LCD_DDRAM_SIZE];
+static uint8_t sim_lcd_address = 0;
+static uint8_t sim_lcd_dirty = 0;
+static uint64_t sim_lcd_written = 0;
+static uint64_t sim_lcd_first = 0; /* first write since the last frame */
+static char sim_lcd_shown[2 * SIM_LCD_COLUMNS + 1];
+static uint8_t sim_lcd_trace = 1;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Blank the display
+ * @param  u8Trace 1 to print every settled frame, 0 for the last one only
+ * @return Void
+ */
+void SIM_vLcdInit(uint8_t u8Trace) {
+  memset(sim_lcd_ddram, ' ', sizeof(sim_lcd_ddram));
+  memset(sim_lcd_shown, ' ', 2 * SIM_LCD_COLUMNS);
+  sim_lcd_trace = u8Trace;
+}
+
+/**
+ * @brief  Current LCD text, both lines back to back
+ * @param  pcText Destination, 2 * SIM_LCD_COLUMNS characters
+ * @return Void
+ */
+static void SIM_vLcdText(char *pcText) {
+  uint8_t u8Column;
+  char cChar;
+  for (u8Column = 0; u8Column < 2 * SIM_LCD_COLUMNS; u8Column++) {
+    cChar = (u8Column < SIM_LCD_COLUMNS)
+                ? sim_lcd_ddram[u8Column]
+                : sim_lcd_ddram[SIM_LCD_LINE2 + u8Column - SIM_LCD_COLUMNS];
+    pcText[u8Column] = ((cChar >= ' ') && (cChar <= '~')) ? cChar : '?';
+  }
+}
+
+/**
+ * @brief  Print one LCD frame
+ * @param  pcTag Line tag
+ * @param  pcText Both lines back to back
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+static void SIM_vLcdPrintText(const char *pcTag, const char *pcText,
+                              uint64_t u64Now) {
+  printf("%s %7llu ms |%.16s|%.16s|\n", pcTag,
+         (unsigned long long)(u64Now / SIM_NS_PER_MS), pcText,
+         pcText + SIM_LCD_COLUMNS);
+}
+
+/**
+ * @brief  HD44780 bus cycle (falling edge of EN), 8-bit interface
+ * @param  u8Data Data bus
+ * @param  u8Rs Register select, 1 for data
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vLcdLatch(uint8_t u8Data, uint8_t u8Rs, uint64_t u64Now) {
+  if (u8Rs != 0) {
+    sim_lcd_ddram[sim_lcd_address & (SIM_LCD_DDRAM_SIZE - 1)] = (char)u8Data;
+    sim_lcd_address++;
+    if (sim_lcd_address == 0x28) {
+      sim_lcd_address = SIM_LCD_LINE2;
+    } else if (sim_lcd_address == SIM_LCD_LINE2 + 0x28) {
+      sim_lcd_address = 0;
+    }
+  } else if (u8Data & 0x80) {
+    sim_lcd_address = (uint8_t)(u8Data & 0x7F); /* set DDRAM address */
+  } else if (u8Data == 0x01) {
+    memset(sim_lcd_ddram, ' ', sizeof(sim_lcd_ddram));
+    sim_lcd_address = 0;
+  } else if ((u8Data & 0xFE) == 0x02) {
+    sim_lcd_address = 0; /* return home */
+  } else {
+    return; /* function set, display control, entry mode: no text change */
+  }
+  if (sim_lcd_dirty == 0) {
+    sim_lcd_first = u64Now;
+  }
+  sim_lcd_dirty = 1;
+  sim_lcd_written = u64Now;
+}
+
+/**
+ * @brief  Print the frame once the display has been stable for a while
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vLcdTick(uint64_t u64Now) {
+  char acText[2 * SIM_LCD_COLUMNS];
+
+  if ((sim_lcd_dirty != 0) &&
+      (u64Now - sim_lcd_written >= SIM_LCD_SETTLE_MS * SIM_NS_PER_MS)) {
+    sim_lcd_dirty = 0;
+    SIM_vLcdText(acText);
+    if (memcmp(acText, sim_lcd_shown, sizeof(acText)) != 0) {
+      memcpy(sim_lcd_shown, acText, sizeof(acText));
+      SIM_vEvent(sim_lcd_written, "master", "LCD |%.16s|%.16s| draw_us=%llu",
+                 acText, acText + SIM_LCD_COLUMNS,
+                 (unsigned long long)((sim_lcd_written - sim_lcd_first) /
+                                      SIM_NS_PER_US));
+      if (sim_lcd_trace != 0) {
+        SIM_vLcdPrintText("LCD", acText, u64Now);
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Print the current frame unconditionally
+ * @param  pcTag Line tag
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vLcdPrint(const char *pcTag, uint64_t u64Now) {
+  char acText[2 * SIM_LCD_COLUMNS];
+  SIM_vLcdText(acText);
+  SIM_vLcdPrintText(pcTag, acText, u64Now);
+}
\ No newline at end of file
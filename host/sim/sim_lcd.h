@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_lcd.h
+ * Description: Header file for the HD44780 display model
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_SIM_SIM_LCD_H_
+#define HOST_SIM_SIM_LCD_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Blank the display
+ * @param  u8Trace 1 to print every settled frame, 0 for the last one only
+ * @return Void
+ */
+void SIM_vLcdInit(uint8_t u8Trace);
+
+/**
+ * @brief  HD44780 bus cycle (falling edge of EN), 8-bit interface
+ * @param  u8Data Data bus
+ * @param  u8Rs Register select, 1 for data
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vLcdLatch(uint8_t u8Data, uint8_t u8Rs, uint64_t u64Now);
+
+/**
+ * @brief  Print the frame once the display has been stable for a while
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vLcdTick(uint64_t u64Now);
+
+/**
+ * @brief  Print the current frame unconditionally
+ * @param  pcTag Line tag
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vLcdPrint(const char *pcTag, uint64_t u64Now);
+
+#endif /* HOST_SIM_SIM_LCD_H_ */
\ No newline at end of file
@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_master.c
+ * Description: Master board model: scripted keypad and virtual LCD
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * The key script comes from SIM_KEYS (see sim_keys.c). Once it is done the
+ * run ends SIM_KEYS_TAIL_MS later unless SIM_TIME_LIMIT_MS is set. A run
+ * that ends on a key the firmware never took prints a STUCK line.
+ *
+ * The LCD model latches PORTA and RS on each falling edge of EN, sampled
+ * at every delay call (LCD.c waits after each EN edge).
+ *
+ * With SIM_EVENTS set, key presses, settled LCD frames, SPI bytes and the
+ * LED and buzzer pins are logged to that file (see sim_events.c).
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "HAL/LCD/LCD.h"
+#include "MCAL/DIO/DIO.h"
+#include "sim.h"
+#include "sim_events.h"
+#include "sim_keys.h"
+#include "sim_lcd.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef eight_bits_mode
+#error "The LCD model only decodes the 8-bit bus"
+#endif
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define SIM_BUZZER_PIN 3 /* PC3, BUZZER_PIN */
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static uint8_t sim_lcd_enable = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Read the board configuration, called before main
+ * @return Void
+ */
+void SIM_vBoardInit(void) {
+  SIM_vEventsOpen(getenv("SIM_EVENTS"), "master");
+  SIM_vWatchPin(ADMIN_LED_PORT, ADMIN_LED_PIN, "admin_led");
+  SIM_vWatchPin(GUEST_LED_PORT, GUEST_LED_PIN, "guest_led");
+  SIM_vWatchPin(BLOCK_LED_PORT, BLOCK_LED_PIN, "block_led");
+  SIM_vWatchPin('C', SIM_BUZZER_PIN, "buzzer");
+  SIM_vLcdInit((uint8_t)SIM_s32Env("SIM_LCD_TRACE", 1));
+  SIM_vKeysInit(getenv("SIM_KEYS"));
+  SIM_vSetTimeLimit(SIM_u64KeysDeadline());
+}
+
+/**
+ * @brief  Keypad rows the firmware strobes
+ * @return Bit n set when row n is an output driven low
+ */
+static uint8_t SIM_u8RowsLow(void) {
+  uint8_t u8Low = (uint8_t)(*DIO_pu8DdrReg(KEYPAD_ROW_PORT) &
+                            ~*DIO_pu8PortReg(KEYPAD_ROW_PORT));
+  return (uint8_t)((u8Low >> KEYPAD_FIRST_PIN) & 0x0F);
+}
+
+/**
+ * @brief  Levels driven onto a port by the outside world
+ * @param  u8Port Port letter ('A'..'D')
+ * @param  u8Levels Levels seen without external drive
+ * @return Levels seen by the firmware
+ */
+uint8_t SIM_u8BoardPins(uint8_t u8Port, uint8_t u8Levels) {
+  uint8_t u8Columns;
+
+  if (u8Port != KEYPAD_PORT) {
+    return u8Levels;
+  }
+  /* A pressed key pulls its column input down while its row is strobed */
+  u8Columns = (uint8_t)(SIM_u8KeysColumns(SIM_u8RowsLow(), SIM_u64Now())
+                        << KEYPAD_FIFTH_PIN);
+  u8Columns &= (uint8_t)~*DIO_pu8DdrReg(KEYPAD_PORT);
+  return (uint8_t)(u8Levels & ~u8Columns);
+}
+
+/**
+ * @brief  Sample the LCD enable line, called before every delay
+ * @return Void
+ */
+void SIM_vBoardDelay(void) {
+  uint8_t u8Enable =
+      (*DIO_pu8PortReg(LCD_CONTROL_PORT) & (1 << LCD_EN_PIN)) ? 1 : 0;
+  if ((sim_lcd_enable != 0) && (u8Enable == 0)) {
+    SIM_vLcdLatch(*DIO_pu8PortReg(LCD_PORT),
+                  (*DIO_pu8PortReg(LCD_CONTROL_PORT) & (1 << LCD_RS_PIN)) ? 1
+                                                                          : 0,
+                  SIM_u64Now());
+  }
+  sim_lcd_enable = u8Enable;
+}
+
+/**
+ * @brief  Called after every time step: key script and settled frames
+ * @return Void
+ */
+void SIM_vBoardTick(void) {
+  SIM_vKeysUpdate(SIM_u64Now());
+  SIM_vSetTimeLimit(SIM_u64KeysDeadline());
+  SIM_vLcdTick(SIM_u64Now());
+}
+
+/**
+ * @brief  Analog input voltage of a channel (no ADC on the master)
+ * @param  u8Channel ADC channel
+ * @return 10-bit conversion result
+ */
+uint16_t SIM_u16BoardAnalog(uint8_t u8Channel) {
+  (void)u8Channel;
+  return 0;
+}
+
+/**
+ * @brief  Print the final display, LEDs, unused keys and a stuck key
+ * @return Void
+ */
+void SIM_vBoardFinish(void) {
+  uint64_t u64Now = SIM_u64Now();
+
+  SIM_vLcdPrint("END", u64Now);
+  printf("LED admin=%d guest=%d block=%d keys=%u/%u\n",
+         (*DIO_pu8PortReg(ADMIN_LED_PORT) >> ADMIN_LED_PIN) & 1,
+         (*DIO_pu8PortReg(GUEST_LED_PORT) >> GUEST_LED_PIN) & 1,
+         (*DIO_pu8PortReg(BLOCK_LED_PORT) >> BLOCK_LED_PIN) & 1,
+         SIM_u16KeysDone(), SIM_u16KeysTotal());
+  if (SIM_u8KeysStuck(u64Now) != 0) {
+    printf("STUCK key=%c waited=%llu ms\n", SIM_cKeysCurrent(),
+           (unsigned long long)(SIM_u64KeysWaiting(u64Now) / SIM_NS_PER_MS));
+  }
+}
\ No newline at end of file
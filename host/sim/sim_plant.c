@@ -0,0 +1,428 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_plant.c
+ * Description: Room thermal model, sensor trace replay and climate metrics
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * SIM_PLANT=1 closes the loop: one lumped room exchanges heat with the
+ * outside through the walls and, while the fan runs, through ventilation.
+ * The heater adds and the AC removes a fixed power. The model steps every
+ * PLANT_STEP_NS with the actuator outputs of the end of the step.
+ *
+ * SIM_TRACE replays a CSV file whose header names the columns: time_ms and
+ * any of temp_c (drives the LM35 directly, the model is bypassed),
+ * outside_c (weather for the model) and ldr (raw reading). Values are
+ * interpolated between rows and held after the last one.
+ *
+ * While the room temperature comes from the model or a trace, the run is
+ * scored against the band SIM_BAND_LOW_C..SIM_BAND_HIGH_C (by default what
+ * the controller holds): time in band, degree-hours outside it, settling
+ * time, overshoot after the first entry, and switch count, on time and
+ * energy per actuator.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "sim_plant.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define PLANT_STEP_NS (10 * SIM_NS_PER_MS)
+#define PLANT_NS_PER_S 1e9
+
+/* Small room: air, walls and furniture, about 100 min time constant */
+#define PLANT_HEAT_CAPACITY 300000.0 /* J/K */
+#define PLANT_LOSS 50.0              /* W/K through the envelope */
+#define PLANT_FAN_LOSS 100.0         /* W/K of ventilation at 100 % duty */
+#define PLANT_HEATER_HEAT 2000.0     /* W into the room */
+#define PLANT_AC_COOLING 3500.0      /* W out of the room */
+
+/* Electrical power, for the energy figures */
+#define PLANT_HEATER_POWER 2000.0
+#define PLANT_AC_POWER 1500.0
+#define PLANT_FAN_POWER 60.0 /* at 100 % duty */
+#define PLANT_J_PER_WH 3600.0
+#define PLANT_NS_PER_H 3.6e12
+
+#define PLANT_OUTSIDE_C 30 /* default weather */
+/* Default band: the heater threshold, and the AC threshold plus the degree
+   the integer reading must pass before the AC starts */
+#define PLANT_BAND_LOW_C 10
+#define PLANT_BAND_HIGH_C 26
+#define PLANT_BAND_MARGIN 0.25 /* one LM35 step, C */
+
+#define PLANT_LINE_SIZE 256
+#define PLANT_COLUMN_MAX 8
+
+/* Trace columns */
+#define PLANT_COL_TEMP 0
+#define PLANT_COL_OUTSIDE 1
+#define PLANT_COL_LDR 2
+#define PLANT_COL_COUNT 3
+#define PLANT_COL_NONE -1
+
+#define PLANT_HEATER 0
+#define PLANT_AC 1
+#define PLANT_FAN 2
+#define PLANT_ACTUATOR_COUNT 3
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint64_t u64Time; /* ns */
+  double adValue[PLANT_COL_COUNT];
+} PlantRow_t;
+
+typedef struct {
+  uint8_t u8On;
+  uint32_t u32Switches; /* off to on */
+  uint64_t u64OnTime;   /* ns */
+  double dEnergy;       /* J */
+} PlantActuator_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const char *const plant_columns[PLANT_COL_COUNT] = {"temp_c",
+                                                           "outside_c", "ldr"};
+static const char *const plant_actuator_names[PLANT_ACTUATOR_COUNT] = {
+    "HEATER", "AC", "FAN"};
+
+static uint8_t plant_model = 0; /* SIM_PLANT */
+static uint8_t plant_scored = 0;
+static SimActuatorsRead_t plant_read = NULL;
+
+static double plant_room = 0.0; /* C */
+static double plant_outside = PLANT_OUTSIDE_C;
+static int32_t plant_ldr = 0;
+static uint64_t plant_time = 0; /* end of the last step */
+
+static PlantRow_t *plant_rows = NULL;
+static size_t plant_row_count = 0;
+static uint8_t plant_has[PLANT_COL_COUNT];
+
+/* Metrics */
+static double plant_band_low = PLANT_BAND_LOW_C;
+static double plant_band_high = PLANT_BAND_HIGH_C;
+static double plant_min = 0.0;
+static double plant_max = 0.0;
+static double plant_overshoot = 0.0;
+static uint8_t plant_entered = 0; /* reached the band once */
+static uint8_t plant_in_band = 0;
+static uint64_t plant_settled_at = 0;
+static uint64_t plant_band_time = 0;
+static double plant_discomfort = 0.0; /* K ns outside the band */
+static PlantActuator_t plant_actuators[PLANT_ACTUATOR_COUNT];
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Load the trace, exits on a malformed file
+ * @param  pcPath CSV file
+ * @return Void
+ */
+static void SIM_vPlantLoadTrace(const char *pcPath) {
+  char acLine[PLANT_LINE_SIZE];
+  int aiColumn[PLANT_COLUMN_MAX]; /* trace column of each CSV field */
+  int iFields = 0;
+  int iTimeField = -1;
+  int iField;
+  int iCol;
+  char *pcField;
+  char *pcEnd;
+  PlantRow_t stRow;
+  FILE *pFile = fopen(pcPath, "r");
+
+  if ((pFile == NULL) || (fgets(acLine, sizeof(acLine), pFile) == NULL)) {
+    perror(pcPath);
+    exit(2);
+  }
+  for (pcField = strtok(acLine, ",\r\n"); pcField != NULL;
+       pcField = strtok(NULL, ",\r\n")) {
+    if (iFields == PLANT_COLUMN_MAX) {
+      fprintf(stderr, "%s: too many columns\n", pcPath);
+      exit(2);
+    }
+    aiColumn[iFields] = PLANT_COL_NONE;
+    if (strcmp(pcField, "time_ms") == 0) {
+      iTimeField = iFields;
+    }
+    for (iCol = 0; iCol < PLANT_COL_COUNT; iCol++) {
+      if (strcmp(pcField, plant_columns[iCol]) == 0) {
+        aiColumn[iFields] = iCol;
+        plant_has[iCol] = 1;
+      }
+    }
+    iFields++;
+  }
+  if (iTimeField < 0) {
+    fprintf(stderr, "%s: no time_ms column\n", pcPath);
+    exit(2);
+  }
+
+  while (fgets(acLine, sizeof(acLine), pFile) != NULL) {
+    if ((acLine[0] == '\n') || (acLine[0] == '\r') || (acLine[0] == '#')) {
+      continue;
+    }
+    memset(&stRow, 0, sizeof(stRow));
+    pcField = acLine;
+    for (iField = 0; iField < iFields; iField++) {
+      double dValue = strtod(pcField, &pcEnd);
+      if ((pcEnd == pcField) ||
+          ((*pcEnd != ',') && (iField < iFields - 1))) {
+        fprintf(stderr, "%s: bad row \"%s\"\n", pcPath, acLine);
+        exit(2);
+      }
+      if (iField == iTimeField) {
+        stRow.u64Time = (uint64_t)(dValue * SIM_NS_PER_MS);
+      } else if (aiColumn[iField] != PLANT_COL_NONE) {
+        stRow.adValue[aiColumn[iField]] = dValue;
+      }
+      pcField = pcEnd + 1;
+    }
+    if ((plant_row_count > 0) &&
+        (stRow.u64Time < plant_rows[plant_row_count - 1].u64Time)) {
+      fprintf(stderr, "%s: time_ms goes backwards\n", pcPath);
+      exit(2);
+    }
+    plant_rows =
+        realloc(plant_rows, (plant_row_count + 1) * sizeof(PlantRow_t));
+    if (plant_rows == NULL) {
+      perror("realloc");
+      exit(2);
+    }
+    plant_rows[plant_row_count] = stRow;
+    plant_row_count++;
+  }
+  fclose(pFile);
+  if (plant_row_count == 0) {
+    fprintf(stderr, "%s: no rows\n", pcPath);
+    exit(2);
+  }
+}
+
+/**
+ * @brief  Trace value at a time, interpolated between rows
+ * @param  iCol PLANT_COL_x
+ * @param  u64Now Simulated time in ns
+ * @return Value
+ */
+static double SIM_dPlantTrace(int iCol, uint64_t u64Now) {
+  const PlantRow_t *pstNext = plant_rows;
+  const PlantRow_t *pstLast = &plant_rows[plant_row_count - 1];
+  double dSpan;
+
+  while ((pstNext < pstLast) && (pstNext->u64Time <= u64Now)) {
+    pstNext++;
+  }
+  if ((pstNext == plant_rows) || (u64Now >= pstNext->u64Time)) {
+    return pstNext->adValue[iCol]; /* before the first or after the last */
+  }
+  dSpan = (double)(pstNext->u64Time - pstNext[-1].u64Time);
+  return pstNext[-1].adValue[iCol] +
+         (pstNext->adValue[iCol] - pstNext[-1].adValue[iCol]) *
+             (double)(u64Now - pstNext[-1].u64Time) / dSpan;
+}
+
+/**
+ * @brief  Check a temperature against the band, with one sensor step margin
+ * @param  dTemperature Degrees C
+ * @return 1 inside the band, 0 outside
+ */
+static uint8_t SIM_u8PlantInBand(double dTemperature) {
+  return (uint8_t)((dTemperature >= plant_band_low - PLANT_BAND_MARGIN) &&
+                   (dTemperature <= plant_band_high + PLANT_BAND_MARGIN));
+}
+
+/**
+ * @brief  Read the model and trace settings from the environment
+ * @param  s32RoomC Room temperature at reset
+ * @param  s32Ldr Raw LDR reading when no trace drives it
+ * @param  pfRead Reads the actuators of the board
+ * @return Void
+ */
+void SIM_vPlantInit(int32_t s32RoomC, int32_t s32Ldr,
+                    SimActuatorsRead_t pfRead) {
+  const char *pcTrace = getenv("SIM_TRACE");
+
+  plant_model = (uint8_t)(SIM_s32Env("SIM_PLANT", 0) != 0);
+  plant_read = pfRead;
+  plant_room = s32RoomC;
+  plant_ldr = s32Ldr;
+  plant_outside = SIM_s32Env("SIM_OUTSIDE_C", PLANT_OUTSIDE_C);
+  plant_band_low = SIM_s32Env("SIM_BAND_LOW_C", PLANT_BAND_LOW_C);
+  plant_band_high = SIM_s32Env("SIM_BAND_HIGH_C", PLANT_BAND_HIGH_C);
+  if ((pcTrace != NULL) && (*pcTrace != '\0')) {
+    SIM_vPlantLoadTrace(pcTrace);
+  }
+
+  plant_scored = (uint8_t)(plant_model || plant_has[PLANT_COL_TEMP]);
+  if (plant_has[PLANT_COL_TEMP]) {
+    plant_room = SIM_dPlantTrace(PLANT_COL_TEMP, 0);
+  }
+  plant_min = plant_room;
+  plant_max = plant_room;
+  plant_in_band = SIM_u8PlantInBand(plant_room);
+  plant_entered = plant_in_band;
+}
+
+/**
+ * @brief  Account one step of an actuator
+ * @param  u8Actuator PLANT_x
+ * @param  dLoad Share of the full power, 0 when off
+ * @param  dPower Electrical power at full load in W
+ * @return Void
+ */
+static void SIM_vPlantActuator(uint8_t u8Actuator, double dLoad,
+                               double dPower) {
+  PlantActuator_t *pstActuator = &plant_actuators[u8Actuator];
+  uint8_t u8On = (uint8_t)(dLoad > 0.0);
+
+  if (u8On && !pstActuator->u8On) {
+    pstActuator->u32Switches++;
+  }
+  pstActuator->u8On = u8On;
+  if (u8On) {
+    pstActuator->u64OnTime += PLANT_STEP_NS;
+    pstActuator->dEnergy += dLoad * dPower * PLANT_STEP_NS / PLANT_NS_PER_S;
+  }
+}
+
+/**
+ * @brief  Score the room temperature at the end of a step
+ * @return Void
+ */
+static void SIM_vPlantScore(void) {
+  double dOutside = 0.0;
+  uint8_t u8InBand = SIM_u8PlantInBand(plant_room);
+
+  if (plant_room < plant_band_low) {
+    plant_discomfort += (plant_band_low - plant_room) * PLANT_STEP_NS;
+  } else if (plant_room > plant_band_high) {
+    plant_discomfort += (plant_room - plant_band_high) * PLANT_STEP_NS;
+  }
+  if (plant_room < plant_min) {
+    plant_min = plant_room;
+  }
+  if (plant_room > plant_max) {
+    plant_max = plant_room;
+  }
+  if (u8InBand) {
+    plant_band_time += PLANT_STEP_NS;
+    if (!plant_in_band) {
+      plant_settled_at = plant_time; /* entered again */
+    }
+    plant_entered = 1;
+  } else if (plant_entered) {
+    dOutside = (plant_room < plant_band_low) ? plant_band_low - plant_room
+                                             : plant_room - plant_band_high;
+    if (dOutside > plant_overshoot) {
+      plant_overshoot = dOutside;
+    }
+  }
+  plant_in_band = u8InBand;
+}
+
+/**
+ * @brief  Integrate the model up to a time
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vPlantUpdate(uint64_t u64Now) {
+  SimActuators_t stActuators;
+  double dHeat;
+  double dFan;
+
+  if (plant_has[PLANT_COL_LDR]) {
+    plant_ldr = (int32_t)(SIM_dPlantTrace(PLANT_COL_LDR, u64Now) + 0.5);
+  }
+  if (!plant_scored) {
+    return;
+  }
+
+  while (plant_time + PLANT_STEP_NS <= u64Now) {
+    plant_time += PLANT_STEP_NS;
+    plant_read(&stActuators);
+    dFan = stActuators.u8FanDuty / 100.0;
+
+    if (plant_has[PLANT_COL_TEMP]) {
+      plant_room = SIM_dPlantTrace(PLANT_COL_TEMP, plant_time);
+    } else {
+      if (plant_has[PLANT_COL_OUTSIDE]) {
+        plant_outside = SIM_dPlantTrace(PLANT_COL_OUTSIDE, plant_time);
+      }
+      dHeat = (plant_outside - plant_room) *
+              (PLANT_LOSS + dFan * PLANT_FAN_LOSS);
+      dHeat += stActuators.u8Heater ? PLANT_HEATER_HEAT : 0.0;
+      dHeat -= stActuators.u8Ac ? PLANT_AC_COOLING : 0.0;
+      plant_room +=
+          dHeat * PLANT_STEP_NS / PLANT_NS_PER_S / PLANT_HEAT_CAPACITY;
+    }
+
+    SIM_vPlantActuator(PLANT_HEATER, stActuators.u8Heater ? 1.0 : 0.0,
+                       PLANT_HEATER_POWER);
+    SIM_vPlantActuator(PLANT_AC, stActuators.u8Ac ? 1.0 : 0.0, PLANT_AC_POWER);
+    SIM_vPlantActuator(PLANT_FAN, dFan, PLANT_FAN_POWER);
+    SIM_vPlantScore();
+  }
+}
+
+/**
+ * @brief  Room temperature seen by the LM35
+ * @return Degrees C
+ */
+double SIM_dPlantTemperature(void) { return plant_room; }
+
+/**
+ * @brief  Raw LDR reading
+ * @return 10-bit ADC value
+ */
+int32_t SIM_s32PlantLdr(void) { return plant_ldr; }
+
+/**
+ * @brief  Print the climate metrics of the run, if the model or a trace ran
+ * @return Void
+ */
+void SIM_vPlantReport(void) {
+  const PlantActuator_t *pstActuator;
+  uint8_t u8Actuator;
+
+  if (!plant_scored) {
+    return;
+  }
+  printf("PLANT %7llu ms temp=%.1fC min=%.1fC max=%.1fC band=%.0f..%.0fC "
+         "in_band=%.1f%% discomfort=%.2fKh",
+         (unsigned long long)(plant_time / SIM_NS_PER_MS), plant_room,
+         plant_min, plant_max, plant_band_low, plant_band_high,
+         (plant_time > 0) ? 100.0 * plant_band_time / plant_time : 0.0,
+         plant_discomfort / PLANT_NS_PER_H);
+  if (plant_in_band) {
+    printf(" settle=%llu ms",
+           (unsigned long long)(plant_settled_at / SIM_NS_PER_MS));
+  } else {
+    printf(" settle=never");
+  }
+  if (plant_entered) {
+    printf(" overshoot=%.1fC\n", plant_overshoot);
+  } else {
+    printf(" overshoot=-\n");
+  }
+  for (u8Actuator = 0; u8Actuator < PLANT_ACTUATOR_COUNT; u8Actuator++) {
+    pstActuator = &plant_actuators[u8Actuator];
+    printf("%-6s switches=%lu on=%.1f s energy=%.1f Wh\n",
+           plant_actuator_names[u8Actuator],
+           (unsigned long)pstActuator->u32Switches,
+           pstActuator->u64OnTime / PLANT_NS_PER_S,
+           pstActuator->dEnergy / PLANT_J_PER_WH);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_plant.h
+ * Description: Header file for the room thermal model and the sensor traces
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef HOST_SIM_SIM_PLANT_H_
+#define HOST_SIM_SIM_PLANT_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+/* Actuator outputs of the slave, sampled by the board */
+typedef struct {
+  uint8_t u8Heater;
+  uint8_t u8Ac;
+  uint8_t u8FanDuty; /* percent, 0 when the fan is stopped */
+} SimActuators_t;
+
+/* Reads the actuator outputs at the current time */
+typedef void (*SimActuatorsRead_t)(SimActuators_t *pstActuators);
+
+/*******************************************************************************
+ *                    Software Interfaces Declarations                  *
+ *******************************************************************************/
+/**
+ * @brief  Read the model and trace settings from the environment
+ * @param  s32RoomC Room temperature at reset
+ * @param  s32Ldr Raw LDR reading when no trace drives it
+ * @param  pfRead Reads the actuators of the board
+ * @return Void
+ */
+void SIM_vPlantInit(int32_t s32RoomC, int32_t s32Ldr,
+                    SimActuatorsRead_t pfRead);
+
+/**
+ * @brief  Integrate the model up to a time
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+void SIM_vPlantUpdate(uint64_t u64Now);
+
+/**
+ * @brief  Room temperature seen by the LM35
+ * @return Degrees C
+ */
+double SIM_dPlantTemperature(void);
+
+/**
+ * @brief  Raw LDR reading
+ * @return 10-bit ADC value
+ */
+int32_t SIM_s32PlantLdr(void);
+
+/**
+ * @brief  Print the climate metrics of the run, if the model or a trace ran
+ * @return Void
+ */
+void SIM_vPlantReport(void);
+
+#endif /* HOST_SIM_SIM_PLANT_H_ */
\ No newline at end of file
@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_slave.c
+ * Description: Slave board model: temperature sensor, LDR and the room
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "APP/APP_slave_Macros.h"
+#include "MCAL/DIO/DIO.h"
+#include "sim.h"
+#include "sim_events.h"
+#include "sim_plant.h"
+#include "sim_tune.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Channels and output pins as wired in APP/main.c */
+#define SIM_TEMP_CHANNEL 0
+#define SIM_LDR_CHANNEL 1
+#define SIM_TEMP_LSB_PER_C 4 /* LM35, 10 mV/C against the 2.56 V reference */
+#define SIM_HEATER_PIN 1     /* PD1 */
+#define SIM_FAN_IN1_PIN 1    /* PB1, PB0 is the soft PWM enable */
+#define SIM_FAN_IN2_PIN 2    /* PB2 */
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Soft PWM duty of the fan, owned by APP/main.c */
+extern volatile uint8 fan_duty_cycle;
+
+/* Climate thresholds of APP/main.c, the defaults are the firmware's */
+int32_t sim_heater_on_temp = 10;
+int32_t sim_ac_on_temp = 25;
+int32_t sim_min_fan_temp = 30;
+int32_t sim_max_temp = 40;
+int32_t sim_fan_gain = 10;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Heater, AC and fan outputs for the room model
+ * @param  pstActuators Receives the outputs
+ * @return Void
+ */
+static void SIM_vReadActuators(SimActuators_t *pstActuators) {
+  uint8_t u8PortD = *DIO_pu8PortReg('D');
+  uint8_t u8PortB = *DIO_pu8PortReg('B');
+  pstActuators->u8Heater = (u8PortD >> SIM_HEATER_PIN) & 1;
+  pstActuators->u8Ac = (*DIO_pu8PortReg(AIR_COND_PORT) >> AIR_COND_PIN) & 1;
+  /* The duty only moves air while a direction is selected */
+  pstActuators->u8FanDuty =
+      (u8PortB & ((1 << SIM_FAN_IN1_PIN) | (1 << SIM_FAN_IN2_PIN)))
+          ? fan_duty_cycle
+          : 0;
+}
+
+/**
+ * @brief  Read the board configuration, called before main
+ * @return Void
+ */
+void SIM_vBoardInit(void) {
+  SIM_vEventsOpen(getenv("SIM_EVENTS"), "slave");
+  SIM_vWatchPin(ROOM1_PORT, ROOM1_PIN, "room1");
+  SIM_vWatchPin(ROOM2_PORT, ROOM2_PIN, "room2");
+  SIM_vWatchPin(ROOM3_PORT, ROOM3_PIN, "room3");
+  SIM_vWatchPin(ROOM4_PORT, ROOM4_PIN, "room4");
+  SIM_vWatchPin(TV_PORT, TV_PIN, "tv");
+  SIM_vWatchPin(AIR_COND_PORT, AIR_COND_PIN, "ac");
+  SIM_vWatchPin('D', SIM_HEATER_PIN, "heater");
+  SIM_vWatchPin('B', SIM_FAN_IN1_PIN, "fan_in1");
+  SIM_vWatchPin('B', SIM_FAN_IN2_PIN, "fan_in2");
+  sim_heater_on_temp = SIM_s32Env("SIM_HEATER_ON_C", sim_heater_on_temp);
+  sim_ac_on_temp = SIM_s32Env("SIM_AC_ON_C", sim_ac_on_temp);
+  sim_min_fan_temp = SIM_s32Env("SIM_MIN_FAN_C", sim_min_fan_temp);
+  sim_max_temp = SIM_s32Env("SIM_MAX_FAN_C", sim_max_temp);
+  sim_fan_gain = SIM_s32Env("SIM_FAN_GAIN", sim_fan_gain);
+  SIM_vPlantInit(SIM_s32Env("SIM_TEMP_C", 24), SIM_s32Env("SIM_LDR", 800),
+                 SIM_vReadActuators);
+}
+
+/**
+ * @brief  Called by _delay_ms/_delay_us before time moves on
+ * @return Void
+ */
+void SIM_vBoardDelay(void) {}
+
+/**
+ * @brief  Called after every time step: the room follows the actuators
+ * @return Void
+ */
+void SIM_vBoardTick(void) { SIM_vPlantUpdate(SIM_u64Now()); }
+
+/**
+ * @brief  Levels driven onto a port by the outside world (none)
+ * @param  u8Port Port letter ('A'..'D')
+ * @param  u8Levels Levels seen without external drive
+ * @return Levels seen by the firmware
+ */
+uint8_t SIM_u8BoardPins(uint8_t u8Port, uint8_t u8Levels) {
+  (void)u8Port;
+  return u8Levels;
+}
+
+/**
+ * @brief  Analog input voltage of a channel
+ * @param  u8Channel ADC channel
+ * @return 10-bit conversion result
+ */
+uint16_t SIM_u16BoardAnalog(uint8_t u8Channel) {
+  int32_t s32Value = 0;
+  SIM_vPlantUpdate(SIM_u64Now());
+  if (u8Channel == SIM_TEMP_CHANNEL) {
+    s32Value = (int32_t)floor(SIM_dPlantTemperature() * SIM_TEMP_LSB_PER_C);
+  } else if (u8Channel == SIM_LDR_CHANNEL) {
+    s32Value = SIM_s32PlantLdr();
+  }
+  if (s32Value < 0) {
+    s32Value = 0;
+  } else if (s32Value > 0x3FF) {
+    s32Value = 0x3FF;
+  }
+  return (uint16_t)s32Value;
+}
+
+/**
+ * @brief  Print the final output state
+ * @return Void
+ */
+void SIM_vBoardFinish(void) {
+  uint8_t u8PortD = *DIO_pu8PortReg('D');
+  printf("SLAVE %7llu ms rooms=%d%d%d%d tv=%d ac=%d heater=%d fan=%d%%\n",
+         (unsigned long long)(SIM_u64Now() / SIM_NS_PER_MS),
+         (u8PortD >> ROOM1_PIN) & 1, (u8PortD >> ROOM2_PIN) & 1,
+         (u8PortD >> ROOM3_PIN) & 1, (u8PortD >> ROOM4_PIN) & 1,
+         (u8PortD >> TV_PIN) & 1, (u8PortD >> AIR_COND_PIN) & 1,
+         (u8PortD >> SIM_HEATER_PIN) & 1, fan_duty_cycle);
+  SIM_vPlantReport();
+}
\ No newline at end of file
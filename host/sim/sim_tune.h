@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: sim_tune.h
+ * Description: Climate thresholds of the slave, set per run on the host
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Included ahead of every source of the slave host build (-include), so the
+ * threshold macros of APP/main.c read these variables instead of their
+ * defaults. sim_slave.c sets them from the environment before main.
+ */
+#ifndef HOST_SIM_SIM_TUNE_H_
+#define HOST_SIM_SIM_TUNE_H_
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define HEATER_ON_TEMP sim_heater_on_temp /* SIM_HEATER_ON_C */
+#define AC_ON_TEMP sim_ac_on_temp         /* SIM_AC_ON_C */
+#define MIN_FAN_TEMP sim_min_fan_temp     /* SIM_MIN_FAN_C */
+#define MAX_TEMP sim_max_temp             /* SIM_MAX_FAN_C */
+#define FAN_GAIN sim_fan_gain             /* SIM_FAN_GAIN */
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+extern int32_t sim_heater_on_temp;
+extern int32_t sim_ac_on_temp;
+extern int32_t sim_min_fan_temp;
+extern int32_t sim_max_temp;
+extern int32_t sim_fan_gain;
+
+#endif /* HOST_SIM_SIM_TUNE_H_ */
\ No newline at end of file
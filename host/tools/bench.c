@@ -0,0 +1,376 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: bench.c
+ * Description: End-to-end latency benchmarks over simulated sessions
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_bench [options] [-- simulator arguments]
+ *   --sim PROGRAM     simulator to drive, smarthome_sim by default; any
+ *                     program with the smarthome_sim options works, e.g.
+ *                     smarthome_cosim with the two ELF files after "--"
+ *   --out FILE        append the results to a CSV file
+ *   --tag TAG         first CSV column, e.g. the commit id (default "local")
+ *   --only NAME       run one scenario
+ *
+ * Every scenario is one simulated session on an EEPROM provisioned with
+ * admin pass 1234 and guest pass 5678. The clock starts at reset or when
+ * the last key of the script goes down, and stops at the first (or last)
+ * event of the session log that starts with the stop pattern, usually a
+ * slave output pin. See sim/sim_events.c for the log format.
+ *
+ * The exit code is 1 if a scenario never reached its stop event.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#ifndef SIM_BENCH_SIM
+#define SIM_BENCH_SIM "smarthome_sim"
+#endif
+
+#define BENCH_DIR_SIZE 256
+#define BENCH_PATH_SIZE 512
+#define BENCH_LINE_SIZE 256
+#define BENCH_ARGS_MAX 32
+#define BENCH_NS_PER_MS 1000000.0
+
+#define BENCH_FROM_BOOT (uint8_t)0 /* clock starts at reset */
+#define BENCH_FROM_KEY (uint8_t)1  /* clock starts at the last key press */
+
+#define BENCH_FIRST (uint8_t)0 /* first matching event after the start */
+#define BENCH_LAST (uint8_t)1  /* last one, e.g. the end of a sequence */
+
+#define BENCH_SETUP_KEYS "1234 5678" /* first time setup: admin, guest */
+
+/* Idle time before a measured tap, so it lands on a screen that is waiting
+   for it rather than on the tail of the previous step */
+#define BENCH_SETTLE "[2000]"
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  const char *pcName;
+  const char *pcKeys;   /* the measured tap is the last key */
+  const char *pcOption; /* extra simulator option or NULL */
+  const char *pcValue;
+  uint8_t u8From;
+  const char *pcUntil; /* "<node> <kind> <details>" prefix */
+  uint8_t u8Match;
+} BenchScenario_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const BenchScenario_t bench_scenarios[] = {
+    {"boot_to_ready", "", NULL, NULL, BENCH_FROM_BOOT,
+     "master LCD |Select mode:", BENCH_FIRST},
+    {"login_admin", "0 123 " BENCH_SETTLE " 4", NULL, NULL, BENCH_FROM_KEY,
+     "master PIN admin_led 1", BENCH_FIRST},
+    {"room1_on", "0 1234 1 1 " BENCH_SETTLE " 1", NULL, NULL, BENCH_FROM_KEY,
+     "slave PIN room1 1", BENCH_FIRST},
+    {"room2_on", "0 1234 1 2 " BENCH_SETTLE " 1", NULL, NULL, BENCH_FROM_KEY,
+     "slave PIN room2 1", BENCH_FIRST},
+    {"room3_on", "0 1234 1 3 " BENCH_SETTLE " 1", NULL, NULL, BENCH_FROM_KEY,
+     "slave PIN room3 1", BENCH_FIRST},
+    {"room4_on", "0 1234 1 4 " BENCH_SETTLE " 1", NULL, NULL, BENCH_FROM_KEY,
+     "slave PIN room4 1", BENCH_FIRST},
+    {"room1_hotkey", "0 1234 " BENCH_SETTLE " /", NULL, NULL, BENCH_FROM_KEY,
+     "slave PIN room1 1", BENCH_FIRST},
+    {"set_temperature", "0 1234 3 1 2 " BENCH_SETTLE " 8", NULL, NULL,
+     BENCH_FROM_KEY, "slave SPI rx=0x1c", BENCH_FIRST},
+    /* The prompt waits for a full idle window of the main menu */
+    {"smart_night_prompt", "0 1234 1 5 " BENCH_SETTLE " 1 [6000]", "--ldr",
+     "100", BENCH_FROM_KEY, "master LCD |Night, Light ON?", BENCH_FIRST},
+    {"smart_night_all_on", "0 1234 1 5 1 [6000] 1 " BENCH_SETTLE " 1", "--ldr",
+     "100", BENCH_FROM_KEY, "slave PIN room4 1", BENCH_FIRST},
+    {"logout_all_off", "0 1234 / * - + " BENCH_SETTLE " 0", NULL, NULL,
+     BENCH_FROM_KEY, "slave PIN room", BENCH_LAST}};
+
+#define BENCH_SCENARIO_COUNT                                                   \
+  (sizeof(bench_scenarios) / sizeof(bench_scenarios[0]))
+
+static const struct option bench_options[] = {
+    {"sim", required_argument, NULL, 's'},
+    {"out", required_argument, NULL, 'o'},
+    {"tag", required_argument, NULL, 't'},
+    {"only", required_argument, NULL, 'n'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+static const char *bench_sim = SIM_BENCH_SIM;
+static char **bench_extra = NULL; /* arguments after "--" */
+static int bench_extra_count = 0;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Copy a file, a missing source is not an error
+ * @param  pcFrom Source path
+ * @param  pcTo Destination path
+ * @return Void
+ */
+static void BENCH_vCopy(const char *pcFrom, const char *pcTo) {
+  char acBuffer[BENCH_LINE_SIZE];
+  size_t sRead;
+  FILE *pFrom = fopen(pcFrom, "rb");
+  FILE *pTo;
+  if (pFrom == NULL) {
+    return;
+  }
+  pTo = fopen(pcTo, "wb");
+  if (pTo != NULL) {
+    while ((sRead = fread(acBuffer, 1, sizeof(acBuffer), pFrom)) > 0) {
+      (void)fwrite(acBuffer, 1, sRead, pTo);
+    }
+    fclose(pTo);
+  }
+  fclose(pFrom);
+}
+
+/**
+ * @brief  Run one simulated session, its output is discarded
+ * @param  pcKeys Key script
+ * @param  pcDir EEPROM directory
+ * @param  pcEvents Event log or NULL
+ * @param  pcOption Extra option or NULL
+ * @param  pcValue Its value
+ * @return Exit code of the simulator
+ */
+static int BENCH_iRun(const char *pcKeys, const char *pcDir,
+                      const char *pcEvents, const char *pcOption,
+                      const char *pcValue) {
+  const char *apcArgs[BENCH_ARGS_MAX + 1];
+  int iCount = 0;
+  int iStatus = 0;
+  int iNull;
+  int iExtra;
+  pid_t sPid;
+
+  apcArgs[iCount++] = bench_sim;
+  apcArgs[iCount++] = "--quiet";
+  apcArgs[iCount++] = "--keys";
+  apcArgs[iCount++] = pcKeys;
+  apcArgs[iCount++] = "--eeprom-dir";
+  apcArgs[iCount++] = pcDir;
+  if (pcEvents != NULL) {
+    apcArgs[iCount++] = "--events";
+    apcArgs[iCount++] = pcEvents;
+  }
+  if (pcOption != NULL) {
+    apcArgs[iCount++] = pcOption;
+    apcArgs[iCount++] = pcValue;
+  }
+  for (iExtra = 0; (iExtra < bench_extra_count) && (iCount < BENCH_ARGS_MAX);
+       iExtra++) {
+    apcArgs[iCount++] = bench_extra[iExtra];
+  }
+  apcArgs[iCount] = NULL;
+
+  fflush(stdout);
+  sPid = fork();
+  if (sPid == 0) {
+    iNull = open("/dev/null", O_WRONLY);
+    if (iNull >= 0) {
+      dup2(iNull, STDOUT_FILENO);
+      dup2(iNull, STDERR_FILENO);
+    }
+    execv(bench_sim, (char *const *)apcArgs);
+    _exit(127);
+  }
+  if ((sPid < 0) || (waitpid(sPid, &iStatus, 0) < 0)) {
+    return 127;
+  }
+  return WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : 128;
+}
+
+/**
+ * @brief  Measure one scenario from its event log
+ * @param  pstScenario Scenario
+ * @param  pcEvents Event log of the session
+ * @param  pu64Start Receives the start time in ns
+ * @param  pu64Stop Receives the stop time in ns
+ * @return 1 if the stop event was found, 0 otherwise
+ */
+static uint8_t BENCH_u8Measure(const BenchScenario_t *pstScenario,
+                               const char *pcEvents, uint64_t *pu64Start,
+                               uint64_t *pu64Stop) {
+  char acLine[BENCH_LINE_SIZE];
+  size_t sUntil = strlen(pstScenario->pcUntil);
+  uint8_t u8Found = 0;
+  unsigned long long u64Time;
+  uint64_t u64Start = 0;
+  uint64_t u64Stop = 0;
+  char *pcText;
+  FILE *pFile = fopen(pcEvents, "r");
+
+  if (pFile == NULL) {
+    return 0;
+  }
+  /* The log is sorted per node only: find the start in a first pass */
+  while ((pstScenario->u8From == BENCH_FROM_KEY) &&
+         (fgets(acLine, sizeof(acLine), pFile) != NULL)) {
+    u64Time = strtoull(acLine, &pcText, 10);
+    if ((strncmp(pcText, " master KEY ", 12) == 0) && (u64Time > u64Start)) {
+      u64Start = u64Time;
+    }
+  }
+  rewind(pFile);
+  while (fgets(acLine, sizeof(acLine), pFile) != NULL) {
+    u64Time = strtoull(acLine, &pcText, 10);
+    if ((u64Time < u64Start) ||
+        (strncmp(pcText + 1, pstScenario->pcUntil, sUntil) != 0)) {
+      continue;
+    }
+    if ((u8Found == 0) ||
+        ((pstScenario->u8Match == BENCH_FIRST) && (u64Time < u64Stop)) ||
+        ((pstScenario->u8Match == BENCH_LAST) && (u64Time > u64Stop))) {
+      u64Stop = u64Time;
+      u8Found = 1;
+    }
+  }
+  fclose(pFile);
+  *pu64Start = u64Start;
+  *pu64Stop = u64Stop;
+  return u8Found;
+}
+
+/**
+ * @brief  Open the CSV file, writing the header if it is new
+ * @param  pcPath CSV path
+ * @return File or NULL
+ */
+static FILE *BENCH_pOpenCsv(const char *pcPath) {
+  struct stat stInfo;
+  uint8_t u8New = ((stat(pcPath, &stInfo) != 0) || (stInfo.st_size == 0));
+  FILE *pFile = fopen(pcPath, "a");
+  if ((pFile != NULL) && u8New) {
+    fprintf(pFile, "tag,scenario,start_ms,stop_ms,latency_ms\n");
+  }
+  return pFile;
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 if every scenario completed, 1 otherwise, 2 on bad usage
+ */
+int main(int argc, char *argv[]) {
+  char acWork[] = "/tmp/smarthome_bench.XXXXXX";
+  char acBase[BENCH_DIR_SIZE];
+  char acDir[BENCH_DIR_SIZE];
+  char acFrom[BENCH_PATH_SIZE];
+  char acTo[BENCH_PATH_SIZE];
+  char acEvents[BENCH_PATH_SIZE];
+  const BenchScenario_t *pstScenario;
+  const char *pcOut = NULL;
+  const char *pcTag = "local";
+  const char *pcOnly = NULL;
+  const char *const apcFiles[] = {"master.eep", "slave.eep"};
+  uint64_t u64Start;
+  uint64_t u64Stop;
+  FILE *pCsv = NULL;
+  size_t sIndex;
+  int iFile;
+  int iOption;
+  int iResult = 0;
+
+  while ((iOption = getopt_long(argc, argv, "", bench_options, NULL)) != -1) {
+    switch (iOption) {
+    case 's':
+      bench_sim = optarg;
+      break;
+    case 'o':
+      pcOut = optarg;
+      break;
+    case 't':
+      pcTag = optarg;
+      break;
+    case 'n':
+      pcOnly = optarg;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [--sim PROGRAM] [--out FILE] [--tag TAG] "
+              "[--only NAME] [-- simulator arguments]\n",
+              argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+  bench_extra = &argv[optind];
+  bench_extra_count = argc - optind;
+
+  if (mkdtemp(acWork) == NULL) {
+    perror("mkdtemp");
+    return 1;
+  }
+  snprintf(acBase, sizeof(acBase), "%s/base", acWork);
+  mkdir(acBase, 0755);
+  if (BENCH_iRun(BENCH_SETUP_KEYS, acBase, NULL, NULL, NULL) != 0) {
+    fprintf(stderr, "%s: first time setup failed\n", bench_sim);
+    return 1;
+  }
+  if (pcOut != NULL) {
+    pCsv = BENCH_pOpenCsv(pcOut);
+    if (pCsv == NULL) {
+      perror(pcOut);
+      return 2;
+    }
+  }
+
+  printf("%-20s %12s %12s %12s\n", "scenario", "start ms", "stop ms",
+         "latency ms");
+  for (sIndex = 0; sIndex < BENCH_SCENARIO_COUNT; sIndex++) {
+    pstScenario = &bench_scenarios[sIndex];
+    if ((pcOnly != NULL) && (strcmp(pcOnly, pstScenario->pcName) != 0)) {
+      continue;
+    }
+    /* Every session starts from the provisioned EEPROM */
+    snprintf(acDir, sizeof(acDir), "%s/%s", acWork, pstScenario->pcName);
+    mkdir(acDir, 0755);
+    for (iFile = 0; iFile < 2; iFile++) {
+      snprintf(acFrom, sizeof(acFrom), "%s/%s", acBase, apcFiles[iFile]);
+      snprintf(acTo, sizeof(acTo), "%s/%s", acDir, apcFiles[iFile]);
+      BENCH_vCopy(acFrom, acTo);
+    }
+    snprintf(acEvents, sizeof(acEvents), "%s/events.txt", acDir);
+
+    if ((BENCH_iRun(pstScenario->pcKeys, acDir, acEvents,
+                    pstScenario->pcOption, pstScenario->pcValue) != 0) ||
+        (BENCH_u8Measure(pstScenario, acEvents, &u64Start, &u64Stop) == 0)) {
+      printf("%-20s %12s %12s %12s\n", pstScenario->pcName, "-", "-", "FAIL");
+      iResult = 1;
+      continue;
+    }
+    printf("%-20s %12.3f %12.3f %12.3f\n", pstScenario->pcName,
+           u64Start / BENCH_NS_PER_MS, u64Stop / BENCH_NS_PER_MS,
+           (u64Stop - u64Start) / BENCH_NS_PER_MS);
+    if (pCsv != NULL) {
+      fprintf(pCsv, "%s,%s,%.3f,%.3f,%.3f\n", pcTag, pstScenario->pcName,
+              u64Start / BENCH_NS_PER_MS, u64Stop / BENCH_NS_PER_MS,
+              (u64Stop - u64Start) / BENCH_NS_PER_MS);
+    }
+  }
+  if (pCsv != NULL) {
+    fclose(pCsv);
+  }
+  printf("sessions kept in %s\n", acWork);
+  return iResult;
+}
\ No newline at end of file
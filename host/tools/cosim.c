@@ -0,0 +1,846 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: cosim.c
+ * Description: Runs the master and slave ELF images on two simavr cores
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_cosim [options] MASTER.elf SLAVE.elf
+ *   --keys SCRIPT     keypad script, same syntax as smarthome_sim
+ *   --time MS         stop after MS ms of simulated time
+ *   --uart-in FILE    console input, "-" for stdin
+ *   --uart-out FILE   console output, stderr by default
+ *   --eeprom-dir DIR  keep master.eep / slave.eep in DIR between runs
+ *   --temp C          room temperature on the slave's LM35 (ADC0)
+ *   --ldr N           raw LDR reading on the slave's ADC1
+ *   --vcd FILE        record the buses and output pins as a VCD trace
+ *   --pins            print every change of the LED and load pins
+ *   --events FILE     log keys, LCD frames, SPI bytes and pins
+ *   --isr             print the cycle statistics of every interrupt vector
+ *   --quiet           only print the final state
+ *
+ * Both images run unmodified on ATmega32 cores at 8 MHz. The cores advance
+ * one instruction at a time, always the one that is behind, so the skew
+ * between them never exceeds one instruction. The SPI ports are wired
+ * back to back: a byte the master shifts out reaches the slave's SPDR and
+ * the slave's preloaded SPDR comes back, as with the real MOSI/MISO pair.
+ * The byte time is that of simavr's SPI model, not the SCK divider.
+ *
+ * The keypad user, the LCD decoder and the output format are those of the
+ * host build (sim/sim_keys.c, sim/sim_lcd.c), so both runs of one script
+ * can be compared line by line, and so can their event logs
+ * (sim/sim_events.c). The master's clock is the time base.
+ *
+ * With --isr an interrupt runs from the cycle its vector is taken to the
+ * cycle after its RETI, prologue and epilogue included. A nested interrupt
+ * is charged to the one it interrupted. The load is the share of all
+ * cycles of the core.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "HAL/LCD/LCD_config.h"
+#include "LIB/STD_Types.h"
+#include "MCAL/DIO/DIO_config_master.h"
+#include "sim.h"
+#include "sim_events.h"
+#include "sim_keys.h"
+#include "sim_lcd.h"
+#include <fcntl.h>
+#include <getopt.h>
+#include <simavr/avr_adc.h>
+#include <simavr/avr_eeprom.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_spi.h>
+#include <simavr/avr_uart.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_cycle_timers.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_vcd_file.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef eight_bits_mode
+#error "The LCD model only decodes the 8-bit bus"
+#endif
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define COSIM_MCU "atmega32"
+#define COSIM_FREQUENCY 8000000UL
+#define COSIM_POLL_US 1000 /* key script, LCD frames and UART input */
+#define COSIM_EEPROM_SIZE 1024
+#define COSIM_PATH_SIZE 512
+#define COSIM_VCD_PERIOD_US 100000
+
+/* Data space address of PORTx, DDRx sits just below it */
+#define COSIM_PORT(port) (0x3B - 3 * ((port) - 'A'))
+#define COSIM_DDR(port) (COSIM_PORT(port) - 1)
+
+/* Slave inputs: LM35 on ADC0 and the LDR divider on ADC1, 2.56 V reference */
+#define COSIM_TEMP_MV_PER_C 10
+#define COSIM_VREF_MV 2560
+
+/* Slave outputs as wired in APP/main.c and APP_slave_Macros.h */
+#define COSIM_ROOM1_PIN 4 /* PD4..PD7 */
+#define COSIM_TV_PIN 3
+#define COSIM_AC_PIN 2
+#define COSIM_HEATER_PIN 1
+#define COSIM_FAN_EN_PIN 0 /* PB0, soft PWM */
+#define COSIM_FAN_WINDOW_MS 1000ULL
+
+#define COSIM_VECTOR_COUNT 21 /* ATmega32, vector 0 is the reset */
+
+#define COSIM_MASTER (uint8_t)0
+#define COSIM_SLAVE (uint8_t)1
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint8_t u8Node;
+  char cPort;
+  uint8_t u8Pin;
+  const char *pcName;
+} CosimPin_t;
+
+typedef struct {
+  uint64_t u64Count;
+  uint64_t u64Cycles;
+  uint64_t u64Min;
+  uint64_t u64Max;
+} CosimIsr_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const struct option cosim_options[] = {
+    {"keys", required_argument, NULL, 'k'},
+    {"time", required_argument, NULL, 't'},
+    {"uart-in", required_argument, NULL, 'i'},
+    {"uart-out", required_argument, NULL, 'o'},
+    {"eeprom-dir", required_argument, NULL, 'e'},
+    {"temp", required_argument, NULL, 'c'},
+    {"ldr", required_argument, NULL, 'l'},
+    {"vcd", required_argument, NULL, 'v'},
+    {"pins", no_argument, NULL, 'p'},
+    {"events", required_argument, NULL, 'x'},
+    {"isr", no_argument, NULL, 'r'},
+    {"quiet", no_argument, NULL, 'q'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+/* Traced with --pins, --events and in the VCD file */
+static const CosimPin_t cosim_pins[] = {
+    {COSIM_MASTER, 'C', ADMIN_LED_PIN, "admin_led"},
+    {COSIM_MASTER, 'C', GUEST_LED_PIN, "guest_led"},
+    {COSIM_MASTER, 'C', BLOCK_LED_PIN, "block_led"},
+    {COSIM_MASTER, 'C', 3, "buzzer"}, /* PC3, BUZZER_PIN */
+    {COSIM_SLAVE, 'D', COSIM_ROOM1_PIN, "room1"},
+    {COSIM_SLAVE, 'D', COSIM_ROOM1_PIN + 1, "room2"},
+    {COSIM_SLAVE, 'D', COSIM_ROOM1_PIN + 2, "room3"},
+    {COSIM_SLAVE, 'D', COSIM_ROOM1_PIN + 3, "room4"},
+    {COSIM_SLAVE, 'D', COSIM_TV_PIN, "tv"},
+    {COSIM_SLAVE, 'D', COSIM_AC_PIN, "ac"},
+    {COSIM_SLAVE, 'D', COSIM_HEATER_PIN, "heater"},
+    {COSIM_SLAVE, 'B', 1, "fan_in1"},
+    {COSIM_SLAVE, 'B', 2, "fan_in2"}};
+
+static const char *const cosim_node_names[] = {"master", "slave"};
+
+static const char *const cosim_vector_names[COSIM_VECTOR_COUNT] = {
+    "RESET",        "INT0",         "INT1",        "INT2",
+    "TIMER2_COMP",  "TIMER2_OVF",   "TIMER1_CAPT", "TIMER1_COMPA",
+    "TIMER1_COMPB", "TIMER1_OVF",   "TIMER0_COMP", "TIMER0_OVF",
+    "SPI_STC",      "USART_RXC",    "USART_UDRE",  "USART_TXC",
+    "ADC",          "EE_RDY",       "ANA_COMP",    "TWI",
+    "SPM_RDY"};
+
+static avr_t *cosim_avr[2];
+static avr_irq_t *cosim_columns[4];
+static avr_irq_t *cosim_uart_input = NULL;
+static FILE *cosim_uart_in = NULL;
+static FILE *cosim_uart_out = NULL;
+static avr_vcd_t cosim_vcd;
+
+static uint64_t cosim_limit = SIM_NO_LIMIT; /* --time, in ns */
+static uint8_t cosim_trace_pins = 0;
+static uint8_t cosim_done = 0;
+static uint8_t cosim_lcd_enable = 0;
+static uint8_t cosim_spi_mosi = 0xFF; /* last byte sent by the master */
+
+static uint8_t cosim_isr_profile = 0; /* --isr */
+static CosimIsr_t cosim_isrs[2][COSIM_VECTOR_COUNT];
+static uint8_t cosim_isr_vector[2];          /* outermost running vector */
+static avr_cycle_count_t cosim_isr_entry[2]; /* cycle it was taken */
+static uint8_t cosim_isr_depth[2];           /* nesting after the last step */
+
+static uint8_t cosim_fan_on = 0;
+static uint64_t cosim_fan_rise = 0;
+static uint64_t cosim_fan_high = 0;   /* high time in the current window */
+static uint64_t cosim_fan_window = 0; /* start of the current window */
+static uint8_t cosim_fan_duty = 0;    /* percent, last full window */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Simulated time, the master's cycle counter is the time base
+ * @return Time in ns
+ */
+static uint64_t COSIM_u64Now(void) {
+  return cosim_avr[COSIM_MASTER]->cycle * SIM_NS_PER_CYCLE;
+}
+
+/**
+ * @brief  Create a core and load an ELF image into it
+ * @param  pcPath ELF file
+ * @return Core, exits with code 2 if the image cannot be read
+ */
+static avr_t *COSIM_pstLoad(const char *pcPath) {
+  elf_firmware_t stFirmware;
+  avr_t *pstAvr;
+
+  memset(&stFirmware, 0, sizeof(stFirmware));
+  if (elf_read_firmware(pcPath, &stFirmware) != 0) {
+    fprintf(stderr, "%s: cannot read the ELF image\n", pcPath);
+    exit(2);
+  }
+  /* The Studio images carry no .mmcu section */
+  strncpy(stFirmware.mmcu, COSIM_MCU, sizeof(stFirmware.mmcu) - 1);
+  stFirmware.frequency = COSIM_FREQUENCY;
+
+  pstAvr = avr_make_mcu_by_name(stFirmware.mmcu);
+  if (pstAvr == NULL) {
+    fprintf(stderr, "simavr has no %s core\n", COSIM_MCU);
+    exit(2);
+  }
+  avr_init(pstAvr);
+  avr_load_firmware(pstAvr, &stFirmware);
+  return pstAvr;
+}
+
+/**
+ * @brief  Load or save the EEPROM of a core
+ * @param  pstAvr Core
+ * @param  pcPath Image file, 1 KB raw, same format as the host build
+ * @param  u8Save 1 to save, 0 to load (a missing file keeps the ELF data)
+ * @return Void
+ */
+static void COSIM_vEeprom(avr_t *pstAvr, const char *pcPath, uint8_t u8Save) {
+  static uint8_t au8Image[COSIM_EEPROM_SIZE];
+  avr_eeprom_desc_t stDesc;
+  FILE *pFile;
+
+  stDesc.ee = au8Image;
+  stDesc.offset = 0;
+  stDesc.size = COSIM_EEPROM_SIZE;
+  if (u8Save != 0) {
+    avr_ioctl(pstAvr, AVR_IOCTL_EEPROM_GET, &stDesc);
+    pFile = fopen(pcPath, "wb");
+    if (pFile != NULL) {
+      (void)fwrite(au8Image, 1, COSIM_EEPROM_SIZE, pFile);
+      fclose(pFile);
+    }
+    return;
+  }
+  pFile = fopen(pcPath, "rb");
+  if (pFile == NULL) {
+    return;
+  }
+  if (fread(au8Image, 1, COSIM_EEPROM_SIZE, pFile) == COSIM_EEPROM_SIZE) {
+    avr_ioctl(pstAvr, AVR_IOCTL_EEPROM_SET, &stDesc);
+  }
+  fclose(pFile);
+}
+
+/**
+ * @brief  One pin of a port
+ * @param  pstAvr Core
+ * @param  cPort Port letter
+ * @param  u8Index IOPORT_IRQ_PINx, IOPORT_IRQ_PIN_ALL or IOPORT_IRQ_REG_PORT
+ * @return Pin IRQ
+ */
+static avr_irq_t *COSIM_pstPort(avr_t *pstAvr, char cPort, uint8_t u8Index) {
+  return avr_io_getirq(pstAvr, AVR_IOCTL_IOPORT_GETIRQ(cPort), u8Index);
+}
+
+/**
+ * @brief  Drive the keypad columns for the rows strobed right now
+ * @return Void
+ */
+static void COSIM_vDriveColumns(void) {
+  const uint8_t *pu8Data = cosim_avr[COSIM_MASTER]->data;
+  uint8_t u8RowsLow = (uint8_t)(pu8Data[COSIM_DDR(KEYPAD_ROW_PORT)] &
+                                ~pu8Data[COSIM_PORT(KEYPAD_ROW_PORT)]);
+  uint8_t u8Columns = SIM_u8KeysColumns(
+      (uint8_t)((u8RowsLow >> KEYPAD_FIRST_PIN) & 0x0F), COSIM_u64Now());
+  uint8_t u8Column;
+
+  for (u8Column = 0; u8Column < 4; u8Column++) {
+    avr_raise_irq(cosim_columns[u8Column],
+                  (u8Columns & (1 << u8Column)) ? 0 : 1);
+  }
+}
+
+/**
+ * @brief  PORT write on the keypad row port: answer before the next read
+ * @param  pstIrq Source IRQ
+ * @param  u32Value New PORT value
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void COSIM_vRowsWritten(avr_irq_t *pstIrq, uint32_t u32Value,
+                               void *pvParam) {
+  (void)pstIrq;
+  (void)u32Value;
+  (void)pvParam;
+  COSIM_vDriveColumns();
+}
+
+/**
+ * @brief  LCD enable line: latch the bus on the falling edge
+ * @param  pstIrq Source IRQ
+ * @param  u32Value New level
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void COSIM_vLcdEnable(avr_irq_t *pstIrq, uint32_t u32Value,
+                             void *pvParam) {
+  const uint8_t *pu8Data = cosim_avr[COSIM_MASTER]->data;
+  (void)pstIrq;
+  (void)pvParam;
+  if ((cosim_lcd_enable != 0) && (u32Value == 0)) {
+    SIM_vLcdLatch(pu8Data[COSIM_PORT(LCD_PORT)],
+                  (pu8Data[COSIM_PORT(LCD_CONTROL_PORT)] >> LCD_RS_PIN) & 1,
+                  COSIM_u64Now());
+  }
+  cosim_lcd_enable = (u32Value != 0) ? 1 : 0;
+}
+
+/**
+ * @brief  Traced output pin changed
+ * @param  pstIrq Source IRQ
+ * @param  u32Value New level
+ * @param  pvParam Entry of cosim_pins
+ * @return Void
+ */
+static void COSIM_vPinChanged(avr_irq_t *pstIrq, uint32_t u32Value,
+                              void *pvParam) {
+  const CosimPin_t *pstPin = (const CosimPin_t *)pvParam;
+  (void)pstIrq;
+  if (cosim_trace_pins != 0) {
+    printf("PIN %7llu ms %s %s=%u\n",
+           (unsigned long long)(COSIM_u64Now() / SIM_NS_PER_MS),
+           cosim_node_names[pstPin->u8Node], pstPin->pcName,
+           (unsigned)(u32Value != 0));
+  }
+  SIM_vEvent(COSIM_u64Now(), cosim_node_names[pstPin->u8Node], "PIN %s %u",
+             pstPin->pcName, (unsigned)(u32Value != 0));
+}
+
+/**
+ * @brief  Byte shifted out by the master, remembered for the slave's answer
+ * @param  pstIrq Source IRQ
+ * @param  u32Value Byte
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void COSIM_vSpiMaster(avr_irq_t *pstIrq, uint32_t u32Value,
+                             void *pvParam) {
+  (void)pstIrq;
+  (void)pvParam;
+  cosim_spi_mosi = (uint8_t)u32Value;
+}
+
+/**
+ * @brief  Byte shifted out by the slave: one exchange is complete
+ * @param  pstIrq Source IRQ
+ * @param  u32Value Byte
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void COSIM_vSpiSlave(avr_irq_t *pstIrq, uint32_t u32Value,
+                            void *pvParam) {
+  uint64_t u64Now = COSIM_u64Now();
+  (void)pstIrq;
+  (void)pvParam;
+  SIM_vEvent(u64Now, "master", "SPI rx=0x%02x tx=0x%02x",
+             (unsigned)(u32Value & 0xFF), cosim_spi_mosi);
+  SIM_vEvent(u64Now, "slave", "SPI rx=0x%02x tx=0x%02x", cosim_spi_mosi,
+             (unsigned)(u32Value & 0xFF));
+}
+
+/**
+ * @brief  Fan enable pin: integrate the high time of the soft PWM
+ * @param  pstIrq Source IRQ
+ * @param  u32Value New level
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void COSIM_vFanChanged(avr_irq_t *pstIrq, uint32_t u32Value,
+                              void *pvParam) {
+  uint64_t u64Now = COSIM_u64Now();
+  (void)pstIrq;
+  (void)pvParam;
+  if ((cosim_fan_on != 0) && (u32Value == 0)) {
+    cosim_fan_high += u64Now - cosim_fan_rise;
+  } else if ((cosim_fan_on == 0) && (u32Value != 0)) {
+    cosim_fan_rise = u64Now;
+  }
+  cosim_fan_on = (u32Value != 0) ? 1 : 0;
+}
+
+/**
+ * @brief  Close a fan measurement window every COSIM_FAN_WINDOW_MS
+ * @param  u64Now Simulated time in ns
+ * @return Void
+ */
+static void COSIM_vFanWindow(uint64_t u64Now) {
+  if (u64Now - cosim_fan_window < COSIM_FAN_WINDOW_MS * SIM_NS_PER_MS) {
+    return;
+  }
+  if (cosim_fan_on != 0) {
+    cosim_fan_high += u64Now - cosim_fan_rise;
+    cosim_fan_rise = u64Now;
+  }
+  cosim_fan_duty =
+      (uint8_t)((cosim_fan_high * 100 + (u64Now - cosim_fan_window) / 2) /
+                (u64Now - cosim_fan_window));
+  cosim_fan_high = 0;
+  cosim_fan_window = u64Now;
+}
+
+/**
+ * @brief  Byte sent by the master's UART
+ * @param  pstIrq Source IRQ
+ * @param  u32Value Byte
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void COSIM_vUartOutput(avr_irq_t *pstIrq, uint32_t u32Value,
+                              void *pvParam) {
+  (void)pstIrq;
+  (void)pvParam;
+  fputc((int)(u32Value & 0xFF), cosim_uart_out);
+  fflush(cosim_uart_out);
+}
+
+/**
+ * @brief  Periodic work on the master's clock
+ * @param  pstAvr Master core
+ * @param  u64When Cycle the timer was due
+ * @param  pvParam Unused
+ * @return Cycle of the next call
+ */
+static avr_cycle_count_t COSIM_u64Poll(avr_t *pstAvr, avr_cycle_count_t u64When,
+                                       void *pvParam) {
+  uint64_t u64Now = COSIM_u64Now();
+  int iByte;
+  (void)pvParam;
+
+  SIM_vKeysUpdate(u64Now);
+  COSIM_vDriveColumns();
+  SIM_vLcdTick(u64Now);
+  COSIM_vFanWindow(u64Now);
+
+  /* One console byte per poll, far below the line rate */
+  if (cosim_uart_in != NULL) {
+    iByte = fgetc(cosim_uart_in);
+    if (iByte != EOF) {
+      avr_raise_irq(cosim_uart_input, (uint32_t)iByte);
+    } else if (cosim_uart_in != stdin) {
+      fclose(cosim_uart_in);
+      cosim_uart_in = NULL;
+    } else {
+      clearerr(stdin); /* non-blocking: no byte yet */
+    }
+  }
+
+  if ((u64Now >= cosim_limit) ||
+      ((cosim_limit == SIM_NO_LIMIT) && (u64Now >= SIM_u64KeysDeadline()))) {
+    cosim_done = 1;
+  }
+  return u64When + avr_usec_to_cycles(pstAvr, COSIM_POLL_US);
+}
+
+/**
+ * @brief  Wire the boards around the two cores
+ * @param  pcUartIn Console input file, "-" for stdin, or NULL
+ * @param  pcUartOut Console output file or NULL for stderr
+ * @param  s32Temp Room temperature in degrees C
+ * @param  s32Ldr Raw LDR reading
+ * @return Void
+ */
+static void COSIM_vWire(const char *pcUartIn, const char *pcUartOut,
+                        int32_t s32Temp, int32_t s32Ldr) {
+  avr_t *pstMaster = cosim_avr[COSIM_MASTER];
+  avr_t *pstSlave = cosim_avr[COSIM_SLAVE];
+  uint32_t u32Flags = 0;
+  uint8_t u8Pin;
+  int32_t s32Millivolts;
+
+  /* MOSI and MISO: each core's shifted out byte is the other's input */
+  avr_connect_irq(
+      avr_io_getirq(pstMaster, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_OUTPUT),
+      avr_io_getirq(pstSlave, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_INPUT));
+  avr_connect_irq(
+      avr_io_getirq(pstSlave, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_OUTPUT),
+      avr_io_getirq(pstMaster, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_INPUT));
+  avr_irq_register_notify(
+      avr_io_getirq(pstMaster, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_OUTPUT),
+      COSIM_vSpiMaster, NULL);
+  avr_irq_register_notify(
+      avr_io_getirq(pstSlave, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_OUTPUT),
+      COSIM_vSpiSlave, NULL);
+
+  /* Keypad: columns idle high, answer every row strobe at once */
+  for (u8Pin = 0; u8Pin < 4; u8Pin++) {
+    cosim_columns[u8Pin] = COSIM_pstPort(pstMaster, KEYPAD_PORT,
+                                         (uint8_t)(KEYPAD_FIFTH_PIN + u8Pin));
+    avr_raise_irq(cosim_columns[u8Pin], 1);
+  }
+  avr_irq_register_notify(
+      COSIM_pstPort(pstMaster, KEYPAD_ROW_PORT, IOPORT_IRQ_REG_PORT),
+      COSIM_vRowsWritten, NULL);
+
+  avr_irq_register_notify(
+      COSIM_pstPort(pstMaster, LCD_CONTROL_PORT, LCD_EN_PIN), COSIM_vLcdEnable,
+      NULL);
+
+  for (u8Pin = 0; u8Pin < sizeof(cosim_pins) / sizeof(cosim_pins[0]);
+       u8Pin++) {
+    if ((cosim_trace_pins != 0) || (SIM_u8EventsOn() != 0)) {
+      avr_irq_register_notify(COSIM_pstPort(cosim_avr[cosim_pins[u8Pin].u8Node],
+                                            cosim_pins[u8Pin].cPort,
+                                            cosim_pins[u8Pin].u8Pin),
+                              COSIM_vPinChanged, (void *)&cosim_pins[u8Pin]);
+    }
+  }
+  avr_irq_register_notify(COSIM_pstPort(pstSlave, 'B', COSIM_FAN_EN_PIN),
+                          COSIM_vFanChanged, NULL);
+
+  /* Sensor voltages, held for the whole run */
+  s32Millivolts = s32Temp * COSIM_TEMP_MV_PER_C;
+  avr_raise_irq(avr_io_getirq(pstSlave, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0),
+                (uint32_t)((s32Millivolts > 0) ? s32Millivolts : 0));
+  s32Millivolts = s32Ldr * COSIM_VREF_MV / 1024;
+  avr_raise_irq(avr_io_getirq(pstSlave, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC1),
+                (uint32_t)((s32Millivolts > 0) ? s32Millivolts : 0));
+
+  /* Console: bytes go to a file instead of simavr's own line printer */
+  avr_ioctl(pstMaster, AVR_IOCTL_UART_GET_FLAGS('0'), &u32Flags);
+  u32Flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(pstMaster, AVR_IOCTL_UART_SET_FLAGS('0'), &u32Flags);
+  cosim_uart_out = stderr;
+  if (pcUartOut != NULL) {
+    cosim_uart_out = fopen(pcUartOut, "w");
+    if (cosim_uart_out == NULL) {
+      perror(pcUartOut);
+      exit(2);
+    }
+  }
+  avr_irq_register_notify(
+      avr_io_getirq(pstMaster, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+      COSIM_vUartOutput, NULL);
+  cosim_uart_input =
+      avr_io_getirq(pstMaster, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+  if (pcUartIn != NULL) {
+    if (strcmp(pcUartIn, "-") == 0) {
+      (void)fcntl(STDIN_FILENO, F_SETFL,
+                  fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+      cosim_uart_in = stdin;
+    } else if ((cosim_uart_in = fopen(pcUartIn, "rb")) == NULL) {
+      perror(pcUartIn);
+      exit(2);
+    }
+  }
+
+  avr_cycle_timer_register_usec(pstMaster, COSIM_POLL_US, COSIM_u64Poll, NULL);
+}
+
+/**
+ * @brief  Record the buses and outputs of both boards
+ * @param  pcPath VCD file
+ * @return Void
+ */
+static void COSIM_vStartVcd(const char *pcPath) {
+  avr_t *pstMaster = cosim_avr[COSIM_MASTER];
+  avr_t *pstSlave = cosim_avr[COSIM_SLAVE];
+  char acName[32];
+  uint8_t u8Pin;
+
+  avr_vcd_init(pstMaster, pcPath, &cosim_vcd, COSIM_VCD_PERIOD_US);
+  avr_vcd_add_signal(&cosim_vcd,
+                     COSIM_pstPort(pstMaster, LCD_PORT, IOPORT_IRQ_PIN_ALL), 8,
+                     "master_lcd_data");
+  avr_vcd_add_signal(&cosim_vcd,
+                     COSIM_pstPort(pstMaster, LCD_CONTROL_PORT, LCD_EN_PIN), 1,
+                     "master_lcd_en");
+  avr_vcd_add_signal(&cosim_vcd,
+                     COSIM_pstPort(pstMaster, LCD_CONTROL_PORT, LCD_RS_PIN), 1,
+                     "master_lcd_rs");
+  avr_vcd_add_signal(
+      &cosim_vcd, COSIM_pstPort(pstMaster, KEYPAD_ROW_PORT, IOPORT_IRQ_PIN_ALL),
+      8, "master_keypad_rows");
+  avr_vcd_add_signal(&cosim_vcd,
+                     COSIM_pstPort(pstMaster, KEYPAD_PORT, IOPORT_IRQ_PIN_ALL),
+                     8, "master_keypad_columns");
+  avr_vcd_add_signal(
+      &cosim_vcd,
+      avr_io_getirq(pstMaster, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_OUTPUT), 8,
+      "master_spi_tx");
+  avr_vcd_add_signal(
+      &cosim_vcd,
+      avr_io_getirq(pstSlave, AVR_IOCTL_SPI_GETIRQ('0'), SPI_IRQ_OUTPUT), 8,
+      "slave_spi_tx");
+  avr_vcd_add_signal(&cosim_vcd, COSIM_pstPort(pstSlave, 'B', COSIM_FAN_EN_PIN),
+                     1, "slave_fan_en");
+  for (u8Pin = 0; u8Pin < sizeof(cosim_pins) / sizeof(cosim_pins[0]);
+       u8Pin++) {
+    snprintf(acName, sizeof(acName), "%s_%s",
+             cosim_node_names[cosim_pins[u8Pin].u8Node],
+             cosim_pins[u8Pin].pcName);
+    avr_vcd_add_signal(&cosim_vcd,
+                       COSIM_pstPort(cosim_avr[cosim_pins[u8Pin].u8Node],
+                                     cosim_pins[u8Pin].cPort,
+                                     cosim_pins[u8Pin].u8Pin),
+                       1, strdup(acName)); /* simavr keeps the pointer */
+  }
+  avr_vcd_start(&cosim_vcd);
+}
+
+/**
+ * @brief  Follow the interrupt nesting of a core after one step
+ * @param  u8Node COSIM_MASTER or COSIM_SLAVE
+ * @return Void
+ */
+static void COSIM_vTrackIsr(uint8_t u8Node) {
+  avr_t *pstAvr = cosim_avr[u8Node];
+  uint8_t u8Depth = pstAvr->interrupts.running_ptr;
+  uint64_t u64Cycles;
+  CosimIsr_t *pstIsr;
+
+  if ((u8Depth > 0) && (cosim_isr_depth[u8Node] == 0)) {
+    cosim_isr_vector[u8Node] =
+        pstAvr->interrupts.running[0]->vector % COSIM_VECTOR_COUNT;
+    cosim_isr_entry[u8Node] = pstAvr->cycle;
+  } else if ((u8Depth == 0) && (cosim_isr_depth[u8Node] > 0)) {
+    pstIsr = &cosim_isrs[u8Node][cosim_isr_vector[u8Node]];
+    u64Cycles = pstAvr->cycle - cosim_isr_entry[u8Node];
+    if ((pstIsr->u64Count == 0) || (u64Cycles < pstIsr->u64Min)) {
+      pstIsr->u64Min = u64Cycles;
+    }
+    if (u64Cycles > pstIsr->u64Max) {
+      pstIsr->u64Max = u64Cycles;
+    }
+    pstIsr->u64Cycles += u64Cycles;
+    pstIsr->u64Count++;
+  }
+  cosim_isr_depth[u8Node] = u8Depth;
+}
+
+/**
+ * @brief  Print the statistics of every vector that ran
+ * @return Void
+ */
+static void COSIM_vPrintIsrs(void) {
+  const CosimIsr_t *pstIsr;
+  uint8_t u8Node;
+  uint8_t u8Vector;
+
+  for (u8Node = COSIM_MASTER; u8Node <= COSIM_SLAVE; u8Node++) {
+    for (u8Vector = 0; u8Vector < COSIM_VECTOR_COUNT; u8Vector++) {
+      pstIsr = &cosim_isrs[u8Node][u8Vector];
+      if (pstIsr->u64Count == 0) {
+        continue;
+      }
+      printf("ISR %-6s %-12s n=%llu min=%llu max=%llu mean=%llu "
+             "load=%.3f%%\n",
+             cosim_node_names[u8Node], cosim_vector_names[u8Vector],
+             (unsigned long long)pstIsr->u64Count,
+             (unsigned long long)pstIsr->u64Min,
+             (unsigned long long)pstIsr->u64Max,
+             (unsigned long long)(pstIsr->u64Cycles / pstIsr->u64Count),
+             100.0 * pstIsr->u64Cycles / cosim_avr[u8Node]->cycle);
+    }
+  }
+}
+
+/**
+ * @brief  Print the final display, LEDs and slave outputs
+ * @return Void
+ */
+static void COSIM_vPrintFinal(void) {
+  const uint8_t *pu8Master = cosim_avr[COSIM_MASTER]->data;
+  uint8_t u8PortD = cosim_avr[COSIM_SLAVE]->data[COSIM_PORT('D')];
+  uint64_t u64Now = COSIM_u64Now();
+
+  SIM_vLcdPrint("END", u64Now);
+  printf("LED admin=%d guest=%d block=%d keys=%u/%u\n",
+         (pu8Master[COSIM_PORT(ADMIN_LED_PORT)] >> ADMIN_LED_PIN) & 1,
+         (pu8Master[COSIM_PORT(GUEST_LED_PORT)] >> GUEST_LED_PIN) & 1,
+         (pu8Master[COSIM_PORT(BLOCK_LED_PORT)] >> BLOCK_LED_PIN) & 1,
+         SIM_u16KeysDone(), SIM_u16KeysTotal());
+  if (SIM_u8KeysStuck(u64Now) != 0) {
+    printf("STUCK key=%c waited=%llu ms\n", SIM_cKeysCurrent(),
+           (unsigned long long)(SIM_u64KeysWaiting(u64Now) / SIM_NS_PER_MS));
+  }
+  printf("SLAVE %7llu ms rooms=%d%d%d%d tv=%d ac=%d heater=%d fan=%d%%\n",
+         (unsigned long long)(u64Now / SIM_NS_PER_MS),
+         (u8PortD >> COSIM_ROOM1_PIN) & 1,
+         (u8PortD >> (COSIM_ROOM1_PIN + 1)) & 1,
+         (u8PortD >> (COSIM_ROOM1_PIN + 2)) & 1,
+         (u8PortD >> (COSIM_ROOM1_PIN + 3)) & 1, (u8PortD >> COSIM_TV_PIN) & 1,
+         (u8PortD >> COSIM_AC_PIN) & 1, (u8PortD >> COSIM_HEATER_PIN) & 1,
+         cosim_fan_duty);
+}
+
+/**
+ * @brief  Print the command line syntax
+ * @param  pcProgram argv[0]
+ * @return Void
+ */
+static void COSIM_vUsage(const char *pcProgram) {
+  fprintf(stderr,
+          "usage: %s [--keys SCRIPT] [--time MS] [--uart-in FILE] "
+          "[--uart-out FILE] [--eeprom-dir DIR] [--temp C] [--ldr N] "
+          "[--vcd FILE] [--pins] [--events FILE] [--isr] [--quiet] "
+          "MASTER.elf SLAVE.elf\n",
+          pcProgram);
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 at the end of the run, 1 if a core crashed, 2 on bad usage
+ */
+int main(int argc, char *argv[]) {
+  const char *pcKeys = NULL;
+  const char *pcUartIn = NULL;
+  const char *pcUartOut = NULL;
+  const char *pcEepromDir = NULL;
+  const char *pcVcd = NULL;
+  const char *pcEvents = NULL;
+  FILE *pEvents;
+  char acEeprom[2][COSIM_PATH_SIZE];
+  int32_t s32Temp = 24;
+  int32_t s32Ldr = 800;
+  uint8_t u8Trace = 1;
+  uint8_t u8Node;
+  int iOption;
+  int iState;
+  int iResult = 0;
+
+  while ((iOption = getopt_long(argc, argv, "", cosim_options, NULL)) != -1) {
+    switch (iOption) {
+    case 'k':
+      pcKeys = optarg;
+      break;
+    case 't':
+      cosim_limit = strtoull(optarg, NULL, 10) * SIM_NS_PER_MS;
+      break;
+    case 'i':
+      pcUartIn = optarg;
+      break;
+    case 'o':
+      pcUartOut = optarg;
+      break;
+    case 'e':
+      pcEepromDir = optarg;
+      break;
+    case 'c':
+      s32Temp = (int32_t)strtol(optarg, NULL, 0);
+      break;
+    case 'l':
+      s32Ldr = (int32_t)strtol(optarg, NULL, 0);
+      break;
+    case 'v':
+      pcVcd = optarg;
+      break;
+    case 'p':
+      cosim_trace_pins = 1;
+      break;
+    case 'x':
+      pcEvents = optarg;
+      break;
+    case 'r':
+      cosim_isr_profile = 1;
+      break;
+    case 'q':
+      u8Trace = 0;
+      break;
+    default:
+      COSIM_vUsage(argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+  if (argc - optind != 2) {
+    COSIM_vUsage(argv[0]);
+    return 2;
+  }
+
+  if (pcEvents != NULL) {
+    pEvents = fopen(pcEvents, "w");
+    if (pEvents == NULL) {
+      perror(pcEvents);
+      return 2;
+    }
+    fclose(pEvents);
+    SIM_vEventsOpen(pcEvents, "master");
+  }
+  SIM_vLcdInit(u8Trace);
+  SIM_vKeysInit(pcKeys);
+  cosim_avr[COSIM_MASTER] = COSIM_pstLoad(argv[optind]);
+  cosim_avr[COSIM_SLAVE] = COSIM_pstLoad(argv[optind + 1]);
+  if (pcEepromDir != NULL) {
+    for (u8Node = COSIM_MASTER; u8Node <= COSIM_SLAVE; u8Node++) {
+      snprintf(acEeprom[u8Node], COSIM_PATH_SIZE, "%s/%s.eep", pcEepromDir,
+               cosim_node_names[u8Node]);
+      COSIM_vEeprom(cosim_avr[u8Node], acEeprom[u8Node], 0);
+    }
+  }
+  COSIM_vWire(pcUartIn, pcUartOut, s32Temp, s32Ldr);
+  if (pcVcd != NULL) {
+    COSIM_vStartVcd(pcVcd);
+  }
+
+  /* Lockstep: always step the core that is behind */
+  while (cosim_done == 0) {
+    u8Node = (cosim_avr[COSIM_MASTER]->cycle <= cosim_avr[COSIM_SLAVE]->cycle)
+                 ? COSIM_MASTER
+                 : COSIM_SLAVE;
+    iState = avr_run(cosim_avr[u8Node]);
+    if (cosim_isr_profile != 0) {
+      COSIM_vTrackIsr(u8Node);
+    }
+    if ((iState == cpu_Done) || (iState == cpu_Crashed)) {
+      fprintf(stderr, "%s stopped (%s)\n", cosim_node_names[u8Node],
+              (iState == cpu_Crashed) ? "crashed" : "halted");
+      iResult = (iState == cpu_Crashed) ? 1 : 0;
+      break;
+    }
+  }
+
+  COSIM_vPrintFinal();
+  if (cosim_isr_profile != 0) {
+    COSIM_vPrintIsrs();
+  }
+  if (pcVcd != NULL) {
+    avr_vcd_stop(&cosim_vcd);
+    avr_vcd_close(&cosim_vcd);
+  }
+  if (pcEepromDir != NULL) {
+    for (u8Node = COSIM_MASTER; u8Node <= COSIM_SLAVE; u8Node++) {
+      COSIM_vEeprom(cosim_avr[u8Node], acEeprom[u8Node], 1);
+    }
+  }
+  fflush(stdout);
+  return iResult;
+}
\ No newline at end of file
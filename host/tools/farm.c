@@ -0,0 +1,721 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: farm.c
+ * Description: Parallel sweeps of the slave climate thresholds
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_farm [options]
+ *   --heater LIST     heater on below, SIM_HEATER_ON_C (default 10)
+ *   --ac LIST         AC on above, SIM_AC_ON_C (default 25)
+ *   --fan LIST        auto fan on above, SIM_MIN_FAN_C (default 30)
+ *   --fan-max LIST    full fan speed, SIM_MAX_FAN_C (default 40)
+ *   --gain LIST       fan duty percent per degree, SIM_FAN_GAIN (default 10)
+ *   --outside LIST    constant weather profiles in C (default 0,35)
+ *   --weather FILE    CSV weather profile for --trace, may be repeated
+ *   --temp C          room temperature at reset (default 24)
+ *   --time MS         simulated time of every run (default 4 h)
+ *   --band LOW:HIGH   comfort band of the score (default the model's)
+ *   --weight WH       energy charged per degree-hour outside the band
+ *   --jobs N          simulations at a time (default one per core)
+ *   --top N           parameter sets in the ranked report (default 10)
+ *   --out FILE        append every run to a CSV file
+ *   --slave PROGRAM   slave host build to run
+ *
+ * A LIST is comma separated values or FIRST:LAST:STEP ranges, e.g.
+ * "8:12:2,15". Every combination of the lists is one parameter set, run
+ * once against every weather profile with the room model of
+ * sim/sim_plant.c. The firmware keeps its globals per process, so each run
+ * is a slave process; a pool of worker threads keeps --jobs of them busy.
+ *
+ * Sets are ranked by cost: the energy of all runs plus --weight Wh per
+ * degree-hour outside the band. The firmware defaults are marked with *.
+ * The exit code is 1 if a run failed.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#define _GNU_SOURCE /* pipe2 */
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#ifndef SIM_FARM_SLAVE
+#define SIM_FARM_SLAVE "smarthome_slave_host"
+#endif
+
+#define FARM_PARAM_COUNT 5
+#define FARM_VALUE_MAX 64 /* values per list */
+#define FARM_PROFILE_MAX 32
+#define FARM_ENV_SIZE 64
+#define FARM_ENV_COUNT 12 /* variables set per run, at most */
+#define FARM_OUTPUT_SIZE 1024
+
+#define FARM_TIME_MS 14400000L
+#define FARM_TEMP_C 24
+#define FARM_WEIGHT_WH 1000.0
+#define FARM_TOP 10
+
+#define FARM_HEATER 0
+#define FARM_AC 1
+#define FARM_FAN 2
+#define FARM_ACTUATOR_COUNT 3
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  const char *pcOption;
+  const char *pcVariable;
+  const char *pcColumn;
+  int32_t s32Default; /* of APP/main.c */
+  int32_t as32Values[FARM_VALUE_MAX];
+  int iCount;
+} FarmParam_t;
+
+typedef struct {
+  const char *pcTrace; /* NULL for a constant outside temperature */
+  int32_t s32Outside;
+  char acName[FARM_ENV_SIZE];
+} FarmProfile_t;
+
+typedef struct {
+  uint8_t u8Ok;
+  double dInBand;     /* percent */
+  double dDiscomfort; /* K h */
+  long lSettle;       /* ms, -1 never */
+  double dOvershoot;  /* C, -1 never in band */
+  unsigned long aulSwitches[FARM_ACTUATOR_COUNT];
+  double adEnergy[FARM_ACTUATOR_COUNT]; /* Wh */
+} FarmResult_t;
+
+typedef struct {
+  size_t sSet;
+  double dCost;
+  double dEnergy;
+  double dDiscomfort;
+  double dInBand; /* mean */
+  unsigned long ulSwitches;
+  double dOvershoot; /* worst */
+  uint8_t u8Ok;
+} FarmRank_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static FarmParam_t farm_params[FARM_PARAM_COUNT] = {
+    {"heater", "SIM_HEATER_ON_C", "heater_on_c", 10, {0}, 0},
+    {"ac", "SIM_AC_ON_C", "ac_on_c", 25, {0}, 0},
+    {"fan", "SIM_MIN_FAN_C", "min_fan_c", 30, {0}, 0},
+    {"fan-max", "SIM_MAX_FAN_C", "max_fan_c", 40, {0}, 0},
+    {"gain", "SIM_FAN_GAIN", "fan_gain", 10, {0}, 0}};
+
+static const char *const farm_actuators[FARM_ACTUATOR_COUNT] = {
+    "HEATER", "AC", "FAN"};
+
+static const struct option farm_options[] = {
+    {"heater", required_argument, NULL, 0},
+    {"ac", required_argument, NULL, 1},
+    {"fan", required_argument, NULL, 2},
+    {"fan-max", required_argument, NULL, 3},
+    {"gain", required_argument, NULL, 4},
+    {"outside", required_argument, NULL, 'x'},
+    {"weather", required_argument, NULL, 'w'},
+    {"temp", required_argument, NULL, 'c'},
+    {"time", required_argument, NULL, 't'},
+    {"band", required_argument, NULL, 'b'},
+    {"weight", required_argument, NULL, 'g'},
+    {"jobs", required_argument, NULL, 'j'},
+    {"top", required_argument, NULL, 'n'},
+    {"out", required_argument, NULL, 'o'},
+    {"slave", required_argument, NULL, 's'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+static const char *farm_slave = SIM_FARM_SLAVE;
+static FarmProfile_t farm_profiles[FARM_PROFILE_MAX];
+static int farm_profile_count = 0;
+static long farm_time_ms = FARM_TIME_MS;
+static int32_t farm_temp = FARM_TEMP_C;
+static const char *farm_band = NULL;
+static char **farm_environ = NULL; /* inherited, without SIM_ variables */
+static size_t farm_environ_count = 0;
+
+/* Work queue: run n is set n / farm_profile_count against profile
+   n % farm_profile_count */
+static size_t farm_set_count = 0;
+static size_t farm_run_count = 0;
+static size_t farm_next_run = 0;
+static FarmResult_t *farm_results = NULL;
+static pthread_mutex_t farm_lock = PTHREAD_MUTEX_INITIALIZER; /* next run */
+
+extern char **environ;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Parse a LIST option into values
+ * @param  pcList "a,b,first:last:step"
+ * @param  ps32Values Receives the values
+ * @param  piCount Receives the number of values
+ * @return 1 on success, 0 on a malformed list
+ */
+static uint8_t FARM_u8ParseList(const char *pcList, int32_t *ps32Values,
+                                int *piCount) {
+  const char *pcItem = pcList;
+  char *pcEnd;
+  long lFirst;
+  long lLast;
+  long lStep;
+  long lValue;
+
+  *piCount = 0;
+  while (*pcItem != '\0') {
+    lFirst = strtol(pcItem, &pcEnd, 10);
+    if (pcEnd == pcItem) {
+      return 0;
+    }
+    lLast = lFirst;
+    lStep = 1;
+    if (*pcEnd == ':') {
+      pcItem = pcEnd + 1;
+      lLast = strtol(pcItem, &pcEnd, 10);
+      if ((pcEnd == pcItem) || (*pcEnd != ':')) {
+        return 0;
+      }
+      pcItem = pcEnd + 1;
+      lStep = strtol(pcItem, &pcEnd, 10);
+      if ((pcEnd == pcItem) || (lStep <= 0)) {
+        return 0;
+      }
+    }
+    for (lValue = lFirst; lValue <= lLast; lValue += lStep) {
+      if (*piCount == FARM_VALUE_MAX) {
+        return 0;
+      }
+      ps32Values[(*piCount)++] = (int32_t)lValue;
+    }
+    if (*pcEnd == ',') {
+      pcEnd++;
+    } else if (*pcEnd != '\0') {
+      return 0;
+    }
+    pcItem = pcEnd;
+  }
+  return (uint8_t)(*piCount > 0);
+}
+
+/**
+ * @brief  Value of a parameter in a set
+ * @param  sSet Set number
+ * @param  iParam Parameter number
+ * @return Value
+ */
+static int32_t FARM_s32Value(size_t sSet, int iParam) {
+  int iIndex;
+  for (iIndex = FARM_PARAM_COUNT - 1; iIndex > iParam; iIndex--) {
+    sSet /= (size_t)farm_params[iIndex].iCount;
+  }
+  return farm_params[iParam]
+      .as32Values[sSet % (size_t)farm_params[iParam].iCount];
+}
+
+/**
+ * @brief  Copy the environment without the SIM_ variables of the caller
+ * @return Void
+ */
+static void FARM_vInheritEnvironment(void) {
+  size_t sCount = 0;
+  size_t sIndex;
+  while (environ[sCount] != NULL) {
+    sCount++;
+  }
+  farm_environ = calloc(sCount, sizeof(char *));
+  if ((farm_environ == NULL) && (sCount > 0)) {
+    perror("calloc");
+    exit(1);
+  }
+  for (sIndex = 0; sIndex < sCount; sIndex++) {
+    if (strncmp(environ[sIndex], "SIM_", 4) != 0) {
+      farm_environ[farm_environ_count++] = environ[sIndex];
+    }
+  }
+}
+
+/**
+ * @brief  Read a number after "key=" in a report line
+ * @param  pcLine Report line
+ * @param  pcKey Key with its "="
+ * @param  pdValue Receives the value, untouched if the key is missing
+ * @return 1 if a number was read, 0 otherwise
+ */
+static uint8_t FARM_u8Field(const char *pcLine, const char *pcKey,
+                            double *pdValue) {
+  const char *pcValue = strstr(pcLine, pcKey);
+  char *pcEnd;
+  double dValue;
+  if (pcValue == NULL) {
+    return 0;
+  }
+  pcValue += strlen(pcKey);
+  dValue = strtod(pcValue, &pcEnd);
+  if (pcEnd == pcValue) {
+    return 0;
+  }
+  *pdValue = dValue;
+  return 1;
+}
+
+/**
+ * @brief  Fill a result from the report of a slave run
+ * @param  pcOutput Standard output of the run
+ * @param  pstResult Receives the metrics
+ * @return Void
+ */
+static void FARM_vParse(char *pcOutput, FarmResult_t *pstResult) {
+  char *pcLine;
+  char *pcSave = NULL;
+  double dValue;
+  int iActuator;
+
+  pstResult->lSettle = -1;
+  pstResult->dOvershoot = -1.0;
+  for (pcLine = strtok_r(pcOutput, "\n", &pcSave); pcLine != NULL;
+       pcLine = strtok_r(NULL, "\n", &pcSave)) {
+    if (strncmp(pcLine, "PLANT ", 6) == 0) {
+      pstResult->u8Ok = (uint8_t)(
+          FARM_u8Field(pcLine, "in_band=", &pstResult->dInBand) &&
+          FARM_u8Field(pcLine, "discomfort=", &pstResult->dDiscomfort));
+      if (FARM_u8Field(pcLine, "settle=", &dValue)) {
+        pstResult->lSettle = (long)dValue;
+      }
+      (void)FARM_u8Field(pcLine, "overshoot=", &pstResult->dOvershoot);
+      continue;
+    }
+    for (iActuator = 0; iActuator < FARM_ACTUATOR_COUNT; iActuator++) {
+      if ((strncmp(pcLine, farm_actuators[iActuator],
+                   strlen(farm_actuators[iActuator])) == 0) &&
+          (pcLine[strlen(farm_actuators[iActuator])] == ' ')) {
+        if (FARM_u8Field(pcLine, "switches=", &dValue)) {
+          pstResult->aulSwitches[iActuator] = (unsigned long)dValue;
+        }
+        (void)FARM_u8Field(pcLine, "energy=", &pstResult->adEnergy[iActuator]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Run one set against one profile in a slave process
+ * @param  sRun Run number
+ * @param  pstResult Receives the metrics, u8Ok is 0 if the run failed
+ * @return Void
+ */
+static void FARM_vRun(size_t sRun, FarmResult_t *pstResult) {
+  size_t sSet = sRun / (size_t)farm_profile_count;
+  const FarmProfile_t *pstProfile =
+      &farm_profiles[sRun % (size_t)farm_profile_count];
+  char aacEnv[FARM_ENV_COUNT][FARM_ENV_SIZE];
+  char *const apcArgs[] = {(char *)farm_slave, NULL};
+  char *pcOutput = NULL;
+  char **ppcEnviron;
+  size_t sSize = 0;
+  size_t sUsed = 0;
+  ssize_t sRead;
+  int aiPipe[2];
+  int iCount = 0;
+  int iStatus = 0;
+  int iParam;
+  int iIndex;
+  long lLow;
+  long lHigh;
+  pid_t sPid;
+
+  memset(pstResult, 0, sizeof(*pstResult));
+  for (iParam = 0; iParam < FARM_PARAM_COUNT; iParam++) {
+    snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "%s=%ld",
+             farm_params[iParam].pcVariable, (long)FARM_s32Value(sSet, iParam));
+  }
+  snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_TIME_LIMIT_MS=%ld",
+           farm_time_ms);
+  snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_PLANT=1");
+  snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_TEMP_C=%ld", (long)farm_temp);
+  if (pstProfile->pcTrace != NULL) {
+    snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_TRACE=%s",
+             pstProfile->pcTrace);
+  } else {
+    snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_OUTSIDE_C=%ld",
+             (long)pstProfile->s32Outside);
+  }
+  if ((farm_band != NULL) &&
+      (sscanf(farm_band, "%ld:%ld", &lLow, &lHigh) == 2)) {
+    snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_BAND_LOW_C=%ld", lLow);
+    snprintf(aacEnv[iCount++], FARM_ENV_SIZE, "SIM_BAND_HIGH_C=%ld", lHigh);
+  }
+  /* The run's variables, then the inherited ones */
+  ppcEnviron =
+      calloc((size_t)iCount + farm_environ_count + 1, sizeof(char *));
+  if (ppcEnviron == NULL) {
+    perror("calloc");
+    exit(1);
+  }
+  for (iIndex = 0; iIndex < iCount; iIndex++) {
+    ppcEnviron[iIndex] = aacEnv[iIndex];
+  }
+  memcpy(&ppcEnviron[iCount], farm_environ,
+         farm_environ_count * sizeof(char *));
+
+  /* Close on exec, so the other workers' children do not hold the pipe */
+  if (pipe2(aiPipe, O_CLOEXEC) != 0) {
+    free(ppcEnviron);
+    return;
+  }
+  sPid = fork();
+  if (sPid == 0) {
+    dup2(aiPipe[1], STDOUT_FILENO);
+    execve(farm_slave, apcArgs, ppcEnviron);
+    _exit(127);
+  }
+  free(ppcEnviron);
+  close(aiPipe[1]);
+
+  do {
+    if (sSize - sUsed < FARM_OUTPUT_SIZE) {
+      sSize += FARM_OUTPUT_SIZE;
+      pcOutput = realloc(pcOutput, sSize + 1);
+      if (pcOutput == NULL) {
+        perror("realloc");
+        exit(1);
+      }
+    }
+    sRead = read(aiPipe[0], pcOutput + sUsed, sSize - sUsed);
+    if (sRead > 0) {
+      sUsed += (size_t)sRead;
+    }
+  } while (sRead > 0);
+  close(aiPipe[0]);
+
+  if ((sPid > 0) && (waitpid(sPid, &iStatus, 0) == sPid) &&
+      WIFEXITED(iStatus) && (WEXITSTATUS(iStatus) == 0) &&
+      (pcOutput != NULL)) {
+    pcOutput[sUsed] = '\0';
+    FARM_vParse(pcOutput, pstResult);
+  }
+  free(pcOutput);
+}
+
+/**
+ * @brief  Worker thread: takes runs off the queue until it is empty
+ * @param  pvArg Unused
+ * @return NULL
+ */
+static void *FARM_pvWorker(void *pvArg) {
+  size_t sRun;
+  (void)pvArg;
+  while (1) {
+    pthread_mutex_lock(&farm_lock);
+    sRun = farm_next_run++;
+    pthread_mutex_unlock(&farm_lock);
+    if (sRun >= farm_run_count) {
+      return NULL;
+    }
+    FARM_vRun(sRun, &farm_results[sRun]);
+  }
+}
+
+/**
+ * @brief  Order sets by cost, failed sets last
+ * @param  pvA First set
+ * @param  pvB Second set
+ * @return qsort order
+ */
+static int FARM_iCompare(const void *pvA, const void *pvB) {
+  const FarmRank_t *pstA = pvA;
+  const FarmRank_t *pstB = pvB;
+  if (pstA->u8Ok != pstB->u8Ok) {
+    return pstA->u8Ok ? -1 : 1;
+  }
+  if (pstA->dCost != pstB->dCost) {
+    return (pstA->dCost < pstB->dCost) ? -1 : 1;
+  }
+  return (pstA->sSet < pstB->sSet) ? -1 : 1;
+}
+
+/**
+ * @brief  Append every run to the CSV file, with a header if it is new
+ * @param  pcPath CSV path
+ * @param  dWeight Wh per degree-hour
+ * @return 1 on success, 0 if the file could not be written
+ */
+static uint8_t FARM_u8WriteCsv(const char *pcPath, double dWeight) {
+  const FarmResult_t *pstResult;
+  struct stat stInfo;
+  uint8_t u8New = ((stat(pcPath, &stInfo) != 0) || (stInfo.st_size == 0));
+  double dEnergy;
+  size_t sRun;
+  int iParam;
+  FILE *pFile = fopen(pcPath, "a");
+
+  if (pFile == NULL) {
+    return 0;
+  }
+  if (u8New) {
+    for (iParam = 0; iParam < FARM_PARAM_COUNT; iParam++) {
+      fprintf(pFile, "%s,", farm_params[iParam].pcColumn);
+    }
+    fprintf(pFile, "weather,ok,in_band_pct,discomfort_kh,settle_ms,"
+                   "overshoot_c,heater_switches,ac_switches,fan_switches,"
+                   "energy_wh,cost\n");
+  }
+  for (sRun = 0; sRun < farm_run_count; sRun++) {
+    pstResult = &farm_results[sRun];
+    for (iParam = 0; iParam < FARM_PARAM_COUNT; iParam++) {
+      fprintf(pFile, "%ld,",
+              (long)FARM_s32Value(sRun / (size_t)farm_profile_count, iParam));
+    }
+    dEnergy = pstResult->adEnergy[FARM_HEATER] + pstResult->adEnergy[FARM_AC] +
+              pstResult->adEnergy[FARM_FAN];
+    fprintf(pFile, "%s,%u,%.1f,%.3f,%ld,%.1f,%lu,%lu,%lu,%.1f,%.1f\n",
+            farm_profiles[sRun % (size_t)farm_profile_count].acName,
+            pstResult->u8Ok, pstResult->dInBand, pstResult->dDiscomfort,
+            pstResult->lSettle, pstResult->dOvershoot,
+            pstResult->aulSwitches[FARM_HEATER],
+            pstResult->aulSwitches[FARM_AC], pstResult->aulSwitches[FARM_FAN],
+            dEnergy, dEnergy + dWeight * pstResult->dDiscomfort);
+  }
+  fclose(pFile);
+  return 1;
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 if every run completed, 1 otherwise, 2 on bad usage
+ */
+int main(int argc, char *argv[]) {
+  const char *pcOut = NULL;
+  const char *pcOutside = NULL;
+  const char *pcName;
+  const FarmResult_t *pstResult;
+  FarmRank_t *pstRanks;
+  FarmRank_t *pstRank;
+  pthread_t *psThreads;
+  struct timespec stStart;
+  struct timespec stEnd;
+  int32_t as32Outside[FARM_VALUE_MAX];
+  double dWeight = FARM_WEIGHT_WH;
+  long lJobs = sysconf(_SC_NPROCESSORS_ONLN);
+  long lTop = FARM_TOP;
+  long lThread;
+  size_t sSet;
+  size_t sRun;
+  int iProfile;
+  int iParam;
+  int iCount;
+  int iOption;
+  int iResult = 0;
+  uint8_t u8Default;
+
+  while ((iOption = getopt_long(argc, argv, "", farm_options, NULL)) != -1) {
+    switch (iOption) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+      if (!FARM_u8ParseList(optarg, farm_params[iOption].as32Values,
+                            &farm_params[iOption].iCount)) {
+        fprintf(stderr, "--%s: bad list \"%s\"\n",
+                farm_params[iOption].pcOption, optarg);
+        return 2;
+      }
+      break;
+    case 'x':
+      pcOutside = optarg;
+      break;
+    case 'w':
+      if (farm_profile_count == FARM_PROFILE_MAX) {
+        fprintf(stderr, "too many weather profiles\n");
+        return 2;
+      }
+      pcName = strrchr(optarg, '/');
+      farm_profiles[farm_profile_count].pcTrace = optarg;
+      snprintf(farm_profiles[farm_profile_count].acName, FARM_ENV_SIZE, "%s",
+               (pcName != NULL) ? pcName + 1 : optarg);
+      farm_profile_count++;
+      break;
+    case 'c':
+      farm_temp = (int32_t)strtol(optarg, NULL, 10);
+      break;
+    case 't':
+      farm_time_ms = strtol(optarg, NULL, 10);
+      break;
+    case 'b':
+      farm_band = optarg;
+      break;
+    case 'g':
+      dWeight = strtod(optarg, NULL);
+      break;
+    case 'j':
+      lJobs = strtol(optarg, NULL, 10);
+      break;
+    case 'n':
+      lTop = strtol(optarg, NULL, 10);
+      break;
+    case 'o':
+      pcOut = optarg;
+      break;
+    case 's':
+      farm_slave = optarg;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [--heater LIST] [--ac LIST] [--fan LIST] "
+              "[--fan-max LIST] [--gain LIST] [--outside LIST] "
+              "[--weather FILE]... [--temp C] [--time MS] [--band LOW:HIGH] "
+              "[--weight WH] [--jobs N] [--top N] [--out FILE] "
+              "[--slave PROGRAM]\n",
+              argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+
+  /* Defaults: the firmware values, a cold and a hot day */
+  farm_set_count = 1;
+  for (iParam = 0; iParam < FARM_PARAM_COUNT; iParam++) {
+    if (farm_params[iParam].iCount == 0) {
+      farm_params[iParam].as32Values[0] = farm_params[iParam].s32Default;
+      farm_params[iParam].iCount = 1;
+    }
+    farm_set_count *= (size_t)farm_params[iParam].iCount;
+  }
+  if ((pcOutside == NULL) && (farm_profile_count == 0)) {
+    pcOutside = "0,35";
+  }
+  if (pcOutside != NULL) {
+    if (!FARM_u8ParseList(pcOutside, as32Outside, &iCount) ||
+        (farm_profile_count + iCount > FARM_PROFILE_MAX)) {
+      fprintf(stderr, "--outside: bad list \"%s\"\n", pcOutside);
+      return 2;
+    }
+    for (iProfile = 0; iProfile < iCount; iProfile++) {
+      farm_profiles[farm_profile_count].s32Outside = as32Outside[iProfile];
+      snprintf(farm_profiles[farm_profile_count].acName, FARM_ENV_SIZE,
+               "outside=%ld", (long)as32Outside[iProfile]);
+      farm_profile_count++;
+    }
+  }
+  if (lJobs < 1) {
+    lJobs = 1;
+  }
+
+  farm_run_count = farm_set_count * (size_t)farm_profile_count;
+  farm_results = calloc(farm_run_count, sizeof(FarmResult_t));
+  pstRanks = calloc(farm_set_count, sizeof(FarmRank_t));
+  psThreads = calloc((size_t)lJobs, sizeof(pthread_t));
+  if ((farm_results == NULL) || (pstRanks == NULL) || (psThreads == NULL)) {
+    perror("calloc");
+    return 1;
+  }
+  FARM_vInheritEnvironment();
+
+  clock_gettime(CLOCK_MONOTONIC, &stStart);
+  for (lThread = 0; lThread < lJobs; lThread++) {
+    if (pthread_create(&psThreads[lThread], NULL, FARM_pvWorker, NULL) != 0) {
+      perror("pthread_create");
+      return 1;
+    }
+  }
+  for (lThread = 0; lThread < lJobs; lThread++) {
+    pthread_join(psThreads[lThread], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stEnd);
+
+  /* Aggregate every set over the weather profiles */
+  for (sSet = 0; sSet < farm_set_count; sSet++) {
+    pstRank = &pstRanks[sSet];
+    pstRank->sSet = sSet;
+    pstRank->u8Ok = 1;
+    for (iProfile = 0; iProfile < farm_profile_count; iProfile++) {
+      sRun = sSet * (size_t)farm_profile_count + (size_t)iProfile;
+      pstResult = &farm_results[sRun];
+      if (!pstResult->u8Ok) {
+        pstRank->u8Ok = 0;
+        iResult = 1;
+      }
+      pstRank->dEnergy += pstResult->adEnergy[FARM_HEATER] +
+                          pstResult->adEnergy[FARM_AC] +
+                          pstResult->adEnergy[FARM_FAN];
+      pstRank->dDiscomfort += pstResult->dDiscomfort;
+      pstRank->dInBand += pstResult->dInBand / farm_profile_count;
+      pstRank->ulSwitches += pstResult->aulSwitches[FARM_HEATER] +
+                             pstResult->aulSwitches[FARM_AC] +
+                             pstResult->aulSwitches[FARM_FAN];
+      if (pstResult->dOvershoot > pstRank->dOvershoot) {
+        pstRank->dOvershoot = pstResult->dOvershoot;
+      }
+    }
+    pstRank->dCost = pstRank->dEnergy + dWeight * pstRank->dDiscomfort;
+  }
+  qsort(pstRanks, farm_set_count, sizeof(FarmRank_t), FARM_iCompare);
+
+  printf("%zu runs (%zu sets x %d profiles, %ld ms each) on %ld workers "
+         "in %.1f s\n",
+         farm_run_count, farm_set_count, farm_profile_count, farm_time_ms,
+         lJobs,
+         (stEnd.tv_sec - stStart.tv_sec) +
+             (stEnd.tv_nsec - stStart.tv_nsec) / 1e9);
+  printf("%4s  %6s %4s %4s %7s %4s %10s %10s %10s %8s %8s %9s\n", "rank",
+         "heater", "ac", "fan", "fan_max", "gain", "cost", "energy_Wh",
+         "disc_Kh", "in_band%", "switches", "overshoot");
+  for (sSet = 0; (sSet < farm_set_count) && ((long)sSet < lTop); sSet++) {
+    pstRank = &pstRanks[sSet];
+    u8Default = 1;
+    for (iParam = 0; iParam < FARM_PARAM_COUNT; iParam++) {
+      if (FARM_s32Value(pstRank->sSet, iParam) !=
+          farm_params[iParam].s32Default) {
+        u8Default = 0;
+      }
+    }
+    if (!pstRank->u8Ok) {
+      printf("%3zu%c  %6ld %4ld %4ld %7ld %4ld %10s\n", sSet + 1,
+             u8Default ? '*' : ' ', (long)FARM_s32Value(pstRank->sSet, 0),
+             (long)FARM_s32Value(pstRank->sSet, 1),
+             (long)FARM_s32Value(pstRank->sSet, 2),
+             (long)FARM_s32Value(pstRank->sSet, 3),
+             (long)FARM_s32Value(pstRank->sSet, 4), "FAIL");
+      continue;
+    }
+    printf("%3zu%c  %6ld %4ld %4ld %7ld %4ld %10.1f %10.1f %10.3f %8.1f %8lu "
+           "%8.1fC\n",
+           sSet + 1, u8Default ? '*' : ' ',
+           (long)FARM_s32Value(pstRank->sSet, 0),
+           (long)FARM_s32Value(pstRank->sSet, 1),
+           (long)FARM_s32Value(pstRank->sSet, 2),
+           (long)FARM_s32Value(pstRank->sSet, 3),
+           (long)FARM_s32Value(pstRank->sSet, 4), pstRank->dCost,
+           pstRank->dEnergy, pstRank->dDiscomfort, pstRank->dInBand,
+           pstRank->ulSwitches, pstRank->dOvershoot);
+  }
+
+  if ((pcOut != NULL) && !FARM_u8WriteCsv(pcOut, dWeight)) {
+    perror(pcOut);
+    return 2;
+  }
+  return iResult;
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: launcher.c
+ * Description: Runs one simulated session of the master and the slave
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_sim [options]
+ *   --keys SCRIPT     keypad script, e.g. "0[500]1234" (SIM_KEYS)
+ *   --time MS         stop after MS ms of simulated time (SIM_TIME_LIMIT_MS)
+ *   --uart-in FILE    console input, "-" for stdin (SIM_UART_IN)
+ *   --uart-out FILE   console output, stderr by default (SIM_UART_OUT)
+ *   --eeprom-dir DIR  keep master.eep / slave.eep in DIR between runs
+ *   --temp C          room temperature seen by the slave (SIM_TEMP_C)
+ *   --ldr N           raw LDR reading seen by the slave (SIM_LDR)
+ *   --plant           close the loop through the room model (SIM_PLANT)
+ *   --outside C       outside temperature of the model (SIM_OUTSIDE_C)
+ *   --trace FILE      replay a CSV sensor trace on the slave (SIM_TRACE)
+ *   --events FILE     log keys, LCD frames, SPI bytes and pins (SIM_EVENTS)
+ *   --quiet           only print the final state (SIM_LCD_TRACE=0)
+ *   --no-slave        run the master alone, SPI reads return 0xFF
+ *   --slave-only      run the slave alone until --time, e.g. for climate
+ *                     runs with --plant or --trace
+ *
+ * The exit code is the one of the master, or of the slave with --slave-only.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#ifndef SIM_MASTER_PATH
+#define SIM_MASTER_PATH "smarthome_master_host"
+#endif
+#ifndef SIM_SLAVE_PATH
+#define SIM_SLAVE_PATH "smarthome_slave_host"
+#endif
+
+#define SIM_PATH_SIZE 512
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const struct option sim_options[] = {
+    {"keys", required_argument, NULL, 'k'},
+    {"time", required_argument, NULL, 't'},
+    {"uart-in", required_argument, NULL, 'i'},
+    {"uart-out", required_argument, NULL, 'o'},
+    {"eeprom-dir", required_argument, NULL, 'e'},
+    {"temp", required_argument, NULL, 'c'},
+    {"ldr", required_argument, NULL, 'l'},
+    {"plant", no_argument, NULL, 'p'},
+    {"outside", required_argument, NULL, 'x'},
+    {"trace", required_argument, NULL, 'r'},
+    {"events", required_argument, NULL, 'v'},
+    {"quiet", no_argument, NULL, 'q'},
+    {"no-slave", no_argument, NULL, 'n'},
+    {"slave-only", no_argument, NULL, 's'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Start a node with its end of the SPI link
+ * @param  pcPath Executable
+ * @param  iSpiFd Socket end, -1 for none
+ * @param  iOtherFd Socket end to close in the child, -1 for none
+ * @param  pcEeprom EEPROM image or NULL
+ * @return Child pid, -1 on error
+ */
+static pid_t SIM_sStartNode(const char *pcPath, int iSpiFd, int iOtherFd,
+                            const char *pcEeprom) {
+  char acFd[16];
+  pid_t sPid = fork();
+  if (sPid != 0) {
+    return sPid;
+  }
+  if (iOtherFd >= 0) {
+    close(iOtherFd);
+  }
+  if (iSpiFd >= 0) {
+    snprintf(acFd, sizeof(acFd), "%d", iSpiFd);
+    setenv("SIM_SPI_FD", acFd, 1);
+  } else {
+    unsetenv("SIM_SPI_FD");
+  }
+  if (pcEeprom != NULL) {
+    setenv("SIM_EEPROM", pcEeprom, 1);
+  }
+  execl(pcPath, pcPath, (char *)NULL);
+  perror(pcPath);
+  _exit(127);
+}
+
+/**
+ * @brief  Exit code of a finished child
+ * @param  sPid Child pid
+ * @return Exit code, 128 + signal if it was killed
+ */
+static int SIM_iWait(pid_t sPid) {
+  int iStatus = 0;
+  if (waitpid(sPid, &iStatus, 0) < 0) {
+    return 127;
+  }
+  if (WIFSIGNALED(iStatus)) {
+    return 128 + WTERMSIG(iStatus);
+  }
+  return WEXITSTATUS(iStatus);
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return Exit code of the master
+ */
+int main(int argc, char *argv[]) {
+  const char *pcEepromDir = NULL;
+  FILE *pEvents;
+  char acMasterEeprom[SIM_PATH_SIZE];
+  char acSlaveEeprom[SIM_PATH_SIZE];
+  int aiLink[2] = {-1, -1};
+  int iWithSlave = 1;
+  int iWithMaster = 1;
+  int iOption;
+  int iResult;
+  pid_t sSlave = -1;
+  pid_t sMaster;
+
+  while ((iOption = getopt_long(argc, argv, "", sim_options, NULL)) != -1) {
+    switch (iOption) {
+    case 'k':
+      setenv("SIM_KEYS", optarg, 1);
+      break;
+    case 't':
+      setenv("SIM_TIME_LIMIT_MS", optarg, 1);
+      break;
+    case 'i':
+      setenv("SIM_UART_IN", optarg, 1);
+      break;
+    case 'o':
+      setenv("SIM_UART_OUT", optarg, 1);
+      break;
+    case 'e':
+      pcEepromDir = optarg;
+      break;
+    case 'c':
+      setenv("SIM_TEMP_C", optarg, 1);
+      break;
+    case 'l':
+      setenv("SIM_LDR", optarg, 1);
+      break;
+    case 'p':
+      setenv("SIM_PLANT", "1", 1);
+      break;
+    case 'x':
+      setenv("SIM_OUTSIDE_C", optarg, 1);
+      break;
+    case 'r':
+      setenv("SIM_TRACE", optarg, 1);
+      break;
+    case 'v':
+      pEvents = fopen(optarg, "w"); /* both nodes append to it */
+      if (pEvents == NULL) {
+        perror(optarg);
+        return 2;
+      }
+      fclose(pEvents);
+      setenv("SIM_EVENTS", optarg, 1);
+      break;
+    case 'q':
+      setenv("SIM_LCD_TRACE", "0", 1);
+      break;
+    case 'n':
+      iWithSlave = 0;
+      break;
+    case 's':
+      iWithMaster = 0;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [--keys SCRIPT] [--time MS] [--uart-in FILE] "
+              "[--uart-out FILE] [--eeprom-dir DIR] [--temp C] [--ldr N] "
+              "[--plant] [--outside C] [--trace FILE] [--events FILE] "
+              "[--quiet] [--no-slave | --slave-only]\n",
+              argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+
+  if (pcEepromDir != NULL) {
+    snprintf(acMasterEeprom, sizeof(acMasterEeprom), "%s/master.eep",
+             pcEepromDir);
+    snprintf(acSlaveEeprom, sizeof(acSlaveEeprom), "%s/slave.eep",
+             pcEepromDir);
+  }
+
+  if (!iWithMaster) {
+    sSlave = SIM_sStartNode(SIM_SLAVE_PATH, -1, -1,
+                            pcEepromDir ? acSlaveEeprom : NULL);
+    return SIM_iWait(sSlave);
+  }
+
+  if (iWithSlave) {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, aiLink) != 0) {
+      perror("socketpair");
+      return 1;
+    }
+    sSlave = SIM_sStartNode(SIM_SLAVE_PATH, aiLink[1], aiLink[0],
+                            pcEepromDir ? acSlaveEeprom : NULL);
+    close(aiLink[1]);
+  }
+  sMaster = SIM_sStartNode(SIM_MASTER_PATH, aiLink[0], -1,
+                           pcEepromDir ? acMasterEeprom : NULL);
+
+  /* The slave ends when the master closes its end of the link */
+  iResult = SIM_iWait(sMaster);
+  fflush(stdout);
+  if (iWithSlave) {
+    close(aiLink[0]);
+    (void)SIM_iWait(sSlave);
+  }
+  return iResult;
+}
\ No newline at end of file
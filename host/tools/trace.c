@@ -0,0 +1,471 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: trace.c
+ * Description: Decoder of the console trace dumps of both nodes
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_trace [FILE...]
+ *
+ * Reads console logs (standard input when no file is given) and decodes
+ * every output of the console command "trace". The log may hold anything
+ * else, e.g. the simulator output or a terminal capture; only the trace
+ * blocks are read:
+ *
+ *   trace <node> tick_us=<us> now=<ticks> total=<n> n=<count> [sync=<ticks>]
+ *   r <ticks> <event> <arg0> <arg1>      one line per record, hex
+ *   end ok | end ERR link
+ *
+ * A master block starts a new dump, the slave block after it joins it.
+ * Each record gets its age from the tick count of its block, counted back
+ * across the 16-bit wraps. The slave takes its "now" only once the master
+ * has printed its own block and sent GET_TRACE; sync on the slave header is
+ * the master trace clock at that moment, so the slave block is moved later
+ * by sync - now of the master. The records of both nodes are then printed
+ * as one timeline in seconds before the master froze its ring, good to the
+ * few ms the slave takes to answer the command.
+ *
+ * The exit code is 1 if no block could be decoded, 2 on a usage error or
+ * an unreadable file.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "APP/main_config.h"
+#include "LIB/STD_MESSAGES.h"
+#include "MCAL/Trace/trace.h"
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define DUMP_LINE_SIZE 256
+#define DUMP_TEXT_SIZE 64
+#define DUMP_US_PER_S 1000000.0
+
+#define DUMP_MASTER 0
+#define DUMP_SLAVE 1
+#define DUMP_NODES 2
+
+/* State of a node block */
+#define DUMP_ABSENT 0
+#define DUMP_OPEN 1 /* header read, waiting for the end line */
+#define DUMP_OK 2
+#define DUMP_OFF 3 /* built without TRACE_ENABLE */
+#define DUMP_FAILED 4
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint16_t u16Time;
+  uint8_t u8Event;
+  uint8_t u8Arg0;
+  uint8_t u8Arg1;
+} DumpRecord_t;
+
+typedef struct {
+  int iState;
+  unsigned uTickUs;
+  unsigned uNow;
+  unsigned uSync;  /* master clock at the slave "now", slave only */
+  int iSynced;     /* uSync was given */
+  unsigned uTotal;
+  unsigned uCount; /* announced by the header */
+  unsigned uRead;  /* record lines seen */
+  DumpRecord_t astRecords[TRACE_DEPTH];
+} DumpBlock_t;
+
+typedef struct {
+  double dTime; /* seconds before the dump, negative */
+  int iNode;
+  unsigned uIndex; /* keeps the order of a node on equal times */
+  const DumpRecord_t *pstRecord;
+} DumpEvent_t;
+
+typedef struct {
+  uint8_t u8Code;
+  const char *pcName;
+} DumpName_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const struct option dump_options[] = {{"help", no_argument, NULL, 'h'},
+                                             {NULL, 0, NULL, 0}};
+
+static const char *const dump_nodes[DUMP_NODES] = {"master", "slave"};
+
+#define DUMP_COMMAND(code) {code, #code}
+static const DumpName_t dump_commands[] = {
+    DUMP_COMMAND(ROOM1_STATUS),      DUMP_COMMAND(ROOM2_STATUS),
+    DUMP_COMMAND(ROOM3_STATUS),      DUMP_COMMAND(ROOM4_STATUS),
+    DUMP_COMMAND(TV_STATUS),         DUMP_COMMAND(AIR_COND_STATUS),
+    DUMP_COMMAND(ROOM1_TURN_ON),     DUMP_COMMAND(ROOM2_TURN_ON),
+    DUMP_COMMAND(ROOM3_TURN_ON),     DUMP_COMMAND(ROOM4_TURN_ON),
+    DUMP_COMMAND(TV_TURN_ON),        DUMP_COMMAND(AIR_COND_TURN_ON),
+    DUMP_COMMAND(ROOM1_TURN_OFF),    DUMP_COMMAND(ROOM2_TURN_OFF),
+    DUMP_COMMAND(ROOM3_TURN_OFF),    DUMP_COMMAND(ROOM4_TURN_OFF),
+    DUMP_COMMAND(TV_TURN_OFF),       DUMP_COMMAND(AIR_COND_TURN_OFF),
+    DUMP_COMMAND(SET_TEMPERATURE),   DUMP_COMMAND(BLOWER_TURN_ON),
+    DUMP_COMMAND(BLOWER_TURN_OFF),   DUMP_COMMAND(GET_LDR_STATUS),
+    DUMP_COMMAND(GET_TELEMETRY),     DUMP_COMMAND(CLEAR_BOOT_FLAG),
+    DUMP_COMMAND(GET_ISR_PROFILE),   DUMP_COMMAND(RESET_ISR_PROFILE),
+    DUMP_COMMAND(GET_STACK_INFO),    DUMP_COMMAND(GET_TRACE),
+    DUMP_COMMAND(CLEAR_TRACE)};
+
+#define DUMP_COMMAND_COUNT (sizeof(dump_commands) / sizeof(dump_commands[0]))
+
+static DumpBlock_t dump_blocks[DUMP_NODES];
+static DumpBlock_t *dump_open = NULL; /* block the record lines belong to */
+static unsigned dump_number = 0;
+static int dump_decoded = 0; /* blocks that ended with "end ok" */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Name of a link command
+ * @param  u8Code Command byte
+ * @return Macro name from STD_MESSAGES.h, NULL if unknown
+ */
+static const char *DUMP_pcCommand(uint8_t u8Code) {
+  size_t sIndex;
+  for (sIndex = 0; sIndex < DUMP_COMMAND_COUNT; sIndex++) {
+    if (dump_commands[sIndex].u8Code == u8Code) {
+      return dump_commands[sIndex].pcName;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Describe a link command and its reply or value
+ * @param  pcText Receives the text
+ * @param  sSize Size of pcText
+ * @param  pcDirection "tx" or "rx"
+ * @param  pstRecord TRACE_LINK_TX or TRACE_LINK_RX record
+ * @return Void
+ */
+static void DUMP_vLink(char *pcText, size_t sSize, const char *pcDirection,
+                       const DumpRecord_t *pstRecord) {
+  const char *pcName = DUMP_pcCommand(pstRecord->u8Arg0);
+  int iLength;
+
+  if (pcName != NULL) {
+    iLength = snprintf(pcText, sSize, "%s %s", pcDirection, pcName);
+  } else {
+    iLength = snprintf(pcText, sSize, "%s 0x%02x", pcDirection,
+                       pstRecord->u8Arg0);
+  }
+  if ((pstRecord->u8Arg1 != TRACE_NONE) && (iLength > 0) &&
+      ((size_t)iLength < sSize)) {
+    snprintf(pcText + iLength, sSize - iLength, " = %u", pstRecord->u8Arg1);
+  }
+}
+
+/**
+ * @brief  Describe a record
+ * @param  pcText Receives the text
+ * @param  sSize Size of pcText
+ * @param  pstRecord Record to describe
+ * @return Void
+ */
+static void DUMP_vDescribe(char *pcText, size_t sSize,
+                           const DumpRecord_t *pstRecord) {
+  static const char *const apcModes[] = {"none", "admin", "guest"};
+  uint8_t u8Arg0 = pstRecord->u8Arg0;
+  uint8_t u8Arg1 = pstRecord->u8Arg1;
+
+  switch (pstRecord->u8Event) {
+  case TRACE_BOOT:
+    snprintf(pcText, sSize, "boot reset=%02x%s%s%s%s%s", u8Arg0,
+             (u8Arg0 & 0x01) ? " power-on" : "",
+             (u8Arg0 & 0x02) ? " external" : "",
+             (u8Arg0 & 0x04) ? " brown-out" : "",
+             (u8Arg0 & 0x08) ? " watchdog" : "",
+             (u8Arg0 & 0x10) ? " jtag" : "");
+    break;
+  case TRACE_LINK_TX:
+    DUMP_vLink(pcText, sSize, "tx", pstRecord);
+    break;
+  case TRACE_LINK_RX:
+    DUMP_vLink(pcText, sSize, "rx", pstRecord);
+    break;
+  case TRACE_KEY:
+    snprintf(pcText, sSize, "key '%c' %s", u8Arg0, u8Arg1 ? "down" : "up");
+    break;
+  case TRACE_LOGIN:
+    snprintf(pcText, sSize, "login %s%s",
+             (u8Arg0 <= GUEST) ? apcModes[u8Arg0] : "?",
+             u8Arg1 ? " blocked" : "");
+    break;
+  case TRACE_TIMEOUT:
+    if (u8Arg0 == TRACE_TIMEOUT_SESSION) {
+      snprintf(pcText, sSize, "timeout session %s",
+               (u8Arg1 <= GUEST) ? apcModes[u8Arg1] : "?");
+    } else if (u8Arg0 == TRACE_TIMEOUT_LINK) {
+      snprintf(pcText, sSize, "link %s", u8Arg1 ? "back" : "lost");
+    } else {
+      snprintf(pcText, sSize, "timeout %u", u8Arg0);
+    }
+    break;
+  case TRACE_LOCKOUT:
+    snprintf(pcText, sSize, "lockout %s #%u", u8Arg0 ? "start" : "end",
+             u8Arg1);
+    break;
+  case TRACE_CLIMATE:
+    snprintf(pcText, sSize, "climate %u C ->%s%s%s%s", u8Arg0,
+             (u8Arg1 & TRACE_OUT_HEATER) ? " heater" : "",
+             (u8Arg1 & TRACE_OUT_AC) ? " ac" : "",
+             (u8Arg1 & TRACE_OUT_FAN) ? " fan" : "",
+             (u8Arg1 == 0) ? " off" : "");
+    break;
+  case TRACE_FAN:
+    snprintf(pcText, sSize, "fan %u%% %s", u8Arg0, u8Arg1 ? "blower" : "auto");
+    break;
+  default:
+    snprintf(pcText, sSize, "event 0x%02x %02x %02x", pstRecord->u8Event,
+             u8Arg0, u8Arg1);
+    break;
+  }
+}
+
+/**
+ * @brief  Timeline order: oldest first, the master first on equal times
+ * @param  pvLeft First event
+ * @param  pvRight Second event
+ * @return qsort comparison result
+ */
+static int DUMP_iCompare(const void *pvLeft, const void *pvRight) {
+  const DumpEvent_t *pstLeft = pvLeft;
+  const DumpEvent_t *pstRight = pvRight;
+  if (pstLeft->dTime != pstRight->dTime) {
+    return (pstLeft->dTime < pstRight->dTime) ? -1 : 1;
+  }
+  if (pstLeft->iNode != pstRight->iNode) {
+    return pstLeft->iNode - pstRight->iNode;
+  }
+  return (pstLeft->uIndex < pstRight->uIndex) ? -1 : 1;
+}
+
+/**
+ * @brief  Print the dump held in dump_blocks as one timeline and forget it
+ * @return Void
+ */
+static void DUMP_vFlush(void) {
+  DumpEvent_t astEvents[DUMP_NODES * TRACE_DEPTH];
+  char acText[DUMP_TEXT_SIZE];
+  const DumpBlock_t *pstBlock;
+  unsigned uEvents = 0;
+  double dShift;
+  unsigned uAge;
+  unsigned uIndex;
+  int iNode;
+
+  if ((dump_blocks[DUMP_MASTER].iState == DUMP_ABSENT) &&
+      (dump_blocks[DUMP_SLAVE].iState == DUMP_ABSENT)) {
+    return;
+  }
+  dump_number++;
+  printf("dump %u\n", dump_number);
+
+  for (iNode = 0; iNode < DUMP_NODES; iNode++) {
+    pstBlock = &dump_blocks[iNode];
+    printf("  %-6s ", dump_nodes[iNode]);
+    switch (pstBlock->iState) {
+    case DUMP_ABSENT:
+      printf("not dumped\n");
+      continue;
+    case DUMP_OFF:
+      printf("off\n");
+      continue;
+    case DUMP_OPEN:
+      printf("incomplete, %u of %u records\n", pstBlock->uRead,
+             pstBlock->uCount);
+      continue;
+    case DUMP_FAILED:
+      printf("ERR link\n");
+      continue;
+    }
+    dump_decoded++;
+    printf("%u records, %u overwritten, tick %u us\n", pstBlock->uCount,
+           (unsigned)(uint16_t)(pstBlock->uTotal - pstBlock->uCount),
+           pstBlock->uTickUs);
+
+    /* A slave block is older than it looks by the time it waited */
+    dShift = 0.0;
+    if ((iNode == DUMP_SLAVE) && pstBlock->iSynced &&
+        (dump_blocks[DUMP_MASTER].iState == DUMP_OK)) {
+      dShift = (double)(uint16_t)(pstBlock->uSync -
+                                  dump_blocks[DUMP_MASTER].uNow) *
+               dump_blocks[DUMP_MASTER].uTickUs / DUMP_US_PER_S;
+    }
+
+    /* Ages from the newest record back, each step taken modulo 2^16 */
+    uAge = 0;
+    for (uIndex = pstBlock->uCount; uIndex > 0; uIndex--) {
+      if (uIndex == pstBlock->uCount) {
+        uAge = (uint16_t)(pstBlock->uNow -
+                          pstBlock->astRecords[uIndex - 1].u16Time);
+      } else {
+        uAge += (uint16_t)(pstBlock->astRecords[uIndex].u16Time -
+                           pstBlock->astRecords[uIndex - 1].u16Time);
+      }
+      astEvents[uEvents].dTime =
+          dShift - (double)uAge * pstBlock->uTickUs / DUMP_US_PER_S;
+      astEvents[uEvents].iNode = iNode;
+      astEvents[uEvents].uIndex = uIndex;
+      astEvents[uEvents].pstRecord = &pstBlock->astRecords[uIndex - 1];
+      uEvents++;
+    }
+  }
+
+  qsort(astEvents, uEvents, sizeof(astEvents[0]), DUMP_iCompare);
+  for (uIndex = 0; uIndex < uEvents; uIndex++) {
+    DUMP_vDescribe(acText, sizeof(acText), astEvents[uIndex].pstRecord);
+    printf("  %10.3f s  %-6s  %s\n", astEvents[uIndex].dTime,
+           dump_nodes[astEvents[uIndex].iNode], acText);
+  }
+  memset(dump_blocks, 0, sizeof(dump_blocks));
+}
+
+/**
+ * @brief  Read one log line
+ * @param  pcLine Line without its line break
+ * @return Void
+ */
+static void DUMP_vLine(const char *pcLine) {
+  DumpBlock_t *pstBlock;
+  DumpRecord_t *pstRecord;
+  char acNode[16];
+  unsigned auField[5];
+  int iFields;
+  int iOffset = 0;
+  int iNode;
+
+  if (sscanf(pcLine, "trace %15s %n", acNode, &iOffset) == 1 && iOffset > 0) {
+    for (iNode = 0; iNode < DUMP_NODES; iNode++) {
+      if (strcmp(acNode, dump_nodes[iNode]) == 0) {
+        break;
+      }
+    }
+    if (iNode == DUMP_NODES) {
+      return;
+    }
+    /* A master block, or a second slave block, begins the next dump */
+    if ((iNode == DUMP_MASTER) || (dump_blocks[iNode].iState != DUMP_ABSENT)) {
+      DUMP_vFlush();
+    }
+    pstBlock = &dump_blocks[iNode];
+    memset(pstBlock, 0, sizeof(*pstBlock));
+    dump_open = NULL;
+    if (strncmp(pcLine + iOffset, "off", 3) == 0) {
+      pstBlock->iState = DUMP_OFF; /* the end line follows, it adds nothing */
+    } else if (strncmp(pcLine + iOffset, "ERR", 3) == 0) {
+      pstBlock->iState = DUMP_FAILED;
+    } else if (((iFields = sscanf(pcLine + iOffset,
+                                  "tick_us=%u now=%u total=%u n=%u sync=%u",
+                                  &auField[0], &auField[1], &auField[2],
+                                  &auField[3], &auField[4])) >= 4) &&
+               (auField[3] <= TRACE_DEPTH)) {
+      pstBlock->iState = DUMP_OPEN;
+      pstBlock->uTickUs = auField[0];
+      pstBlock->uNow = auField[1];
+      pstBlock->uTotal = auField[2];
+      pstBlock->uCount = auField[3];
+      pstBlock->uSync = auField[4];
+      pstBlock->iSynced = (iFields == 5);
+      dump_open = pstBlock;
+    } else {
+      pstBlock->iState = DUMP_FAILED;
+    }
+    return;
+  }
+
+  if (dump_open == NULL) {
+    return;
+  }
+  if (sscanf(pcLine, "r %x %x %x %x", &auField[0], &auField[1], &auField[2],
+             &auField[3]) == 4) {
+    if (dump_open->uRead < dump_open->uCount) {
+      pstRecord = &dump_open->astRecords[dump_open->uRead];
+      pstRecord->u16Time = (uint16_t)auField[0];
+      pstRecord->u8Event = (uint8_t)auField[1];
+      pstRecord->u8Arg0 = (uint8_t)auField[2];
+      pstRecord->u8Arg1 = (uint8_t)auField[3];
+    }
+    dump_open->uRead++;
+  } else if (strncmp(pcLine, "end ", 4) == 0) {
+    dump_open->iState = ((strcmp(pcLine + 4, "ok") == 0) &&
+                         (dump_open->uRead == dump_open->uCount))
+                            ? DUMP_OK
+                            : DUMP_FAILED;
+    dump_open = NULL;
+  }
+}
+
+/**
+ * @brief  Read a console log
+ * @param  pFile Open log
+ * @return Void
+ */
+static void DUMP_vRead(FILE *pFile) {
+  char acLine[DUMP_LINE_SIZE];
+  size_t sLength;
+
+  while (fgets(acLine, sizeof(acLine), pFile) != NULL) {
+    sLength = strlen(acLine);
+    while ((sLength > 0) &&
+           ((acLine[sLength - 1] == '\n') || (acLine[sLength - 1] == '\r') ||
+            (acLine[sLength - 1] == ' '))) {
+      sLength--;
+    }
+    acLine[sLength] = '\0';
+    DUMP_vLine(acLine);
+  }
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 when a block was decoded, 1 if none, 2 on usage or file errors
+ */
+int main(int argc, char *argv[]) {
+  FILE *pFile;
+  int iOption;
+  int iArg;
+
+  while ((iOption = getopt_long(argc, argv, "", dump_options, NULL)) != -1) {
+    fprintf(stderr, "usage: %s [FILE...]\n", argv[0]);
+    return (iOption == 'h') ? 0 : 2;
+  }
+
+  if (optind == argc) {
+    DUMP_vRead(stdin);
+  }
+  for (iArg = optind; iArg < argc; iArg++) {
+    pFile = fopen(argv[iArg], "r");
+    if (pFile == NULL) {
+      perror(argv[iArg]);
+      return 2;
+    }
+    DUMP_vRead(pFile);
+    fclose(pFile);
+  }
+  DUMP_vFlush();
+
+  if (dump_decoded == 0) {
+    fprintf(stderr, "%s: no trace dump found\n", argv[0]);
+    return 1;
+  }
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: ubench.c
+ * Description: Cycle counts of the driver primitives on simavr
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_ubench [options] MASTER_UBENCH.elf SLAVE_UBENCH.elf
+ *   --out FILE        append the results to a CSV file
+ *   --tag TAG         first CSV column, e.g. the commit id (default "local")
+ *
+ * Runs the benchmark images of the AVR build (ubench/) one after the other
+ * on an ATmega32 core at 8 MHz and times every case between its two writes
+ * to the marker register (ubench/ubench.h). The cost of the empty loop is
+ * subtracted, so a row is the cost of one call including its argument
+ * setup. The images run with the interrupts off, the keypad columns idle
+ * high and fixed voltages on ADC0/ADC1, so every run gives the same counts.
+ *
+ * Delays are counted like any other code: the LCD and keypad rows are
+ * mostly _delay_ms. The SPI byte time is that of simavr's SPI model with
+ * nothing on the other end of the bus.
+ *
+ * The exit code is 1 if an image crashed or did not finish in time.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "LIB/STD_Types.h"
+#include "MCAL/DIO/DIO_config_master.h"
+#include "ubench.h"
+#include <getopt.h>
+#include <simavr/avr_adc.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define UBENCH_MCU "atmega32"
+#define UBENCH_FREQUENCY 8000000UL
+#define UBENCH_CYCLES_PER_US (UBENCH_FREQUENCY / 1000000.0)
+#define UBENCH_LIMIT_CYCLES (30ULL * UBENCH_FREQUENCY) /* 30 s per image */
+
+/* Slave inputs in mV: 24 C on the LM35, a dim room on the LDR */
+#define UBENCH_TEMP_MV 240
+#define UBENCH_LDR_MV 1000
+
+#define UBENCH_MASTER (uint8_t)0
+#define UBENCH_SLAVE (uint8_t)1
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint8_t u8Node;
+  uint8_t u8Case;
+  uint16_t u16Calls;
+  const char *pcName;
+} UbenchCase_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const struct option ubench_options[] = {
+    {"out", required_argument, NULL, 'o'},
+    {"tag", required_argument, NULL, 't'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+static const char *const ubench_node_names[] = {"master", "slave"};
+
+/* Report order; UBENCH_LOOP is the baseline of each image */
+static const UbenchCase_t ubench_cases[] = {
+    {UBENCH_MASTER, UBENCH_DIO_WRITE, UBENCH_DIO_WRITE_CALLS, "DIO_write"},
+    {UBENCH_MASTER, UBENCH_DIO_WRITE_PIN, UBENCH_DIO_WRITE_PIN_CALLS,
+     "DIO_vWritePin"},
+    {UBENCH_MASTER, UBENCH_DIO_READ, UBENCH_DIO_READ_CALLS, "DIO_u8read"},
+    {UBENCH_MASTER, UBENCH_LCD_CHAR, UBENCH_LCD_CHAR_CALLS,
+     "LCD_vSend_char"},
+    {UBENCH_MASTER, UBENCH_LCD_STRING, UBENCH_LCD_STRING_CALLS,
+     "LCD_vSend_string"},
+    {UBENCH_MASTER, UBENCH_LCD_CURSOR, UBENCH_LCD_CURSOR_CALLS,
+     "LCD_movecursor"},
+    {UBENCH_MASTER, UBENCH_KEYPAD, UBENCH_KEYPAD_CALLS,
+     "keypad_u8check_press"},
+    {UBENCH_MASTER, UBENCH_SPI, UBENCH_SPI_CALLS, "SPI_ui8TransmitRecive"},
+    {UBENCH_MASTER, UBENCH_COMPARE_PASS, UBENCH_COMPARE_PASS_CALLS,
+     "ui8ComparePass"},
+    {UBENCH_SLAVE, UBENCH_ADC_READ, UBENCH_ADC_READ_CALLS, "ADC_u16Read"},
+    {UBENCH_SLAVE, UBENCH_ADC_CHANNEL, UBENCH_ADC_CHANNEL_CALLS,
+     "ADC_u16ReadChannel_Custom"},
+};
+#define UBENCH_REPORT_COUNT (sizeof(ubench_cases) / sizeof(ubench_cases[0]))
+
+/* Written by the marker hook while an image runs */
+static uint64_t ubench_cycles[2][UBENCH_CASE_COUNT]; /* per case and node */
+static uint8_t ubench_seen[2][UBENCH_CASE_COUNT];
+static uint8_t ubench_node;
+static uint8_t ubench_case = UBENCH_STOP;
+static uint64_t ubench_start;
+static uint8_t ubench_done;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Write to the marker register: start or stop the clock of a case
+ * @param  pstAvr Core
+ * @param  u16Addr Marker address
+ * @param  u8Value Case number, UBENCH_STOP or UBENCH_DONE
+ * @param  pvParam Unused
+ * @return Void
+ */
+static void UBENCH_vMark(avr_t *pstAvr, avr_io_addr_t u16Addr, uint8_t u8Value,
+                         void *pvParam) {
+  (void)u16Addr;
+  (void)pvParam;
+  if (u8Value == UBENCH_DONE) {
+    ubench_done = 1;
+  } else if (u8Value == UBENCH_STOP) {
+    if ((ubench_case != UBENCH_STOP) && (ubench_case < UBENCH_CASE_COUNT)) {
+      ubench_cycles[ubench_node][ubench_case] = pstAvr->cycle - ubench_start;
+      ubench_seen[ubench_node][ubench_case] = 1;
+    }
+    ubench_case = UBENCH_STOP;
+  } else {
+    ubench_case = u8Value;
+    ubench_start = pstAvr->cycle;
+  }
+}
+
+/**
+ * @brief  Create a core and load an ELF image into it
+ * @param  pcPath ELF file
+ * @return Core, exits with code 2 if the image cannot be read
+ */
+static avr_t *UBENCH_pstLoad(const char *pcPath) {
+  elf_firmware_t stFirmware;
+  avr_t *pstAvr;
+
+  memset(&stFirmware, 0, sizeof(stFirmware));
+  if (elf_read_firmware(pcPath, &stFirmware) != 0) {
+    fprintf(stderr, "%s: cannot read the ELF image\n", pcPath);
+    exit(2);
+  }
+  strncpy(stFirmware.mmcu, UBENCH_MCU, sizeof(stFirmware.mmcu) - 1);
+  stFirmware.frequency = UBENCH_FREQUENCY;
+
+  pstAvr = avr_make_mcu_by_name(stFirmware.mmcu);
+  if (pstAvr == NULL) {
+    fprintf(stderr, "simavr has no %s core\n", UBENCH_MCU);
+    exit(2);
+  }
+  avr_init(pstAvr);
+  avr_load_firmware(pstAvr, &stFirmware);
+  return pstAvr;
+}
+
+/**
+ * @brief  Run one benchmark image to its UBENCH_DONE marker
+ * @param  u8Node UBENCH_MASTER or UBENCH_SLAVE
+ * @param  pcPath ELF file
+ * @return 0 on success, 1 if the image crashed or ran out of time
+ */
+static int UBENCH_iRun(uint8_t u8Node, const char *pcPath) {
+  avr_t *pstAvr = UBENCH_pstLoad(pcPath);
+  uint8_t u8Pin;
+  int iState;
+
+  ubench_node = u8Node;
+  ubench_case = UBENCH_STOP;
+  ubench_done = 0;
+  avr_register_io_write(pstAvr, UBENCH_MARK_ADDR, UBENCH_vMark, NULL);
+
+  if (u8Node == UBENCH_MASTER) {
+    for (u8Pin = 0; u8Pin < 4; u8Pin++) {
+      avr_raise_irq(avr_io_getirq(pstAvr, AVR_IOCTL_IOPORT_GETIRQ(KEYPAD_PORT),
+                                  KEYPAD_FIFTH_PIN + u8Pin),
+                    1);
+    }
+  } else {
+    avr_raise_irq(avr_io_getirq(pstAvr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0),
+                  UBENCH_TEMP_MV);
+    avr_raise_irq(avr_io_getirq(pstAvr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC1),
+                  UBENCH_LDR_MV);
+  }
+
+  while ((ubench_done == 0) && (pstAvr->cycle < UBENCH_LIMIT_CYCLES)) {
+    iState = avr_run(pstAvr);
+    if ((iState == cpu_Done) || (iState == cpu_Crashed)) {
+      break;
+    }
+  }
+  if (ubench_done == 0) {
+    fprintf(stderr, "%s: %s before the last case\n", pcPath,
+            (pstAvr->cycle < UBENCH_LIMIT_CYCLES) ? "stopped" : "timed out");
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief  Open the CSV file, writing the header if it is new
+ * @param  pcPath CSV path
+ * @return File or NULL
+ */
+static FILE *UBENCH_pOpenCsv(const char *pcPath) {
+  struct stat stInfo;
+  uint8_t u8New = ((stat(pcPath, &stInfo) != 0) || (stInfo.st_size == 0));
+  FILE *pFile = fopen(pcPath, "a");
+  if ((pFile != NULL) && u8New) {
+    fprintf(pFile, "tag,node,primitive,calls,cycles,us\n");
+  }
+  return pFile;
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 if both images ran every case, 1 otherwise, 2 on bad usage
+ */
+int main(int argc, char *argv[]) {
+  const UbenchCase_t *pstCase;
+  const char *pcOut = NULL;
+  const char *pcTag = "local";
+  FILE *pCsv = NULL;
+  double dLoop;
+  double dCycles;
+  size_t sIndex;
+  uint8_t u8Node;
+  int iOption;
+  int iResult = 0;
+
+  while ((iOption = getopt_long(argc, argv, "", ubench_options, NULL)) != -1) {
+    switch (iOption) {
+    case 'o':
+      pcOut = optarg;
+      break;
+    case 't':
+      pcTag = optarg;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [--out FILE] [--tag TAG] "
+              "MASTER_UBENCH.elf SLAVE_UBENCH.elf\n",
+              argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+  if (argc - optind != 2) {
+    fprintf(stderr, "%s: expected the master and slave benchmark images\n",
+            argv[0]);
+    return 2;
+  }
+  if (pcOut != NULL) {
+    pCsv = UBENCH_pOpenCsv(pcOut);
+    if (pCsv == NULL) {
+      perror(pcOut);
+      return 2;
+    }
+  }
+
+  for (u8Node = UBENCH_MASTER; u8Node <= UBENCH_SLAVE; u8Node++) {
+    iResult |= UBENCH_iRun(u8Node, argv[optind + u8Node]);
+  }
+
+  printf("%-7s %-26s %6s %12s %12s\n", "node", "primitive", "calls",
+         "cycles", "us");
+  for (sIndex = 0; sIndex < UBENCH_REPORT_COUNT; sIndex++) {
+    pstCase = &ubench_cases[sIndex];
+    u8Node = pstCase->u8Node;
+    if ((ubench_seen[u8Node][pstCase->u8Case] == 0) ||
+        (ubench_seen[u8Node][UBENCH_LOOP] == 0)) {
+      printf("%-7s %-26s %6u %12s %12s\n", ubench_node_names[u8Node],
+             pstCase->pcName, pstCase->u16Calls, "-", "-");
+      iResult = 1;
+      continue;
+    }
+    dLoop = (double)ubench_cycles[u8Node][UBENCH_LOOP] / UBENCH_LOOP_CALLS;
+    dCycles =
+        (double)ubench_cycles[u8Node][pstCase->u8Case] / pstCase->u16Calls -
+        dLoop;
+    printf("%-7s %-26s %6u %12.1f %12.2f\n", ubench_node_names[u8Node],
+           pstCase->pcName, pstCase->u16Calls, dCycles,
+           dCycles / UBENCH_CYCLES_PER_US);
+    if (pCsv != NULL) {
+      fprintf(pCsv, "%s,%s,%s,%u,%.1f,%.2f\n", pcTag,
+              ubench_node_names[u8Node], pstCase->pcName, pstCase->u16Calls,
+              dCycles, dCycles / UBENCH_CYCLES_PER_US);
+    }
+  }
+  if (pCsv != NULL) {
+    fclose(pCsv);
+  }
+  return iResult;
+}
\ No newline at end of file
@@ -0,0 +1,747 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: uiload.c
+ * Description: Keypad storms against the master UI, per screen timings
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_uiload [options] [-- simulator arguments]
+ *   --sim PROGRAM     simulator to drive, smarthome_sim by default
+ *   --runs N          sessions, each with its own seed (default 4)
+ *   --storm N         random taps per session (default 1000)
+ *   --seed S          seed of the first session, S + 1 for the next...
+ *   --script SCRIPT   key script of every session instead of the storm
+ *   --stuck MS        SIM_KEYS_STUCK_MS of the sessions, the simulator's
+ *                     default is longer than the login lockout
+ *   --jobs N          sessions at a time (default one per core)
+ *   --out FILE        append the per screen results to a CSV file
+ *   --tag TAG         first CSV column, e.g. the commit id (default "local")
+ *
+ * Every session starts from an EEPROM provisioned with admin pass 1234 and
+ * guest pass 5678, logs in as admin and plays "~N:SEED", a storm of random
+ * taps (see sim/sim_keys.c). A screen is the first line of a settled LCD
+ * frame. From the session logs it reports, per screen:
+ *   frames     settled frames drawn, with the mean and worst draw time
+ *              (first to last LCD write of the redraw)
+ *   responses  taps made on the screen that were followed by a new frame
+ *              once the firmware scanned them, before the next tap, with
+ *              the scan to frame latency
+ *   ignored    taps made on the screen that were scanned but changed
+ *              nothing
+ * and the time the firmware took to scan a pressed key, which includes
+ * the login lockout and every message the UI shows with a delay. A session
+ * whose script stopped on a key the firmware never took is reported with
+ * the screen it was stuck on. The "(scan)" CSV row holds the key-down to
+ * scan times in its response columns.
+ *
+ * The exit code is 1 if a session failed or got stuck, 2 on bad usage.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#ifndef SIM_UILOAD_SIM
+#define SIM_UILOAD_SIM "smarthome_sim"
+#endif
+
+#define UILOAD_DIR_SIZE 256
+#define UILOAD_PATH_SIZE 512
+#define UILOAD_LINE_SIZE 256
+#define UILOAD_SCRIPT_SIZE 64
+#define UILOAD_ARGS_MAX 32
+#define UILOAD_SCREEN_SIZE 17 /* one LCD line */
+#define UILOAD_NS_PER_MS 1000000.0
+#define UILOAD_US_PER_MS 1000.0
+
+#define UILOAD_RUNS 4L
+#define UILOAD_STORM 1000L
+
+#define UILOAD_SETUP_KEYS "1234 5678" /* first time setup: admin, guest */
+#define UILOAD_LOGIN "0 1234 [1000] " /* the storm starts in the menu */
+
+/* Kinds of the events kept from a session log */
+#define UILOAD_KEY (uint8_t)0
+#define UILOAD_SCAN (uint8_t)1
+#define UILOAD_LCD (uint8_t)2
+#define UILOAD_STUCK (uint8_t)3
+
+#define UILOAD_NO_SCREEN (-1)
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint64_t u64Time;   /* ns */
+  size_t sOrder;      /* line number, keeps the log order on equal times */
+  uint8_t u8Kind;     /* UILOAD_x */
+  char cKey;
+  int iScreen;        /* LCD: index in uiload_screens */
+  uint32_t u32DrawUs; /* LCD: draw time */
+} UiloadEvent_t;
+
+typedef struct {
+  double *pdSamples; /* ms */
+  size_t sCount;
+  size_t sSize;
+} UiloadSamples_t;
+
+typedef struct {
+  char acName[UILOAD_SCREEN_SIZE];
+  unsigned long ulFrames;
+  double dDrawSum; /* ms */
+  double dDrawMax;
+  unsigned long ulIgnored;
+  UiloadSamples_t stResponses;
+} UiloadScreen_t;
+
+typedef struct {
+  uint8_t u8Ok;
+  uint8_t u8Stuck;
+  char cStuckKey;
+  int iStuckScreen;
+  unsigned long ulTaps;
+} UiloadRun_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const struct option uiload_options[] = {
+    {"sim", required_argument, NULL, 's'},
+    {"runs", required_argument, NULL, 'r'},
+    {"storm", required_argument, NULL, 'n'},
+    {"seed", required_argument, NULL, 'd'},
+    {"script", required_argument, NULL, 'k'},
+    {"stuck", required_argument, NULL, 'u'},
+    {"jobs", required_argument, NULL, 'j'},
+    {"out", required_argument, NULL, 'o'},
+    {"tag", required_argument, NULL, 't'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+static const char *uiload_sim = SIM_UILOAD_SIM;
+static char **uiload_extra = NULL; /* arguments after "--" */
+static int uiload_extra_count = 0;
+static const char *uiload_script = NULL;
+static long uiload_storm = UILOAD_STORM;
+static unsigned long uiload_seed = 1;
+static char uiload_work[] = "/tmp/smarthome_uiload.XXXXXX";
+
+/* Work queue of the sessions */
+static long uiload_run_count = UILOAD_RUNS;
+static long uiload_next_run = 0;
+static UiloadRun_t *uiload_runs = NULL;
+static pthread_mutex_t uiload_lock = PTHREAD_MUTEX_INITIALIZER; /* next run */
+
+/* Merged over every session, filled in after the workers are done */
+static UiloadScreen_t *uiload_screens = NULL;
+static int uiload_screen_count = 0;
+static UiloadSamples_t uiload_scans;
+static double uiload_scan_max = -1.0;
+static long uiload_scan_run = 0;
+static char uiload_scan_key = ' ';
+static int uiload_scan_screen = UILOAD_NO_SCREEN;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Copy a file, a missing source is not an error
+ * @param  pcFrom Source path
+ * @param  pcTo Destination path
+ * @return Void
+ */
+static void UILOAD_vCopy(const char *pcFrom, const char *pcTo) {
+  char acBuffer[UILOAD_LINE_SIZE];
+  size_t sRead;
+  FILE *pFrom = fopen(pcFrom, "rb");
+  FILE *pTo;
+  if (pFrom == NULL) {
+    return;
+  }
+  pTo = fopen(pcTo, "wb");
+  if (pTo != NULL) {
+    while ((sRead = fread(acBuffer, 1, sizeof(acBuffer), pFrom)) > 0) {
+      (void)fwrite(acBuffer, 1, sRead, pTo);
+    }
+    fclose(pTo);
+  }
+  fclose(pFrom);
+}
+
+/**
+ * @brief  Run one simulated session, its output is discarded
+ * @param  pcKeys Key script
+ * @param  pcDir EEPROM directory
+ * @param  pcEvents Event log or NULL
+ * @return Exit code of the simulator
+ */
+static int UILOAD_iSession(const char *pcKeys, const char *pcDir,
+                           const char *pcEvents) {
+  const char *apcArgs[UILOAD_ARGS_MAX + 1];
+  int iCount = 0;
+  int iStatus = 0;
+  int iNull;
+  int iExtra;
+  pid_t sPid;
+
+  apcArgs[iCount++] = uiload_sim;
+  apcArgs[iCount++] = "--quiet";
+  apcArgs[iCount++] = "--keys";
+  apcArgs[iCount++] = pcKeys;
+  apcArgs[iCount++] = "--eeprom-dir";
+  apcArgs[iCount++] = pcDir;
+  if (pcEvents != NULL) {
+    apcArgs[iCount++] = "--events";
+    apcArgs[iCount++] = pcEvents;
+  }
+  for (iExtra = 0;
+       (iExtra < uiload_extra_count) && (iCount < UILOAD_ARGS_MAX);
+       iExtra++) {
+    apcArgs[iCount++] = uiload_extra[iExtra];
+  }
+  apcArgs[iCount] = NULL;
+
+  sPid = fork();
+  if (sPid == 0) {
+    iNull = open("/dev/null", O_WRONLY);
+    if (iNull >= 0) {
+      dup2(iNull, STDOUT_FILENO);
+      dup2(iNull, STDERR_FILENO);
+    }
+    execv(uiload_sim, (char *const *)apcArgs);
+    _exit(127);
+  }
+  if ((sPid < 0) || (waitpid(sPid, &iStatus, 0) < 0)) {
+    return 127;
+  }
+  return WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : 128;
+}
+
+/**
+ * @brief  Paths of a session's directory and event log
+ * @param  lRun Session number
+ * @param  pcDir Receives the directory, UILOAD_DIR_SIZE bytes
+ * @param  pcEvents Receives the event log, UILOAD_PATH_SIZE bytes
+ * @return Void
+ */
+static void UILOAD_vPaths(long lRun, char *pcDir, char *pcEvents) {
+  snprintf(pcDir, UILOAD_DIR_SIZE, "%s/run%ld", uiload_work, lRun);
+  snprintf(pcEvents, UILOAD_PATH_SIZE, "%s/events.txt", pcDir);
+}
+
+/**
+ * @brief  Worker thread: takes sessions off the queue until it is empty
+ * @param  pvArg Unused
+ * @return NULL
+ */
+static void *UILOAD_pvWorker(void *pvArg) {
+  const char *const apcFiles[] = {"master.eep", "slave.eep"};
+  char acScript[UILOAD_SCRIPT_SIZE];
+  char acDir[UILOAD_DIR_SIZE];
+  char acEvents[UILOAD_PATH_SIZE];
+  char acFrom[UILOAD_PATH_SIZE];
+  char acTo[UILOAD_PATH_SIZE];
+  const char *pcKeys = uiload_script;
+  long lRun;
+  int iFile;
+  (void)pvArg;
+
+  while (1) {
+    pthread_mutex_lock(&uiload_lock);
+    lRun = uiload_next_run++;
+    pthread_mutex_unlock(&uiload_lock);
+    if (lRun >= uiload_run_count) {
+      return NULL;
+    }
+    /* Every session starts from the provisioned EEPROM */
+    UILOAD_vPaths(lRun, acDir, acEvents);
+    mkdir(acDir, 0755);
+    for (iFile = 0; iFile < 2; iFile++) {
+      snprintf(acFrom, sizeof(acFrom), "%s/base/%s", uiload_work,
+               apcFiles[iFile]);
+      snprintf(acTo, sizeof(acTo), "%s/%s", acDir, apcFiles[iFile]);
+      UILOAD_vCopy(acFrom, acTo);
+    }
+    if (uiload_script == NULL) {
+      snprintf(acScript, sizeof(acScript), UILOAD_LOGIN "~%ld:%lu",
+               uiload_storm, uiload_seed + (unsigned long)lRun);
+      pcKeys = acScript;
+    }
+    uiload_runs[lRun].u8Ok = (UILOAD_iSession(pcKeys, acDir, acEvents) == 0);
+  }
+}
+
+/**
+ * @brief  Add a sample to a set
+ * @param  pstSamples Set
+ * @param  dValue Sample in ms
+ * @return Void
+ */
+static void UILOAD_vAddSample(UiloadSamples_t *pstSamples, double dValue) {
+  if (pstSamples->sCount == pstSamples->sSize) {
+    pstSamples->sSize = (pstSamples->sSize == 0) ? 64 : 2 * pstSamples->sSize;
+    pstSamples->pdSamples = realloc(pstSamples->pdSamples,
+                                    pstSamples->sSize * sizeof(double));
+    if (pstSamples->pdSamples == NULL) {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  pstSamples->pdSamples[pstSamples->sCount++] = dValue;
+}
+
+/**
+ * @brief  Order samples by value
+ * @param  pvA First sample
+ * @param  pvB Second sample
+ * @return qsort order
+ */
+static int UILOAD_iCompareSamples(const void *pvA, const void *pvB) {
+  double dA = *(const double *)pvA;
+  double dB = *(const double *)pvB;
+  return (dA < dB) ? -1 : (dA > dB);
+}
+
+/**
+ * @brief  Summary of a set, sorts it
+ * @param  pstSamples Set
+ * @param  pdMean Receives the mean
+ * @param  pdP95 Receives the 95th percentile
+ * @param  pdMax Receives the maximum
+ * @return Void
+ */
+static void UILOAD_vSummary(UiloadSamples_t *pstSamples, double *pdMean,
+                            double *pdP95, double *pdMax) {
+  double dSum = 0.0;
+  size_t sIndex;
+
+  *pdMean = 0.0;
+  *pdP95 = 0.0;
+  *pdMax = 0.0;
+  if (pstSamples->sCount == 0) {
+    return;
+  }
+  qsort(pstSamples->pdSamples, pstSamples->sCount, sizeof(double),
+        UILOAD_iCompareSamples);
+  for (sIndex = 0; sIndex < pstSamples->sCount; sIndex++) {
+    dSum += pstSamples->pdSamples[sIndex];
+  }
+  *pdMean = dSum / (double)pstSamples->sCount;
+  /* Nearest rank */
+  *pdP95 = pstSamples->pdSamples[(pstSamples->sCount * 95 + 99) / 100 - 1];
+  *pdMax = pstSamples->pdSamples[pstSamples->sCount - 1];
+}
+
+/**
+ * @brief  Index of a screen, added on first sight
+ * @param  pcLine First LCD line, 16 characters
+ * @return Index in uiload_screens
+ */
+static int UILOAD_iScreen(const char *pcLine) {
+  char acName[UILOAD_SCREEN_SIZE];
+  int iLength = UILOAD_SCREEN_SIZE - 1;
+  int iScreen;
+
+  memcpy(acName, pcLine, UILOAD_SCREEN_SIZE - 1);
+  while ((iLength > 0) && (acName[iLength - 1] == ' ')) {
+    iLength--;
+  }
+  acName[iLength] = '\0';
+  for (iScreen = 0; iScreen < uiload_screen_count; iScreen++) {
+    if (strcmp(uiload_screens[iScreen].acName, acName) == 0) {
+      return iScreen;
+    }
+  }
+  uiload_screens = realloc(uiload_screens, (size_t)(uiload_screen_count + 1) *
+                                               sizeof(UiloadScreen_t));
+  if (uiload_screens == NULL) {
+    perror("realloc");
+    exit(1);
+  }
+  memset(&uiload_screens[uiload_screen_count], 0, sizeof(UiloadScreen_t));
+  strcpy(uiload_screens[uiload_screen_count].acName, acName);
+  return uiload_screen_count++;
+}
+
+/**
+ * @brief  Order events by time, then by log line
+ * @param  pvA First event
+ * @param  pvB Second event
+ * @return qsort order
+ */
+static int UILOAD_iCompareEvents(const void *pvA, const void *pvB) {
+  const UiloadEvent_t *pstA = pvA;
+  const UiloadEvent_t *pstB = pvB;
+  if (pstA->u64Time != pstB->u64Time) {
+    return (pstA->u64Time < pstB->u64Time) ? -1 : 1;
+  }
+  return (pstA->sOrder < pstB->sOrder) ? -1 : 1;
+}
+
+/**
+ * @brief  Read the master's keypad and LCD events of a session log
+ * @param  pcEvents Event log
+ * @param  psCount Receives the number of events
+ * @return Events sorted by time, NULL if the log cannot be read
+ */
+static UiloadEvent_t *UILOAD_pstRead(const char *pcEvents, size_t *psCount) {
+  char acLine[UILOAD_LINE_SIZE];
+  UiloadEvent_t *pstEvents = NULL;
+  UiloadEvent_t stEvent;
+  size_t sSize = 0;
+  size_t sLine = 0;
+  char *pcText;
+  char *pcDraw;
+  FILE *pFile = fopen(pcEvents, "r");
+
+  *psCount = 0;
+  if (pFile == NULL) {
+    return NULL;
+  }
+  while (fgets(acLine, sizeof(acLine), pFile) != NULL) {
+    memset(&stEvent, 0, sizeof(stEvent));
+    stEvent.u64Time = strtoull(acLine, &pcText, 10);
+    stEvent.sOrder = sLine++;
+    if (strncmp(pcText, " master KEY ", 12) == 0) {
+      stEvent.u8Kind = UILOAD_KEY;
+      stEvent.cKey = pcText[12];
+    } else if (strncmp(pcText, " master SCAN ", 13) == 0) {
+      stEvent.u8Kind = UILOAD_SCAN;
+      stEvent.cKey = pcText[13];
+    } else if (strncmp(pcText, " master STUCK ", 14) == 0) {
+      stEvent.u8Kind = UILOAD_STUCK;
+      stEvent.cKey = pcText[14];
+    } else if ((strncmp(pcText, " master LCD |", 13) == 0) &&
+               (strlen(pcText) > 13 + UILOAD_SCREEN_SIZE)) {
+      stEvent.u8Kind = UILOAD_LCD;
+      stEvent.iScreen = UILOAD_iScreen(pcText + 13);
+      pcDraw = strstr(pcText, " draw_us=");
+      if (pcDraw != NULL) {
+        stEvent.u32DrawUs = (uint32_t)strtoul(pcDraw + 9, NULL, 10);
+      }
+    } else {
+      continue;
+    }
+    if (*psCount == sSize) {
+      sSize = (sSize == 0) ? 1024 : 2 * sSize;
+      pstEvents = realloc(pstEvents, sSize * sizeof(UiloadEvent_t));
+      if (pstEvents == NULL) {
+        perror("realloc");
+        exit(1);
+      }
+    }
+    pstEvents[(*psCount)++] = stEvent;
+  }
+  fclose(pFile);
+  /* The LCD event of a frame is written after its settle time */
+  if (*psCount > 0) {
+    qsort(pstEvents, *psCount, sizeof(UiloadEvent_t), UILOAD_iCompareEvents);
+  }
+  return pstEvents;
+}
+
+/**
+ * @brief  Add the timings of one session to the totals
+ * @param  lRun Session number
+ * @return Void
+ */
+static void UILOAD_vMeasure(long lRun) {
+  char acDir[UILOAD_DIR_SIZE];
+  char acEvents[UILOAD_PATH_SIZE];
+  UiloadRun_t *pstRun = &uiload_runs[lRun];
+  UiloadEvent_t *pstEvents;
+  const UiloadEvent_t *pstEvent;
+  UiloadScreen_t *pstScreen;
+  int iShown = UILOAD_NO_SCREEN;
+  int iTapScreen = UILOAD_NO_SCREEN; /* shown when the last tap went down */
+  uint8_t u8Pending = 0; /* last tap scanned, no frame since */
+  uint64_t u64Key = 0;
+  uint64_t u64Scan = 0;
+  double dValue;
+  size_t sCount;
+  size_t sIndex;
+
+  UILOAD_vPaths(lRun, acDir, acEvents);
+  pstEvents = UILOAD_pstRead(acEvents, &sCount);
+  if (pstEvents == NULL) {
+    pstRun->u8Ok = 0;
+    return;
+  }
+  for (sIndex = 0; sIndex < sCount; sIndex++) {
+    pstEvent = &pstEvents[sIndex];
+    switch (pstEvent->u8Kind) {
+    case UILOAD_KEY:
+      if (u8Pending && (iTapScreen != UILOAD_NO_SCREEN)) {
+        uiload_screens[iTapScreen].ulIgnored++;
+      }
+      pstRun->ulTaps++;
+      u64Key = pstEvent->u64Time;
+      iTapScreen = iShown;
+      u8Pending = 0;
+      break;
+    case UILOAD_SCAN:
+      dValue = (pstEvent->u64Time - u64Key) / UILOAD_NS_PER_MS;
+      UILOAD_vAddSample(&uiload_scans, dValue);
+      if (dValue > uiload_scan_max) {
+        uiload_scan_max = dValue;
+        uiload_scan_run = lRun;
+        uiload_scan_key = pstEvent->cKey;
+        uiload_scan_screen = iShown;
+      }
+      /* Frames drawn before the scan, e.g. a countdown, are not replies */
+      u64Scan = pstEvent->u64Time;
+      u8Pending = 1;
+      break;
+    case UILOAD_LCD:
+      pstScreen = &uiload_screens[pstEvent->iScreen];
+      pstScreen->ulFrames++;
+      dValue = pstEvent->u32DrawUs / UILOAD_US_PER_MS;
+      pstScreen->dDrawSum += dValue;
+      if (dValue > pstScreen->dDrawMax) {
+        pstScreen->dDrawMax = dValue;
+      }
+      if (u8Pending && (iTapScreen != UILOAD_NO_SCREEN)) {
+        UILOAD_vAddSample(&uiload_screens[iTapScreen].stResponses,
+                          (pstEvent->u64Time - u64Scan) / UILOAD_NS_PER_MS);
+      }
+      u8Pending = 0;
+      iShown = pstEvent->iScreen;
+      break;
+    default: /* UILOAD_STUCK */
+      pstRun->u8Stuck = 1;
+      pstRun->cStuckKey = pstEvent->cKey;
+      pstRun->iStuckScreen = iShown;
+      break;
+    }
+  }
+  free(pstEvents);
+}
+
+/**
+ * @brief  Name of a screen for the report
+ * @param  iScreen Index in uiload_screens or UILOAD_NO_SCREEN
+ * @return Screen name
+ */
+static const char *UILOAD_pcScreenName(int iScreen) {
+  return (iScreen == UILOAD_NO_SCREEN) ? "(blank)"
+                                       : uiload_screens[iScreen].acName;
+}
+
+/**
+ * @brief  Append the per screen results to the CSV file, with a header if
+ *         it is new
+ * @param  pcPath CSV path
+ * @param  pcTag First column
+ * @return 1 on success, 0 if the file cannot be written
+ */
+static uint8_t UILOAD_u8WriteCsv(const char *pcPath, const char *pcTag) {
+  struct stat stInfo;
+  uint8_t u8New = ((stat(pcPath, &stInfo) != 0) || (stInfo.st_size == 0));
+  UiloadScreen_t *pstScreen;
+  double dMean;
+  double dP95;
+  double dMax;
+  int iScreen;
+  FILE *pFile = fopen(pcPath, "a");
+
+  if (pFile == NULL) {
+    return 0;
+  }
+  if (u8New) {
+    fprintf(pFile, "tag,screen,frames,draw_mean_ms,draw_max_ms,responses,"
+                   "response_mean_ms,response_p95_ms,response_max_ms,"
+                   "ignored\n");
+  }
+  for (iScreen = 0; iScreen < uiload_screen_count; iScreen++) {
+    pstScreen = &uiload_screens[iScreen];
+    UILOAD_vSummary(&pstScreen->stResponses, &dMean, &dP95, &dMax);
+    fprintf(pFile, "%s,\"%s\",%lu,%.3f,%.3f,%zu,%.3f,%.3f,%.3f,%lu\n", pcTag,
+            pstScreen->acName, pstScreen->ulFrames,
+            pstScreen->dDrawSum / (double)pstScreen->ulFrames,
+            pstScreen->dDrawMax, pstScreen->stResponses.sCount, dMean, dP95,
+            dMax, pstScreen->ulIgnored);
+  }
+  UILOAD_vSummary(&uiload_scans, &dMean, &dP95, &dMax);
+  fprintf(pFile, "%s,\"(scan)\",0,0,0,%zu,%.3f,%.3f,%.3f,0\n", pcTag,
+          uiload_scans.sCount, dMean, dP95, dMax);
+  fclose(pFile);
+  return 1;
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 if every session completed, 1 otherwise, 2 on bad usage
+ */
+int main(int argc, char *argv[]) {
+  char acBase[UILOAD_DIR_SIZE];
+  struct timespec stStart;
+  struct timespec stEnd;
+  UiloadScreen_t *pstScreen;
+  const UiloadRun_t *pstRun;
+  const char *pcOut = NULL;
+  const char *pcTag = "local";
+  const char *pcStuck = NULL;
+  pthread_t *psThreads;
+  unsigned long ulTaps = 0;
+  long lJobs = sysconf(_SC_NPROCESSORS_ONLN);
+  long lThread;
+  long lRun;
+  double dMean;
+  double dP95;
+  double dMax;
+  int iScreen;
+  int iOption;
+  int iResult = 0;
+
+  while ((iOption = getopt_long(argc, argv, "", uiload_options, NULL)) !=
+         -1) {
+    switch (iOption) {
+    case 's':
+      uiload_sim = optarg;
+      break;
+    case 'r':
+      uiload_run_count = strtol(optarg, NULL, 10);
+      break;
+    case 'n':
+      uiload_storm = strtol(optarg, NULL, 10);
+      break;
+    case 'd':
+      uiload_seed = strtoul(optarg, NULL, 0);
+      break;
+    case 'k':
+      uiload_script = optarg;
+      break;
+    case 'u':
+      pcStuck = optarg;
+      break;
+    case 'j':
+      lJobs = strtol(optarg, NULL, 10);
+      break;
+    case 'o':
+      pcOut = optarg;
+      break;
+    case 't':
+      pcTag = optarg;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [--sim PROGRAM] [--runs N] [--storm N] [--seed S] "
+              "[--script SCRIPT] [--stuck MS] [--jobs N] [--out FILE] "
+              "[--tag TAG] [-- simulator arguments]\n",
+              argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+  uiload_extra = &argv[optind];
+  uiload_extra_count = argc - optind;
+  if ((uiload_run_count < 1) || (uiload_storm < 1)) {
+    fprintf(stderr, "--runs and --storm must be at least 1\n");
+    return 2;
+  }
+  if (lJobs < 1) {
+    lJobs = 1;
+  }
+  if (lJobs > uiload_run_count) {
+    lJobs = uiload_run_count;
+  }
+  /* Inherited by every session */
+  if (pcStuck != NULL) {
+    setenv("SIM_KEYS_STUCK_MS", pcStuck, 1);
+  }
+
+  uiload_runs = calloc((size_t)uiload_run_count, sizeof(UiloadRun_t));
+  psThreads = calloc((size_t)lJobs, sizeof(pthread_t));
+  if ((uiload_runs == NULL) || (psThreads == NULL)) {
+    perror("calloc");
+    return 1;
+  }
+  if (mkdtemp(uiload_work) == NULL) {
+    perror("mkdtemp");
+    return 1;
+  }
+  snprintf(acBase, sizeof(acBase), "%s/base", uiload_work);
+  mkdir(acBase, 0755);
+  if (UILOAD_iSession(UILOAD_SETUP_KEYS, acBase, NULL) != 0) {
+    fprintf(stderr, "%s: first time setup failed\n", uiload_sim);
+    return 1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &stStart);
+  for (lThread = 0; lThread < lJobs; lThread++) {
+    if (pthread_create(&psThreads[lThread], NULL, UILOAD_pvWorker, NULL) !=
+        0) {
+      perror("pthread_create");
+      return 1;
+    }
+  }
+  for (lThread = 0; lThread < lJobs; lThread++) {
+    pthread_join(psThreads[lThread], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stEnd);
+
+  for (lRun = 0; lRun < uiload_run_count; lRun++) {
+    if (uiload_runs[lRun].u8Ok) {
+      UILOAD_vMeasure(lRun);
+    }
+    ulTaps += uiload_runs[lRun].ulTaps;
+  }
+
+  printf("%ld sessions, %lu taps on %ld workers in %.1f s\n",
+         uiload_run_count, ulTaps, lJobs,
+         (stEnd.tv_sec - stStart.tv_sec) +
+             (stEnd.tv_nsec - stStart.tv_nsec) / 1e9);
+  printf("%-16s %7s %8s %8s %9s %8s %8s %8s %7s\n", "screen", "frames",
+         "draw ms", "max", "responses", "mean ms", "p95", "max", "ignored");
+  for (iScreen = 0; iScreen < uiload_screen_count; iScreen++) {
+    pstScreen = &uiload_screens[iScreen];
+    UILOAD_vSummary(&pstScreen->stResponses, &dMean, &dP95, &dMax);
+    printf("%-16s %7lu %8.2f %8.2f %9zu %8.1f %8.1f %8.1f %7lu\n",
+           pstScreen->acName, pstScreen->ulFrames,
+           pstScreen->dDrawSum / (double)pstScreen->ulFrames,
+           pstScreen->dDrawMax, pstScreen->stResponses.sCount, dMean, dP95,
+           dMax, pstScreen->ulIgnored);
+  }
+  UILOAD_vSummary(&uiload_scans, &dMean, &dP95, &dMax);
+  printf("scan: mean %.1f ms, p95 %.1f ms, max %.1f ms (session %ld, key %c "
+         "on \"%s\")\n",
+         dMean, dP95, dMax, uiload_scan_run, uiload_scan_key,
+         UILOAD_pcScreenName(uiload_scan_screen));
+
+  for (lRun = 0; lRun < uiload_run_count; lRun++) {
+    pstRun = &uiload_runs[lRun];
+    if (!pstRun->u8Ok) {
+      printf("session %ld: FAIL\n", lRun);
+      iResult = 1;
+    } else if (pstRun->u8Stuck) {
+      printf("session %ld: STUCK on key %c, screen \"%s\", after %lu taps\n",
+             lRun, pstRun->cStuckKey,
+             UILOAD_pcScreenName(pstRun->iStuckScreen), pstRun->ulTaps);
+      iResult = 1;
+    }
+  }
+
+  if ((pcOut != NULL) && !UILOAD_u8WriteCsv(pcOut, pcTag)) {
+    perror(pcOut);
+    return 2;
+  }
+  printf("sessions kept in %s\n", uiload_work);
+  return iResult;
+}
\ No newline at end of file
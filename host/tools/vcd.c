@@ -0,0 +1,836 @@
+/******************************************************************************
+ * Module: Host Simulation
+ * File Name: vcd.c
+ * Description: Timing analysis of the SPI, LCD and fan PWM signals of a VCD
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * smarthome_vcd [options] [FILE]
+ *   --spi NAME        SPI byte signal, may be repeated (default
+ *                     master_spi_tx and slave_spi_tx)
+ *   --ss NAME         active low chip select, not traced by default
+ *   --byte-us US      time on the wire of one byte (default 16: SCK at
+ *                     F_CPU / 16, SPI.c)
+ *   --frame-gap-ms MS longer gaps end an SPI transfer (default 20)
+ *   --lcd-en NAME     LCD enable (default master_lcd_en)
+ *   --lcd-rs NAME     LCD register select (default master_lcd_rs)
+ *   --burst-gap-ms MS longer gaps between LCD cycles end a redraw
+ *                     (default 10)
+ *   --pwm NAME        fan PWM pin (default slave_fan_en, FAN_EN_PIN)
+ *   --tick-us US      period of the PWM tick (default 2048, Timer0 of the
+ *                     slave)
+ *   --steps N         ticks per PWM period (default 100)
+ *   --duty PERCENT    commanded duty, the error is taken against the
+ *                     nearest step when it is not given
+ *
+ * Reads a VCD file (standard input when no file is given), e.g. the one
+ * smarthome_cosim --vcd writes, and needs no simulator. Default names are
+ * those of that trace.
+ *
+ * simavr's SPI model moves whole bytes and does not drive the SCK, MOSI
+ * and MISO pins, so a transfer is seen on the byte signals: every value
+ * change is one byte. A writer that only records changes merges a byte
+ * sent twice in a row into one. Bytes closer than --frame-gap-ms form one
+ * transfer, e.g. a command and its telemetry frame; the time a transfer
+ * spends between its bytes is what the firmware sleeps in _delay_ms.
+ *
+ * An LCD cycle is a pulse of EN, latched on its falling edge as a
+ * character when RS is high. Cycles closer than --burst-gap-ms form one
+ * redraw.
+ *
+ * A PWM period runs from a rising edge to the next one. Its duty is the
+ * high share of the period. Edge jitter is the spread of the edges around
+ * the tick grid started by the first edge, i.e. the interrupt latency the
+ * software PWM suffers.
+ *
+ * The exit code is 1 if none of the signals is in the trace, 2 on a usage
+ * error, an unreadable file or a malformed trace.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include <getopt.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define WAVE_TOKEN_SIZE 256
+#define WAVE_ID_SIZE 16
+#define WAVE_SPI_MAX 4
+
+#define WAVE_PS_PER_US 1000000.0
+#define WAVE_US_PER_MS 1000.0
+#define WAVE_US_PER_S 1000000.0
+
+/* Signals, the SPI byte signals come last */
+#define WAVE_SS 0
+#define WAVE_LCD_EN 1
+#define WAVE_LCD_RS 2
+#define WAVE_PWM 3
+#define WAVE_SPI 4
+#define WAVE_SIGNAL_MAX (WAVE_SPI + WAVE_SPI_MAX)
+
+#define WAVE_BYTE_US 16.0
+#define WAVE_FRAME_GAP_MS 20.0
+#define WAVE_BURST_GAP_MS 10.0
+#define WAVE_TICK_US 2048.0
+#define WAVE_STEPS 100L
+
+/*******************************************************************************
+ *                    Data Types Declaration                    *
+ *******************************************************************************/
+typedef struct {
+  uint64_t u64Time;  /* ps */
+  uint32_t u32Value; /* low 32 bits */
+  uint8_t u8Known;   /* 0 for x or z */
+  uint8_t u8Initial; /* from $dumpvars, not a change */
+} WaveChange_t;
+
+typedef struct {
+  const char *pcName;
+  char acId[WAVE_ID_SIZE];
+  uint8_t u8Found;
+  WaveChange_t *pstChanges;
+  size_t sCount;
+  size_t sSize;
+} WaveSignal_t;
+
+typedef struct {
+  size_t sCount;
+  double dSum;
+  double dSquares;
+  double dMin;
+  double dMax;
+} WaveStats_t;
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+static const struct option wave_options[] = {
+    {"spi", required_argument, NULL, 's'},
+    {"ss", required_argument, NULL, 'c'},
+    {"byte-us", required_argument, NULL, 'b'},
+    {"frame-gap-ms", required_argument, NULL, 'f'},
+    {"lcd-en", required_argument, NULL, 'e'},
+    {"lcd-rs", required_argument, NULL, 'r'},
+    {"burst-gap-ms", required_argument, NULL, 'g'},
+    {"pwm", required_argument, NULL, 'p'},
+    {"tick-us", required_argument, NULL, 't'},
+    {"steps", required_argument, NULL, 'n'},
+    {"duty", required_argument, NULL, 'd'},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0}};
+
+static WaveSignal_t wave_signals[WAVE_SIGNAL_MAX] = {
+    {NULL, "", 0, NULL, 0, 0},
+    {"master_lcd_en", "", 0, NULL, 0, 0},
+    {"master_lcd_rs", "", 0, NULL, 0, 0},
+    {"slave_fan_en", "", 0, NULL, 0, 0},
+    {"master_spi_tx", "", 0, NULL, 0, 0},
+    {"slave_spi_tx", "", 0, NULL, 0, 0}};
+static int wave_spi_count = 2;
+
+static double wave_scale_ps = 1.0; /* one $timescale unit */
+static uint64_t wave_end = 0;      /* last timestamp, ps */
+
+static double wave_byte_us = WAVE_BYTE_US;
+static double wave_frame_gap_us = WAVE_FRAME_GAP_MS * WAVE_US_PER_MS;
+static double wave_burst_gap_us = WAVE_BURST_GAP_MS * WAVE_US_PER_MS;
+static double wave_tick_us = WAVE_TICK_US;
+static long wave_steps = WAVE_STEPS;
+static double wave_duty = -1.0; /* percent, -1 for the nearest step */
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Convert a trace time to microseconds
+ * @param  u64Time Time in ps
+ * @return Time in us
+ */
+static double WAVE_dUs(uint64_t u64Time) { return u64Time / WAVE_PS_PER_US; }
+
+/**
+ * @brief  Add a sample to running statistics
+ * @param  pstStats Statistics
+ * @param  dValue Sample
+ * @return Void
+ */
+static void WAVE_vAdd(WaveStats_t *pstStats, double dValue) {
+  if ((pstStats->sCount == 0) || (dValue < pstStats->dMin)) {
+    pstStats->dMin = dValue;
+  }
+  if ((pstStats->sCount == 0) || (dValue > pstStats->dMax)) {
+    pstStats->dMax = dValue;
+  }
+  pstStats->sCount++;
+  pstStats->dSum += dValue;
+  pstStats->dSquares += dValue * dValue;
+}
+
+/**
+ * @brief  Mean of running statistics
+ * @param  pstStats Statistics
+ * @return Mean, 0 without samples
+ */
+static double WAVE_dMean(const WaveStats_t *pstStats) {
+  return (pstStats->sCount == 0) ? 0.0 : pstStats->dSum / pstStats->sCount;
+}
+
+/**
+ * @brief  Standard deviation of running statistics
+ * @param  pstStats Statistics
+ * @return Population standard deviation, 0 without samples
+ */
+static double WAVE_dDeviation(const WaveStats_t *pstStats) {
+  double dMean = WAVE_dMean(pstStats);
+  double dVariance;
+  if (pstStats->sCount == 0) {
+    return 0.0;
+  }
+  dVariance = pstStats->dSquares / pstStats->sCount - dMean * dMean;
+  return (dVariance > 0.0) ? sqrt(dVariance) : 0.0;
+}
+
+/**
+ * @brief  Read the next blank separated token
+ * @param  pFile Trace
+ * @param  pcToken Receives the token, WAVE_TOKEN_SIZE bytes
+ * @return 1 if a token was read, 0 at the end of the file
+ */
+static uint8_t WAVE_u8Token(FILE *pFile, char *pcToken) {
+  return (fscanf(pFile, "%255s", pcToken) == 1);
+}
+
+/**
+ * @brief  Skip the rest of a header section
+ * @param  pFile Trace
+ * @param  pcToken Scratch buffer, WAVE_TOKEN_SIZE bytes
+ * @return 1 if its $end was found, 0 otherwise
+ */
+static uint8_t WAVE_u8SkipSection(FILE *pFile, char *pcToken) {
+  while (WAVE_u8Token(pFile, pcToken)) {
+    if (strcmp(pcToken, "$end") == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief  Parse "$timescale 1 ns $end", number and unit may be joined
+ * @param  pFile Trace
+ * @param  pcToken Scratch buffer, WAVE_TOKEN_SIZE bytes
+ * @return 1 on success, 0 on a malformed section
+ */
+static uint8_t WAVE_u8Timescale(FILE *pFile, char *pcToken) {
+  static const char *const apcUnits[] = {"s", "ms", "us", "ns", "ps", "fs"};
+  static const double adScales[] = {1e12, 1e9, 1e6, 1e3, 1.0, 1e-3};
+  char acText[WAVE_TOKEN_SIZE] = "";
+  char *pcUnit;
+  double dNumber;
+  size_t sUnit;
+
+  while (WAVE_u8Token(pFile, pcToken) && (strcmp(pcToken, "$end") != 0)) {
+    strncat(acText, pcToken, sizeof(acText) - strlen(acText) - 1);
+  }
+  dNumber = strtod(acText, &pcUnit);
+  for (sUnit = 0; sUnit < sizeof(adScales) / sizeof(adScales[0]); sUnit++) {
+    if (strcmp(pcUnit, apcUnits[sUnit]) == 0) {
+      wave_scale_ps = dNumber * adScales[sUnit];
+      return (dNumber > 0.0);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief  Parse "$var wire 8 ! name [7:0] $end" and bind a wanted signal
+ * @param  pFile Trace
+ * @param  pcToken Scratch buffer, WAVE_TOKEN_SIZE bytes
+ * @return 1 on success, 0 on a malformed section
+ */
+static uint8_t WAVE_u8Var(FILE *pFile, char *pcToken) {
+  char acId[WAVE_TOKEN_SIZE];
+  const char *pcName;
+  int iSignal;
+
+  /* Type and width, then the identifier and the reference */
+  if (!WAVE_u8Token(pFile, pcToken) || !WAVE_u8Token(pFile, pcToken) ||
+      !WAVE_u8Token(pFile, acId) || !WAVE_u8Token(pFile, pcToken)) {
+    return 0;
+  }
+  for (iSignal = 0; iSignal < WAVE_SPI + wave_spi_count; iSignal++) {
+    pcName = wave_signals[iSignal].pcName;
+    if ((pcName != NULL) && (strcmp(pcName, pcToken) == 0) &&
+        (strlen(acId) < WAVE_ID_SIZE)) {
+      strcpy(wave_signals[iSignal].acId, acId);
+      wave_signals[iSignal].u8Found = 1;
+    }
+  }
+  return WAVE_u8SkipSection(pFile, pcToken);
+}
+
+/**
+ * @brief  Record a value change of every signal bound to an identifier
+ * @param  pcId Identifier
+ * @param  pcValue Binary digits, x and z allowed
+ * @param  u64Time Time in ps
+ * @param  u8Initial 1 inside $dumpvars
+ * @return Void
+ */
+static void WAVE_vChange(const char *pcId, const char *pcValue,
+                         uint64_t u64Time, uint8_t u8Initial) {
+  WaveSignal_t *pstSignal;
+  WaveChange_t stChange = {u64Time, 0, 1, u8Initial};
+  int iSignal;
+
+  for (; *pcValue != '\0'; pcValue++) {
+    if ((*pcValue == '0') || (*pcValue == '1')) {
+      stChange.u32Value = (stChange.u32Value << 1) | (uint32_t)(*pcValue - '0');
+    } else {
+      stChange.u8Known = 0;
+    }
+  }
+  for (iSignal = 0; iSignal < WAVE_SPI + wave_spi_count; iSignal++) {
+    pstSignal = &wave_signals[iSignal];
+    if ((pstSignal->u8Found == 0) || (strcmp(pstSignal->acId, pcId) != 0)) {
+      continue;
+    }
+    if (pstSignal->sCount == pstSignal->sSize) {
+      pstSignal->sSize = (pstSignal->sSize == 0) ? 1024 : 2 * pstSignal->sSize;
+      pstSignal->pstChanges = realloc(pstSignal->pstChanges,
+                                      pstSignal->sSize * sizeof(WaveChange_t));
+      if (pstSignal->pstChanges == NULL) {
+        perror("realloc");
+        exit(2);
+      }
+    }
+    pstSignal->pstChanges[pstSignal->sCount++] = stChange;
+  }
+}
+
+/**
+ * @brief  Read the header and the value changes of a trace
+ * @param  pFile Trace
+ * @return 1 on success, 0 on a malformed trace
+ */
+static uint8_t WAVE_u8Read(FILE *pFile) {
+  char acToken[WAVE_TOKEN_SIZE];
+  char acId[WAVE_TOKEN_SIZE];
+  uint64_t u64Time = 0;
+  uint8_t u8Initial = 0;
+
+  while (WAVE_u8Token(pFile, acToken)) {
+    if (acToken[0] == '#') {
+      u64Time = (uint64_t)(strtod(acToken + 1, NULL) * wave_scale_ps + 0.5);
+      if (u64Time > wave_end) {
+        wave_end = u64Time;
+      }
+    } else if (strcmp(acToken, "$timescale") == 0) {
+      if (!WAVE_u8Timescale(pFile, acToken)) {
+        fprintf(stderr, "vcd: bad $timescale\n");
+        return 0;
+      }
+    } else if (strcmp(acToken, "$var") == 0) {
+      if (!WAVE_u8Var(pFile, acToken)) {
+        fprintf(stderr, "vcd: bad $var\n");
+        return 0;
+      }
+    } else if (strcmp(acToken, "$dumpvars") == 0) {
+      u8Initial = 1;
+    } else if (strcmp(acToken, "$end") == 0) {
+      u8Initial = 0; /* of $dumpvars, $dumpall, $dumpon or $dumpoff */
+    } else if ((strcmp(acToken, "$dumpall") == 0) ||
+               (strcmp(acToken, "$dumpon") == 0) ||
+               (strcmp(acToken, "$dumpoff") == 0)) {
+      continue; /* value changes follow */
+    } else if (acToken[0] == '$') {
+      (void)WAVE_u8SkipSection(pFile, acToken); /* $scope, $comment... */
+    } else if ((acToken[0] == 'b') || (acToken[0] == 'B')) {
+      if (!WAVE_u8Token(pFile, acId)) {
+        fprintf(stderr, "vcd: vector value without identifier\n");
+        return 0;
+      }
+      WAVE_vChange(acId, acToken + 1, u64Time, u8Initial);
+    } else if ((acToken[0] == 'r') || (acToken[0] == 'R')) {
+      (void)WAVE_u8Token(pFile, acId); /* real values are not used */
+    } else if (strchr("01xXzZ", acToken[0]) != NULL) {
+      acId[0] = acToken[0];
+      acId[1] = '\0';
+      WAVE_vChange(acToken + 1, acId, u64Time, u8Initial);
+    } else {
+      fprintf(stderr, "vcd: unexpected \"%s\"\n", acToken);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief  Transitions of a 1-bit signal, repeated values dropped
+ * @param  pstSignal Signal, its change list is rewritten
+ * @return Void
+ */
+static void WAVE_vEdges(WaveSignal_t *pstSignal) {
+  const WaveChange_t *pstLast = NULL;
+  const WaveChange_t *pstChange;
+  size_t sIn;
+  size_t sOut = 0;
+
+  for (sIn = 0; sIn < pstSignal->sCount; sIn++) {
+    pstChange = &pstSignal->pstChanges[sIn];
+    if ((pstLast != NULL) && (pstLast->u8Known == pstChange->u8Known) &&
+        (pstLast->u32Value == pstChange->u32Value)) {
+      continue;
+    }
+    pstSignal->pstChanges[sOut] = *pstChange;
+    pstLast = &pstSignal->pstChanges[sOut++];
+  }
+  pstSignal->sCount = sOut;
+}
+
+/**
+ * @brief  Print the utilisation and idle gaps of an SPI byte signal
+ * @param  pstSignal Byte signal
+ * @return Void
+ */
+static void WAVE_vSpi(const WaveSignal_t *pstSignal) {
+  const WaveChange_t *pstChange;
+  WaveStats_t stInside = {0};   /* gaps between bytes of a transfer, us */
+  WaveStats_t stBetween = {0};  /* idle between transfers, us */
+  WaveStats_t stTransfer = {0}; /* transfer durations, us */
+  double dSpan = WAVE_dUs(wave_end);
+  double dStart = 0.0;
+  double dLast = 0.0;
+  double dTime;
+  double dGap;
+  size_t sBytes = 0;
+  size_t sIndex;
+
+  for (sIndex = 0; sIndex < pstSignal->sCount; sIndex++) {
+    pstChange = &pstSignal->pstChanges[sIndex];
+    if (pstChange->u8Initial || !pstChange->u8Known) {
+      continue;
+    }
+    dTime = WAVE_dUs(pstChange->u64Time);
+    if (sBytes == 0) {
+      dStart = dTime;
+    } else {
+      dGap = dTime - dLast - wave_byte_us;
+      if (dGap > wave_frame_gap_us) {
+        WAVE_vAdd(&stTransfer, dLast + wave_byte_us - dStart);
+        WAVE_vAdd(&stBetween, dGap);
+        dStart = dTime;
+      } else {
+        WAVE_vAdd(&stInside, (dGap > 0.0) ? dGap : 0.0);
+      }
+    }
+    dLast = dTime;
+    sBytes++;
+  }
+  if (sBytes == 0) {
+    printf("SPI %s: no bytes\n", pstSignal->pcName);
+    return;
+  }
+  WAVE_vAdd(&stTransfer, dLast + wave_byte_us - dStart);
+
+  printf("SPI %s: %zu bytes in %zu transfers, busy %.3f %% of %.3f s "
+         "(%.1f us per byte)\n",
+         pstSignal->pcName, sBytes, stTransfer.sCount,
+         (dSpan > 0.0) ? 100.0 * sBytes * wave_byte_us / dSpan : 0.0,
+         dSpan / WAVE_US_PER_S, wave_byte_us);
+  printf("  in transfers: %.3f ms moving bytes, %.3f ms between bytes "
+         "(%.1f %% sleeping)\n",
+         sBytes * wave_byte_us / WAVE_US_PER_MS, stInside.dSum / WAVE_US_PER_MS,
+         (stTransfer.dSum > 0.0) ? 100.0 * stInside.dSum / stTransfer.dSum
+                                 : 0.0);
+  printf("  transfer: min %.3f mean %.3f max %.3f ms\n",
+         stTransfer.dMin / WAVE_US_PER_MS,
+         WAVE_dMean(&stTransfer) / WAVE_US_PER_MS,
+         stTransfer.dMax / WAVE_US_PER_MS);
+  if (stInside.sCount > 0) {
+    printf("  gap between bytes: min %.3f mean %.3f max %.3f ms\n",
+           stInside.dMin / WAVE_US_PER_MS,
+           WAVE_dMean(&stInside) / WAVE_US_PER_MS,
+           stInside.dMax / WAVE_US_PER_MS);
+  }
+  if (stBetween.sCount > 0) {
+    printf("  idle between transfers: min %.3f mean %.3f max %.3f ms\n",
+           stBetween.dMin / WAVE_US_PER_MS,
+           WAVE_dMean(&stBetween) / WAVE_US_PER_MS,
+           stBetween.dMax / WAVE_US_PER_MS);
+  }
+}
+
+/**
+ * @brief  Print the share of time the chip select is low and the bytes
+ *         moved while it is
+ * @param  pstSelect Chip select, edges only
+ * @param  pstBytes Byte signal counted against it
+ * @return Void
+ */
+static void WAVE_vSelect(const WaveSignal_t *pstSelect,
+                         const WaveSignal_t *pstBytes) {
+  const WaveChange_t *pstChange;
+  double dLow = 0.0;
+  double dFall = -1.0; /* start of the current select, -1 when high */
+  double dTime;
+  size_t sSelects = 0;
+  size_t sBytes = 0;
+  size_t sByte = 0;
+  size_t sIndex;
+
+  for (sIndex = 0; sIndex <= pstSelect->sCount; sIndex++) {
+    pstChange =
+        (sIndex < pstSelect->sCount) ? &pstSelect->pstChanges[sIndex] : NULL;
+    dTime = (pstChange != NULL) ? WAVE_dUs(pstChange->u64Time)
+                                : WAVE_dUs(wave_end);
+    /* A byte is logged when it is complete: bytes up to this edge belong
+       to the interval that ends here */
+    while ((pstBytes != NULL) && (sByte < pstBytes->sCount) &&
+           (WAVE_dUs(pstBytes->pstChanges[sByte].u64Time) <= dTime)) {
+      if ((dFall >= 0.0) && !pstBytes->pstChanges[sByte].u8Initial) {
+        sBytes++;
+      }
+      sByte++;
+    }
+    if (dFall >= 0.0) {
+      dLow += dTime - dFall;
+      dFall = -1.0;
+    }
+    if ((pstChange != NULL) && pstChange->u8Known &&
+        (pstChange->u32Value == 0)) {
+      dFall = dTime;
+      sSelects++;
+    }
+  }
+  printf("SS %s: %zu selects, low %.3f %% of the run, moving bytes "
+         "%.3f %% of the selected time\n",
+         pstSelect->pcName, sSelects,
+         (wave_end > 0) ? 100.0 * dLow / WAVE_dUs(wave_end) : 0.0,
+         (dLow > 0.0) ? 100.0 * sBytes * wave_byte_us / dLow : 0.0);
+}
+
+/**
+ * @brief  Value of a signal at a time
+ * @param  pstSignal Signal, edges only
+ * @param  psCursor Search start, moved forward; times must not go back
+ * @param  u64Time Time in ps
+ * @return Value, 0 before the first change
+ */
+static uint32_t WAVE_u32ValueAt(const WaveSignal_t *pstSignal,
+                                size_t *psCursor, uint64_t u64Time) {
+  while ((*psCursor < pstSignal->sCount) &&
+         (pstSignal->pstChanges[*psCursor].u64Time <= u64Time)) {
+    (*psCursor)++;
+  }
+  return (*psCursor == 0) ? 0
+                          : pstSignal->pstChanges[*psCursor - 1].u32Value;
+}
+
+/**
+ * @brief  Print the enable pulse rate and character rate of the LCD
+ * @param  pstEnable Enable, edges only
+ * @param  pstSelect Register select, edges only, or NULL
+ * @return Void
+ */
+static void WAVE_vLcd(const WaveSignal_t *pstEnable,
+                      const WaveSignal_t *pstSelect) {
+  const WaveChange_t *pstChange;
+  WaveStats_t stWidth = {0};  /* us */
+  WaveStats_t stRedraw = {0}; /* us */
+  double dRise = -1.0;
+  double dStart = 0.0;
+  double dLast = -1.0;
+  double dTime;
+  double dSpan = WAVE_dUs(wave_end);
+  size_t sCursor = 0;
+  size_t sChars = 0;
+  size_t sCommands = 0;
+  size_t sIndex;
+
+  for (sIndex = 0; sIndex < pstEnable->sCount; sIndex++) {
+    pstChange = &pstEnable->pstChanges[sIndex];
+    if (!pstChange->u8Known) {
+      continue;
+    }
+    dTime = WAVE_dUs(pstChange->u64Time);
+    if (pstChange->u32Value != 0) {
+      dRise = dTime;
+      continue;
+    }
+    if (dRise < 0.0) {
+      continue; /* low at the start of the trace */
+    }
+    WAVE_vAdd(&stWidth, dTime - dRise);
+    dRise = -1.0;
+    if ((pstSelect != NULL) &&
+        (WAVE_u32ValueAt(pstSelect, &sCursor, pstChange->u64Time) != 0)) {
+      sChars++;
+    } else {
+      sCommands++;
+    }
+    if (dLast < 0.0) {
+      dStart = dTime;
+    } else if (dTime - dLast > wave_burst_gap_us) {
+      WAVE_vAdd(&stRedraw, dLast - dStart);
+      dStart = dTime;
+    }
+    dLast = dTime;
+  }
+  if (stWidth.sCount == 0) {
+    printf("LCD %s: no enable pulses\n", pstEnable->pcName);
+    return;
+  }
+  WAVE_vAdd(&stRedraw, dLast - dStart);
+
+  printf("LCD %s: %zu enable pulses (width min %.1f mean %.1f max %.1f us), "
+         "%zu characters, %zu commands%s\n",
+         pstEnable->pcName, stWidth.sCount, stWidth.dMin, WAVE_dMean(&stWidth),
+         stWidth.dMax, sChars, sCommands,
+         (pstSelect == NULL) ? " (no RS signal)" : "");
+  printf("  %zu redraws: min %.3f mean %.3f max %.3f ms, drawing %.3f %% of "
+         "the run\n",
+         stRedraw.sCount, stRedraw.dMin / WAVE_US_PER_MS,
+         WAVE_dMean(&stRedraw) / WAVE_US_PER_MS,
+         stRedraw.dMax / WAVE_US_PER_MS,
+         (dSpan > 0.0) ? 100.0 * stRedraw.dSum / dSpan : 0.0);
+  if (stRedraw.dSum > 0.0) {
+    printf("  while drawing: %.0f pulses/s, %.0f characters/s\n",
+           stWidth.sCount * WAVE_US_PER_S / stRedraw.dSum,
+           sChars * WAVE_US_PER_S / stRedraw.dSum);
+  }
+  if (dSpan > 0.0) {
+    printf("  over the run: %.1f pulses/s, %.1f characters/s\n",
+           stWidth.sCount * WAVE_US_PER_S / dSpan,
+           sChars * WAVE_US_PER_S / dSpan);
+  }
+}
+
+/**
+ * @brief  Print the frequency, duty accuracy and jitter of the fan PWM
+ * @param  pstSignal PWM pin, edges only
+ * @return Void
+ */
+static void WAVE_vPwm(const WaveSignal_t *pstSignal) {
+  const WaveChange_t *pstChange;
+  WaveStats_t stPeriod = {0}; /* us */
+  WaveStats_t stDuty = {0};   /* percent */
+  WaveStats_t stError = {0};  /* percent points, absolute */
+  WaveStats_t stEdge = {0};   /* us from the tick grid */
+  double dFirst = -1.0;
+  double dRise = -1.0;
+  double dFall = -1.0;
+  double dHigh = 0.0;
+  double dLevelSince = 0.0;
+  double dTime;
+  double dDuty;
+  double dTarget;
+  double dOffset;
+  uint32_t u32Level = 0;
+  size_t sIndex;
+
+  for (sIndex = 0; sIndex < pstSignal->sCount; sIndex++) {
+    pstChange = &pstSignal->pstChanges[sIndex];
+    if (!pstChange->u8Known) {
+      continue;
+    }
+    dTime = WAVE_dUs(pstChange->u64Time);
+    if (u32Level != 0) {
+      dHigh += dTime - dLevelSince;
+    }
+    u32Level = pstChange->u32Value;
+    dLevelSince = dTime;
+    if (pstChange->u8Initial) {
+      continue;
+    }
+
+    /* Every edge should sit on the tick grid */
+    if (dFirst < 0.0) {
+      dFirst = dTime;
+    }
+    dOffset = fmod(dTime - dFirst, wave_tick_us);
+    if (dOffset > wave_tick_us / 2.0) {
+      dOffset -= wave_tick_us;
+    }
+    WAVE_vAdd(&stEdge, dOffset);
+
+    if (u32Level == 0) {
+      dFall = dTime;
+      continue;
+    }
+    if ((dRise >= 0.0) && (dFall > dRise)) {
+      WAVE_vAdd(&stPeriod, dTime - dRise);
+      dDuty = 100.0 * (dFall - dRise) / (dTime - dRise);
+      WAVE_vAdd(&stDuty, dDuty);
+      dTarget = (wave_duty >= 0.0)
+                    ? wave_duty
+                    : round(dDuty * wave_steps / 100.0) * 100.0 / wave_steps;
+      WAVE_vAdd(&stError, fabs(dDuty - dTarget));
+    }
+    dRise = dTime;
+  }
+  if (u32Level != 0) {
+    dHigh += WAVE_dUs(wave_end) - dLevelSince;
+  }
+
+  if (stPeriod.sCount == 0) {
+    printf("PWM %s: no full period, high %.1f %% of the run\n",
+           pstSignal->pcName,
+           (wave_end > 0) ? 100.0 * dHigh / WAVE_dUs(wave_end) : 0.0);
+    return;
+  }
+  printf("PWM %s: %zu periods, %.3f Hz (period mean %.3f ms, expected "
+         "%.3f ms), high %.1f %% of the run\n",
+         pstSignal->pcName, stPeriod.sCount,
+         WAVE_US_PER_S / WAVE_dMean(&stPeriod),
+         WAVE_dMean(&stPeriod) / WAVE_US_PER_MS,
+         wave_tick_us * wave_steps / WAVE_US_PER_MS,
+         100.0 * dHigh / WAVE_dUs(wave_end));
+  printf("  period jitter: sd %.1f us, min %.3f max %.3f ms (p-p %.1f us)\n",
+         WAVE_dDeviation(&stPeriod), stPeriod.dMin / WAVE_US_PER_MS,
+         stPeriod.dMax / WAVE_US_PER_MS, stPeriod.dMax - stPeriod.dMin);
+  printf("  duty: mean %.2f min %.2f max %.2f %%, error vs %s: mean %.3f max "
+         "%.3f points\n",
+         WAVE_dMean(&stDuty), stDuty.dMin, stDuty.dMax,
+         (wave_duty >= 0.0) ? "--duty" : "nearest step", WAVE_dMean(&stError),
+         stError.dMax);
+  printf("  edges vs the %.0f us tick: sd %.1f us, p-p %.1f us\n",
+         wave_tick_us, WAVE_dDeviation(&stEdge), stEdge.dMax - stEdge.dMin);
+}
+
+/**
+ * @brief  Main Function
+ * @param  argc Argument count
+ * @param  argv Arguments
+ * @return 0 if a signal was analysed, 1 if none was found, 2 on an error
+ */
+int main(int argc, char *argv[]) {
+  WaveSignal_t *pstSignal;
+  FILE *pFile = stdin;
+  uint8_t u8Custom = 0; /* --spi replaces the default byte signals */
+  uint8_t u8Any = 0;
+  int iOption;
+  int iSignal;
+
+  while ((iOption = getopt_long(argc, argv, "", wave_options, NULL)) != -1) {
+    switch (iOption) {
+    case 's':
+      if (u8Custom == 0) {
+        u8Custom = 1;
+        wave_spi_count = 0;
+      }
+      if (wave_spi_count == WAVE_SPI_MAX) {
+        fprintf(stderr, "--spi: at most %d signals\n", WAVE_SPI_MAX);
+        return 2;
+      }
+      wave_signals[WAVE_SPI + wave_spi_count++].pcName = optarg;
+      break;
+    case 'c':
+      wave_signals[WAVE_SS].pcName = optarg;
+      break;
+    case 'b':
+      wave_byte_us = strtod(optarg, NULL);
+      break;
+    case 'f':
+      wave_frame_gap_us = strtod(optarg, NULL) * WAVE_US_PER_MS;
+      break;
+    case 'e':
+      wave_signals[WAVE_LCD_EN].pcName = optarg;
+      break;
+    case 'r':
+      wave_signals[WAVE_LCD_RS].pcName = optarg;
+      break;
+    case 'g':
+      wave_burst_gap_us = strtod(optarg, NULL) * WAVE_US_PER_MS;
+      break;
+    case 'p':
+      wave_signals[WAVE_PWM].pcName = optarg;
+      break;
+    case 't':
+      wave_tick_us = strtod(optarg, NULL);
+      break;
+    case 'n':
+      wave_steps = strtol(optarg, NULL, 10);
+      break;
+    case 'd':
+      wave_duty = strtod(optarg, NULL);
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [--spi NAME]... [--ss NAME] [--byte-us US] "
+              "[--frame-gap-ms MS] [--lcd-en NAME] [--lcd-rs NAME] "
+              "[--burst-gap-ms MS] [--pwm NAME] [--tick-us US] [--steps N] "
+              "[--duty PERCENT] [FILE]\n",
+              argv[0]);
+      return (iOption == 'h') ? 0 : 2;
+    }
+  }
+  if ((optind < argc - 1) || (wave_tick_us <= 0.0) || (wave_steps < 1)) {
+    fprintf(stderr, "%s: one trace, a positive tick and step count\n",
+            argv[0]);
+    return 2;
+  }
+  if ((optind == argc - 1) && (strcmp(argv[optind], "-") != 0)) {
+    pFile = fopen(argv[optind], "r");
+    if (pFile == NULL) {
+      perror(argv[optind]);
+      return 2;
+    }
+  }
+  if (!WAVE_u8Read(pFile)) {
+    return 2;
+  }
+  if (pFile != stdin) {
+    fclose(pFile);
+  }
+
+  for (iSignal = 0; iSignal < WAVE_SPI + wave_spi_count; iSignal++) {
+    pstSignal = &wave_signals[iSignal];
+    if (pstSignal->pcName == NULL) {
+      continue;
+    }
+    if (pstSignal->u8Found == 0) {
+      printf("%s: not in the trace\n", pstSignal->pcName);
+      continue;
+    }
+    if (iSignal != WAVE_LCD_RS) {
+      u8Any = 1; /* RS alone is not analysed */
+    }
+    if (iSignal < WAVE_SPI) {
+      WAVE_vEdges(pstSignal); /* bytes are kept, repeats included */
+    }
+  }
+  if (u8Any == 0) {
+    fprintf(stderr, "%s: none of the signals is in the trace\n", argv[0]);
+    return 1;
+  }
+
+  for (iSignal = WAVE_SPI; iSignal < WAVE_SPI + wave_spi_count; iSignal++) {
+    if (wave_signals[iSignal].u8Found) {
+      WAVE_vSpi(&wave_signals[iSignal]);
+    }
+  }
+  if (wave_signals[WAVE_SS].u8Found) {
+    WAVE_vSelect(&wave_signals[WAVE_SS],
+                 wave_signals[WAVE_SPI].u8Found ? &wave_signals[WAVE_SPI]
+                                                : NULL);
+  }
+  if (wave_signals[WAVE_LCD_EN].u8Found) {
+    WAVE_vLcd(&wave_signals[WAVE_LCD_EN], wave_signals[WAVE_LCD_RS].u8Found
+                                              ? &wave_signals[WAVE_LCD_RS]
+                                              : NULL);
+  }
+  if (wave_signals[WAVE_PWM].u8Found) {
+    WAVE_vPwm(&wave_signals[WAVE_PWM]);
+  }
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Module: Micro-benchmark
+ * File Name: ubench.h
+ * Description: Cases and marker protocol shared by the benchmark images and
+ *              smarthome_ubench
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+#ifndef UBENCH_UBENCH_H_
+#define UBENCH_UBENCH_H_
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+/* Marker register: TWBR, the TWI is unused on both nodes. The image writes
+   the case number before the loop of a case and UBENCH_STOP after it, the
+   simulator takes the cycle count on each write */
+#define UBENCH_MARK_ADDR 0x20 /* data space address */
+#define UBENCH_STOP 0x00
+#define UBENCH_DONE 0xFF /* every case has run */
+
+/* Cases, with the number of calls each loop makes */
+#define UBENCH_LOOP 1 /* empty loop, subtracted from the other cases */
+#define UBENCH_LOOP_CALLS 1000
+#define UBENCH_DIO_WRITE 2
+#define UBENCH_DIO_WRITE_CALLS 1000
+#define UBENCH_DIO_WRITE_PIN 3 /* inline, constant port and pin */
+#define UBENCH_DIO_WRITE_PIN_CALLS 1000
+#define UBENCH_DIO_READ 4
+#define UBENCH_DIO_READ_CALLS 1000
+#define UBENCH_LCD_CHAR 5
+#define UBENCH_LCD_CHAR_CALLS 20
+#define UBENCH_LCD_STRING 6 /* 16 characters, one row */
+#define UBENCH_LCD_STRING_CALLS 5
+#define UBENCH_LCD_CURSOR 7
+#define UBENCH_LCD_CURSOR_CALLS 20
+#define UBENCH_KEYPAD 8 /* no key down, every row is scanned */
+#define UBENCH_KEYPAD_CALLS 5
+#define UBENCH_SPI 9
+#define UBENCH_SPI_CALLS 100
+#define UBENCH_COMPARE_PASS 10 /* equal passwords, every byte compared */
+#define UBENCH_COMPARE_PASS_CALLS 1000
+#define UBENCH_ADC_READ 11
+#define UBENCH_ADC_READ_CALLS 100
+#define UBENCH_ADC_CHANNEL 12
+#define UBENCH_ADC_CHANNEL_CALLS 100
+#define UBENCH_CASE_COUNT 13 /* case numbers are below this */
+
+#define UBENCH_MARK TWBR /* image side, from <avr/io.h> */
+
+/* Calls statement u16Calls times between the two markers of case u8Case */
+#define UBENCH_RUN(u8Case, u16Calls, statement)                               \
+  do {                                                                         \
+    uint16 u16Call;                                                            \
+    UBENCH_MARK = (u8Case);                                                    \
+    for (u16Call = 0; u16Call < (u16Calls); u16Call++) {                       \
+      statement;                                                               \
+    }                                                                          \
+    UBENCH_MARK = UBENCH_STOP;                                                 \
+  } while (0)
+
+#endif /* UBENCH_UBENCH_H_ */
\ No newline at end of file
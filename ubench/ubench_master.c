@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Module: Micro-benchmark
+ * File Name: ubench_master.c
+ * Description: Benchmark image for the master's DIO, LCD, keypad, SPI and
+ *              password primitives
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Runs every case of ubench.h once with the interrupts off, then idles.
+ * The cycle counts come from the simulator (host/tools/ubench.c), the image
+ * itself prints nothing. The drivers are the node's own sources, built with
+ * the node's flags.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "APP/menu.h"
+#include "ubench.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Results land here so the calls are not optimised away */
+static volatile uint8 ubench_sink;
+
+static const char ubench_row[] = "Select a room:  "; /* 16 characters */
+static uint8 ubench_pass1[PASS_SIZE] = ADMIN_PASS;
+static uint8 ubench_pass2[PASS_SIZE] = ADMIN_PASS;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Main Function
+ * @return Never returns
+ */
+int main(void) {
+  DIO_vsetPINDir(ADMIN_LED_PORT, ADMIN_LED_PIN, 1);
+  LCD_vInit();
+  keypad_vInit();
+  SPI_vInitMaster();
+
+  UBENCH_RUN(UBENCH_LOOP, UBENCH_LOOP_CALLS, ubench_sink = 0);
+  UBENCH_RUN(UBENCH_DIO_WRITE, UBENCH_DIO_WRITE_CALLS,
+             DIO_write(ADMIN_LED_PORT, ADMIN_LED_PIN, (uint8)(u16Call & 1)));
+  UBENCH_RUN(
+      UBENCH_DIO_WRITE_PIN, UBENCH_DIO_WRITE_PIN_CALLS,
+      DIO_vWritePin(ADMIN_LED_PORT, ADMIN_LED_PIN, (uint8)(u16Call & 1)));
+  UBENCH_RUN(UBENCH_DIO_READ, UBENCH_DIO_READ_CALLS,
+             ubench_sink = DIO_u8read(KEYPAD_PORT, KEYPAD_FIFTH_PIN));
+  UBENCH_RUN(UBENCH_LCD_CHAR, UBENCH_LCD_CHAR_CALLS, LCD_vSend_char('*'));
+  UBENCH_RUN(UBENCH_LCD_STRING, UBENCH_LCD_STRING_CALLS,
+             LCD_vSend_string(ubench_row));
+  UBENCH_RUN(UBENCH_LCD_CURSOR, UBENCH_LCD_CURSOR_CALLS,
+             LCD_movecursor(2, 1));
+  UBENCH_RUN(UBENCH_KEYPAD, UBENCH_KEYPAD_CALLS,
+             ubench_sink = keypad_u8check_press());
+  UBENCH_RUN(UBENCH_SPI, UBENCH_SPI_CALLS,
+             ubench_sink = SPI_ui8TransmitRecive(DEMAND_RESPONSE));
+  UBENCH_RUN(UBENCH_COMPARE_PASS, UBENCH_COMPARE_PASS_CALLS,
+             ubench_sink =
+                 ui8ComparePass(ubench_pass1, ubench_pass2, PASS_SIZE));
+
+  UBENCH_MARK = UBENCH_DONE;
+  while (1) {
+  }
+}
\ No newline at end of file
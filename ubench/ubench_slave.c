@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Module: Micro-benchmark
+ * File Name: ubench_slave.c
+ * Description: Benchmark image for the slave's ADC primitives
+ * Author: Abdelrahman Arafa
+ * Email: engarafa55@gmail.com
+ ******************************************************************************/
+/*
+ * Same protocol as ubench_master.c. A conversion takes 13 ADC clocks at
+ * clk/64, so both cases are dominated by the busy wait on ADIF.
+ */
+
+/*******************************************************************************
+ *                             Includes                                 *
+ *******************************************************************************/
+#include "MCAL/ADC/ADC_driver.h"
+#include "ubench.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                             Definitions                              *
+ *******************************************************************************/
+#define UBENCH_LDR_CHANNEL (uint8)1 /* as in APP/main.c */
+
+/*******************************************************************************
+ *                           Global Variables                           *
+ *******************************************************************************/
+/* Results land here so the calls are not optimised away */
+static volatile uint16 ubench_sink;
+
+/*******************************************************************************
+ *                        Functions Definitions                         *
+ *******************************************************************************/
+/**
+ * @brief  Main Function
+ * @return Never returns
+ */
+int main(void) {
+  ADC_vinit();
+
+  UBENCH_RUN(UBENCH_LOOP, UBENCH_LOOP_CALLS, ubench_sink = 0);
+  UBENCH_RUN(UBENCH_ADC_READ, UBENCH_ADC_READ_CALLS,
+             ubench_sink = ADC_u16Read());
+  UBENCH_RUN(UBENCH_ADC_CHANNEL, UBENCH_ADC_CHANNEL_CALLS,
+             ubench_sink = ADC_u16ReadChannel_Custom(UBENCH_LDR_CHANNEL));
+
+  UBENCH_MARK = UBENCH_DONE;
+  while (1) {
+  }
+}
\ No newline at end of file